@@ -0,0 +1,306 @@
+/**************************************************************************
+
+    This is the device code. This file contains the child class where
+    custom functionality can be added to the device. Custom
+    functionality to the base class can be extended here. Access to
+    the ports can also be done from this class
+
+**************************************************************************/
+
+#include "DDC.h"
+#include "../RDC/RDC.h"
+
+using namespace DDC_ns;
+
+PREPARE_LOGGING(DDC_i)
+
+DDC_i::DDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl) :
+    DDC_base(devMgr_ior, id, lbl, sftwrPrfl)
+{
+}
+
+DDC_i::DDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev) :
+    DDC_base(devMgr_ior, id, lbl, sftwrPrfl, compDev)
+{
+}
+
+DDC_i::DDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities) :
+    DDC_base(devMgr_ior, id, lbl, sftwrPrfl, capacities)
+{
+}
+
+DDC_i::DDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev) :
+    DDC_base(devMgr_ior, id, lbl, sftwrPrfl, capacities, compDev)
+{
+}
+
+DDC_i::~DDC_i()
+{
+}
+
+void DDC_i::constructor()
+{
+    /***********************************************************************************
+     This is the RH constructor. All properties are properly initialized before this function is called
+
+     For a tuner device, the structure frontend_tuner_status needs to match the number
+     of tuners that this device controls and what kind of device it is.
+     The options for devices are: TX, RX, RX_DIGITIZER, CHANNELIZER, DDC, RX_DIGITIZER_CHANNELIZER
+    ***********************************************************************************/
+    this->addChannels(1, "DDC");
+    this->setDataPort(dataFloat_out->_this());
+    this->setControlPort(DigitalTuner_in->_this());
+    _source = NULL;
+    _active = false;
+    _update_sri = false;
+}
+
+/***********************************************************************************************
+
+    The output data is produced by the parent RDC's service function (see pushChannel), so
+    there is nothing for this device's own processing thread to do.
+
+***********************************************************************************************/
+int DDC_i::serviceFunction()
+{
+    return FINISH;
+}
+
+void DDC_i::setSource(RDC_ns::RDC_i* source, size_t channel)
+{
+    _source = source;
+    channel_index = channel;
+}
+
+bool DDC_i::channelTuning(double& center_frequency, double& bandwidth, double& sample_rate)
+{
+    double rdc_center = 0;
+    double rdc_rate = 0;
+    if ((_source == NULL) or (not _source->channelizerInput(rdc_center, rdc_rate)) or (rdc_rate <= 0))
+        return false;
+
+    // channels from M/2 up hold the negative frequencies
+    const long channels = _source->channelizerChannels();
+    const long offset = (long(channel_index) < channels/2) ? long(channel_index) : long(channel_index)-channels;
+    sample_rate = rdc_rate/channels;
+    center_frequency = rdc_center + offset*sample_rate;
+    bandwidth = sample_rate*_source->channelizerUsableBandwidth();
+    return true;
+}
+
+void DDC_i::pushChannel(const float* data, size_t num_samps, const BULKIO::PrecisionUTCTime& time)
+{
+    boost::mutex::scoped_lock lock(_stream_lock);
+    if ((not isActive()) or _stream_id.empty())
+        return;
+
+    bulkio::OutFloatStream stream = dataFloat_out->getStream(_stream_id);
+    if (_update_sri or !stream) {
+        BULKIO::StreamSRI sri = this->create(_stream_id, frontend_tuner_status[0], -1.0);
+        sri.mode = 1; // complex
+        if (!stream) {
+            stream = dataFloat_out->createStream(sri);
+        } else {
+            stream.sri(sri);
+        }
+        _update_sri = false;
+    }
+
+    // the filterbank reuses its output buffer on the next block
+    redhawk::buffer<float> out(2*num_samps);
+    std::copy(data, data+2*num_samps, out.data());
+    stream.write(out, time);
+}
+
+void DDC_i::sourceChanged(bool tuned)
+{
+    if (not _active)
+        return;
+    if (not tuned) {
+        RH_WARN(this->_baseLog, "sourceChanged|parent RDC lost its allocation; channel " << channel_index << " stops producing data");
+        endStream();
+        return;
+    }
+
+    double center_frequency, bandwidth, sample_rate;
+    if (channelTuning(center_frequency, bandwidth, sample_rate)) {
+        frontend_tuner_status[0].center_frequency = center_frequency;
+        frontend_tuner_status[0].bandwidth = bandwidth;
+        frontend_tuner_status[0].sample_rate = sample_rate;
+        boost::mutex::scoped_lock lock(_stream_lock);
+        if (_stream_id.empty())
+            createStreamId(center_frequency);
+        _update_sri = true;
+    }
+}
+
+// called with _stream_lock held
+void DDC_i::createStreamId(double center_frequency)
+{
+    std::ostringstream id;
+    id<<"ddc_freq_"<<long(center_frequency)<<"_Hz_"<<frontend::uuidGenerator();
+    _stream_id = id.str();
+}
+
+void DDC_i::endStream()
+{
+    boost::mutex::scoped_lock lock(_stream_lock);
+    if (_stream_id.empty())
+        return;
+    bulkio::OutFloatStream stream = dataFloat_out->getStream(_stream_id);
+    if (stream)
+        stream.close();
+    _stream_id.clear();
+}
+
+/*************************************************************
+Functions supporting tuning allocation
+*************************************************************/
+void DDC_i::deviceEnable(frontend_tuner_status_struct_struct &fts, size_t tuner_id){
+    fts.enabled = true;
+    return;
+}
+void DDC_i::deviceDisable(frontend_tuner_status_struct_struct &fts, size_t tuner_id){
+    fts.enabled = false;
+    return;
+}
+bool DDC_i::deviceSetTuning(const frontend::frontend_tuner_allocation_struct &request, frontend_tuner_status_struct_struct &fts, size_t tuner_id){
+    /************************************************************
+    The channel is fixed by the filterbank; the request has to fall inside it
+    and not ask for more rate or bandwidth than the channel has
+    ************************************************************/
+    double center_frequency, bandwidth, sample_rate;
+    if (not channelTuning(center_frequency, bandwidth, sample_rate)) {
+        RH_DEBUG(this->_baseLog, "deviceSetTuning|parent RDC is not allocated");
+        return false;
+    }
+
+    try {
+        if (not frontend::validateRequest(center_frequency-bandwidth/2, center_frequency+bandwidth/2,
+                                          request.center_frequency-request.bandwidth/2, request.center_frequency+request.bandwidth/2)) {
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- request is not within channel");
+        }
+        if ((request.sample_rate > sample_rate) or
+            ((request.sample_rate > 0) and (request.sample_rate_tolerance > 0) and (sample_rate > request.sample_rate*(1+request.sample_rate_tolerance/100.0)))) {
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- channel rate does not match sr request");
+        }
+        if ((request.bandwidth > 0) and (request.bandwidth_tolerance > 0) and (bandwidth > request.bandwidth*(1+request.bandwidth_tolerance/100.0))) {
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- channel bandwidth does not match bw request");
+        }
+    } catch(FRONTEND::BadParameterException& e){
+        RH_DEBUG(this->_baseLog,"deviceSetTuning|channel " << channel_index << " at " << center_frequency << " Hz|" << e.msg);
+        return false;
+    }
+
+    fts.center_frequency = center_frequency;
+    fts.bandwidth = bandwidth;
+    fts.sample_rate = sample_rate;
+    fts.bandwidth_tolerance = request.bandwidth_tolerance;
+    fts.sample_rate_tolerance = request.sample_rate_tolerance;
+
+    {
+        boost::mutex::scoped_lock lock(_stream_lock);
+        createStreamId(center_frequency);
+        _update_sri = true;
+    }
+    _active = true;
+    RH_DEBUG(this->_baseLog,"deviceSetTuning|channel " << channel_index << " at " << center_frequency << " Hz, " << sample_rate << " sps");
+    return true;
+}
+
+bool DDC_i::deviceDeleteTuning(frontend_tuner_status_struct_struct &fts, size_t tuner_id) {
+    _active = false;
+    endStream();
+    return true;
+}
+
+/*************************************************************
+Functions servicing the tuner control port
+*************************************************************/
+std::string DDC_i::getTunerType(const std::string& allocation_id) {
+    return frontend_tuner_status[0].tuner_type;
+}
+
+bool DDC_i::getTunerDeviceControl(const std::string& allocation_id) {
+    return true;
+}
+
+std::string DDC_i::getTunerGroupId(const std::string& allocation_id) {
+    return frontend_tuner_status[0].group_id;
+}
+
+std::string DDC_i::getTunerRfFlowId(const std::string& allocation_id) {
+    return frontend_tuner_status[0].rf_flow_id;
+}
+
+void DDC_i::setTunerCenterFrequency(const std::string& allocation_id, double freq) {
+    throw FRONTEND::NotSupportedException("setTunerCenterFrequency not supported; allocate the DDC channel covering the frequency instead");
+}
+
+double DDC_i::getTunerCenterFrequency(const std::string& allocation_id) {
+    return frontend_tuner_status[0].center_frequency;
+}
+
+void DDC_i::setTunerBandwidth(const std::string& allocation_id, double bw) {
+    throw FRONTEND::NotSupportedException("setTunerBandwidth not supported");
+}
+
+double DDC_i::getTunerBandwidth(const std::string& allocation_id) {
+    return frontend_tuner_status[0].bandwidth;
+}
+
+void DDC_i::setTunerAgcEnable(const std::string& allocation_id, bool enable)
+{
+    throw FRONTEND::NotSupportedException("setTunerAgcEnable not supported");
+}
+
+bool DDC_i::getTunerAgcEnable(const std::string& allocation_id)
+{
+    throw FRONTEND::NotSupportedException("getTunerAgcEnable not supported");
+}
+
+void DDC_i::setTunerGain(const std::string& allocation_id, float gain)
+{
+    throw FRONTEND::NotSupportedException("setTunerGain not supported");
+}
+
+float DDC_i::getTunerGain(const std::string& allocation_id)
+{
+    throw FRONTEND::NotSupportedException("getTunerGain not supported");
+}
+
+void DDC_i::setTunerReferenceSource(const std::string& allocation_id, long source)
+{
+    throw FRONTEND::NotSupportedException("setTunerReferenceSource not supported");
+}
+
+long DDC_i::getTunerReferenceSource(const std::string& allocation_id)
+{
+    throw FRONTEND::NotSupportedException("getTunerReferenceSource not supported");
+}
+
+void DDC_i::setTunerEnable(const std::string& allocation_id, bool enable) {
+    this->frontend_tuner_status[0].enabled = enable;
+}
+
+bool DDC_i::getTunerEnable(const std::string& allocation_id) {
+    return frontend_tuner_status[0].enabled;
+}
+
+void DDC_i::setTunerOutputSampleRate(const std::string& allocation_id, double sr) {
+    throw FRONTEND::NotSupportedException("setTunerOutputSampleRate not supported");
+}
+
+double DDC_i::getTunerOutputSampleRate(const std::string& allocation_id){
+    return frontend_tuner_status[0].sample_rate;
+}
+
+void DDC_i::configureTuner(const std::string& id, const CF::Properties& tunerSettings){
+    // set the appropriate tuner settings
+}
+
+CF::Properties* DDC_i::getTunerSettings(const std::string& id){
+    // return the tuner settings
+    redhawk::PropertyMap* tuner_settings = new redhawk::PropertyMap();
+    return tuner_settings;
+}
@@ -0,0 +1,91 @@
+#ifndef DDC_I_IMPL_H
+#define DDC_I_IMPL_H
+
+#include "DDC_base.h"
+#include <atomic>
+
+namespace RDC_ns {
+class RDC_i;
+};
+
+namespace DDC_ns {
+/*
+ * One channel of an RDC's polyphase filterbank (see RDC_ns::pfbChannelizer).
+ * The channel's center and rate follow the parent RDC's tuning, so an allocation
+ * only succeeds while the RDC is allocated and the request fits inside this
+ * channel. The RDC's service function hands each block of channel output to
+ * pushChannel().
+ */
+class DDC_i : public DDC_base
+{
+    ENABLE_LOGGING
+    public:
+        DDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl);
+        DDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev);
+        DDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities);
+        DDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev);
+        ~DDC_i();
+
+        void constructor();
+
+        int serviceFunction();
+
+        void setSource(RDC_ns::RDC_i* source, size_t channel);
+
+        // allocated and enabled, i.e. the RDC should produce this channel
+        bool isActive() const {
+            return _active and frontend_tuner_status[0].enabled;
+        }
+        // num_samps interleaved complex samples of this channel's output, the first taken at time
+        void pushChannel(const float* data, size_t num_samps, const BULKIO::PrecisionUTCTime& time);
+        // the RDC was retuned (tuned true) or lost its allocation (tuned false)
+        void sourceChanged(bool tuned);
+
+    protected:
+        std::string getTunerType(const std::string& allocation_id);
+        bool getTunerDeviceControl(const std::string& allocation_id);
+        std::string getTunerGroupId(const std::string& allocation_id);
+        std::string getTunerRfFlowId(const std::string& allocation_id);
+        double getTunerCenterFrequency(const std::string& allocation_id);
+        void setTunerCenterFrequency(const std::string& allocation_id, double freq);
+        double getTunerBandwidth(const std::string& allocation_id);
+        void setTunerBandwidth(const std::string& allocation_id, double bw);
+        bool getTunerAgcEnable(const std::string& allocation_id);
+        void setTunerAgcEnable(const std::string& allocation_id, bool enable);
+        float getTunerGain(const std::string& allocation_id);
+        void setTunerGain(const std::string& allocation_id, float gain);
+        long getTunerReferenceSource(const std::string& allocation_id);
+        void setTunerReferenceSource(const std::string& allocation_id, long source);
+        bool getTunerEnable(const std::string& allocation_id);
+        void setTunerEnable(const std::string& allocation_id, bool enable);
+        double getTunerOutputSampleRate(const std::string& allocation_id);
+        void setTunerOutputSampleRate(const std::string& allocation_id, double sr);
+        void configureTuner(const std::string& id, const CF::Properties& tunerSettings);
+        CF::Properties* getTunerSettings(const std::string& id);
+
+        // center, usable bandwidth and rate of this channel at the RDC's current tuning
+        bool channelTuning(double& center_frequency, double& bandwidth, double& sample_rate);
+        void createStreamId(double center_frequency);
+        void endStream();
+
+        RDC_ns::RDC_i* _source;
+        std::string _stream_id;
+        std::atomic<bool> _active;
+        bool _update_sri;
+        boost::mutex _stream_lock; // _stream_id, _update_sri and the output stream
+
+    private:
+        ////////////////////////////////////////
+        // Required device specific functions // -- to be implemented by device developer
+        ////////////////////////////////////////
+
+        // these are pure virtual, must be implemented here
+        void deviceEnable(frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+        void deviceDisable(frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+        bool deviceSetTuning(const frontend::frontend_tuner_allocation_struct &request, frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+        bool deviceDeleteTuning(frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+
+};
+};
+
+#endif // DDC_I_IMPL_H
@@ -0,0 +1,150 @@
+#include "DDC_base.h"
+
+/*******************************************************************************************
+
+    AUTO-GENERATED CODE. DO NOT MODIFY
+
+    The following class functions are for the base class for the device class. To
+    customize any of these functions, do not modify them here. Instead, overload them
+    on the child class
+
+******************************************************************************************/
+
+using namespace DDC_ns;
+
+DDC_base::DDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl) :
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>(devMgr_ior, id, lbl, sftwrPrfl),
+    ThreadedComponent()
+{
+    construct();
+}
+
+DDC_base::DDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev) :
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>(devMgr_ior, id, lbl, sftwrPrfl, compDev),
+    ThreadedComponent()
+{
+    construct();
+}
+
+DDC_base::DDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities) :
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>(devMgr_ior, id, lbl, sftwrPrfl, capacities),
+    ThreadedComponent()
+{
+    construct();
+}
+
+DDC_base::DDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev) :
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>(devMgr_ior, id, lbl, sftwrPrfl, capacities, compDev),
+    ThreadedComponent()
+{
+    construct();
+}
+
+DDC_base::~DDC_base()
+{
+    DigitalTuner_in->_remove_ref();
+    DigitalTuner_in = 0;
+    dataFloat_out->_remove_ref();
+    dataFloat_out = 0;
+}
+
+void DDC_base::construct()
+{
+    loadProperties();
+
+    DigitalTuner_in = new frontend::InDigitalTunerPort("DigitalTuner_in", this);
+    DigitalTuner_in->setLogger(this->_baseLog->getChildLogger("DigitalTuner_in", "ports"));
+    addPort("DigitalTuner_in", DigitalTuner_in);
+    dataFloat_out = new bulkio::OutFloatPort("dataFloat_out");
+    dataFloat_out->setLogger(this->_baseLog->getChildLogger("dataFloat_out", "ports"));
+    addPort("dataFloat_out", dataFloat_out);
+    this->setHost(this);
+
+}
+
+/*******************************************************************************************
+    Framework-level functions
+    These functions are generally called by the framework to perform housekeeping.
+*******************************************************************************************/
+void DDC_base::start() throw (CORBA::SystemException, CF::Resource::StartError)
+{
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>::start();
+    ThreadedComponent::startThread();
+}
+
+void DDC_base::stop() throw (CORBA::SystemException, CF::Resource::StopError)
+{
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>::stop();
+    if (!ThreadedComponent::stopThread()) {
+        throw CF::Resource::StopError(CF::CF_NOTSET, "Processing thread did not die");
+    }
+}
+
+void DDC_base::releaseObject() throw (CORBA::SystemException, CF::LifeCycle::ReleaseError)
+{
+    // This function clears the device running condition so main shuts down everything
+    try {
+        stop();
+    } catch (CF::Resource::StopError& ex) {
+        // TODO - this should probably be logged instead of ignored
+    }
+
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>::releaseObject();
+}
+
+void DDC_base::loadProperties()
+{
+    device_kind = "FRONTEND::TUNER";
+    addProperty(channel_index,
+                0,
+                "channel_index",
+                "channel_index",
+                "readonly",
+                "",
+                "external",
+                "property");
+
+    frontend_listener_allocation = frontend::frontend_listener_allocation_struct();
+    frontend_tuner_allocation = frontend::frontend_tuner_allocation_struct();
+
+}
+
+CF::Properties* DDC_base::getTunerStatus(const std::string& allocation_id)
+{
+    CF::Properties* tmpVal = new CF::Properties();
+    long tuner_id = getTunerMapping(allocation_id);
+    if (tuner_id < 0)
+        throw FRONTEND::FrontendException(("ERROR: ID: " + std::string(allocation_id) + " IS NOT ASSOCIATED WITH ANY TUNER!").c_str());
+    CORBA::Any prop;
+    prop <<= *(static_cast<frontend_tuner_status_struct_struct*>(&this->frontend_tuner_status[tuner_id]));
+    prop >>= tmpVal;
+
+    CF::Properties_var tmp = new CF::Properties(*tmpVal);
+    return tmp._retn();
+}
+
+void DDC_base::frontendTunerStatusChanged(const std::vector<frontend_tuner_status_struct_struct>* oldValue, const std::vector<frontend_tuner_status_struct_struct>* newValue)
+{
+    this->tuner_allocation_ids.resize(this->frontend_tuner_status.size());
+}
+
+void DDC_base::assignListener(const std::string& listen_alloc_id, const std::string& allocation_id)
+{
+    // find control allocation_id
+    std::string existing_alloc_id = allocation_id;
+    std::map<std::string,std::string>::iterator existing_listener;
+    while ((existing_listener=listeners.find(existing_alloc_id)) != listeners.end())
+        existing_alloc_id = existing_listener->second;
+    listeners[listen_alloc_id] = existing_alloc_id;
+
+}
+
+void DDC_base::removeListener(const std::string& listen_alloc_id)
+{
+    if (listeners.find(listen_alloc_id) != listeners.end()) {
+        listeners.erase(listen_alloc_id);
+    }
+}
+void DDC_base::removeAllocationIdRouting(const size_t tuner_id) {
+}
+
@@ -0,0 +1,56 @@
+#ifndef DDC_BASE_IMPL_BASE_H
+#define DDC_BASE_IMPL_BASE_H
+
+#include <boost/thread.hpp>
+#include <frontend/frontend.h>
+#include <ossie/ThreadedComponent.h>
+#include <ossie/DynamicComponent.h>
+
+#include <frontend/frontend.h>
+#include <bulkio/bulkio.h>
+#include "DDC_struct_props.h"
+
+#define BOOL_VALUE_HERE 0
+
+namespace DDC_ns {
+class DDC_base : public frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>, public virtual frontend::digital_tuner_delegation, protected ThreadedComponent, public virtual DynamicComponent
+{
+    public:
+        DDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl);
+        DDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev);
+        DDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities);
+        DDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev);
+        ~DDC_base();
+
+        void start() throw (CF::Resource::StartError, CORBA::SystemException);
+
+        void stop() throw (CF::Resource::StopError, CORBA::SystemException);
+
+        void releaseObject() throw (CF::LifeCycle::ReleaseError, CORBA::SystemException);
+
+        void loadProperties();
+        void removeAllocationIdRouting(const size_t tuner_id);
+
+        virtual CF::Properties* getTunerStatus(const std::string& allocation_id);
+        virtual void assignListener(const std::string& listen_alloc_id, const std::string& allocation_id);
+        virtual void removeListener(const std::string& listen_alloc_id);
+        void frontendTunerStatusChanged(const std::vector<frontend_tuner_status_struct_struct>* oldValue, const std::vector<frontend_tuner_status_struct_struct>* newValue);
+
+    protected:
+        // Member variables exposed as properties
+        /// Property: channel_index
+        CORBA::ULong channel_index;
+
+        // Ports
+        /// Port: DigitalTuner_in
+        frontend::InDigitalTunerPort *DigitalTuner_in;
+        /// Port: dataFloat_out
+        bulkio::OutFloatPort *dataFloat_out;
+
+        std::map<std::string, std::string> listeners;
+
+    private:
+        void construct();
+};
+};
+#endif // DDC_BASE_IMPL_BASE_H
@@ -0,0 +1,509 @@
+/**************************************************************************
+
+    This is the device code. This file contains the child class where
+    custom functionality can be added to the device. Custom
+    functionality to the base class can be extended here. Access to
+    the ports can also be done from this class
+
+**************************************************************************/
+
+#include "DRDC.h"
+#include "../RDC/RDC.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace DRDC_ns;
+
+PREPARE_LOGGING(DRDC_i)
+
+DRDC_i::DRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl) :
+    DRDC_base(devMgr_ior, id, lbl, sftwrPrfl)
+{
+}
+
+DRDC_i::DRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev) :
+    DRDC_base(devMgr_ior, id, lbl, sftwrPrfl, compDev)
+{
+}
+
+DRDC_i::DRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities) :
+    DRDC_base(devMgr_ior, id, lbl, sftwrPrfl, capacities)
+{
+}
+
+DRDC_i::DRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev) :
+    DRDC_base(devMgr_ior, id, lbl, sftwrPrfl, capacities, compDev)
+{
+}
+
+DRDC_i::~DRDC_i()
+{
+}
+
+namespace {
+    // most samples sent in one packet; a backlog is worked off over several
+    const uint64_t PUSH_SAMPLES = 1 << 18;
+    // blocks from the RDC waiting for the store; past this the newest are dropped
+    const size_t QUEUE_BLOCKS = 128;
+
+    BULKIO::PrecisionUTCTime j1970(double seconds)
+    {
+        const double whole = floor(seconds);
+        return bulkio::time::utils::create(whole, seconds-whole);
+    }
+}
+
+void DRDC_i::constructor()
+{
+    /***********************************************************************************
+     This is the RH constructor. All properties are properly initialized before this function is called
+
+     For a tuner device, the structure frontend_tuner_status needs to match the number
+     of tuners that this device controls and what kind of device it is.
+     The options for devices are: TX, RX, RX_DIGITIZER, CHANNELIZER, DDC, RX_DIGITIZER_CHANNELIZER
+    ***********************************************************************************/
+    this->addChannels(1, "DRDC");
+    this->setDataPort(dataShort_out->_this());
+    this->setControlPort(DigitalTuner_in->_this());
+    this->setThreadDelay(0.01);
+    _source = NULL;
+    _active = false;
+    _restart = true;
+    _delay = 0;
+    _reposition = true;
+    _read_index = 0;
+    _next_delay = false;
+    _next_delay_relative = true;
+    _next_delay_whole = 0;
+    _next_delay_partial = 0;
+    _update_sri = false;
+    _queue_open = false;
+    _queue_gap = false;
+    _queue_dropping = false;
+}
+
+/***********************************************************************************************
+
+    Stores the blocks the RDC queued, then sends whatever the store holds that is at least
+    _delay old, up to PUSH_SAMPLES at a time. Each packet stays within one run of contiguous
+    samples, so its timestamp holds for all of it.
+
+***********************************************************************************************/
+int DRDC_i::serviceFunction()
+{
+    redhawk::shared_buffer<short> out;
+    BULKIO::PrecisionUTCTime time;
+    double delay;
+    bool delay_changed;
+    {
+        boost::mutex::scoped_lock lock(_store_lock);
+        if (_active)
+            storeQueued();
+        if ((not _active) or (_store.end() == 0))
+            return NOOP;
+
+        delay_changed = updateDelay();
+        delay = _delay;
+        const double now = bulkio::time::utils::now() - _epoch;
+        if (_reposition) {
+            _read_index = _store.indexOf(now - _delay);
+            _reposition = false;
+        }
+        if (_read_index < _store.begin()) {
+            RH_WARN(this->_baseLog, "serviceFunction|output fell " << _store.begin()-_read_index << " samples behind the oldest stored sample; skipping ahead");
+            _read_index = _store.begin();
+        }
+        _read_index = std::min(_read_index, _store.end());
+
+        delay_held_seconds = _store.timeOf(_store.end()) - _store.timeOf(_store.begin());
+        delay_actual_seconds = now - _store.timeOf(_read_index);
+
+        // a time in a gap maps past it, but the segment limit keeps the far side from going early
+        const uint64_t due = std::min(_store.indexOf(now - _delay), _store.segmentEnd(_read_index));
+        const uint64_t last = std::min(due, _read_index + PUSH_SAMPLES);
+        if (last <= _read_index)
+            return NOOP;
+        if (not frontend_tuner_status[0].enabled) {
+            _read_index = last;
+            return NOOP;
+        }
+        const size_t count = last-_read_index;
+        redhawk::buffer<short> pooled = _out_pool.get(2*count);
+        _store.read(_read_index, count, pooled.data());
+        out = pooled.slice(0, 2*count);
+        time = _epoch + _store.timeOf(_read_index);
+        _read_index = last;
+    }
+
+    boost::mutex::scoped_lock lock(_stream_lock);
+    if (_stream_id.empty())
+        return NOOP;
+    bulkio::OutShortStream stream = dataShort_out->getStream(_stream_id);
+    if (_update_sri or delay_changed or !stream) {
+        BULKIO::StreamSRI sri = this->create(_stream_id, frontend_tuner_status[0], -1.0);
+        sri.mode = 1; // complex
+        redhawk::PropertyMap::cast(sri.keywords)["DELAY_SECONDS"] = delay;
+        if (!stream) {
+            stream = dataShort_out->createStream(sri);
+        } else {
+            stream.sri(sri);
+        }
+        _update_sri = false;
+    }
+    stream.write(out, time);
+    return NORMAL;
+}
+
+bool DRDC_i::updateDelay()
+{
+    if (delay_start_time > 0) {
+        delay_seconds = bulkio::time::utils::now() - j1970(delay_start_time);
+        delay_start_time = 0;
+    }
+    if (delay_seconds == _delay)
+        return false;
+
+    const double longest = _store.capacity() / _store.sampleRate();
+    if ((delay_seconds < 0) or (delay_seconds > longest)) {
+        RH_WARN(this->_baseLog, "updateDelay|delay of " << delay_seconds << " s is outside the store's 0 to " << longest << " s; keeping " << _delay << " s");
+        delay_seconds = _delay;
+        return false;
+    }
+    RH_DEBUG(this->_baseLog, "updateDelay|output moves from " << _delay << " s to " << delay_seconds << " s behind");
+    _delay = delay_seconds;
+    _reposition = true;
+    return true;
+}
+
+void DRDC_i::setSource(RDC_ns::RDC_i* source)
+{
+    _source = source;
+}
+
+void DRDC_i::setDelayRequest(bool relative, double whole_seconds, double partial_seconds)
+{
+    boost::mutex::scoped_lock lock(_store_lock);
+    _next_delay = true;
+    _next_delay_relative = relative;
+    _next_delay_whole = whole_seconds;
+    _next_delay_partial = partial_seconds;
+}
+
+void DRDC_i::clearDelayRequest()
+{
+    boost::mutex::scoped_lock lock(_store_lock);
+    _next_delay = false;
+}
+
+/* called from the RDC's service function, so only the reference to the block
+ * is queued; the copy into the store is left to storeQueued()
+ */
+void DRDC_i::pushDelayed(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time, bool discontinuity)
+{
+    boost::mutex::scoped_lock lock(_queue_lock);
+    if (not _queue_open)
+        return;
+    if (_queue.size() >= QUEUE_BLOCKS) {
+        _queue_gap = true;
+        if (not _queue_dropping) {
+            // reported once per run of dropped blocks
+            _queue_dropping = true;
+            RH_WARN(this->_baseLog, "pushDelayed|the store is falling behind; dropping blocks");
+        }
+        return;
+    }
+    _queue_dropping = false;
+    queuedBlock block;
+    block.data = data;
+    block.time = time;
+    block.discontinuity = discontinuity or _queue_gap;
+    _queue_gap = false;
+    _queue.push_back(block);
+}
+
+void DRDC_i::storeQueued()
+{
+    std::deque<queuedBlock> queued;
+    {
+        boost::mutex::scoped_lock lock(_queue_lock);
+        queued.swap(_queue);
+    }
+    for (std::deque<queuedBlock>::const_iterator it=queued.begin(); it!=queued.end(); it++) {
+        if (_restart) {
+            _store.clear();
+            _epoch = it->time;
+            _reposition = true;
+            _restart = false;
+        }
+        _store.write(it->data.data(), it->data.size()/2, it->time - _epoch, it->discontinuity);
+    }
+}
+
+void DRDC_i::sourceChanged(bool tuned)
+{
+    boost::mutex::scoped_lock lock(_store_lock);
+    if (not _active)
+        return;
+
+    // samples from the previous tuning would go out under the new SRI
+    _restart = true;
+    {
+        boost::mutex::scoped_lock queue_lock(_queue_lock);
+        _queue.clear();
+        _queue_gap = false;
+    }
+    if (not tuned) {
+        RH_WARN(this->_baseLog, "sourceChanged|parent RDC lost its allocation; no data until it is allocated again");
+        return;
+    }
+
+    double center_frequency, bandwidth, sample_rate;
+    if (_source->sourceTuning(center_frequency, bandwidth, sample_rate)) {
+        if (sample_rate != _store.sampleRate()) {
+            std::string error;
+            if (not _store.open(delay_store_directory, size_t(delay_store_seconds*sample_rate), sample_rate, error)) {
+                RH_ERROR(this->_baseLog, "sourceChanged|" << error << "; no data until the DRDC is allocated again");
+                _active = false;
+                boost::mutex::scoped_lock queue_lock(_queue_lock);
+                _queue_open = false;
+                return;
+            }
+        }
+        frontend_tuner_status[0].center_frequency = center_frequency;
+        frontend_tuner_status[0].bandwidth = bandwidth;
+        frontend_tuner_status[0].sample_rate = sample_rate;
+        boost::mutex::scoped_lock stream_lock(_stream_lock);
+        _update_sri = true;
+    }
+}
+
+// called with _stream_lock held
+void DRDC_i::createStreamId(double center_frequency)
+{
+    std::ostringstream id;
+    id<<"delay_freq_"<<long(center_frequency)<<"_Hz_"<<frontend::uuidGenerator();
+    _stream_id = id.str();
+}
+
+void DRDC_i::endStream()
+{
+    boost::mutex::scoped_lock lock(_stream_lock);
+    if (_stream_id.empty())
+        return;
+    bulkio::OutShortStream stream = dataShort_out->getStream(_stream_id);
+    if (stream)
+        stream.close();
+    _stream_id.clear();
+}
+
+/*************************************************************
+Functions supporting tuning allocation
+*************************************************************/
+void DRDC_i::deviceEnable(frontend_tuner_status_struct_struct &fts, size_t tuner_id){
+    fts.enabled = true;
+    return;
+}
+void DRDC_i::deviceDisable(frontend_tuner_status_struct_struct &fts, size_t tuner_id){
+    fts.enabled = false;
+    return;
+}
+bool DRDC_i::deviceSetTuning(const frontend::frontend_tuner_allocation_struct &request, frontend_tuner_status_struct_struct &fts, size_t tuner_id){
+    /************************************************************
+    Shares the RDC's tuning (the request has to fit inside it); the store is
+    created here, so the output can reach back to the allocation at most
+    ************************************************************/
+    if (_source == NULL)
+        return false;
+
+    bool request_delay, relative;
+    double whole_seconds, partial_seconds;
+    {
+        boost::mutex::scoped_lock lock(_store_lock);
+        request_delay = _next_delay;
+        relative = _next_delay_relative;
+        whole_seconds = _next_delay_whole;
+        partial_seconds = _next_delay_partial;
+        _next_delay = false;
+    }
+
+    // the RDC is not called with _store_lock held; it holds its tuner lock while notifying us
+    double center_frequency, bandwidth, sample_rate;
+    if (not _source->sourceTuning(center_frequency, bandwidth, sample_rate)) {
+        RH_DEBUG(this->_baseLog, "deviceSetTuning|parent RDC is not allocated");
+        return false;
+    }
+    try {
+        if (not frontend::validateRequest(center_frequency-bandwidth/2, center_frequency+bandwidth/2,
+                                          request.center_frequency-request.bandwidth/2, request.center_frequency+request.bandwidth/2)) {
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- request is not within the RDC's band");
+        }
+        if ((request.sample_rate > sample_rate) or
+            ((request.sample_rate > 0) and (request.sample_rate_tolerance > 0) and (sample_rate > request.sample_rate*(1+request.sample_rate_tolerance/100.0)))) {
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- RDC rate does not match sr request");
+        }
+    } catch(FRONTEND::BadParameterException& e){
+        RH_DEBUG(this->_baseLog,"deviceSetTuning|sharing RDC at " << center_frequency << " Hz|" << e.msg);
+        return false;
+    }
+
+    double delay = delay_seconds;
+    if (request_delay) {
+        if (relative) {
+            delay = whole_seconds + partial_seconds;
+        } else {
+            delay = bulkio::time::utils::now() - bulkio::time::utils::create(whole_seconds, partial_seconds);
+        }
+    }
+    if ((delay < 0) or (delay > delay_store_seconds)) {
+        RH_INFO(this->_baseLog, "deviceSetTuning|delay of " << delay << " s is outside the store's 0 to " << delay_store_seconds << " s");
+        return false;
+    }
+
+    {
+        boost::mutex::scoped_lock lock(_store_lock);
+        std::string error;
+        if (not _store.open(delay_store_directory, size_t(delay_store_seconds*sample_rate), sample_rate, error)) {
+            RH_ERROR(this->_baseLog, "deviceSetTuning|" << error);
+            return false;
+        }
+        fts.center_frequency = center_frequency;
+        fts.bandwidth = bandwidth;
+        fts.sample_rate = sample_rate;
+        fts.bandwidth_tolerance = request.bandwidth_tolerance;
+        fts.sample_rate_tolerance = request.sample_rate_tolerance;
+
+        delay_seconds = delay;
+        delay_start_time = 0;
+        delay_actual_seconds = 0;
+        delay_held_seconds = 0;
+        _delay = delay;
+        _restart = true;
+        _reposition = true;
+        _active = true;
+    }
+    {
+        boost::mutex::scoped_lock lock(_queue_lock);
+        _queue.clear();
+        _queue_gap = false;
+        _queue_dropping = false;
+        _queue_open = true;
+    }
+    {
+        boost::mutex::scoped_lock lock(_stream_lock);
+        createStreamId(center_frequency);
+        _update_sri = true;
+    }
+    RH_DEBUG(this->_baseLog,"deviceSetTuning|sharing RDC at " << center_frequency << " Hz, " << sample_rate << " sps, "
+             << delay << " s behind, " << delay_store_seconds << " s stored in " << delay_store_directory);
+    this->start();
+    return true;
+}
+
+bool DRDC_i::deviceDeleteTuning(frontend_tuner_status_struct_struct &fts, size_t tuner_id) {
+    {
+        boost::mutex::scoped_lock lock(_queue_lock);
+        _queue_open = false;
+        _queue.clear();
+    }
+    {
+        boost::mutex::scoped_lock lock(_store_lock);
+        _active = false;
+        _store.close();
+        delay_actual_seconds = 0;
+        delay_held_seconds = 0;
+    }
+    endStream();
+    return true;
+}
+
+/*************************************************************
+Functions servicing the tuner control port
+*************************************************************/
+std::string DRDC_i::getTunerType(const std::string& allocation_id) {
+    return frontend_tuner_status[0].tuner_type;
+}
+
+bool DRDC_i::getTunerDeviceControl(const std::string& allocation_id) {
+    return true;
+}
+
+std::string DRDC_i::getTunerGroupId(const std::string& allocation_id) {
+    return frontend_tuner_status[0].group_id;
+}
+
+std::string DRDC_i::getTunerRfFlowId(const std::string& allocation_id) {
+    return frontend_tuner_status[0].rf_flow_id;
+}
+
+void DRDC_i::setTunerCenterFrequency(const std::string& allocation_id, double freq) {
+    throw FRONTEND::NotSupportedException("setTunerCenterFrequency not supported; the DRDC follows its RDC's tuning");
+}
+
+double DRDC_i::getTunerCenterFrequency(const std::string& allocation_id) {
+    return frontend_tuner_status[0].center_frequency;
+}
+
+void DRDC_i::setTunerBandwidth(const std::string& allocation_id, double bw) {
+    throw FRONTEND::NotSupportedException("setTunerBandwidth not supported");
+}
+
+double DRDC_i::getTunerBandwidth(const std::string& allocation_id) {
+    return frontend_tuner_status[0].bandwidth;
+}
+
+void DRDC_i::setTunerAgcEnable(const std::string& allocation_id, bool enable)
+{
+    throw FRONTEND::NotSupportedException("setTunerAgcEnable not supported");
+}
+
+bool DRDC_i::getTunerAgcEnable(const std::string& allocation_id)
+{
+    throw FRONTEND::NotSupportedException("getTunerAgcEnable not supported");
+}
+
+void DRDC_i::setTunerGain(const std::string& allocation_id, float gain)
+{
+    throw FRONTEND::NotSupportedException("setTunerGain not supported");
+}
+
+float DRDC_i::getTunerGain(const std::string& allocation_id)
+{
+    throw FRONTEND::NotSupportedException("getTunerGain not supported");
+}
+
+void DRDC_i::setTunerReferenceSource(const std::string& allocation_id, long source)
+{
+    throw FRONTEND::NotSupportedException("setTunerReferenceSource not supported");
+}
+
+long DRDC_i::getTunerReferenceSource(const std::string& allocation_id)
+{
+    throw FRONTEND::NotSupportedException("getTunerReferenceSource not supported");
+}
+
+void DRDC_i::setTunerEnable(const std::string& allocation_id, bool enable) {
+    this->frontend_tuner_status[0].enabled = enable;
+}
+
+bool DRDC_i::getTunerEnable(const std::string& allocation_id) {
+    return frontend_tuner_status[0].enabled;
+}
+
+void DRDC_i::setTunerOutputSampleRate(const std::string& allocation_id, double sr) {
+    throw FRONTEND::NotSupportedException("setTunerOutputSampleRate not supported");
+}
+
+double DRDC_i::getTunerOutputSampleRate(const std::string& allocation_id){
+    return frontend_tuner_status[0].sample_rate;
+}
+
+void DRDC_i::configureTuner(const std::string& id, const CF::Properties& tunerSettings){
+    // set the appropriate tuner settings
+}
+
+CF::Properties* DRDC_i::getTunerSettings(const std::string& id){
+    // return the tuner settings
+    redhawk::PropertyMap* tuner_settings = new redhawk::PropertyMap();
+    return tuner_settings;
+}
@@ -0,0 +1,125 @@
+#ifndef DRDC_I_IMPL_H
+#define DRDC_I_IMPL_H
+
+#include "DRDC_base.h"
+#include "../uhd_access.h"
+#include "delay_store.h"
+#include <deque>
+
+namespace RDC_ns {
+class RDC_i;
+};
+
+namespace DRDC_ns {
+/*
+ * Time-delayed copy of one RDC's output. The DRDC shares the RDC's tuning, so
+ * an allocation only succeeds while the RDC is allocated. The RDC's service
+ * function hands every block to pushDelayed(), which only queues a reference
+ * to it; this device's own thread appends the queued blocks to a memory-mapped
+ * store of the last delay_store_seconds (see delayStore) and replays the store
+ * as one continuous stream running delay_seconds behind, or from a past
+ * delay_start_time.
+ */
+class DRDC_i : public DRDC_base
+{
+    ENABLE_LOGGING
+    public:
+        DRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl);
+        DRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev);
+        DRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities);
+        DRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev);
+        ~DRDC_i();
+
+        void constructor();
+
+        int serviceFunction();
+
+        void setSource(RDC_ns::RDC_i* source);
+
+        // FRONTEND::delay for the allocation about to be made (see USRP_i::allocate)
+        void setDelayRequest(bool relative, double whole_seconds, double partial_seconds);
+        void clearDelayRequest();
+
+        // a block of the RDC's output, its first sample taken at time
+        void pushDelayed(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time, bool discontinuity);
+        // the RDC was retuned (tuned true) or lost its allocation (tuned false)
+        void sourceChanged(bool tuned);
+
+    protected:
+        std::string getTunerType(const std::string& allocation_id);
+        bool getTunerDeviceControl(const std::string& allocation_id);
+        std::string getTunerGroupId(const std::string& allocation_id);
+        std::string getTunerRfFlowId(const std::string& allocation_id);
+        double getTunerCenterFrequency(const std::string& allocation_id);
+        void setTunerCenterFrequency(const std::string& allocation_id, double freq);
+        double getTunerBandwidth(const std::string& allocation_id);
+        void setTunerBandwidth(const std::string& allocation_id, double bw);
+        bool getTunerAgcEnable(const std::string& allocation_id);
+        void setTunerAgcEnable(const std::string& allocation_id, bool enable);
+        float getTunerGain(const std::string& allocation_id);
+        void setTunerGain(const std::string& allocation_id, float gain);
+        long getTunerReferenceSource(const std::string& allocation_id);
+        void setTunerReferenceSource(const std::string& allocation_id, long source);
+        bool getTunerEnable(const std::string& allocation_id);
+        void setTunerEnable(const std::string& allocation_id, bool enable);
+        double getTunerOutputSampleRate(const std::string& allocation_id);
+        void setTunerOutputSampleRate(const std::string& allocation_id, double sr);
+        void configureTuner(const std::string& id, const CF::Properties& tunerSettings);
+        CF::Properties* getTunerSettings(const std::string& id);
+
+        // picks up changes to delay_seconds and delay_start_time; called with _store_lock held
+        bool updateDelay();
+        void createStreamId(double center_frequency);
+        void endStream();
+        // moves the queued blocks into the store; called with _store_lock held
+        void storeQueued();
+
+        RDC_ns::RDC_i* _source;
+        boost::mutex _store_lock;   // everything down to _stream_lock; the RDC's service function feeds it
+
+        delayStore _store;
+        bool _active;               // allocated; the store is open
+        bool _restart;              // drop the stored samples before the next block
+        BULKIO::PrecisionUTCTime _epoch; // store times are seconds since this
+        double _delay;              // delay the output is paced at; delay_seconds as last seen
+        bool _reposition;           // move the output to the sample _delay ago
+        uint64_t _read_index;       // next store index to send
+
+        bool _next_delay;           // FRONTEND::delay for the allocation in progress
+        bool _next_delay_relative;
+        double _next_delay_whole;
+        double _next_delay_partial;
+
+        std::string _stream_id;
+        bool _update_sri;
+        boost::mutex _stream_lock;  // _stream_id, _update_sri and the output stream
+
+        struct queuedBlock {
+            redhawk::shared_buffer<short> data;
+            BULKIO::PrecisionUTCTime time;
+            bool discontinuity;
+        };
+        boost::mutex _queue_lock;   // everything down to _queue_dropping; taken inside _store_lock, never around it
+        bool _queue_open;           // allocated, so blocks are queued
+        std::deque<queuedBlock> _queue;
+        bool _queue_gap;            // a block was dropped before the next one queued
+        bool _queue_dropping;
+
+        // service function output, reused once BulkIO lets go of it
+        usrpBufferPool _out_pool;
+
+    private:
+        ////////////////////////////////////////
+        // Required device specific functions // -- to be implemented by device developer
+        ////////////////////////////////////////
+
+        // these are pure virtual, must be implemented here
+        void deviceEnable(frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+        void deviceDisable(frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+        bool deviceSetTuning(const frontend::frontend_tuner_allocation_struct &request, frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+        bool deviceDeleteTuning(frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+
+};
+};
+
+#endif // DRDC_I_IMPL_H
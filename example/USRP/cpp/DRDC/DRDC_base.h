@@ -0,0 +1,66 @@
+#ifndef DRDC_BASE_IMPL_BASE_H
+#define DRDC_BASE_IMPL_BASE_H
+
+#include <boost/thread.hpp>
+#include <frontend/frontend.h>
+#include <ossie/ThreadedComponent.h>
+#include <ossie/DynamicComponent.h>
+
+#include <frontend/frontend.h>
+#include <bulkio/bulkio.h>
+#include "DRDC_struct_props.h"
+
+#define BOOL_VALUE_HERE 0
+
+namespace DRDC_ns {
+class DRDC_base : public frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>, public virtual frontend::digital_tuner_delegation, protected ThreadedComponent, public virtual DynamicComponent
+{
+    public:
+        DRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl);
+        DRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev);
+        DRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities);
+        DRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev);
+        ~DRDC_base();
+
+        void start() throw (CF::Resource::StartError, CORBA::SystemException);
+
+        void stop() throw (CF::Resource::StopError, CORBA::SystemException);
+
+        void releaseObject() throw (CF::LifeCycle::ReleaseError, CORBA::SystemException);
+
+        void loadProperties();
+        void removeAllocationIdRouting(const size_t tuner_id);
+
+        virtual CF::Properties* getTunerStatus(const std::string& allocation_id);
+        virtual void assignListener(const std::string& listen_alloc_id, const std::string& allocation_id);
+        virtual void removeListener(const std::string& listen_alloc_id);
+        void frontendTunerStatusChanged(const std::vector<frontend_tuner_status_struct_struct>* oldValue, const std::vector<frontend_tuner_status_struct_struct>* newValue);
+
+    protected:
+        // Member variables exposed as properties
+        /// Property: delay_store_directory
+        std::string delay_store_directory;
+        /// Property: delay_store_seconds
+        double delay_store_seconds;
+        /// Property: delay_seconds
+        double delay_seconds;
+        /// Property: delay_start_time
+        double delay_start_time;
+        /// Property: delay_actual_seconds
+        double delay_actual_seconds;
+        /// Property: delay_held_seconds
+        double delay_held_seconds;
+
+        // Ports
+        /// Port: DigitalTuner_in
+        frontend::InDigitalTunerPort *DigitalTuner_in;
+        /// Port: dataShort_out
+        bulkio::OutShortPort *dataShort_out;
+
+        std::map<std::string, std::string> listeners;
+
+    private:
+        void construct();
+};
+};
+#endif // DRDC_BASE_IMPL_BASE_H
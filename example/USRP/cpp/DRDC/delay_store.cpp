@@ -0,0 +1,203 @@
+#include "delay_store.h"
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+using namespace DRDC_ns;
+
+delayStore::delayStore() :
+    _fd(-1),
+    _samples(NULL),
+    _bytes(0),
+    _capacity(0),
+    _rate(0),
+    _end(0)
+{
+}
+
+delayStore::~delayStore()
+{
+    close();
+}
+
+bool delayStore::open(const std::string& directory, size_t capacity, double sample_rate, std::string& error)
+{
+    close();
+    if ((capacity == 0) or (sample_rate <= 0)) {
+        error = "the store would hold no samples";
+        return false;
+    }
+
+    std::string path = directory + "/drdc_XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    const int fd = mkstemp(&name[0]);
+    if (fd < 0) {
+        error = "unable to create a file in " + directory + ": " + strerror(errno);
+        return false;
+    }
+    // nothing else needs the name, and the file must not outlive us
+    unlink(&name[0]);
+
+    const size_t bytes = capacity * 2 * sizeof(short);
+    const int status = posix_fallocate(fd, 0, bytes);
+    if (status != 0) {
+        std::ostringstream msg;
+        msg << "unable to reserve " << bytes << " bytes in " << directory << ": " << strerror(status);
+        error = msg.str();
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(NULL, bytes, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        error = std::string("unable to map the store: ") + strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    _fd = fd;
+    _samples = static_cast<short*>(map);
+    _bytes = bytes;
+    _capacity = capacity;
+    _rate = sample_rate;
+    clear();
+    return true;
+}
+
+void delayStore::close()
+{
+    if (_samples != NULL) {
+        munmap(_samples, _bytes);
+        ::close(_fd);
+    }
+    _fd = -1;
+    _samples = NULL;
+    _bytes = 0;
+    _capacity = 0;
+    _rate = 0;
+    clear();
+}
+
+void delayStore::clear()
+{
+    _end = 0;
+    _segments.clear();
+}
+
+void delayStore::write(const short* data, size_t num_samps, double time, bool discontinuity)
+{
+    if ((num_samps == 0) or (_samples == NULL))
+        return;
+
+    const bool contiguous = (not discontinuity) and (not _segments.empty()) and
+                            (std::fabs(time - timeOf(_end)) <= 0.5/_rate);
+    if (not contiguous) {
+        if ((not _segments.empty()) and (_segments.back().index == _end)) {
+            _segments.back().time = time;
+        } else {
+            segment next = {_end, time};
+            _segments.push_back(next);
+        }
+    }
+
+    // only the newest capacity samples survive the write
+    if (num_samps > _capacity) {
+        data += 2*(num_samps-_capacity);
+        _end += num_samps-_capacity;
+        num_samps = _capacity;
+    }
+    while (num_samps > 0) {
+        const size_t pos = _end % _capacity;
+        const size_t chunk = std::min(num_samps, _capacity-pos);
+        memcpy(&_samples[2*pos], data, 2*chunk*sizeof(short));
+        data += 2*chunk;
+        _end += chunk;
+        num_samps -= chunk;
+    }
+
+    while ((_segments.size() > 1) and (_segments[1].index <= begin())) {
+        _segments.pop_front();
+    }
+}
+
+void delayStore::read(uint64_t from, size_t count, short* out) const
+{
+    while (count > 0) {
+        const size_t pos = from % _capacity;
+        const size_t chunk = std::min(count, _capacity-pos);
+        memcpy(out, &_samples[2*pos], 2*chunk*sizeof(short));
+        out += 2*chunk;
+        from += chunk;
+        count -= chunk;
+    }
+}
+
+std::deque<delayStore::segment>::const_iterator delayStore::segmentOf(uint64_t index) const
+{
+    std::deque<segment>::const_iterator it = _segments.begin();
+    size_t count = _segments.size();
+    // segments are in index order; find the first starting after index
+    while (count > 0) {
+        const size_t step = count/2;
+        std::deque<segment>::const_iterator mid = it + step;
+        if (mid->index <= index) {
+            it = mid + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return (it == _segments.begin()) ? it : it-1;
+}
+
+uint64_t delayStore::indexOf(double time) const
+{
+    if (_segments.empty())
+        return _end;
+
+    // segments are in time order too; find the first starting after time
+    std::deque<segment>::const_iterator it = _segments.begin();
+    size_t count = _segments.size();
+    while (count > 0) {
+        const size_t step = count/2;
+        std::deque<segment>::const_iterator mid = it + step;
+        if (mid->time <= time) {
+            it = mid + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    if (it == _segments.begin())
+        return begin();
+
+    const uint64_t limit = (it == _segments.end()) ? _end : it->index;
+    const segment& held = *(it-1);
+    const int64_t offset = std::max(int64_t(0), int64_t(llround((time - held.time)*_rate)));
+    return std::max(begin(), std::min(held.index + uint64_t(offset), limit));
+}
+
+double delayStore::timeOf(uint64_t index) const
+{
+    if (_segments.empty())
+        return 0;
+    const segment& held = *segmentOf(index);
+    return held.time + (double(index) - double(held.index))/_rate;
+}
+
+uint64_t delayStore::segmentEnd(uint64_t index) const
+{
+    if (_segments.empty())
+        return _end;
+    std::deque<segment>::const_iterator it = segmentOf(index);
+    if (it->index > index)
+        return it->index;
+    return (++it == _segments.end()) ? _end : it->index;
+}
@@ -0,0 +1,101 @@
+#ifndef DELAY_STORE_H
+#define DELAY_STORE_H
+
+#include <deque>
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace DRDC_ns {
+
+/*
+ * Circular store of the most recent interleaved sc16 samples, held in a
+ * memory-mapped file rather than the heap, so minutes of a wideband feed only
+ * cost disk space and whatever the page cache keeps resident.
+ *  - the file is created in the given directory and unlinked straight away, so
+ *    it goes away with the process; its blocks are reserved up front so a full
+ *    disk fails open() rather than faulting a write into the mapping
+ *  - samples are addressed by an absolute index that counts every sample
+ *    written since the last clear(); index i lives at offsetOf(i) in the file
+ *  - times are seconds relative to an epoch chosen by the caller. Each run of
+ *    contiguous samples (a segment) records the time of its first sample, so
+ *    time to index lookups stay exact across overflows and dropped buffers
+ *  - single writer; the caller serializes reads against writes
+ */
+class delayStore {
+    public:
+        delayStore();
+        ~delayStore();
+
+        // capacity in complex samples; drops whatever was held
+        bool open(const std::string& directory, size_t capacity, double sample_rate, std::string& error);
+        void close();
+        bool isOpen() const {
+            return _samples != NULL;
+        }
+        // forgets the held samples and restarts the index at 0
+        void clear();
+
+        size_t capacity() const {
+            return _capacity;
+        }
+        double sampleRate() const {
+            return _rate;
+        }
+        // index one past the newest sample
+        uint64_t end() const {
+            return _end;
+        }
+        // index of the oldest sample still held
+        uint64_t begin() const {
+            return (_end > _capacity) ? _end-_capacity : 0;
+        }
+        // byte offset of sample index in the backing file
+        off_t offsetOf(uint64_t index) const {
+            return off_t(index % _capacity) * 2 * sizeof(short);
+        }
+
+        /* appends num_samps complex samples (2*num_samps shorts), the first taken
+         * at time. A new segment starts if discontinuity is set or time does not
+         * follow on from the previous sample
+         */
+        void write(const short* data, size_t num_samps, double time, bool discontinuity);
+
+        /* copies count complex samples starting at index from into out;
+         * [from, from+count) must lie within [begin(), end())
+         */
+        void read(uint64_t from, size_t count, short* out) const;
+
+        /* index of the sample taken nearest time, clamped to [begin(), end()];
+         * a time that falls in a gap between segments maps to the first sample after it
+         */
+        uint64_t indexOf(double time) const;
+        // time sample index was taken at
+        double timeOf(uint64_t index) const;
+        // one past the last sample contiguous with index (end() if none follow a gap)
+        uint64_t segmentEnd(uint64_t index) const;
+
+    private:
+        delayStore(const delayStore&);
+        delayStore& operator=(const delayStore&);
+
+        struct segment {
+            uint64_t index; // first sample of the segment
+            double time;    // time of that sample
+        };
+        // last segment starting at or before index
+        std::deque<segment>::const_iterator segmentOf(uint64_t index) const;
+
+        int _fd;
+        short* _samples;
+        size_t _bytes;
+        size_t _capacity;
+        double _rate;
+        uint64_t _end;
+        std::deque<segment> _segments; // oldest first; the first may start before begin()
+};
+
+};
+
+#endif // DELAY_STORE_H
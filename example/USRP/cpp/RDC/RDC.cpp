@@ -8,11 +8,36 @@
 **************************************************************************/
 
 #include "RDC.h"
+#include "../sample_convert.h"
+#include "../DDC/DDC.h"
+#include "../SRDC/SRDC.h"
+#include "../DRDC/DRDC.h"
 
 using namespace RDC_ns;
 
 PREPARE_LOGGING(RDC_i)
 
+namespace {
+    // the shortest scan dwell the capture thread keeps up with
+    const double SCAN_MIN_DWELL = 0.001;
+
+    frontend::ScanStrategy* copyStrategy(const frontend::ScanStrategy& strategy)
+    {
+        frontend::ScanStrategy* copy;
+        if (const frontend::SpanStrategy* span = dynamic_cast<const frontend::SpanStrategy*>(&strategy)) {
+            copy = new frontend::SpanStrategy(span->freq_scan_list);
+        } else if (const frontend::DiscreteStrategy* discrete = dynamic_cast<const frontend::DiscreteStrategy*>(&strategy)) {
+            copy = new frontend::DiscreteStrategy(discrete->discrete_freq_list);
+        } else {
+            const frontend::ManualStrategy* manual = dynamic_cast<const frontend::ManualStrategy*>(&strategy);
+            copy = new frontend::ManualStrategy(manual ? manual->center_frequency : 0);
+        }
+        copy->control_mode = strategy.control_mode;
+        copy->control_value = strategy.control_value;
+        return copy;
+    }
+}
+
 RDC_i::RDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl) :
     RDC_base(devMgr_ior, id, lbl, sftwrPrfl)
 {
@@ -35,6 +60,11 @@ RDC_i::RDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Propert
 
 RDC_i::~RDC_i()
 {
+    stopCapture();
+    retireRecorder();
+    joinRecorderClosers();
+    stopSpectrum();
+    _status.stop();
 }
 
 void RDC_i::constructor()
@@ -64,6 +94,745 @@ void RDC_i::constructor()
         usrp_tuner.lock.cond = new boost::condition_variable;
     if (usrp_tuner.lock.mutex == NULL)
         usrp_tuner.lock.mutex = new boost::mutex;
+
+    _capture_thread = NULL;
+    _capture_running = false;
+    _allocation_enabled = false;
+    _burst_configured = false;
+    _record_wanted = record_enable;
+    _record_failed = false;
+    _record_dropping = false;
+    _record_gap = false;
+    _spectrum_thread = NULL;
+    _spectrum_wanted = false;
+    _spectrum_running = false;
+    _spectrum_pending = false;
+    _spectrum_center_frequency = 0;
+    _spectrum_sample_rate = 0;
+    _rx_grouped = false;
+    _expecting = false;
+    _retune_landed = false;
+    _gain_landed = false;
+    _landed_rate_changed = false;
+    _rx_next_valid = false;
+    _rx_next_index = 0;
+    _lo_frequency = 0;
+    _rx_analog_bandwidth = 0;
+    _needed_bandwidth = 0;
+    _lo_settling = false;
+    _start_pending = false;
+    _scan_request_set = false;
+    _scan_allocated = false;
+    _scan_dwell = 0;
+    _scan_armed = false;
+    _scan_scheduled = false;
+    _scan_hops = 0;
+    // the service function only drains rx_ring, so keep its idle wait short
+    this->setThreadDelay(0.001);
+
+    addPropertyListener(device_mode, this, &RDC_i::deviceModeChanged);
+
+    _fanout_enabled = false;
+    _fanout_sync = true;
+    configureListeners();
+    dataShort_out->addConnectListener(this, &RDC_i::listenerConnected);
+    dataShort_out->addDisconnectListener(this, &RDC_i::listenerDisconnected);
+    addPropertyListener(listener_policy, this, &RDC_i::listenerPolicyChanged);
+    addPropertyListener(listener_queue_depth, this, &RDC_i::listenerSizeChanged);
+    addPropertyListener(listener_decimation, this, &RDC_i::listenerSizeChanged);
+    addPropertyListener(listener_policies, this, &RDC_i::listenerPoliciesChanged);
+    setPropertyQueryImpl(listener_status, this, &RDC_i::getListenerStatus);
+    addPropertyListener(latency_reset, this, &RDC_i::latencyResetChanged);
+    setPropertyQueryImpl(latency_stats, this, &RDC_i::getLatencyStats);
+    setPropertyQueryImpl(retune_history, this, &RDC_i::getRetuneHistory);
+    addPropertyListener(record_enable, this, &RDC_i::recordEnableChanged);
+    setPropertyQueryImpl(record_file, this, &RDC_i::getRecordFile);
+    setPropertyQueryImpl(record_io_mode, this, &RDC_i::getRecordIoMode);
+    setPropertyQueryImpl(record_backlog, this, &RDC_i::getRecordBacklog);
+    setPropertyQueryImpl(record_dropped_blocks, this, &RDC_i::getRecordDroppedBlocks);
+    setPropertyQueryImpl(record_bytes_written, this, &RDC_i::getRecordBytesWritten);
+    addPropertyListener(status_max_rate, this, &RDC_i::statusMaxRateChanged);
+    _status.setMaxRate(status_max_rate);
+    _status.start(boost::bind(&RDC_i::sendStatus, this, _1, _2),
+                  boost::bind(&RDC_i::statusConnections, this));
+
+    _command_lock.reset(new boost::mutex);
+    _agc_running = false;
+    _agc_pending = false;
+    _tuned = false;
+    _srdc = NULL;
+    _drdc = NULL;
+    _snapshot_reserved = false;
+    _channelizer_restart = true;
+    _egress_gap = false;
+    _egress_drops = 0;
+    _capture_overrun = false;
+    _overrun_drops = 0;
+    _resampling = false;
+}
+
+void RDC_i::start() throw (CORBA::SystemException, CF::Resource::StartError)
+{
+    // capture thread must be up (and rx_ring sized) before the service thread starts draining it
+    startCapture();
+    startSpectrum();
+    RDC_base::start();
+}
+
+void RDC_i::stop() throw (CORBA::SystemException, CF::Resource::StopError)
+{
+    stopCapture();
+    // a blocking listener may be holding up the service function, so let it go first;
+    // the service function may start the listeners again before it exits, so
+    // the listeners only see the end of the stream once it is gone
+    _fanout.stop(false);
+    RDC_base::stop();
+    _fanout.stop(true);
+    _fanout_sync = true;
+    stopSpectrum();
+    // the capture thread is gone, so nothing feeds the recording any more
+    retireRecorder();
+    joinRecorderClosers();
+    // end the burst the service function was in the middle of
+    if (_burst_stream) {
+        _burst_stream.close();
+        _burst_stream = bulkio::OutShortStream();
+    }
+    _burst_configured = false;
+}
+
+CF::Device::Allocations* RDC_i::allocate (const CF::Properties& capacities)
+throw (CF::Device::InvalidState, CF::Device::InvalidCapacity, CF::Device::InsufficientCapacity, CORBA::SystemException)
+{
+    CF::Device::Allocations_var result = RDC_base::allocate(capacities);
+    snapshotAllocations();
+    return result._retn();
+}
+
+void RDC_i::deallocate (const char* alloc_id)
+throw (CF::Device::InvalidState, CF::Device::InvalidCapacity, CORBA::SystemException)
+{
+    RDC_base::deallocate(alloc_id);
+    snapshotAllocations();
+}
+
+/* copies the allocation ids and enabled flag out of frontend_tuner_status;
+ * called from the threads that change them
+ */
+void RDC_i::snapshotAllocations()
+{
+    std::vector<std::string> ids;
+    const std::string& csv = frontend_tuner_status[0].allocation_id_csv;
+    for (size_t begin=0; begin<csv.size(); ) {
+        size_t end = csv.find(',', begin);
+        if (end == std::string::npos)
+            end = csv.size();
+        if (end > begin)
+            ids.push_back(csv.substr(begin, end-begin));
+        begin = end+1;
+    }
+    boost::mutex::scoped_lock lock(_allocation_lock);
+    _allocation_ids.swap(ids);
+    _allocation_enabled = frontend_tuner_status[0].enabled;
+}
+
+std::string RDC_i::controllingAllocation()
+{
+    boost::mutex::scoped_lock lock(_allocation_lock);
+    return _allocation_ids.empty() ? std::string() : _allocation_ids.front();
+}
+
+bool RDC_i::captureEnabled()
+{
+    boost::mutex::scoped_lock lock(_allocation_lock);
+    return _allocation_enabled and not _allocation_ids.empty();
+}
+
+bool RDC_i::hasAllocation(const std::string& allocation_id)
+{
+    boost::mutex::scoped_lock lock(_allocation_lock);
+    return std::find(_allocation_ids.begin(), _allocation_ids.end(), allocation_id) != _allocation_ids.end();
+}
+
+// the controlling allocation comes first in allocation_id_csv; the rest are listeners
+bool RDC_i::isController(const std::string& allocation_id)
+{
+    boost::mutex::scoped_lock lock(_allocation_lock);
+    return (not allocation_id.empty()) and (not _allocation_ids.empty()) and (_allocation_ids.front() == allocation_id);
+}
+
+void RDC_i::startCapture()
+{
+    if (_capture_thread != NULL)
+        return;
+    rx_ring.resize(rx_ring_depth);
+    _capture_running = true;
+    _capture_thread = new boost::thread(&RDC_i::captureThread, this);
+    RH_DEBUG(this->_baseLog, "startCapture|tuner_number=" << _tuner_number << " rx_ring_depth=" << rx_ring.depth());
+}
+
+void RDC_i::stopCapture()
+{
+    if (_capture_thread == NULL)
+        return;
+    _capture_running = false;
+    _capture_thread->join(); // bounded by the recv() timeout
+    delete _capture_thread;
+    _capture_thread = NULL;
+    {
+        // pending changes land wherever streaming picks up again
+        scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+        _rx_next_valid = false;
+        applyTuneCommands(false);
+        takeExpectedChanges();
+        for (; not _changes.empty(); _changes.pop_front())
+            landChange(_changes.front());
+    }
+    RH_DEBUG(this->_baseLog, "stopCapture|tuner_number=" << _tuner_number);
+}
+
+void RDC_i::captureThread()
+{
+    while (_capture_running) {
+        // a coherent RX group receives on our behalf (see usrpRxGroup)
+        if ((usrp_device_ptr.get() == NULL) or (not captureEnabled()) or _rx_grouped) {
+            if (not _tune_queue.empty()) {
+                scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+                applyTuneCommands(false);
+            }
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+            continue;
+        }
+        if (_start_pending and not startPendingStream()) {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+            continue;
+        }
+        captureBuffer();
+    }
+}
+
+/* receives into usrp_tuner.output_buffer and, once it is full (or cut short by
+ * an overflow), hands it to the service function through rx_ring.
+ * Only the capture thread calls this function.
+ */
+bool RDC_i::captureBuffer()
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    takeExpectedChanges();
+    applyTuneCommands(true);
+    if (_scan_armed)
+        scheduleScanHops();
+    if (_lo_settling)
+        checkLoSettled();
+    return completeCapture(usrpReceive(captureTimeout()));
+}
+
+/* bookkeeping after num_samps (< 0 on overflow) were received into usrp_tuner.output_buffer:
+ * auto-gain, AGC and handing the buffer to rx_ring when it is due
+ * acquire tuner_lock prior to calling this function
+ */
+bool RDC_i::completeCapture(long num_samps)
+{
+    if ((num_samps > 0) and (usrp_tuner.buffer_size == size_t(2*num_samps))) {
+        // back-date by the samples just received to get to the oldest one
+        _oldest_sample_wall = boost::posix_time::microsec_clock::universal_time()
+            - boost::posix_time::microseconds(long(1e6*num_samps/rx_hardware_sample_rate));
+    }
+
+    /* if auto-gain enabled, push data to gain method */
+    if (trigger_rx_autogain) {
+        latencyScope auto_gain_scope(_latency[LATENCY_AUTO_GAIN]);
+        float newGain = auto_gain(); // auto_gain will set trigger to false if appropriate
+        if(newGain != device_gain)
+            updateDeviceRxGain(newGain, false);
+    }
+
+    // a timed change lands on the next sample: the buffer ends here
+    const bool change_due = changeDue();
+    if (change_due and (usrp_tuner.buffer_size == 0))
+        landDueChanges();
+
+    // if the buffer is full OR (overflow occurred and buffer isn't empty) OR its oldest sample is past
+    // the latency deadline OR a timed change lands next, hand off buffer as is and move to next buffer
+    if(usrp_tuner.buffer_size >= usrp_tuner.buffer_capacity || (num_samps < 0 && usrp_tuner.buffer_size > 0) ||
+       (usrp_tuner.buffer_size > 0 && captureTimeout() <= 0) || (usrp_tuner.buffer_size > 0 && change_due) ){
+        const uint64_t capture_start = latencyHistogram::now();
+        _capture_block.data = usrp_tuner.output_buffer;
+        _capture_block.size = usrp_tuner.buffer_size;
+        _capture_block.time = usrp_tuner.output_buffer_time;
+        _capture_block.overflow = (num_samps < 0);
+        sc16_stats(&usrp_tuner.output_buffer[0], usrp_tuner.buffer_size, fullScale(), _capture_block.stats);
+        if (rx_agc_enable and not trigger_rx_autogain) {
+            runAgc(_capture_block);
+        } else {
+            _agc_running = false;
+        }
+        if (_gain_landed) {
+            _capture_block.agc_gain_changed = true;
+            _capture_block.agc_gain = device_gain;
+            _capture_block.agc_gain_offset = 0;
+        }
+        _capture_block.retuned = _retune_landed;
+        _capture_block.center_frequency = _landed.center_frequency;
+        _capture_block.sample_rate = _landed.sample_rate;
+        _capture_block.rate_changed = _landed_rate_changed;
+        // the recording gets every captured buffer, whether or not egress keeps up
+        const bool recorded = recordBlock(_capture_block);
+        _capture_block.queued_ns = latencyHistogram::now();
+        _latency[LATENCY_CAPTURE].record(_capture_block.queued_ns - capture_start);
+        if (rx_ring.push(_capture_block)) {
+            // rx_ring owns that memory now; keep receiving into a pooled buffer.
+            // It goes back to the pool once BulkIO drops its last reference.
+            usrp_tuner.nextOutputBuffer();
+            _retune_landed = false;
+            _landed_rate_changed = false;
+            _gain_landed = false;
+            if (_capture_overrun) {
+                _capture_overrun = false;
+                RH_WARN(this->_baseLog, "captureBuffer|rx ring drained after dropping " << rx_ring.dropped() - _overrun_drops << " buffers");
+            }
+        } else {
+            // once per overrun; rx_ring_drops has the count
+            if (not _capture_overrun) {
+                _capture_overrun = true;
+                _overrun_drops = rx_ring.dropped() - 1;
+                RH_WARN(this->_baseLog, "captureBuffer|rx ring full, dropping buffers until the service function catches up");
+            }
+            if (recorded) {
+                // the recorder still has to write it out
+                usrp_tuner.nextOutputBuffer();
+            } else {
+                usrp_tuner.buffer_size = 0;
+            }
+        }
+        if (change_due)
+            landDueChanges();
+        // drop whatever reference came back out of the ring
+        _capture_block.data = redhawk::buffer<short>();
+        _capture_block.reset();
+        return true;
+    }
+    return (num_samps != 0);
+}
+
+/* seconds the capture thread may spend receiving into the current buffer
+ * before it has to be pushed; <= 0 once the max_latency_ms deadline is reached
+ */
+double RDC_i::captureTimeout()
+{
+    if (max_latency_ms == 0)
+        return 1.0;
+    const double deadline = max_latency_ms / 1000.0;
+    if (usrp_tuner.buffer_size == 0)
+        return deadline;
+    const boost::posix_time::time_duration age = boost::posix_time::microsec_clock::universal_time() - _oldest_sample_wall;
+    return deadline - age.total_microseconds()/1e6;
+}
+
+/* hands a tuner command to the capture thread, or applies it right away when
+ * nothing is capturing; false if too many are already waiting
+ */
+bool RDC_i::queueTuneCommand(usrpTuneCommand::kind_t kind, double value)
+{
+    usrpTuneCommand command;
+    command.kind = kind;
+    command.value = value;
+    if (not _tune_queue.push(command))
+        return false;
+    if (_capture_thread == NULL) {
+        scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+        applyTuneCommands(false);
+    }
+    return true;
+}
+
+/* when a timed command issued now lands: half a buffer (at least
+ * RETUNE_MIN_LEAD) past the next sample recv() returns.
+ * acquire tuner_lock prior to calling this function
+ */
+uhd::time_spec_t RDC_i::nextChangeTime() const
+{
+    // the command has to reach the radio before the samples it applies to are taken
+    static const double RETUNE_MIN_LEAD = 0.002;
+    return _rx_next_time + uhd::time_spec_t(std::max(usrp_tuner.buffer_capacity/2 / rx_hardware_sample_rate, RETUNE_MIN_LEAD));
+}
+
+/* issues the queued tuner commands. Timed, they land together at
+ * nextChangeTime(); untimed, they start the next buffer.
+ * acquire tuner_lock prior to calling this function
+ */
+void RDC_i::applyTuneCommands(bool timed)
+{
+    usrpTuneCommand command;
+    if (not _tune_queue.pop(command))
+        return;
+    if (usrp_device_ptr.get() == NULL) {
+        while (_tune_queue.pop(command));
+        return;
+    }
+
+    timed = timed and _rx_next_valid and (rx_hardware_sample_rate > 0);
+    uhd::time_spec_t when;
+    if (timed) {
+        when = nextChangeTime();
+    }
+    bool retuned = false;
+    {
+        boost::mutex::scoped_lock cmd_lock(*_command_lock);
+        if (timed)
+            usrp_device_ptr->set_command_time(when);
+        do {
+            switch (command.kind) {
+                case usrpTuneCommand::FREQUENCY: {
+                    bool cached = false;
+                    const uhd::tune_request_t request = planTune(command.value, std::min(_rx_analog_bandwidth, rx_hardware_sample_rate), _needed_bandwidth, cached);
+                    const uhd::tune_result_t result = usrp_device_ptr->set_rx_freq(request, _tuner_number);
+                    noteRetune(command.value, result, cached, timed ? when : usrp_device_ptr->get_time_now());
+                    retuned = true;
+                    break;
+                }
+                case usrpTuneCommand::GAIN:
+                    usrp_device_ptr->set_rx_gain(command.value, _tuner_number);
+                    break;
+            }
+        } while (_tune_queue.pop(command));
+        if (timed)
+            usrp_device_ptr->clear_command_time();
+    }
+    usrpTimedChange change;
+    change.when = when;
+    change.center_frequency = usrp_device_ptr->get_rx_freq(_tuner_number);
+    change.gain = usrp_device_ptr->get_rx_gain(_tuner_number);
+
+    // device_gain, like the tuning, follows once the change lands
+    if (timed) {
+        addChange(change);
+        if (usrp_device_ptr->get_time_now() > when)
+            RH_WARN(this->_baseLog, "applyTuneCommands|change to " << change.center_frequency << " Hz, gain " << change.gain << " was late; samples tagged at " << when.get_real_secs() << " may be off");
+    } else {
+        landChange(change);
+    }
+    RH_DEBUG(this->_baseLog, "applyTuneCommands|tuner_number=" << _tuner_number << (retuned ? " retuned to " : " at ") << change.center_frequency
+             << " Hz, gain " << change.gain << (timed ? " (timed)" : ""));
+}
+
+/* how to tune to frequency: leave the LO where it is if frequency, and
+ * needed_bandwidth around it, still fit in the passband, so only the DSP moves;
+ * else go back to an LO that served frequency (or one near enough) before;
+ * else let UHD pick. acquire tuner_lock prior to calling this function
+ */
+uhd::tune_request_t RDC_i::planTune(double frequency, double passband, double needed_bandwidth, bool& cached)
+{
+    uhd::tune_request_t request(frequency);
+    cached = false;
+    if (not fast_retune)
+        return request;
+
+    const double reach = (passband - needed_bandwidth) / 2;
+    if (reach < 0)
+        return request;
+    usrpTuneCache::entry found;
+    if ((_lo_frequency > 0) and (std::abs(frequency - _lo_frequency) <= reach)) {
+        request.rf_freq_policy = uhd::tune_request_t::POLICY_NONE;
+    } else if (_tune_cache.find(frequency, reach, found)) {
+        request.rf_freq_policy = uhd::tune_request_t::POLICY_MANUAL;
+        request.rf_freq = found.lo_frequency;
+        cached = true;
+    }
+    return request;
+}
+
+/* keeps track of where the LO is after a retune that took effect at when;
+ * acquire tuner_lock prior to calling this function
+ */
+void RDC_i::noteRetune(double frequency, const uhd::tune_result_t& result, bool cached, const uhd::time_spec_t& when)
+{
+    retune_record_struct record;
+    record.center_frequency = frequency;
+    record.lo_frequency = result.actual_rf_freq;
+    record.dsp_frequency = result.actual_dsp_freq;
+    record.lo_moved = (_lo_frequency <= 0) or (frontend::floatingPointCompare(result.actual_rf_freq, _lo_frequency) != 0);
+    record.from_cache = cached;
+    record.settle_time = 0;
+    _lo_frequency = result.actual_rf_freq;
+    _tune_cache.store(frequency, result.actual_rf_freq);
+
+    // moved again before it locked
+    if (_lo_settling)
+        loSettled(-1);
+    if (record.lo_moved) {
+        _settling = record;
+        _lo_settling = true;
+        _lo_moved_at = when;
+        _lock_backoff.start(when, _tune_cache.settleTime(record.lo_frequency), _tune_cache.slowestSettleTime());
+    } else {
+        addRetuneRecord(record);
+    }
+    RH_DEBUG(this->_baseLog, "noteRetune|tuner_number=" << _tuner_number << " " << frequency << " Hz: LO " << result.actual_rf_freq
+             << " Hz" << (record.lo_moved ? " (moved)" : "") << (cached ? " (cached)" : "") << ", DSP " << result.actual_dsp_freq << " Hz");
+}
+
+/* records the LO move's settling time once the LO reports lock; the capture
+ * thread checks once a buffer, from when the move took effect.
+ * acquire tuner_lock prior to calling this function
+ */
+void RDC_i::checkLoSettled()
+{
+    if ((not _rx_next_valid) or (_rx_next_time < _lo_moved_at))
+        return;
+    try {
+        if (usrp_device_ptr->get_rx_sensor("lo_locked", _tuner_number).to_bool())
+            loSettled((_rx_next_time - _lo_moved_at).get_real_secs());
+    } catch (...) {
+        // no lock sensor to go by
+        loSettled(-1);
+    }
+}
+
+/* polls lo_locked when _lock_backoff says to; true once the LO has locked or
+ * the wait has run out. acquire tuner_lock prior to calling this function
+ */
+bool RDC_i::pollLoLock()
+{
+    if (not _lo_settling)
+        return true;
+    const uhd::time_spec_t now = usrp_device_ptr->get_time_now();
+    if (not _lock_backoff.due(now))
+        return false;
+    bool locked = false;
+    bool sensor = true;
+    try {
+        locked = usrp_device_ptr->get_rx_sensor("lo_locked", _tuner_number).to_bool();
+    } catch (...) {
+        // no lock sensor to go by, so give it the whole wait
+        sensor = false;
+    }
+    if (locked) {
+        loSettled((now - _lo_moved_at).get_real_secs());
+        return true;
+    }
+    if (_lock_backoff.expired(now)) {
+        if (sensor) {
+            RH_WARN(this->_baseLog, "pollLoLock|tuner_number=" << _tuner_number << " LO at " << _settling.lo_frequency << " Hz has not locked after "
+                    << (now - _lo_moved_at).get_real_secs() << " s; streaming anyway");
+        } else {
+            loSettled(-1);
+        }
+        return true;
+    }
+    _lock_backoff.polled(now);
+    return false;
+}
+
+/* starts the stream usrpEnable() left waiting for the LO; false while it still
+ * waits. Only the capture thread calls this function.
+ */
+bool RDC_i::startPendingStream()
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    if (not _start_pending)
+        return true;
+    try {
+        if (not pollLoLock())
+            return false;
+        uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+        stream_cmd.stream_now = true;
+        usrp_device_ptr->issue_stream_cmd(stream_cmd, _tuner_number);
+        RH_DEBUG(this->_baseLog, "startPendingStream|tuner_number=" << _tuner_number << " started stream_id=" << _stream_id);
+    } catch (const std::exception& e) {
+        RH_ERROR(this->_baseLog, "startPendingStream|tuner_number=" << _tuner_number << " unable to start streaming: " << e.what());
+    }
+    _start_pending = false;
+    return true;
+}
+
+/* returns once the LO has locked (or the wait has run out); LOs settle in
+ * parallel, so waiting on several in turn takes as long as the slowest
+ */
+void RDC_i::waitLoLocked()
+{
+    while (true) {
+        {
+            scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+            if ((usrp_device_ptr.get() == NULL) or pollLoLock())
+                return;
+        }
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    }
+}
+
+/* acquire tuner_lock prior to calling this function */
+void RDC_i::loSettled(double settle_time)
+{
+    _lo_settling = false;
+    _settling.settle_time = settle_time;
+    if (settle_time >= 0) {
+        _tune_cache.settled(_settling.lo_frequency, settle_time);
+        RH_DEBUG(this->_baseLog, "loSettled|tuner_number=" << _tuner_number << " LO at " << _settling.lo_frequency << " Hz locked in " << settle_time << " s");
+    }
+    addRetuneRecord(_settling);
+}
+
+void RDC_i::addRetuneRecord(const retune_record_struct& record)
+{
+    static const size_t RETUNE_HISTORY_DEPTH = 32;
+    boost::mutex::scoped_lock lock(_retune_history_lock);
+    _retune_history.push_back(record);
+    if (_retune_history.size() > RETUNE_HISTORY_DEPTH)
+        _retune_history.pop_front();
+}
+
+std::vector<retune_record_struct> RDC_i::getRetuneHistory()
+{
+    boost::mutex::scoped_lock lock(_retune_history_lock);
+    return std::vector<retune_record_struct>(_retune_history.begin(), _retune_history.end());
+}
+
+/* a timed change USRP_i has issued for this channel; may be called from any thread */
+void RDC_i::expectChange(const usrpTimedChange& change)
+{
+    boost::mutex::scoped_lock lock(_expected_lock);
+    _expected.push_back(change);
+    _expecting = true;
+}
+
+/* checks a timed_commands entry for this channel the way the tuner setters
+ * check their values; 0 is "unchanged" for center_frequency and sample_rate
+ */
+bool RDC_i::validateTimedCommand(double center_frequency, double sample_rate, bool set_gain, double gain, std::string& error)
+{
+    if ((center_frequency < 0) or ((center_frequency > 0) and
+            !frontend::validateRequest(device_characteristics.freq_min, device_characteristics.freq_max, center_frequency))) {
+        error = "center frequency is outside of the device's range";
+        return false;
+    }
+    if ((sample_rate < 0) or ((sample_rate > 0) and
+            !frontend::validateRequest(device_characteristics.rate_min, device_characteristics.rate_max, sample_rate))) {
+        error = "sample rate is outside of the device's range";
+        return false;
+    }
+    if (set_gain and !frontend::validateRequest(device_characteristics.gain_min, device_characteristics.gain_max, gain)) {
+        error = "gain is outside of the device's range";
+        return false;
+    }
+    return true;
+}
+
+/* acquire tuner_lock prior to calling this function */
+void RDC_i::takeExpectedChanges()
+{
+    if (not _expecting)
+        return;
+    std::vector<usrpTimedChange> expected;
+    {
+        boost::mutex::scoped_lock lock(_expected_lock);
+        expected.swap(_expected);
+        _expecting = false;
+    }
+    for (size_t i=0; i<expected.size(); i++)
+        addChange(expected[i]);
+}
+
+/* acquire tuner_lock prior to calling this function */
+void RDC_i::addChange(const usrpTimedChange& change)
+{
+    std::deque<usrpTimedChange>::iterator it = _changes.begin();
+    while ((it != _changes.end()) and (it->when <= change.when))
+        it++;
+    _changes.insert(it, change);
+}
+
+/* the samples from change.when on are at its settings, and the next block
+ * pushed starts with them. acquire tuner_lock prior to calling this function
+ */
+void RDC_i::landChange(const usrpTimedChange& change)
+{
+    if (_command_log and (change.id != 0)) {
+        int64_t sample_index = -1;
+        if (_rx_next_valid)
+            sample_index = _rx_next_index - (_rx_next_time - change.when).to_ticks(rx_hardware_sample_rate);
+        _command_log->landed(change.id, sample_index);
+    }
+    // USRP_i tunes without planTune(), so the LO could be anywhere
+    if (change.id != 0)
+        _lo_frequency = 0;
+    bool retuned = (frontend::floatingPointCompare(change.center_frequency, _landed.center_frequency) != 0);
+    if ((change.sample_rate > 0) and (frontend::floatingPointCompare(change.sample_rate, rx_hardware_sample_rate) != 0)) {
+        rx_hardware_sample_rate = change.sample_rate;
+        _landed_rate_changed = true;
+        retuned = true;
+    }
+    // a gain step is tagged with AGC_GAIN, like the AGC's, rather than with new SRI
+    if (frontend::floatingPointCompare(change.gain, device_gain) != 0)
+        _gain_landed = true;
+    device_gain = change.gain;
+    _landed = change;
+    _retune_landed = _retune_landed or retuned;
+}
+
+/* acquire tuner_lock prior to calling this function */
+void RDC_i::landDueChanges()
+{
+    while (changeDue()) {
+        landChange(_changes.front());
+        _changes.pop_front();
+    }
+}
+
+/* the next sample recv() returns is at or past the earliest pending change */
+bool RDC_i::changeDue() const
+{
+    return (not _changes.empty()) and _rx_next_valid and (_changes.front().when <= _rx_next_time);
+}
+
+/* stops a recv() of samps at the earliest pending change, so it starts a buffer */
+size_t RDC_i::capToChange(size_t samps) const
+{
+    if (_changes.empty() or (not _rx_next_valid))
+        return samps;
+    const long long until = (_changes.front().when - _rx_next_time).to_ticks(rx_hardware_sample_rate);
+    return (until > 0) ? std::min(samps, size_t(until)) : samps;
+}
+
+/* feeds a completed block's statistics to the continuous AGC and, if it calls
+ * for a change, issues it as a timed command landing at nextChangeTime(), like
+ * a retune. acquire tuner_lock prior to calling this function
+ */
+void RDC_i::runAgc(const usrpRxBlock& block)
+{
+    const double sample_rate = rx_hardware_sample_rate;
+    if ((sample_rate <= 0) or (not _rx_next_valid))
+        return;
+    if (not _agc_running) {
+        _agc.reset();
+        _agc_running = true;
+    }
+    const uhd::time_spec_t start = toTimeSpec(block.time);
+    // judge the effect of the last change only once a whole block is at the new gain
+    if (_agc_pending) {
+        if (start < _agc_pending_time)
+            return;
+        _agc_pending = false;
+    }
+
+    agcSettings settings;
+    settings.target_dbfs = rx_agc_target_dbfs;
+    settings.attack_db = rx_agc_attack_db;
+    settings.decay_db = rx_agc_decay_db;
+    settings.hysteresis_db = rx_agc_hysteresis_db;
+    settings.max_rate = rx_agc_max_rate;
+    settings.decimation = rx_agc_decimation;
+
+    float new_gain = device_gain;
+    if (not _agc.update(settings, block.stats, fullScale(), start.get_real_secs(), device_gain,
+                        device_characteristics.gain_min, device_characteristics.gain_max, new_gain))
+        return;
+
+    const uhd::time_spec_t when = nextChangeTime();
+    RH_DEBUG(this->_baseLog, "runAgc|level " << _agc.measuredLevel() << " dBFS, gain " << device_gain << " -> " << new_gain << " at " << when.get_real_secs());
+    updateDeviceRxGainTimed(new_gain, when);
+    _agc_pending = true;
+    _agc_pending_time = when;
 }
 
 /***********************************************************************************************
@@ -319,102 +1088,1283 @@ void RDC_i::constructor()
 ************************************************************************************************/
 int RDC_i::serviceFunction()
 {
-    if ((usrp_device_ptr.get() == NULL) or (frontend_tuner_status[0].allocation_id_csv.empty()) or (not frontend_tuner_status[0].enabled)) {
+    if (not rx_ring.pop(_egress_block)) {
+        rx_ring_fill = 0;
         return NOOP;
     }
+    latencyScope service_scope(_latency[LATENCY_SERVICE]);
+    _latency[LATENCY_RING].since(_egress_block.queued_ns);
+    rx_ring_fill = rx_ring.fill();
+    rx_ring_drops = rx_ring.dropped();
+    rx_peak_magnitude = _egress_block.stats.peak;
+    rx_power_dbfs = _egress_block.stats.powerDbfs(fullScale());
+    rx_clip_count = _egress_block.stats.clip_count;
 
-    bool rx_data = false;
+    RH_DEBUG(this->_baseLog, "serviceFunction|pushing buffer of " << _egress_block.size/2 << " samples");
 
-    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    // set stream id (creates one if not already created for this tuner)
+    getStreamId();
+    updateFanout();
+    bulkio::OutShortStream outputStream = dataShort_out->getStream(_stream_id);
+
+    // this block starts at a timed change (landChange), so its SRI carries the new tuning
+    if (_egress_block.retuned) {
+        frontend_tuner_status[0].center_frequency = _egress_block.center_frequency;
+        if (_egress_block.rate_changed) {
+            // the resampler was set up for the old hardware rate
+            boost::mutex::scoped_lock resampler_lock(_resampler_lock);
+            _resampling = false;
+            frontend_tuner_status[0].sample_rate = _egress_block.sample_rate;
+            frontend_tuner_status[0].bandwidth = std::min(frontend_tuner_status[0].bandwidth, _egress_block.sample_rate);
+        }
+        usrp_tuner.update_sri = true;
+        notifyChildren(_tuned);
+    }
 
-    long num_samps = usrpReceive(1.0); // 1 second timeout
+    // Send updated SRI
+    const bool retuned = usrp_tuner.update_sri;
+    if (usrp_tuner.update_sri or (_fanout_enabled ? !_fanout.hasSRI() : !outputStream)){
+        latencyScope sri_scope(_latency[LATENCY_SRI]);
+        RH_DEBUG(this->_baseLog, "serviceFunction|creating SRI for tuner: "<<_tuner_number<<" with stream id: "<< _stream_id);
+        BULKIO::StreamSRI sri = this->create(_stream_id, frontend_tuner_status[0], -1.0);
+        sri.mode = 1; // complex
+        pushOutputSRI(sri);
+        outputStream = dataShort_out->getStream(_stream_id);
+        usrp_tuner.update_sri = false;
+    }
+    bulkio::OutOctetStream octetStream = dataOctet_out->getStream(_stream_id);
+    bulkio::OutFloatStream floatStream = dataFloat_out->getStream(_stream_id);
 
-    /* if auto-gain enabled, push data to gain method */
-    if (trigger_rx_autogain) {
-        float newGain = auto_gain(); // auto_gain will set trigger to false if appropriate
-        if(newGain != device_gain)
-            updateDeviceRxGain(newGain, false);
+    // handle partial packet (b/c overflow occured) without resizing the underlying buffer
+    redhawk::shared_buffer<short> data = _egress_block.data;
+    if (_egress_block.size < data.size()) {
+        data = data.slice(0, _egress_block.size);
+    }
+    BULKIO::PrecisionUTCTime time = _egress_block.time;
+    size_t agc_gain_offset = _egress_block.agc_gain_offset;
+    const bool discontinuity = egressDiscontinuity();
+    if (_record_failed.exchange(false)) {
+        boost::mutex::scoped_lock lock(propertySetAccess);
+        record_enable = false;
+    }
+    bool resampled = false;
+    {
+        boost::mutex::scoped_lock resampler_lock(_resampler_lock);
+        if (_resampling) {
+            latencyScope resample_scope(_latency[LATENCY_RESAMPLE]);
+            resampled = true;
+            data = resample(data, discontinuity, time);
+            const double offset = std::max(0.0, agc_gain_offset - _resampler.outputOffset());
+            agc_gain_offset = size_t(offset * _resampler.outputRate() / rx_hardware_sample_rate + 0.5);
+        }
+    }
+    if (data.size() == 0) {
+        _egress_block.data = redhawk::buffer<short>();
+        return NORMAL;
+    }
+
+    // Tag the sample the AGC gain change took effect at
+    if (_egress_block.agc_gain_changed) {
+        if (_fanout_enabled) {
+            _fanout.setKeyword("AGC_GAIN", redhawk::Value(double(_egress_block.agc_gain)));
+            _fanout.setKeyword("AGC_GAIN_OFFSET", redhawk::Value(CORBA::ULong(agc_gain_offset)));
+        } else {
+            outputStream.setKeyword("AGC_GAIN", double(_egress_block.agc_gain));
+            outputStream.setKeyword("AGC_GAIN_OFFSET", CORBA::ULong(agc_gain_offset));
+        }
+        octetStream.setKeyword("AGC_GAIN", double(_egress_block.agc_gain));
+        octetStream.setKeyword("AGC_GAIN_OFFSET", CORBA::ULong(agc_gain_offset));
+        floatStream.setKeyword("AGC_GAIN", double(_egress_block.agc_gain));
+        floatStream.setKeyword("AGC_GAIN_OFFSET", CORBA::ULong(agc_gain_offset));
+    }
+
+    if (burst_detect_enable) {
+        // the capture stats only describe the data if it wasn't resampled
+        runBurstDetector(data, resampled ? NULL : &_egress_block.stats, discontinuity or retuned, time);
+    } else if (_burst_configured) {
+        if (_burst_stream) {
+            _burst_stream.close();
+            _burst_stream = bulkio::OutShortStream();
+        }
+        _burst_configured = false;
+    }
+    const bool continuous = not (burst_detect_enable and burst_only);
+
+    // Pushing Data
+    if (not continuous) {
+        // only the bursts go out
+    } else if (_fanout_enabled) {
+        latencyScope write_scope(_latency[LATENCY_WRITE]);
+        _fanout.write(data, time);
+    } else {
+        latencyScope write_scope(_latency[LATENCY_WRITE]);
+        outputStream.write(data, time);
     }
 
-    // if the buffer is full OR (overflow occurred and buffer isn't empty), push buffer out as is and move to next buffer
-    if(usrp_tuner.buffer_size >= usrp_tuner.buffer_capacity || (num_samps < 0 && usrp_tuner.buffer_size > 0) ){
-        rx_data = true;
+    // the converted formats cost a pass over the data, so only produce them for connected ports
+    if (continuous and (dataOctet_out->state() != BULKIO::IDLE)) {
+        redhawk::buffer<unsigned char> octets = _octet_pool.get(data.size());
+        sc16_to_sc8(data.data(), data.size(), (fullScale() > 0x7f) ? 8 : 0, reinterpret_cast<int8_t*>(octets.data()));
+        octetStream.write(octets.slice(0, data.size()), time);
+    }
+    if (continuous and (dataFloat_out->state() != BULKIO::IDLE)) {
+        redhawk::buffer<float> floats = _float_pool.get(data.size());
+        sc16_to_fc32(data.data(), data.size(), 1.0f/(fullScale()+1), floats.data());
+        floatStream.write(floats.slice(0, data.size()), time);
+    }
 
-        RH_DEBUG(this->_baseLog, "serviceFunctionReceive|pushing buffer of " << usrp_tuner.buffer_size/2 << " samples");
+    if (_spectrum_wanted and psd_enable and (dataPSD_out->state() != BULKIO::IDLE)) {
+        offerSpectrum(data, time);
+    }
 
-        // set stream id (creates one if not already created for this tuner)
-        getStreamId();
-        bulkio::OutShortStream outputStream = dataShort_out->getStream(_stream_id);
+    if (not _ddcs.empty()) {
+        runChannelizer(data, discontinuity, time);
+    }
+    if (_srdc != NULL) {
+        _srdc->pushHistory(data, time, discontinuity);
+    }
+    if (_drdc != NULL) {
+        _drdc->pushDelayed(data, time, discontinuity);
+    }
 
-        // Send updated SRI
-        if (usrp_tuner.update_sri){
-            RH_DEBUG(this->_baseLog, "USRP_UHD_i::serviceFunctionReceive|creating SRI for tuner: "<<_tuner_number<<" with stream id: "<< _stream_id);
-            //BULKIO::StreamSRI sri = bulkio::sri::create(_stream_id, frontend_tuner_status[0], -1.0);
-            BULKIO::StreamSRI sri = this->create(_stream_id, frontend_tuner_status[0], -1.0);
-            sri.mode = 1; // complex
-            if (!outputStream) {
-                outputStream = dataShort_out->createStream(sri);
-            } else {
-                outputStream.sri(sri);
-            }
-            //printSRI(&sri,"USRP_UHD_i::serviceFunctionReceive SRI"); // DEBUG
-            //dataShort_out->pushSRI(sri);
-            //dataSDDS_out->pushSRI(sri);
-            usrp_tuner.update_sri = false;
+    // SDDS frames point into the ring buffer and go straight to the network;
+    // only the attach and SRI travel over CORBA
+    {
+        boost::mutex::scoped_lock sdds_lock(_sdds_lock);
+        if (continuous and _sdds.isOpen()) {
+            _sdds.send(data.data(), data.size(), frontend_tuner_status[0].sample_rate,
+                       time_t(time.twsec), time.tfsec);
+            sdds_frames_sent = _sdds.framesSent();
+            sdds_send_errors = _sdds.sendErrors();
+        }
+    }
+
+    // release our reference so the buffer is not held until the next pop
+    _egress_block.data = redhawk::buffer<short>();
+    return NORMAL;
+}
+
+void RDC_i::getStreamId() {
+    if (_stream_id.empty()){
+        std::ostringstream id;
+        id<<"tuner_freq_"<<long(frontend_tuner_status[0].center_frequency)<<"_Hz_"<<frontend::uuidGenerator();
+        _stream_id = id.str();
+        usrp_tuner.update_sri = true;
+        RH_DEBUG(this->_baseLog,"USRP_UHD_i::getStreamId - created NEW stream id: "<< _stream_id);
+    } else {
+        RH_DEBUG(this->_baseLog,"USRP_UHD_i::getStreamId - returning EXISTING stream id: "<< _stream_id);
+    }
+}
+
+/* creates the stream on every BulkIO output (short, octet and float), or
+ * updates the SRI of the ones that already exist
+ */
+void RDC_i::pushOutputSRI(const BULKIO::StreamSRI& sri) {
+    if (_fanout_enabled) {
+        _fanout.pushSRI(sri);
+    } else {
+        bulkio::OutShortStream shortStream = dataShort_out->getStream(_stream_id);
+        if (!shortStream) {
+            dataShort_out->createStream(sri);
+        } else {
+            shortStream.sri(sri);
+        }
+    }
+    bulkio::OutOctetStream octetStream = dataOctet_out->getStream(_stream_id);
+    if (!octetStream) {
+        dataOctet_out->createStream(sri);
+    } else {
+        octetStream.sri(sri);
+    }
+    bulkio::OutFloatStream floatStream = dataFloat_out->getStream(_stream_id);
+    if (!floatStream) {
+        dataFloat_out->createStream(sri);
+    } else {
+        floatStream.sri(sri);
+    }
+
+    boost::mutex::scoped_lock sdds_lock(_sdds_lock);
+    if (_sdds.isOpen()) {
+        // samples go out in host byte order
+        BULKIO::StreamSRI sdds_sri = sri;
+        redhawk::PropertyMap::cast(sdds_sri.keywords)["DATA_REF_STR"] = CORBA::Long(sddsPacketizer::dataRef());
+        dataSDDS_out->pushSRI(sdds_sri, bulkio::time::utils::now());
+    }
+}
+
+/* queues a captured block for the recording, starting a new recording when
+ * there is none or the hardware rate changed; returns true if the recorder
+ * kept a reference to the block's buffer. Only the capture thread calls this
+ */
+bool RDC_i::recordBlock(const usrpRxBlock& block)
+{
+    if (not _record_wanted)
+        return false;
+    boost::shared_ptr<iqRecorder> recorder;
+    {
+        boost::mutex::scoped_lock lock(_recorder_lock);
+        recorder = _recorder;
+    }
+    // a SigMF recording has one sample rate
+    if (recorder and (recorder->sampleRate() != rx_hardware_sample_rate)) {
+        retireRecorder();
+        recorder.reset();
+    }
+    if (not recorder) {
+        recorder = openRecorder(block.time);
+        if (not recorder)
+            return false;
+    }
+
+    redhawk::shared_buffer<short> data = block.data;
+    if (block.size < data.size()) {
+        data = data.slice(0, block.size);
+    }
+    const bool queued = recorder->write(data, block.time, block.center_frequency, _record_gap);
+    _record_gap = block.overflow;
+    if (queued) {
+        _record_dropping = false;
+    } else if (_record_wanted and not _record_dropping) {
+        // reported once per run of dropped buffers
+        _record_dropping = true;
+        RH_WARN(this->_baseLog, "recordBlock|the disk is falling behind; dropping buffers from " << recorder->dataPath());
+        postStatus(CF::DEV_OVERFLOW, "Recording overflow: the disk is falling behind");
+    }
+
+    std::string error;
+    if (recorder->failed(error)) {
+        RH_ERROR(this->_baseLog, "recordBlock|" << error << "; recording stopped");
+        _record_wanted = false;
+        _record_failed = true;
+        retireRecorder();
+    }
+    return queued;
+}
+
+/* called from the capture thread, which only runs for an enabled allocation,
+ * so _stream_id was made before it got here
+ */
+boost::shared_ptr<iqRecorder> RDC_i::openRecorder(const BULKIO::PrecisionUTCTime& time)
+{
+    boost::shared_ptr<iqRecorder> recorder(new iqRecorder());
+    std::ostringstream path;
+    path << record_directory << "/" << _stream_id << "_" << long(time.twsec);
+    std::string error;
+    if (not recorder->open(path.str(), rx_hardware_sample_rate, record_queue_depth, error)) {
+        RH_ERROR(this->_baseLog, "openRecorder|" << error << "; recording disabled");
+        _record_wanted = false;
+        _record_failed = true;
+        return boost::shared_ptr<iqRecorder>();
+    }
+    _record_dropping = false;
+    _record_gap = false;
+    RH_INFO(this->_baseLog, "openRecorder|recording to " << recorder->dataPath() << " (" << recorder->ioMode() << ")");
+    boost::mutex::scoped_lock lock(_recorder_lock);
+    _recorder = recorder;
+    return recorder;
+}
+
+/* stops feeding the current recording and closes it on a thread of its own */
+void RDC_i::retireRecorder()
+{
+    boost::mutex::scoped_lock lock(_recorder_lock);
+    if (not _recorder)
+        return;
+    // forget the closers that are done
+    for (size_t i=_recorder_closers.size(); i>0; i--) {
+        if (_recorder_closers[i-1]->timed_join(boost::posix_time::seconds(0)))
+            _recorder_closers.erase(_recorder_closers.begin()+(i-1));
+    }
+    _recorder_closers.push_back(boost::shared_ptr<boost::thread>(new boost::thread(&RDC_i::closeRecorder, this, _recorder)));
+    _recorder_last = _recorder;
+    _recorder.reset();
+}
+
+/* waits for the queued buffers to reach the disk and finishes the metadata */
+void RDC_i::closeRecorder(boost::shared_ptr<iqRecorder> recorder)
+{
+    recorder->close();
+    RH_INFO(this->_baseLog, "closeRecorder|closed " << recorder->dataPath() << ": " << recorder->bytesWritten() << " bytes, "
+            << recorder->dropped() << " buffers dropped");
+}
+
+void RDC_i::joinRecorderClosers()
+{
+    std::vector<boost::shared_ptr<boost::thread> > closers;
+    {
+        boost::mutex::scoped_lock lock(_recorder_lock);
+        closers.swap(_recorder_closers);
+    }
+    for (size_t i=0; i<closers.size(); i++)
+        closers[i]->join();
+}
+
+/* called with propertySetAccess held, so the recording is closed off this thread */
+void RDC_i::recordEnableChanged(bool old_value, bool new_value)
+{
+    _record_wanted = new_value;
+    if (not new_value)
+        retireRecorder();
+}
+
+/* the recording being fed, or else the last one, for the record_ statistics */
+boost::shared_ptr<iqRecorder> RDC_i::reportedRecorder(bool& current)
+{
+    boost::mutex::scoped_lock lock(_recorder_lock);
+    current = bool(_recorder);
+    return current ? _recorder : _recorder_last;
+}
+
+std::string RDC_i::getRecordFile()
+{
+    bool current;
+    boost::shared_ptr<iqRecorder> recorder = reportedRecorder(current);
+    return current ? recorder->dataPath() : std::string();
+}
+
+std::string RDC_i::getRecordIoMode()
+{
+    bool current;
+    boost::shared_ptr<iqRecorder> recorder = reportedRecorder(current);
+    return recorder ? std::string(recorder->ioMode()) : std::string();
+}
+
+CORBA::ULong RDC_i::getRecordBacklog()
+{
+    bool current;
+    boost::shared_ptr<iqRecorder> recorder = reportedRecorder(current);
+    return current ? recorder->backlog() : 0;
+}
+
+CORBA::ULong RDC_i::getRecordDroppedBlocks()
+{
+    bool current;
+    boost::shared_ptr<iqRecorder> recorder = reportedRecorder(current);
+    return recorder ? recorder->dropped() : 0;
+}
+
+CORBA::ULongLong RDC_i::getRecordBytesWritten()
+{
+    bool current;
+    boost::shared_ptr<iqRecorder> recorder = reportedRecorder(current);
+    return recorder ? recorder->bytesWritten() : 0;
+}
+
+/* feeds the block to the energy detector, (re)configured from the burst_*
+ * properties, and sends what it finds of each burst on a stream of its own;
+ * time is that of the first sample of data
+ */
+void RDC_i::runBurstDetector(const redhawk::shared_buffer<short>& data, const sc16Stats* stats, bool discontinuity, const BULKIO::PrecisionUTCTime& time)
+{
+    const double sample_rate = frontend_tuner_status[0].sample_rate;
+    if (sample_rate <= 0)
+        return;
+
+    const double full_scale = fullScale();
+    burstSettings settings;
+    settings.window = burst_window;
+    settings.on_power = full_scale*full_scale*pow(10.0, burst_threshold_dbfs/10.0);
+    settings.off_power = full_scale*full_scale*pow(10.0, (burst_threshold_dbfs-std::max(0.0f, burst_hysteresis_db))/10.0);
+    settings.trigger_windows = burst_trigger_windows;
+    settings.hangover = size_t(std::max(0.0, burst_hangover)*sample_rate + 0.5);
+    settings.pre_trigger = size_t(std::max(0.0, burst_pre_trigger)*sample_rate + 0.5);
+    settings.max_length = size_t(std::max(0.0, burst_max_length)*sample_rate + 0.5);
+    if ((not _burst_configured) or (settings != _burst_settings)) {
+        if (_burst_stream) {
+            _burst_stream.close();
+            _burst_stream = bulkio::OutShortStream();
+        }
+        _burst_settings = settings;
+        _burst_configured = _bursts.configure(settings);
+        if (not _burst_configured) {
+            RH_WARN(this->_baseLog, "runBurstDetector|burst_window must be at least 1 sample");
+            return;
+        }
+        RH_DEBUG(this->_baseLog, "runBurstDetector|threshold " << burst_threshold_dbfs << " dBFS, window " << settings.window
+                 << ", hangover " << settings.hangover << ", pre-trigger " << settings.pre_trigger << " samples");
+    }
+
+    std::vector<burstChunk> chunks;
+    _bursts.process(data, stats, discontinuity, chunks);
+    for (std::vector<burstChunk>::const_iterator chunk=chunks.begin(); chunk!=chunks.end(); chunk++) {
+        const BULKIO::PrecisionUTCTime chunk_time = time + chunk->offset/sample_rate;
+        if (chunk->first) {
+            std::ostringstream id;
+            id << _stream_id << "_burst_" << chunk->burst_id;
+            BULKIO::StreamSRI sri = this->create(id.str(), frontend_tuner_status[0], -1.0);
+            sri.mode = 1; // complex
+            redhawk::PropertyMap::cast(sri.keywords)["BURST_ID"] = CORBA::ULongLong(chunk->burst_id);
+            redhawk::PropertyMap::cast(sri.keywords)["BURST_THRESHOLD_DBFS"] = burst_threshold_dbfs;
+            _burst_stream = dataBurst_out->createStream(sri);
+            _burst_start_time = chunk_time;
+            bursts_detected++;
+        }
+        if (!_burst_stream)
+            continue;
+        if (chunk->data.size() > 0)
+            _burst_stream.write(chunk->data, chunk_time);
+        if (chunk->last) {
+            const std::string stream_id = _burst_stream.streamID();
+            _burst_stream.close();
+            _burst_stream = bulkio::OutShortStream();
+            const BULKIO::PrecisionUTCTime end_time = chunk_time + (chunk->data.size()/2)/sample_rate;
+            RH_DEBUG(this->_baseLog, "runBurstDetector|burst " << chunk->burst_id << ": " << chunk->length << " samples, peak "
+                     << 10*log10(std::max(chunk->peak_power, 1.0)/(full_scale*full_scale)) << " dBFS");
+            if (burst_status_events)
+                sendBurstStatus(*chunk, stream_id, end_time);
+        }
+    }
+}
+
+/* reports a burst that just ended on DeviceStatus_out; the times are split in
+ * whole and fractional seconds so they keep sample precision
+ */
+void RDC_i::sendBurstStatus(const burstChunk& chunk, const std::string& stream_id, const BULKIO::PrecisionUTCTime& end_time)
+{
+    const std::string allocation_id = controllingAllocation();
+    if (allocation_id.empty())
+        return;
+    const double full_scale = fullScale();
+    CF::DeviceStatusType status;
+    status.allocation_id = CORBA::string_dup(allocation_id.c_str());
+    status.timestamp = redhawk::time::utils::now();
+    status.status = CF::DEV_OK;
+    status.message = CORBA::string_dup("burst");
+    redhawk::PropertyMap& props = redhawk::PropertyMap::cast(status.props);
+    props["BURST_ID"] = CORBA::ULongLong(chunk.burst_id);
+    props["STREAM_ID"] = stream_id;
+    props["BURST_START_WSEC"] = _burst_start_time.twsec;
+    props["BURST_START_FSEC"] = _burst_start_time.tfsec;
+    props["BURST_END_WSEC"] = end_time.twsec;
+    props["BURST_END_FSEC"] = end_time.tfsec;
+    props["BURST_SAMPLES"] = CORBA::ULongLong(chunk.length);
+    props["BURST_PEAK_DBFS"] = 10*log10(std::max(chunk.peak_power, 1.0)/(full_scale*full_scale));
+    // every burst is its own event
+    _status.post(status, false);
+}
+
+/* queues a DeviceStatus_out event for the controlling allocation; never blocks on the port
+ */
+void RDC_i::postStatus(CF::DeviceStatusCode code, const std::string& message)
+{
+    const std::string allocation_id = controllingAllocation();
+    if (allocation_id.empty())
+        return;
+    CF::DeviceStatusType status;
+    status.allocation_id = CORBA::string_dup(allocation_id.c_str());
+    status.timestamp = redhawk::time::utils::now();
+    status.status = code;
+    status.message = CORBA::string_dup(message.c_str());
+    _status.post(status);
+}
+
+/* called from the status dispatcher's thread
+ */
+void RDC_i::sendStatus(const CF::DeviceStatusType& status, const std::string& connection_id)
+{
+    try {
+        this->DeviceStatus_out->statusChanged(status, connection_id);
+    } catch (...) {
+        RH_WARN(this->_baseLog, "sendStatus|unable to send \"" << status.message << "\" to " << connection_id);
+    }
+}
+
+// connections() takes the port's lock; getConnectionIds() doesn't
+std::vector<std::string> RDC_i::statusConnections()
+{
+    std::vector<std::string> ids;
+    ExtendedCF::UsesConnectionSequence_var connections = this->DeviceStatus_out->connections();
+    for (CORBA::ULong i=0; i<connections->length(); i++)
+        ids.push_back(std::string(connections[i].connectionId));
+    return ids;
+}
+
+void RDC_i::statusMaxRateChanged(float old_value, float new_value) {
+    _status.setMaxRate(new_value);
+}
+
+uint64_t deviceStatusTraits::key(const CF::DeviceStatusType& status)
+{
+    uint64_t hash = statusHash(status.allocation_id.in());
+    hash = statusHash(status.message.in(), hash);
+    return hash ^ uint64_t(status.status);
+}
+
+void deviceStatusTraits::coalesce(CF::DeviceStatusType& status, const CF::UTCTime& last, uint64_t count)
+{
+    redhawk::PropertyMap& props = redhawk::PropertyMap::cast(status.props);
+    props["COUNT"] = CORBA::ULongLong(count);
+    props["FIRST_WSEC"] = status.timestamp.twsec;
+    props["FIRST_FSEC"] = status.timestamp.tfsec;
+    props["LAST_WSEC"] = last.twsec;
+    props["LAST_FSEC"] = last.tfsec;
+    status.timestamp = last;
+}
+
+void RDC_i::startSpectrum()
+{
+    if (_spectrum_thread != NULL)
+        return;
+    _spectrum_running = true;
+    _spectrum_thread = new boost::thread(&RDC_i::spectrumThread, this);
+}
+
+void RDC_i::stopSpectrum()
+{
+    if (_spectrum_thread == NULL)
+        return;
+    {
+        boost::mutex::scoped_lock lock(_spectrum_lock);
+        _spectrum_running = false;
+        _spectrum_cond.notify_all();
+    }
+    _spectrum_thread->join();
+    delete _spectrum_thread;
+    _spectrum_thread = NULL;
+    _spectrum_wanted = false;
+    _spectrum_pending = false;
+    _spectrum_data = redhawk::shared_buffer<short>();
+}
+
+/* hands a block to the spectrum thread by reference; gives up rather than wait
+ * if the spectrum thread holds the lock
+ */
+void RDC_i::offerSpectrum(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time)
+{
+    boost::mutex::scoped_try_lock lock(_spectrum_lock);
+    if (not lock.owns_lock())
+        return;
+    _spectrum_data = data;
+    _spectrum_time = time;
+    _spectrum_stream_id = _stream_id;
+    _spectrum_center_frequency = frontend_tuner_status[0].center_frequency;
+    _spectrum_sample_rate = frontend_tuner_status[0].sample_rate;
+    _spectrum_pending = true;
+    _spectrum_wanted = false;
+    _spectrum_cond.notify_one();
+}
+
+/* averages FFTs of the blocks offered by the service function into frames on
+ * dataPSD_out, asking for blocks only as fast as psd_frame_rate needs them
+ */
+void RDC_i::spectrumThread()
+{
+    bulkio::OutFloatStream psdStream;
+    std::string stream_id;
+    double center_frequency = 0;
+    double sample_rate = 0;
+    size_t fft_size = 0;
+    float overlap = 0;
+    size_t averages = 0;
+    bool configured = false;
+    BULKIO::PrecisionUTCTime frame_time;
+    boost::system_time next_frame = boost::get_system_time();
+
+    _spectrum_wanted = true;
+    while (true) {
+        redhawk::shared_buffer<short> data;
+        BULKIO::PrecisionUTCTime time;
+        bool source_changed = false;
+        {
+            boost::mutex::scoped_lock lock(_spectrum_lock);
+            while (_spectrum_running and not _spectrum_pending) {
+                // wake up now and then to end the stream once psd_enable is cleared
+                if (not _spectrum_cond.timed_wait(lock, boost::posix_time::milliseconds(500)) and psdStream and not psd_enable)
+                    break;
+            }
+            if (not _spectrum_running)
+                break;
+            if (not _spectrum_pending) {
+                RH_DEBUG(this->_baseLog, "spectrumThread|ending stream " << psdStream.streamID());
+                psdStream.close();
+                psdStream = bulkio::OutFloatStream();
+                continue;
+            }
+            data = _spectrum_data;
+            _spectrum_data = redhawk::shared_buffer<short>();
+            _spectrum_pending = false;
+            time = _spectrum_time;
+            source_changed = (_spectrum_stream_id != stream_id) or (_spectrum_center_frequency != center_frequency) or (_spectrum_sample_rate != sample_rate);
+            stream_id = _spectrum_stream_id;
+            center_frequency = _spectrum_center_frequency;
+            sample_rate = _spectrum_sample_rate;
+        }
+
+        if ((psd_fft_size != fft_size) or (psd_overlap != overlap) or (psd_averages != averages)) {
+            fft_size = psd_fft_size;
+            overlap = psd_overlap;
+            averages = psd_averages;
+            configured = _spectrum.configure(fft_size, overlap, averages);
+            if (not configured) {
+                RH_WARN(this->_baseLog, "spectrumThread|invalid settings: psd_fft_size " << fft_size << " (must be a power of two), psd_overlap " << overlap << ", psd_averages " << averages);
+            } else if (fft_size > data.size()/2) {
+                RH_WARN(this->_baseLog, "spectrumThread|psd_fft_size " << fft_size << " is larger than the " << data.size()/2 << " sample output blocks; no spectra will be produced");
+            }
+            source_changed = true;
+        }
+        if (source_changed and configured) {
+            _spectrum.reset();
+            BULKIO::StreamSRI sri = bulkio::sri::create(stream_id + "_psd");
+            sri.mode = 0;
+            sri.xstart = -sample_rate/2;
+            sri.xdelta = sample_rate/fft_size;
+            sri.xunits = BULKIO::UNITS_FREQUENCY;
+            sri.subsize = fft_size;
+            sri.ystart = 0;
+            sri.ydelta = (psd_frame_rate > 0) ? 1.0/psd_frame_rate : 0;
+            sri.yunits = BULKIO::UNITS_TIME;
+            redhawk::PropertyMap& keywords = redhawk::PropertyMap::cast(sri.keywords);
+            keywords["CHAN_RF"] = center_frequency;
+            keywords["COL_RF"] = center_frequency;
+            keywords["PSD_AVERAGES"] = CORBA::ULong(averages);
+            keywords["PSD_OVERLAP"] = overlap;
+            if (psdStream and (psdStream.streamID() != std::string(sri.streamID))) {
+                psdStream.close();
+                psdStream = bulkio::OutFloatStream();
+            }
+            if (!psdStream) {
+                psdStream = dataPSD_out->createStream(sri);
+            } else {
+                psdStream.sri(sri);
+            }
+        }
+
+        if (configured) {
+            if (_spectrum.accumulated() == 0)
+                frame_time = time;
+            if (_spectrum.process(data.data(), data.size(), 1.0f/(fullScale()+1))) {
+                const std::vector<float>& frame = _spectrum.frame();
+                redhawk::buffer<float> out(frame.size());
+                std::copy(frame.begin(), frame.end(), out.begin());
+                psdStream.write(out, frame_time);
+
+                // skip the blocks in between frames
+                const boost::system_time now = boost::get_system_time();
+                if (psd_frame_rate > 0)
+                    next_frame += boost::posix_time::microseconds(long(1e6/psd_frame_rate));
+                if (next_frame < now)
+                    next_frame = now;
+                boost::mutex::scoped_lock lock(_spectrum_lock);
+                while (_spectrum_running and (boost::get_system_time() < next_frame)) {
+                    _spectrum_cond.timed_wait(lock, next_frame);
+                }
+            }
+        }
+        // let go of the block before asking for the next one
+        data = redhawk::shared_buffer<short>();
+        _spectrum_wanted = true;
+    }
+
+    if (psdStream)
+        psdStream.close();
+}
+
+/* switches dataShort_out between the BulkIO stream and the per-connection
+ * queues per listener_fanout, and picks up connection changes
+ */
+void RDC_i::updateFanout() {
+    if (listener_fanout != _fanout_enabled) {
+        RH_DEBUG(this->_baseLog, "updateFanout|listener fan-out " << (listener_fanout ? "enabled" : "disabled"));
+        if (listener_fanout) {
+            // end the BulkIO stream so the connections see a clean hand-off
+            bulkio::OutShortStream shortStream = dataShort_out->getStream(_stream_id);
+            if (shortStream) {
+                shortStream.close();
+            }
+        } else {
+            _fanout.stop(true);
+        }
+        _fanout_enabled = listener_fanout;
+        _fanout_sync = true;
+        usrp_tuner.update_sri = true;
+    }
+    if (_fanout_enabled and _fanout_sync.exchange(false)) {
+        _fanout.sync(dataShort_out);
+    }
+}
+
+/* applies listener_policy, listener_queue_depth, listener_decimation and
+ * listener_policies to the connection queues
+ */
+void RDC_i::configureListeners() {
+    listenerSettings defaults;
+    if (not listenerFanout::policyFromString(listener_policy, defaults.policy)) {
+        RH_WARN(this->_baseLog, "configureListeners|unknown listener_policy " << listener_policy << "; using block");
+    }
+    defaults.depth = listener_queue_depth;
+    defaults.decimation = listener_decimation;
+
+    std::map<std::string, listenerSettings> overrides;
+    for (std::vector<listener_policy_struct_struct>::const_iterator it=listener_policies.begin(); it!=listener_policies.end(); it++) {
+        listenerSettings settings;
+        if (not listenerFanout::policyFromString(it->policy, settings.policy)) {
+            RH_WARN(this->_baseLog, "configureListeners|unknown policy " << it->policy << " for connection " << it->connection_id << "; using block");
+        }
+        settings.depth = it->queue_depth;
+        settings.decimation = it->decimation;
+        overrides[it->connection_id] = settings;
+    }
+    _fanout.configure(defaults, overrides);
+}
+
+void RDC_i::listenerConnected(const std::string& connection_id) {
+    _fanout_sync = true;
+}
+
+void RDC_i::listenerDisconnected(const std::string& connection_id) {
+    _fanout_sync = true;
+}
+
+void RDC_i::listenerPolicyChanged(std::string old_value, std::string new_value) {
+    configureListeners();
+}
+
+void RDC_i::listenerSizeChanged(CORBA::ULong old_value, CORBA::ULong new_value) {
+    configureListeners();
+}
+
+void RDC_i::listenerPoliciesChanged(const std::vector<listener_policy_struct_struct>& old_value, const std::vector<listener_policy_struct_struct>& new_value) {
+    configureListeners();
+}
+
+std::vector<latency_stat_struct_struct> RDC_i::getLatencyStats() {
+    static const char* names[LATENCY_STAGES] = {"recv", "auto_gain", "capture", "ring", "sri", "resample", "write", "service"};
+    std::vector<latency_stat_struct_struct> stats(LATENCY_STAGES);
+    for (size_t i=0; i<LATENCY_STAGES; i++) {
+        const latencyHistogram::summary summary = _latency[i].summarize();
+        stats[i].stage = names[i];
+        stats[i].count = summary.count;
+        stats[i].mean_us = summary.mean_us;
+        stats[i].p50_us = summary.p50_us;
+        stats[i].p99_us = summary.p99_us;
+        stats[i].p999_us = summary.p999_us;
+    }
+    return stats;
+}
+
+void RDC_i::latencyResetChanged(bool old_value, bool new_value) {
+    if (not new_value)
+        return;
+    for (size_t i=0; i<LATENCY_STAGES; i++)
+        _latency[i].reset();
+    latency_reset = false;
+    RH_DEBUG(this->_baseLog, "latencyResetChanged|latency histograms cleared");
+}
+
+std::vector<listener_status_struct_struct> RDC_i::getListenerStatus() {
+    std::vector<listener_status_struct_struct> status;
+    const std::vector<listenerStats> stats = _fanout.stats();
+    for (std::vector<listenerStats>::const_iterator it=stats.begin(); it!=stats.end(); it++) {
+        listener_status_struct_struct entry;
+        entry.connection_id = it->connection_id;
+        entry.policy = listenerFanout::policyName(it->settings.policy);
+        entry.queue_depth = it->settings.depth;
+        entry.queued = it->queued;
+        entry.lag_seconds = it->lag_seconds;
+        entry.packets_sent = it->sent;
+        entry.packets_dropped = it->dropped;
+        entry.push_errors = it->errors;
+        status.push_back(entry);
+    }
+    return status;
+}
+
+/* (re)opens the SDDS socket per the sdds_* properties and registers the
+ * stream with dataSDDS_out, which attaches it to every connection
+ */
+void RDC_i::startSdds() {
+    stopSdds();
+    if (sdds_ip_address.empty())
+        return;
+
+    boost::mutex::scoped_lock sdds_lock(_sdds_lock);
+    std::string error;
+    if (not _sdds.open(sdds_ip_address, sdds_port, sdds_interface, sdds_ttl, error)) {
+        RH_ERROR(this->_baseLog, "startSdds|unable to set up SDDS output to " << sdds_ip_address << ":" << sdds_port << " - " << error);
+        return;
+    }
+
+    BULKIO::SDDSStreamDefinition stream;
+    stream.id = CORBA::string_dup(_stream_id.c_str());
+    stream.dataFormat = BULKIO::SDDS_CI;
+    stream.multicastAddress = CORBA::string_dup(sdds_ip_address.c_str());
+    stream.vlan = 0;
+    stream.port = sdds_port;
+    stream.sampleRate = CORBA::ULong(frontend_tuner_status[0].sample_rate);
+    stream.timeTagValid = true;
+    stream.privateInfo = CORBA::string_dup("");
+    dataSDDS_out->addStream(stream);
+    sdds_frames_sent = 0;
+    sdds_send_errors = 0;
+    RH_DEBUG(this->_baseLog, "startSdds|tuner_number=" << _tuner_number << " sending " << _stream_id << " to " << sdds_ip_address << ":" << sdds_port);
+}
+
+void RDC_i::stopSdds() {
+    boost::mutex::scoped_lock sdds_lock(_sdds_lock);
+    if (not _sdds.isOpen())
+        return;
+    dataSDDS_out->removeStream(_stream_id);
+    _sdds.close();
+}
+
+bool RDC_i::egressDiscontinuity()
+{
+    const bool discontinuity = _egress_gap or (rx_ring.dropped() != _egress_drops);
+    _egress_gap = _egress_block.overflow;
+    _egress_drops = rx_ring.dropped();
+    return discontinuity;
+}
+
+/* called with _resampler_lock held; moves time to the first output sample */
+redhawk::shared_buffer<short> RDC_i::resample(const redhawk::shared_buffer<short>& data, bool discontinuity, BULKIO::PrecisionUTCTime& time)
+{
+    if (discontinuity)
+        _resampler.reset();
+    redhawk::buffer<short> out = _resample_pool.get(2*_resampler.maxOutput(data.size()));
+    const size_t count = _resampler.process(data.data(), data.size(), out.data());
+    time = time + _resampler.outputOffset()/rx_hardware_sample_rate;
+    return out.slice(0, 2*count);
+}
+
+/* called once, by the parent, before the device starts; ddcs[k] receives
+ * channel k of the filterbank
+ */
+bool RDC_i::enableChannelizer(size_t channels, size_t taps_per_channel, const std::vector<DDC_ns::DDC_i*>& ddcs)
+{
+    if ((ddcs.size() != channels) or (not _channelizer.configure(channels, taps_per_channel))) {
+        RH_ERROR(this->_baseLog, "enableChannelizer|invalid filterbank of " << channels << " channels, " << taps_per_channel << " taps per channel");
+        return false;
+    }
+    _ddcs = ddcs;
+    for (size_t k=0; k<_ddcs.size(); k++) {
+        _ddcs[k]->setSource(this, k);
+    }
+    RH_INFO(this->_baseLog, "enableChannelizer|" << channels << " DDC channels, " << 100*_channelizer.usableBandwidth() << "% of each usable");
+    return true;
+}
+
+bool RDC_i::channelizerInput(double& center_frequency, double& sample_rate)
+{
+    if (not _tuned)
+        return false;
+    center_frequency = frontend_tuner_status[0].center_frequency;
+    sample_rate = frontend_tuner_status[0].sample_rate;
+    return true;
+}
+
+void RDC_i::notifyChildren(bool tuned)
+{
+    _tuned = tuned;
+    _channelizer_restart = true;
+    for (std::vector<DDC_ns::DDC_i*>::iterator it=_ddcs.begin(); it!=_ddcs.end(); it++) {
+        (*it)->sourceChanged(tuned);
+    }
+    if (_srdc != NULL)
+        _srdc->sourceChanged(tuned);
+    if (_drdc != NULL)
+        _drdc->sourceChanged(tuned);
+}
+
+void RDC_i::runChannelizer(const redhawk::shared_buffer<short>& data, bool discontinuity, const BULKIO::PrecisionUTCTime& time)
+{
+    bool active = false;
+    for (std::vector<DDC_ns::DDC_i*>::iterator it=_ddcs.begin(); it!=_ddcs.end(); it++) {
+        active = active or (*it)->isActive();
+    }
+    if (not active) {
+        _channelizer_restart = true;
+        return;
+    }
+
+    // filter history from before a gap in the samples would smear into the channels
+    if (_channelizer_restart or discontinuity) {
+        _channelizer.reset();
+        _channelizer_restart = false;
+    }
+
+    const size_t count = _channelizer.process(data.data(), data.size(), 1.0f/(fullScale()+1));
+    if (count == 0)
+        return;
+    const double delay = (_channelizer.outputOffset() - _channelizer.groupDelay()) / frontend_tuner_status[0].sample_rate;
+    const BULKIO::PrecisionUTCTime first = time + delay;
+    for (size_t k=0; k<_ddcs.size(); k++) {
+        if (_ddcs[k]->isActive()) {
+            _ddcs[k]->pushChannel(_channelizer.output(k), count, first);
+        }
+    }
+}
+
+/* called once, by the parent, before the device starts */
+void RDC_i::enableSnapshots(SRDC_ns::SRDC_i* srdc)
+{
+    _srdc = srdc;
+    _srdc->setSource(this);
+}
+
+/* called once, by the parent, before the device starts */
+void RDC_i::enableDelay(DRDC_ns::DRDC_i* drdc)
+{
+    _drdc = drdc;
+    _drdc->setSource(this);
+}
+
+/* the allocation USRP_i is about to make on this RDC is a scanner allocation */
+void RDC_i::setScanRequest(const frontend::frontend_scanner_allocation_struct& scan_request)
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    _scan_request_set = true;
+    _scan_request = scan_request;
+}
+
+void RDC_i::clearScanRequest()
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    _scan_request_set = false;
+}
+
+bool RDC_i::isScanner(const std::string& allocation_id)
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    return _scan_allocated and hasAllocation(allocation_id);
+}
+
+/* whether this RDC can run the scan in _scan_request as tuned for request;
+ * acquire tuner_lock prior to calling this function
+ */
+bool RDC_i::validateScanRequest(const frontend::frontend_tuner_allocation_struct& request)
+{
+    const frontend::frontend_scanner_allocation_struct& scan = _scan_request;
+    if (_rx_grouped) {
+        RH_INFO(this->_baseLog, "validateScanRequest|a coherent tuner can't scan");
+        return false;
+    }
+    if ((scan.mode != "SPAN_SCAN") and (scan.mode != "DISCRETE_SCAN")) {
+        RH_INFO(this->_baseLog, "validateScanRequest|unknown scan mode " << scan.mode);
+        return false;
+    }
+    if ((scan.control_mode != "TIME_BASED") and (scan.control_mode != "SAMPLE_BASED")) {
+        RH_INFO(this->_baseLog, "validateScanRequest|unknown control mode " << scan.control_mode);
+        return false;
+    }
+    if ((scan.min_freq > scan.max_freq) or
+            !frontend::validateRequest(device_characteristics.freq_min, device_characteristics.freq_max, scan.min_freq, scan.max_freq)) {
+        RH_INFO(this->_baseLog, "validateScanRequest|device can't scan " << scan.min_freq << " to " << scan.max_freq << " Hz");
+        return false;
+    }
+
+    // the client will hop as often as control_limit, which has to be a rate the capture thread keeps up with
+    double min_dwell = scan.control_limit;
+    if (scan.control_mode == "SAMPLE_BASED") {
+        const double rate = (request.sample_rate > 0) ? request.sample_rate : request.bandwidth;
+        min_dwell = (rate > 0) ? scan.control_limit / rate : 0;
+    }
+    if ((scan.control_limit > 0) and (min_dwell < SCAN_MIN_DWELL)) {
+        RH_INFO(this->_baseLog, "validateScanRequest|dwells of " << min_dwell << " s are shorter than the " << SCAN_MIN_DWELL << " s this tuner sustains");
+        return false;
+    }
+    return true;
+}
+
+/* back to dwelling at the allocated center frequency; acquire tuner_lock prior to calling this function */
+void RDC_i::resetScan()
+{
+    frontend::ManualStrategy* manual = new frontend::ManualStrategy(frontend_tuner_status[0].center_frequency);
+    manual->control_mode = (_scan_allocation.control_mode == "SAMPLE_BASED") ? frontend::SAMPLE_BASED : frontend::TIME_BASED;
+    manual->control_value = _scan_allocation.control_limit;
+    _scan_strategy.reset(manual);
+    _scan_start_time = BULKIO::PrecisionUTCTime();
+    _scan_start_time.tcstatus = BULKIO::TCS_INVALID;
+    _scan_plan.clear();
+    _scan_armed = false;
+    _scan_scheduled = false;
+    _scan_hops = 0;
+}
+
+/* works out the hop plan for strategy; the capture thread starts on it at the
+ * scan start time (or right away, if that isn't set)
+ */
+void RDC_i::setScanStrategy(const frontend::ScanStrategy& strategy)
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    if (not _scan_allocated)
+        throw FRONTEND::NotSupportedException("Not a scanner allocation");
+
+    std::vector<double> frequencies;
+    if (const frontend::SpanStrategy* span = dynamic_cast<const frontend::SpanStrategy*>(&strategy)) {
+        for (size_t i=0; i<span->freq_scan_list.size(); i++) {
+            const frontend::ScanSpanRange& range = span->freq_scan_list[i];
+            if (not usrpScanPlan::expandSpan(range.begin_frequency, range.end_frequency, range.step, frequencies))
+                throw FRONTEND::BadParameterException("Scan has too many hops");
+        }
+    } else if (const frontend::DiscreteStrategy* discrete = dynamic_cast<const frontend::DiscreteStrategy*>(&strategy)) {
+        frequencies = discrete->discrete_freq_list;
+    } else if (const frontend::ManualStrategy* manual = dynamic_cast<const frontend::ManualStrategy*>(&strategy)) {
+        frequencies.push_back(manual->center_frequency);
+    }
+    if (frequencies.empty())
+        throw FRONTEND::BadParameterException("Scan strategy has no frequencies");
+    for (size_t i=0; i<frequencies.size(); i++) {
+        if ((frequencies[i] < _scan_allocation.min_freq) or (frequencies[i] > _scan_allocation.max_freq))
+            throw FRONTEND::BadParameterException("Scan frequency is outside of the allocated range");
+    }
+
+    const bool sample_based = (strategy.control_mode == frontend::SAMPLE_BASED);
+    if (sample_based != (_scan_allocation.control_mode == "SAMPLE_BASED"))
+        throw FRONTEND::BadParameterException("Scan control mode differs from the allocation's");
+    if (strategy.control_value < _scan_allocation.control_limit)
+        throw FRONTEND::BadParameterException("Scan control value is below the allocation's control_limit");
+    const double dwell_time = sample_based ? strategy.control_value / frontend_tuner_status[0].sample_rate : strategy.control_value;
+    if ((frequencies.size() > 1) and (dwell_time < SCAN_MIN_DWELL))
+        throw FRONTEND::BadParameterException("Scan dwell is too short");
+
+    // hops that fit in the passband together share an LO (see planTune())
+    double reach = 0;
+    if (fast_retune)
+        reach = (std::min(_rx_analog_bandwidth, rx_hardware_sample_rate) - _needed_bandwidth) / 2;
+    _scan_plan.build(frequencies, reach);
+    _scan_dwell = std::max<uint64_t>(llround(dwell_time * rx_hardware_sample_rate), 1);
+    _scan_strategy.reset(copyStrategy(strategy));
+    _scan_armed = true;
+    _scan_scheduled = false;
+    _scan_hops = 0;
+    RH_DEBUG(this->_baseLog, "setScanStrategy|" << _scan_plan.size() << " hops of " << _scan_dwell << " samples");
+}
+
+void RDC_i::setScanStartTime(const BULKIO::PrecisionUTCTime& start_time)
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    if (not _scan_allocated)
+        throw FRONTEND::NotSupportedException("Not a scanner allocation");
+    _scan_start_time = start_time;
+    // start the plan over from the new time
+    _scan_armed = not _scan_plan.empty();
+    _scan_scheduled = false;
+    _scan_hops = 0;
+}
+
+frontend::ScanStatus RDC_i::getScanStatus()
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    if (not _scan_strategy)
+        throw FRONTEND::NotSupportedException("Not a scanner allocation");
+    frontend::ScanStatus status(copyStrategy(*_scan_strategy));
+    status.start_time = _scan_start_time;
+    status.center_tune_frequencies = _scan_plan.frequencies();
+    status.started = (_scan_hops > 0) and _rx_next_valid and not (_rx_next_time < _scan_first);
+    return status;
+}
+
+/* issues the scan's hops as timed commands a few at a time (SCAN_AHEAD, or
+ * SCAN_HORIZON ahead of the samples coming in), so each is in the radio before
+ * it's due however short the dwell; each lands as a change that starts a
+ * block, so the dwell goes out under its own SRI on the same stream.
+ * acquire tuner_lock prior to calling this function
+ */
+void RDC_i::scheduleScanHops()
+{
+    static const size_t SCAN_AHEAD = 8;
+    static const double SCAN_HORIZON = 0.05;
+    static const double SCAN_MIN_LEAD = 0.002;
+
+    if (_scan_plan.empty() or (not _rx_next_valid) or (rx_hardware_sample_rate <= 0) or (usrp_device_ptr.get() == NULL))
+        return;
+
+    if (not _scan_scheduled) {
+        // a start time already gone by joins the plan where it would be by now
+        const uhd::time_spec_t earliest = _rx_next_time + uhd::time_spec_t(SCAN_MIN_LEAD);
+        _scan_origin = earliest;
+        _scan_hops = 0;
+        if (_scan_start_time.tcstatus == BULKIO::TCS_VALID) {
+            _scan_origin = uhd::time_spec_t(time_t(_scan_start_time.twsec), _scan_start_time.tfsec);
+            if (_scan_origin < earliest) {
+                const long long behind = (earliest - _scan_origin).to_ticks(rx_hardware_sample_rate);
+                _scan_hops = (behind + _scan_dwell - 1) / _scan_dwell;
+            }
+        }
+        _scan_first = _scan_origin + uhd::time_spec_t::from_ticks(_scan_hops * _scan_dwell, rx_hardware_sample_rate);
+        _scan_scheduled = true;
+    }
+
+    const uhd::time_spec_t horizon = _rx_next_time + uhd::time_spec_t(SCAN_HORIZON);
+    while (_scan_armed and (_changes.size() < SCAN_AHEAD)) {
+        const uhd::time_spec_t when = _scan_origin + uhd::time_spec_t::from_ticks(_scan_hops * _scan_dwell, rx_hardware_sample_rate);
+        if ((_scan_hops > 0) and (horizon < when))
+            break;
+        const usrpScanPlan::hop& hop = _scan_plan[_scan_hops % _scan_plan.size()];
+
+        bool cached = false;
+        uhd::tune_request_t request(hop.frequency);
+        if (hop.lo_frequency > 0) {
+            request.rf_freq_policy = uhd::tune_request_t::POLICY_MANUAL;
+            request.rf_freq = hop.lo_frequency;
+        } else {
+            request = planTune(hop.frequency, std::min(_rx_analog_bandwidth, rx_hardware_sample_rate), _needed_bandwidth, cached);
+        }
+        usrpTimedChange change;
+        change.when = when;
+        {
+            boost::mutex::scoped_lock cmd_lock(*_command_lock);
+            usrp_device_ptr->set_command_time(when);
+            const uhd::tune_result_t result = usrp_device_ptr->set_rx_freq(request, _tuner_number);
+            usrp_device_ptr->clear_command_time();
+            noteRetune(hop.frequency, result, cached, when);
+        }
+        change.center_frequency = usrp_device_ptr->get_rx_freq(_tuner_number);
+        change.gain = usrp_device_ptr->get_rx_gain(_tuner_number);
+        addChange(change);
+        if (usrp_device_ptr->get_time_now() > when)
+            RH_WARN(this->_baseLog, "scheduleScanHops|hop to " << hop.frequency << " Hz was late; samples tagged at " << when.get_real_secs() << " may be off");
+        _scan_hops++;
+
+        // a manual strategy tunes once and stays
+        if (_scan_plan.size() == 1)
+            _scan_armed = false;
+    }
+}
+
+bool RDC_i::sourceTuning(double& center_frequency, double& bandwidth, double& sample_rate)
+{
+    if (not _tuned)
+        return false;
+    center_frequency = frontend_tuner_status[0].center_frequency;
+    bandwidth = frontend_tuner_status[0].bandwidth;
+    sample_rate = frontend_tuner_status[0].sample_rate;
+    return true;
+}
+
+/* tunes the channel for the SRDC's timed bursts and keeps it from being
+ * allocated until releaseSnapshot(); fails if this RDC is in use
+ */
+bool RDC_i::reserveSnapshot(const frontend::frontend_tuner_allocation_struct &request, double& center_frequency, double& bandwidth, double& sample_rate)
+{
+    if (not validateTuning(request))
+        return false;
+
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    if (_tuned or _snapshot_reserved or _rx_grouped) {
+        RH_DEBUG(this->_baseLog, "reserveSnapshot|channel is in use");
+        return false;
+    }
+    tuneHardware(request, center_frequency, bandwidth, sample_rate);
+    _snapshot_reserved = true;
+    updateDeviceCharacteristics();
+    return true;
+}
+
+void RDC_i::releaseSnapshot()
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    _snapshot_reserved = false;
+}
+
+/* receives out.size()/2 samples as one STREAM_MODE_NUM_SAMPS_AND_DONE burst,
+ * timed to start (or right away if start is NULL); first is set to the time of
+ * the first sample. Only valid while reserved by reserveSnapshot(), when the
+ * capture thread is idle since this RDC holds no allocation
+ */
+bool RDC_i::captureSnapshot(const BULKIO::PrecisionUTCTime* start, redhawk::buffer<short>& out, BULKIO::PrecisionUTCTime& first)
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    if (not _snapshot_reserved)
+        return false;
+    if (usrp_rx_streamer.get() == NULL)
+        usrpCreateRxStream();
+
+    const size_t num_samps = out.size()/2;
+    uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
+    stream_cmd.num_samps = num_samps;
+    stream_cmd.stream_now = (start == NULL);
+    double timeout = 0.1 + num_samps/rx_hardware_sample_rate;
+    {
+        boost::mutex::scoped_lock cmd_lock(*_command_lock);
+        if (start != NULL) {
+            stream_cmd.time_spec = uhd::time_spec_t(time_t(start->twsec), start->tfsec);
+            timeout += std::max(0.0, (stream_cmd.time_spec - usrp_device_ptr->get_time_now()).get_real_secs());
+        }
+        usrp_device_ptr->issue_stream_cmd(stream_cmd, _tuner_number);
+    }
+
+    size_t received = 0;
+    while (received < num_samps) {
+        uhd::rx_metadata_t metadata;
+        size_t count = 0;
+        try {
+            count = usrp_rx_streamer->recv(out.data()+2*received, num_samps-received, metadata, timeout);
+        } catch(...) {
+            RH_ERROR(this->_baseLog, "captureSnapshot|uhd::rx_streamer->recv() threw unknown exception");
+            break;
         }
-
-        // Pushing Data
-        // handle partial packet (b/c overflow occured)
-        if(usrp_tuner.buffer_size < usrp_tuner.buffer_capacity){
-            usrp_tuner.output_buffer.resize(usrp_tuner.buffer_size);
+        if (metadata.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE) {
+            RH_WARN(this->_baseLog, "captureSnapshot|error code 0x" << std::hex << metadata.error_code << std::dec
+                    << " after " << received << " of " << num_samps << " samples");
+            break;
         }
-        // Only push on active ports
-        outputStream.write(usrp_tuner.output_buffer, usrp_tuner.output_buffer_time);
-        /*if(dataShort_out->isActive()){
-            dataShort_out->pushPacket(usrp_tuner.output_buffer, usrp_tuner.output_buffer_time, false, _stream_id);
-        }*/
-        // Don't check isActive because could be relying on attach override rather than a connection
-        // It doesn't actually do anything if the tuner/stream isn't configured for sdds already anyway
-        //dataSDDS_out->pushPacket(usrp_tuner.output_buffer, usrp_tuner.output_buffer_time, false, _stream_id);
-        // restore buffer size if necessary
-        if(usrp_tuner.buffer_size < usrp_tuner.buffer_capacity){
-            usrp_tuner.output_buffer.resize(usrp_tuner.buffer_capacity);
+        if ((received == 0) and (count > 0)) {
+            first = bulkio::time::utils::now();
+            first.twsec = (double)metadata.time_spec.get_full_secs();
+            first.tfsec = metadata.time_spec.get_frac_secs();
         }
-        usrp_tuner.buffer_size = 0;
-        
-    } else if(num_samps != 0){ // either received data or overflow occurred, either way data is available
-        rx_data = true;
+        received += count;
+        timeout = 0.1 + (num_samps-received)/rx_hardware_sample_rate;
+        if (metadata.end_of_burst)
+            break;
     }
-
-    if(rx_data)
-        return NORMAL;
-    return NOOP;
-}
-
-void RDC_i::getStreamId() {
-    if (_stream_id.empty()){
-        std::ostringstream id;
-        id<<"tuner_freq_"<<long(frontend_tuner_status[0].center_frequency)<<"_Hz_"<<frontend::uuidGenerator();
-        _stream_id = id.str();
-        usrp_tuner.update_sri = true;
-        RH_DEBUG(this->_baseLog,"USRP_UHD_i::getStreamId - created NEW stream id: "<< _stream_id);
-    } else {
-        RH_DEBUG(this->_baseLog,"USRP_UHD_i::getStreamId - returning EXISTING stream id: "<< _stream_id);
+    if (received < num_samps) {
+        // make sure nothing of a cut short burst is left for the next one
+        uhd::stream_cmd_t stop_cmd(uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS);
+        stop_cmd.stream_now = true;
+        boost::mutex::scoped_lock cmd_lock(*_command_lock);
+        usrp_device_ptr->issue_stream_cmd(stop_cmd, _tuner_number);
+        return false;
     }
+    return true;
 }
 
-void RDC_i::updateDeviceRxGain(double gain, bool lock) {
+/* lock=false: from the capture thread, holding tuner_lock
+ * lock=true: from anywhere else; queued for the capture thread, so device_gain follows later
+ * false if the change couldn't be made (too many already queued)
+ */
+bool RDC_i::updateDeviceRxGain(double gain, bool lock) {
     RH_TRACE(this->_baseLog,__PRETTY_FUNCTION__ << " gain=" << gain);
 
     if (usrp_device_ptr.get() == NULL)
-        return;
+        return false;
 
     if (lock) {
-        scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+        // not from the capture thread: leave it to the capture thread, between recv() calls
+        return queueTuneCommand(usrpTuneCommand::GAIN, gain);
     }
+    boost::mutex::scoped_lock cmd_lock(*_command_lock);
     usrp_device_ptr->set_rx_gain(gain,_tuner_number);
     device_gain = usrp_device_ptr->get_rx_gain(_tuner_number);
     RH_DEBUG(this->_baseLog,__PRETTY_FUNCTION__ << " Updated Gain. New gain is " << device_gain);
+    return true;
+}
+
+/* acquire tuner_lock prior to calling this function */
+void RDC_i::updateDeviceRxGainTimed(double gain, const uhd::time_spec_t& when) {
+    RH_TRACE(this->_baseLog,__PRETTY_FUNCTION__ << " gain=" << gain << " when=" << when.get_real_secs());
+
+    if (usrp_device_ptr.get() == NULL)
+        return;
+
+    usrpTimedChange change;
+    change.when = when;
+    {
+        boost::mutex::scoped_lock cmd_lock(*_command_lock);
+        usrp_device_ptr->set_command_time(when);
+        usrp_device_ptr->set_rx_gain(gain,_tuner_number);
+        usrp_device_ptr->clear_command_time();
+        change.gain = usrp_device_ptr->get_rx_gain(_tuner_number);
+    }
+    // keeps the tuning in effect at when, which a later scan hop may already have changed on the radio
+    change.center_frequency = _landed.center_frequency;
+    for (std::deque<usrpTimedChange>::const_iterator it=_changes.begin(); (it != _changes.end()) and (it->when <= when); it++)
+        change.center_frequency = it->center_frequency;
+    // device_gain, the status and the AGC_GAIN tag follow once the change lands (landChange)
+    addChange(change);
+    if (usrp_device_ptr->get_time_now() > when)
+        RH_WARN(this->_baseLog, "updateDeviceRxGainTimed|gain change to " << change.gain << " was late; samples tagged at " << when.get_real_secs() << " may be off");
 }
 
 /* acquire tuner_lock prior to calling this function *
@@ -424,10 +2374,12 @@ long RDC_i::usrpReceive(double timeout){
     RH_TRACE(this->_baseLog,__PRETTY_FUNCTION__ << " timeout:" << timeout);
 
     // calc num samps to rx based on timeout, sr, and buffer size
+    // (always ask for at least one so a nearly expired deadline still makes progress)
     size_t samps_to_rx = size_t((usrp_tuner.buffer_capacity-usrp_tuner.buffer_size) / 2);
     if( timeout > 0 ){
-        samps_to_rx = std::min(samps_to_rx, size_t(timeout*frontend_tuner_status[0].sample_rate));
+        samps_to_rx = std::min(samps_to_rx, std::max(size_t(timeout*rx_hardware_sample_rate), size_t(1)));
     }
+    samps_to_rx = capToChange(samps_to_rx);
 
     uhd::rx_metadata_t _metadata;
 
@@ -438,6 +2390,7 @@ long RDC_i::usrpReceive(double timeout){
 
     size_t num_samps = 0;
     try{
+        latencyScope recv_scope(_latency[LATENCY_RECV]);
         num_samps = usrp_rx_streamer->recv(
             &usrp_tuner.output_buffer[usrp_tuner.buffer_size], // address of buffer to start filling data
             //&usrp_tuner.output_buffer.at(usrp_tuner.buffer_size), // address of buffer to start filling data
@@ -447,41 +2400,44 @@ long RDC_i::usrpReceive(double timeout){
         RH_ERROR(this->_baseLog, "uhd::rx_streamer->recv() threw unknown exception");
         return 0;
     }
+    return usrpReceived(num_samps, _metadata);
+}
+
+/* accounts for num_samps received at the end of usrp_tuner.output_buffer, by
+ * usrpReceive() or a coherent RX group, and handles the recv() metadata
+ * acquire tuner_lock prior to calling this function
+ */
+long RDC_i::usrpReceived(size_t num_samps, const uhd::rx_metadata_t& _metadata){
     RH_TRACE(this->_baseLog, "usrpReceive|tuner_number=" << _tuner_number << " num_samps=" << num_samps);
     usrp_tuner.buffer_size += (num_samps*2);
 
-    //handle possible errors conditions
-    CF::DeviceStatusType status;
-    status.allocation_id = CORBA::string_dup(_allocationTracker.begin()->first.c_str());
-    status.timestamp = redhawk::time::utils::now();
-    std::ostringstream error_msg;
+    //handle possible errors conditions; status events are only built for errors
     switch (_metadata.error_code) {
         case uhd::rx_metadata_t::ERROR_CODE_NONE:
             break;
-        case uhd::rx_metadata_t::ERROR_CODE_TIMEOUT:
+        case uhd::rx_metadata_t::ERROR_CODE_TIMEOUT: {
+            std::ostringstream error_msg;
             error_msg << "WARNING: TIMEOUT OCCURED ON USRP RECEIVE! (received num_samps=" << num_samps << ")";
             RH_WARN(this->_baseLog, error_msg.str());
-            status.message = CORBA::string_dup(error_msg.str().c_str());
-            status.status = CF::DEV_UNDERFLOW;
-            this->DeviceStatus_out->statusChanged(status);
+            postStatus(CF::DEV_UNDERFLOW, error_msg.str());
             return 0;
+        }
         case uhd::rx_metadata_t::ERROR_CODE_OVERFLOW:
-            status.status = CF::DEV_OVERFLOW;
-            status.message = CORBA::string_dup("Device overflow detected");
-            this->DeviceStatus_out->statusChanged(status);
+            postStatus(CF::DEV_OVERFLOW, "Device overflow detected");
             RH_WARN(this->_baseLog, "WARNING: USRP OVERFLOW DETECTED!");
             // may have received data, but 0 is returned by usrp recv function so we don't know how many samples, must throw away
             return -1; // this will just cause us to return NORMAL so there's no wait before next iteration
         case uhd::rx_metadata_t::ERROR_CODE_LATE_COMMAND:
-            status.message = CORBA::string_dup("Device received a late command");
+            postStatus(CF::DEV_HARDWARE_FAILURE, "Device received a late command");
+            return -1;
         case uhd::rx_metadata_t::ERROR_CODE_BROKEN_CHAIN:
-            status.message = CORBA::string_dup("Device expected another stream command");
+            postStatus(CF::DEV_HARDWARE_FAILURE, "Device expected another stream command");
+            return -1;
         case uhd::rx_metadata_t::ERROR_CODE_ALIGNMENT:
-            status.message = CORBA::string_dup("Device multi-channel alignment failed");
+            postStatus(CF::DEV_HARDWARE_FAILURE, "Device multi-channel alignment failed");
+            return -1;
         case uhd::rx_metadata_t::ERROR_CODE_BAD_PACKET:
-            status.message = CORBA::string_dup("Device could not parse a received packet");
-            status.status = CF::DEV_HARDWARE_FAILURE;
-            this->DeviceStatus_out->statusChanged(status);
+            postStatus(CF::DEV_HARDWARE_FAILURE, "Device could not parse a received packet");
             return -1; // this will just cause us to return NORMAL so there's no wait before next iteration
         default:
             RH_WARN(this->_baseLog, "WARNING: UHD source block got error code 0x" << _metadata.error_code);
@@ -492,6 +2448,18 @@ long RDC_i::usrpReceive(double timeout){
     if(num_samps == 0)
         return 0;
 
+    if (_metadata.has_time_spec) {
+        if (not _rx_next_valid) {
+            _rx_next_index = 0;
+        } else if (_metadata.time_spec > _rx_next_time) {
+            // lost to an overflow
+            _rx_next_index += (_metadata.time_spec - _rx_next_time).to_ticks(rx_hardware_sample_rate);
+        }
+        _rx_next_index += num_samps;
+        _rx_next_time = _metadata.time_spec + uhd::time_spec_t::from_ticks(num_samps, rx_hardware_sample_rate);
+        _rx_next_valid = true;
+    }
+
     RH_DEBUG(this->_baseLog, "usrpReceive|received data.  num_samps=" << num_samps
                                                 << "  buffer_size=" << usrp_tuner.buffer_size
                                                 << "  buffer_capacity=" << usrp_tuner.buffer_capacity );
@@ -516,14 +2484,15 @@ long RDC_i::usrpReceive(double timeout){
              2. Kept generic to work for all daughtercard types in all modes.
              3. Calculates instantaneous values; not continuously calculating.
              4. Requires minimum of 500 samples (250 complex samples)
+             5. Uses the magnitude of both positive and negative excursions.
  ----------------------------------------------------------------------------*/
 float RDC_i::auto_gain() {
     size_t  samplesRequired = 500; // not configurable; hard-coded to 500, which is really 250 complex samples
     size_t  samplesFound    = 0;
     long    maxBits         = (device_mode == "8bit") ? 8 : 16;
     maxBits -= this->rx_autogain_guard_bits;
-    short   maxValue        = (device_mode == "8bit") ? 0x7f  : 0x7fff;
-    short   maxValueFound   = 0; // max value in current buffer
+    uint16_t maxValue       = fullScale();
+    int32_t maxValueFound   = 0; // max magnitude in current buffer
     long    bitsInUse       = 0;
     float   maxGain         = 0;
     float   minGain         = 0;
@@ -533,11 +2502,10 @@ float RDC_i::auto_gain() {
     maxGain = device_characteristics.gain_max;
     minGain = device_characteristics.gain_min;
     samplesFound = usrp_tuner.buffer_size;
-    for(size_t sampleNum=0 ; sampleNum<usrp_tuner.buffer_size; sampleNum++) {
-        // max value tracker. Look at Real and Complex values.
-        if((short)(usrp_tuner.output_buffer[sampleNum]) > maxValueFound)
-            maxValueFound = (short)(usrp_tuner.output_buffer[sampleNum]);
-    }
+    sc16Stats stats;
+    sc16_stats(&usrp_tuner.output_buffer[0], usrp_tuner.buffer_size, maxValue, stats);
+    maxValueFound = stats.peak;
+    RH_DEBUG(this->_baseLog, __PRETTY_FUNCTION__ << " Found " << stats.clip_count << " clipped values, mean power " << stats.powerDbfs(maxValue) << " dBFS (" << sc16_stats_impl() << ")");
 
     // require buffer to have sufficient number of samples before turning off trigger
     RH_DEBUG(this->_baseLog, __PRETTY_FUNCTION__ << " Got " << samplesFound << " of " << samplesRequired << " samples required for auto-gain calculation.");
@@ -587,6 +2555,10 @@ float RDC_i::auto_gain() {
     return newGain;
 }
 
+uint16_t RDC_i::fullScale() const {
+    return (device_mode == "8bit") ? 0x7f : 0x7fff;
+}
+
 void RDC_i::setTunerNumber(size_t tuner_number) {
     this->_tuner_number = tuner_number;
     this->updateDeviceCharacteristics();
@@ -618,7 +2590,7 @@ void RDC_i::updateDeviceCharacteristics() {
         device_characteristics.freq_max = usrp_range.frequency.stop();
 
         try {
-            std::vector<double> rates = usrp_device_ptr->get_rx_dboard_iface(_tuner_number)->get_clock_rates(uhd::usrp::dboard_iface::UNIT_RX);
+            std::vector<double> rates = usrp_device_ptr->get_rx_clock_rates(_tuner_number);
             device_characteristics.clock_min = rates.back();
             device_characteristics.clock_max = rates.front();
         } catch (...) {
@@ -628,11 +2600,19 @@ void RDC_i::updateDeviceCharacteristics() {
     }
 }
 
-void RDC_i::setUHDptr(const uhd::usrp::multi_usrp::sptr parent_device_ptr) {
-    usrp_device_ptr = parent_device_ptr;
+void RDC_i::setRadio(const usrpRadio::sptr& radio) {
+    usrp_device_ptr = radio;
     this->updateDeviceCharacteristics();
 }
 
+void RDC_i::setCommandLock(const usrp_command_lock_t& command_lock) {
+    _command_lock = command_lock;
+}
+
+void RDC_i::setCommandLog(const usrp_command_log_t& command_log) {
+    _command_log = command_log;
+}
+
 /* acquire tuner_lock prior to calling this function *
  */
 bool RDC_i::usrpCreateRxStream(){
@@ -656,10 +2636,7 @@ bool RDC_i::usrpCreateRxStream(){
      *  - sc16 - Q16 I16
      *  - sc8 - Q8_1 I8_1 Q8_0 I8_0
      */
-    std::string wire_format = "sc16";
-    if(device_mode == "8bit") {
-        wire_format = "sc8"; // enable 8-bit mode with "sc8"
-    }
+    std::string wire_format = wireFormat(); // "sc8" in 8-bit mode
     RH_DEBUG(this->_baseLog, "usrpCreateRxStream|using wire_format " << wire_format);
 
     uhd::stream_args_t stream_args(cpu_format,wire_format);
@@ -669,6 +2646,91 @@ bool RDC_i::usrpCreateRxStream(){
     return true;
 }
 
+/* the wire format is fixed when the rx streamer is created, so a streaming
+ * tuner has its streamer rebuilt and restarted in the new mode
+ */
+void RDC_i::deviceModeChanged(std::string old_value, std::string new_value)
+{
+    if (old_value == new_value)
+        return;
+    RH_DEBUG(this->_baseLog, "deviceModeChanged|" << old_value << " -> " << new_value);
+
+    if (_rx_grouped) {
+        RH_WARN(this->_baseLog, "deviceModeChanged|tuner is part of a coherent group; the new mode applies once it leaves the group");
+        return;
+    }
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    if ((usrp_device_ptr.get() == NULL) or (usrp_rx_streamer.get() == NULL))
+        return;
+    restartRxStream();
+}
+
+/* rebuilds this tuner's own rx streamer and restarts streaming if enabled
+ * acquire tuner_lock prior to calling this function
+ */
+void RDC_i::restartRxStream()
+{
+    usrp_device_ptr->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS, _tuner_number);
+    usrpCreateRxStream();
+    usrp_tuner.buffer_size = 0; // don't mix formats or streams within a buffer
+    _rx_next_valid = false;
+    _start_pending = false;
+    if (captureEnabled()) {
+        uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+        stream_cmd.stream_now = true;
+        usrp_device_ptr->issue_stream_cmd(stream_cmd, _tuner_number);
+    }
+}
+
+/* hands reception over to a coherent RX group; the group's streamer replaces ours */
+void RDC_i::joinRxGroup()
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    _rx_grouped = true;
+    _start_pending = false;
+    if (usrp_rx_streamer.get() != NULL) {
+        usrp_device_ptr->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS, _tuner_number);
+        usrp_rx_streamer.reset();
+    }
+    usrp_tuner.buffer_size = 0;
+    RH_DEBUG(this->_baseLog, "joinRxGroup|tuner_number=" << _tuner_number);
+}
+
+/* takes reception back from a coherent RX group, once the group has stopped streaming */
+void RDC_i::leaveRxGroup()
+{
+    scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+    if (not _rx_grouped)
+        return;
+    _rx_grouped = false;
+    if ((usrp_device_ptr.get() != NULL) and captureEnabled())
+        restartRxStream();
+    RH_DEBUG(this->_baseLog, "leaveRxGroup|tuner_number=" << _tuner_number);
+}
+
+/* receive position for a coherent RX group; samps is capped by the space left
+ * and the latency deadline. acquire tuner_lock prior to calling this function
+ */
+short* RDC_i::groupRecvBuffer(size_t& samps)
+{
+    samps = size_t((usrp_tuner.buffer_capacity-usrp_tuner.buffer_size) / 2);
+    const double timeout = captureTimeout();
+    if (timeout > 0)
+        samps = std::min(samps, std::max(size_t(timeout*rx_hardware_sample_rate), size_t(1)));
+    // changes scheduled for the whole group land on the same sample in each member
+    takeExpectedChanges();
+    samps = capToChange(samps);
+    if (_lo_settling)
+        checkLoSettled();
+    return &usrp_tuner.output_buffer[usrp_tuner.buffer_size];
+}
+
+/* called by a coherent RX group after recv(); acquire tuner_lock prior to calling this function */
+void RDC_i::groupReceived(size_t num_samps, const uhd::rx_metadata_t& metadata)
+{
+    completeCapture(usrpReceived(num_samps, metadata));
+}
+
 /*************************************************************
 Functions supporting tuning allocation
 *************************************************************/
@@ -683,6 +2745,7 @@ void RDC_i::deviceEnable(frontend_tuner_status_struct_struct &fts, size_t tuner_
         trigger_rx_autogain = true;
     usrpEnable(); // modifies fts.enabled appropriately
     //fts.enabled = true;
+    snapshotAllocations();
     return;
 }
 void RDC_i::deviceDisable(frontend_tuner_status_struct_struct &fts, size_t tuner_id){
@@ -692,6 +2755,7 @@ void RDC_i::deviceDisable(frontend_tuner_status_struct_struct &fts, size_t tuner
     ************************************************************/
     //#warning deviceDisable(): Disable the given tuner  *********
     fts.enabled = false;
+    snapshotAllocations();
     return;
 }
 bool RDC_i::deviceSetTuning(const frontend::frontend_tuner_allocation_struct &request, frontend_tuner_status_struct_struct &fts, size_t tuner_id){
@@ -707,74 +2771,8 @@ bool RDC_i::deviceSetTuning(const frontend::frontend_tuner_allocation_struct &re
     ************************************************************/
     //{
         //exclusive_lock lock(prop_lock);
-    double if_offset = 0.0;
-    double opt_sr = 0.0;
-    double opt_bw = 0.0;
-
-    // check request against USRP specs and analog input
-    const bool complex = true; // USRP operates using complex data
-    try {
-        // check device constraints
-        // see if IF center frequency is set in rfinfo packet
-        double request_if_center_freq = request.center_frequency;
-
-        // check vs. device center freq capability (ensure 0 <= request <= max device capability)
-        if ( !frontend::validateRequest(device_characteristics.freq_min,device_characteristics.freq_max,request_if_center_freq) ) {
-            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support freq request");
-        }
-
-        // check vs. device bandwidth capability (ensure 0 <= request <= max device capability)
-        if ( !frontend::validateRequest(0,device_characteristics.bandwidth_max,request.bandwidth) ){
-            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support bw request");
-        }
-
-        // check vs. device sample rate capability (ensure 0 <= request <= max device capability)
-        if ( !frontend::validateRequest(0,device_characteristics.rate_max,request.sample_rate) ){
-            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support sr request");
-        }
-
-        // calculate overall frequency range of the device (not just CF range)
-        const size_t scaling_factor = (complex) ? 2 : 4; // adjust for complex data
-        const double min_device_freq = device_characteristics.freq_min-(device_characteristics.rate_max/scaling_factor);
-        const double max_device_freq = device_characteristics.freq_max+(device_characteristics.rate_max/scaling_factor);
-
-        // check based on bandwidth
-        double min_requested_freq = request_if_center_freq-(request.bandwidth/2);
-        double max_requested_freq = request_if_center_freq+(request.bandwidth/2);
-
-        if ( !frontend::validateRequest(min_device_freq,max_device_freq,min_requested_freq,max_requested_freq) ) {
-            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support freq/bw request");
-        }
-
-        // check based on sample rate
-        min_requested_freq = request_if_center_freq-(request.sample_rate/scaling_factor);
-        max_requested_freq = request_if_center_freq+(request.sample_rate/scaling_factor);
-
-        if ( !frontend::validateRequest(min_device_freq,max_device_freq,min_requested_freq,max_requested_freq) ){
-            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support freq/sr request");
-        }
-        /*if( !frontend::validateRequestVsDevice(request, it->second.rfinfo_pkt, complex, device_characteristics.freq_min, device_characteristics.freq_max,
-                device_characteristics.bandwidth_max, device_characteristics.rate_max) ){
-            throw FRONTEND::BadParameterException("INVALID REQUEST -- falls outside of analog input or device capabilities");
-        }*/
-    } catch(FRONTEND::BadParameterException& e){
-        RH_INFO(this->_baseLog,"deviceSetTuning|BadParameterException - " << e.msg);
+    if (not validateTuning(request))
         return false;
-    }
-
-    // calculate if_offset according to rx rfinfo packet
-    /*if(frontend::floatingPointCompare(it->second.rfinfo_pkt.if_center_freq,0) > 0){
-        if_offset = it->second.rfinfo_pkt.rf_center_freq-it->second.rfinfo_pkt.if_center_freq;
-    }*/
-    // If sample rate is zero (don't care) then use bandwidth for tuner request
-    if(frontend::floatingPointCompare(request.sample_rate,0) <= 0) {
-        opt_sr = optimizeRate(request.bandwidth);
-        RH_DEBUG(this->_baseLog,"deviceSetTuning|sr requested 0|opt_sr="<<opt_sr<<"  requested_bw="<<request.bandwidth)
-    } else {
-        opt_sr = optimizeRate(request.sample_rate);
-    }
-    opt_bw = optimizeBandwidth(request.bandwidth);
-    RH_DEBUG(this->_baseLog,"deviceSetTuning|opt_sr="<<opt_sr<<"  opt_bw="<<opt_bw)
 
     // cache SDDS-related props for use at end of function
     /*RH_DEBUG(this->_baseLog,__PRETTY_FUNCTION__ << "Cache sdds_network_settings prop for tuner_id=" << tuner_id);
@@ -793,14 +2791,19 @@ bool RDC_i::deviceSetTuning(const frontend::frontend_tuner_allocation_struct &re
 
     scoped_tuner_lock tuner_lock(usrp_tuner.lock);
 
-    // account for RFInfo_pkt that specifies RF and IF frequencies
-    // since request is always in RF, and USRP may be operating in IF
-    // adjust requested center frequency according to rx rfinfo packet
+    // an SRDC is taking timed bursts on this channel
+    if (_snapshot_reserved) {
+        RH_INFO(this->_baseLog,"deviceSetTuning|channel is held by its SRDC");
+        return false;
+    }
+    if (_scan_request_set and not validateScanRequest(request))
+        return false;
 
-    // configure hw
-    usrp_device_ptr->set_rx_freq(request.center_frequency-if_offset, _tuner_number);
-    usrp_device_ptr->set_rx_bandwidth(opt_bw, _tuner_number);
-    usrp_device_ptr->set_rx_rate(opt_sr, _tuner_number);
+    // levels measured at the old tuning no longer apply
+    _agc_running = false;
+    _agc_pending = false;
+
+    tuneHardware(request, fts.center_frequency, fts.bandwidth, fts.sample_rate);
     /*if (receive_buffer_control.use_dynamic) {
         if (!receive_buffer_control.dynamic_type) {
             usrp_tuner.updateBufferSize((size_t)((opt_sr * receive_buffer_control.sample_rate_multiplier) * 2));
@@ -811,24 +2814,41 @@ bool RDC_i::deviceSetTuning(const frontend::frontend_tuner_allocation_struct &re
         usrp_tuner.setDefaultBufferSize();
     //}
 
-    // update frontend_tuner_status with actual hw values
-    fts.center_frequency = usrp_device_ptr->get_rx_freq(_tuner_number)+if_offset;
-    fts.bandwidth = usrp_device_ptr->get_rx_bandwidth(_tuner_number);
-    fts.sample_rate = usrp_device_ptr->get_rx_rate(_tuner_number);
-
-    // bandwidth will be reported as the minimum of analog filter bandwidth and the sample rate.
-    fts.bandwidth =std::min(fts.sample_rate,fts.bandwidth);
+    // bring the output to exactly the requested rate if the hardware can't
+    {
+        boost::mutex::scoped_lock resampler_lock(_resampler_lock);
+        _resampling = false;
+        if (rx_exact_rate and (frontend::floatingPointCompare(request.sample_rate,0) > 0)
+                and (frontend::floatingPointCompare(fts.sample_rate,request.sample_rate) != 0)) {
+            if (_resampler.configure(fts.sample_rate, request.sample_rate)) {
+                _resampling = true;
+                fts.sample_rate = _resampler.outputRate();
+                fts.bandwidth = std::min(fts.bandwidth, _resampler.passband());
+                RH_DEBUG(this->_baseLog,"deviceSetTuning|resampling "<<rx_hardware_sample_rate<<" to "<<fts.sample_rate
+                         <<(_resampler.isRational() ? " (rational)" : " (interpolated)"));
+            } else {
+                RH_WARN(this->_baseLog,"deviceSetTuning|cannot resample "<<rx_hardware_sample_rate<<" to "<<request.sample_rate
+                        <<"; output stays at the hardware rate");
+            }
+        }
+    }
 
     // update tolerance
     fts.bandwidth_tolerance = request.bandwidth_tolerance;
     fts.sample_rate_tolerance = request.sample_rate_tolerance;
 
-    RH_DEBUG(this->_baseLog,"deviceSetTuning|requested center frequency "<<request.center_frequency<<" and got "<<fts.center_frequency<<" (if_offset="<<if_offset<<")");
+    // a scanner dwells at the allocated frequency until it's given a strategy
+    _scan_allocated = _scan_request_set;
+    _scan_allocation = _scan_request;
+    resetScan();
+
+    RH_DEBUG(this->_baseLog,"deviceSetTuning|requested center frequency "<<request.center_frequency<<" and got "<<fts.center_frequency);
     RH_DEBUG(this->_baseLog,"deviceSetTuning|requested sample rate "<<request.sample_rate<<" and got "<<fts.sample_rate<<" (tolerance="<<fts.sample_rate_tolerance<<")");
     RH_DEBUG(this->_baseLog,"deviceSetTuning|requested bandwidth: "<<request.bandwidth<<" and got "<<fts.bandwidth<<" (tolerance="<<fts.bandwidth_tolerance<<")");
 
     // creates a stream id if not already created for this tuner
     getStreamId();
+    startSdds();
 
     /*RH_DEBUG(this->_baseLog,__PRETTY_FUNCTION__ << "Set up SDDS output for tuner_id=" << tuner_id);
 
@@ -867,6 +2887,7 @@ bool RDC_i::deviceSetTuning(const frontend::frontend_tuner_allocation_struct &re
     usrp_tuner.update_sri = true;
     updateDeviceCharacteristics();
     this->start();
+    notifyChildren(true);
     return true;
 }
 
@@ -876,9 +2897,140 @@ bool RDC_i::deviceDeleteTuning(frontend_tuner_status_struct_struct &fts, size_t
     return true if the tune deletion succeeded, and false if it failed
     ************************************************************/
     //#warning deviceDeleteTuning(): Deallocate an allocated tuner  *********
+    {
+        boost::mutex::scoped_lock lock(_allocation_lock);
+        _allocation_ids.clear();
+        _allocation_enabled = false;
+    }
+    // nothing may receive for an allocation the base class is about to forget;
+    // the next deviceSetTuning() starts the capture thread again
+    stopCapture();
+    {
+        scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+        resetScan();
+        _scan_allocated = false;
+        _scan_strategy.reset();
+    }
+    stopSdds();
+    notifyChildren(false);
+    return true;
+}
+
+/* checks request against the device's capabilities */
+bool RDC_i::validateTuning(const frontend::frontend_tuner_allocation_struct &request)
+{
+    // check request against USRP specs and analog input
+    const bool complex = true; // USRP operates using complex data
+    try {
+        // check device constraints
+        // see if IF center frequency is set in rfinfo packet
+        double request_if_center_freq = request.center_frequency;
+
+        // check vs. device center freq capability (ensure 0 <= request <= max device capability)
+        if ( !frontend::validateRequest(device_characteristics.freq_min,device_characteristics.freq_max,request_if_center_freq) ) {
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support freq request");
+        }
+
+        // check vs. device bandwidth capability (ensure 0 <= request <= max device capability)
+        if ( !frontend::validateRequest(0,device_characteristics.bandwidth_max,request.bandwidth) ){
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support bw request");
+        }
+
+        // check vs. device sample rate capability (ensure 0 <= request <= max device capability)
+        if ( !frontend::validateRequest(0,device_characteristics.rate_max,request.sample_rate) ){
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support sr request");
+        }
+
+        // calculate overall frequency range of the device (not just CF range)
+        const size_t scaling_factor = (complex) ? 2 : 4; // adjust for complex data
+        const double min_device_freq = device_characteristics.freq_min-(device_characteristics.rate_max/scaling_factor);
+        const double max_device_freq = device_characteristics.freq_max+(device_characteristics.rate_max/scaling_factor);
+
+        // check based on bandwidth
+        double min_requested_freq = request_if_center_freq-(request.bandwidth/2);
+        double max_requested_freq = request_if_center_freq+(request.bandwidth/2);
+
+        if ( !frontend::validateRequest(min_device_freq,max_device_freq,min_requested_freq,max_requested_freq) ) {
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support freq/bw request");
+        }
+
+        // check based on sample rate
+        min_requested_freq = request_if_center_freq-(request.sample_rate/scaling_factor);
+        max_requested_freq = request_if_center_freq+(request.sample_rate/scaling_factor);
+
+        if ( !frontend::validateRequest(min_device_freq,max_device_freq,min_requested_freq,max_requested_freq) ){
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- device capabilities cannot support freq/sr request");
+        }
+        /*if( !frontend::validateRequestVsDevice(request, it->second.rfinfo_pkt, complex, device_characteristics.freq_min, device_characteristics.freq_max,
+                device_characteristics.bandwidth_max, device_characteristics.rate_max) ){
+            throw FRONTEND::BadParameterException("INVALID REQUEST -- falls outside of analog input or device capabilities");
+        }*/
+    } catch(FRONTEND::BadParameterException& e){
+        RH_INFO(this->_baseLog,"validateTuning|BadParameterException - " << e.msg);
+        return false;
+    }
+
     return true;
 }
 
+/* tunes the channel as close to request as the hardware gets and returns
+ * what it got; acquire tuner_lock prior to calling this function
+ */
+void RDC_i::tuneHardware(const frontend::frontend_tuner_allocation_struct &request, double& center_frequency, double& bandwidth, double& sample_rate)
+{
+    double if_offset = 0.0;
+    double opt_sr = 0.0;
+    double opt_bw = 0.0;
+
+    // calculate if_offset according to rx rfinfo packet
+    /*if(frontend::floatingPointCompare(it->second.rfinfo_pkt.if_center_freq,0) > 0){
+        if_offset = it->second.rfinfo_pkt.rf_center_freq-it->second.rfinfo_pkt.if_center_freq;
+    }*/
+    // If sample rate is zero (don't care) then use bandwidth for tuner request
+    if(frontend::floatingPointCompare(request.sample_rate,0) <= 0) {
+        opt_sr = optimizeRate(request.bandwidth);
+        RH_DEBUG(this->_baseLog,"tuneHardware|sr requested 0|opt_sr="<<opt_sr<<"  requested_bw="<<request.bandwidth)
+    } else {
+        opt_sr = optimizeRate(request.sample_rate);
+    }
+    opt_bw = optimizeBandwidth(request.bandwidth);
+    RH_DEBUG(this->_baseLog,"tuneHardware|opt_sr="<<opt_sr<<"  opt_bw="<<opt_bw)
+
+    // what the passband has to hold around the center for a later fast retune
+    if (frontend::floatingPointCompare(request.bandwidth,0) > 0) {
+        _needed_bandwidth = request.bandwidth;
+    } else if (frontend::floatingPointCompare(request.sample_rate,0) > 0) {
+        _needed_bandwidth = request.sample_rate;
+    } else {
+        _needed_bandwidth = opt_sr;
+    }
+
+    // account for RFInfo_pkt that specifies RF and IF frequencies
+    // since request is always in RF, and USRP may be operating in IF
+    // adjust requested center frequency according to rx rfinfo packet
+
+    // configure hw
+    {
+        boost::mutex::scoped_lock cmd_lock(*_command_lock);
+        bool cached = false;
+        const double frequency = request.center_frequency-if_offset;
+        const uhd::tune_result_t result = usrp_device_ptr->set_rx_freq(planTune(frequency, std::min(opt_bw, opt_sr), _needed_bandwidth, cached), _tuner_number);
+        noteRetune(frequency, result, cached, usrp_device_ptr->get_time_now());
+        usrp_device_ptr->set_rx_bandwidth(opt_bw, _tuner_number);
+        usrp_device_ptr->set_rx_rate(opt_sr, _tuner_number);
+    }
+
+    // report what the hardware actually got
+    center_frequency = usrp_device_ptr->get_rx_freq(_tuner_number)+if_offset;
+    bandwidth = usrp_device_ptr->get_rx_bandwidth(_tuner_number);
+    sample_rate = usrp_device_ptr->get_rx_rate(_tuner_number);
+    rx_hardware_sample_rate = sample_rate;
+    _rx_analog_bandwidth = bandwidth;
+
+    // bandwidth will be reported as the minimum of analog filter bandwidth and the sample rate.
+    bandwidth =std::min(sample_rate,bandwidth);
+}
+
 bool RDC_i::usrpEnable()
 {
     RH_TRACE(this->_baseLog,__PRETTY_FUNCTION__ << " tuner_number=" << _tuner_number );
@@ -895,38 +3047,30 @@ bool RDC_i::usrpEnable()
         RH_DEBUG(this->_baseLog,"USRP_UHD_i::usrpEnable|creating SRI for tuner: "<< _tuner_number <<" with stream id: "<< _stream_id);
         BULKIO::StreamSRI sri = create(_stream_id, frontend_tuner_status[0]);
         sri.mode = 1; // complex
-        bulkio::OutShortStream outputStream = dataShort_out->getStream(_stream_id);
-        if (!outputStream) {
-            outputStream = dataShort_out->createStream(sri);
-        } else {
-            outputStream.sri(sri);
-        }
+        pushOutputSRI(sri);
         //dataShort_out->pushSRI(sri);
         //dataSDDS_out->pushSRI(sri);
         usrp_tuner.update_sri = false;
     }
 
+    // the group owns the streamer and starts it
+    if (_rx_grouped)
+        return true;
+
     if (usrp_rx_streamer.get() == NULL){
         usrpCreateRxStream();
         //RH_TRACE(this->_baseLog,"usrpEnable|tuner_id=" << tuner_id << " got rx_streamer[" << frontend_tuner_status[tuner_id].tuner_number << "]");
     }
 
-    // check for lo_lock
-    try{
-        //boost::system_time m1 = boost::get_system_time();
-        size_t i;
-        for(i=0; i<10 && !usrp_device_ptr->get_rx_sensor("lo_locked", _tuner_number).to_bool(); i++){
-            boost::this_thread::sleep(boost::posix_time::milliseconds(100));
-        }
-        //boost::system_time m2 = boost::get_system_time();
-        std::ostringstream os;
-        bool lo_status = usrp_device_ptr->get_rx_sensor("lo_locked", this->_tuner_number).to_bool();
-        //os << "Tuner number: " << _tuner_number << " lo_locked=" << lo_status << ", lo_locked status resolution took " <<  m2 - m1 << " seconds, number of retries=" << i; 
-        os << "Tuner number: " << _tuner_number << " lo_locked=" << lo_status << ", lo_locked status resolution took " <<  i << " number of retries"; 
-        RH_TRACE(this->_baseLog, os.str() );
-    } catch(...){
-        sleep(1);
+    // don't stream until the LO has locked; rather than wait for it here, leave
+    // the stream to the capture thread, so channels enabled one after another
+    // settle at the same time
+    if (not pollLoLock()) {
+        _start_pending = true;
+        RH_DEBUG(this->_baseLog,"usrpEnable|tuner_number=" << _tuner_number << " stream waits for LO lock");
+        return true;
     }
+    _start_pending = false;
 
     uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
     stream_cmd.stream_now = true;
@@ -999,8 +3143,12 @@ std::string RDC_i::getTunerRfFlowId(const std::string& allocation_id) {
 
 void RDC_i::setTunerCenterFrequency(const std::string& allocation_id, double freq) {
     if (freq<0) throw FRONTEND::BadParameterException("Center frequency cannot be less than 0");
-    // set hardware to new value. Raise an exception if it's not possible
-    this->frontend_tuner_status[0].center_frequency = freq;
+    if (usrp_device_ptr.get() == NULL) throw FRONTEND::FrontendException("No radio to tune");
+    if (!frontend::validateRequest(device_characteristics.freq_min, device_characteristics.freq_max, freq))
+        throw FRONTEND::BadParameterException("Center frequency is outside of the device's range");
+    // frontend_tuner_status follows once the retuned samples go out
+    if (not queueTuneCommand(usrpTuneCommand::FREQUENCY, freq))
+        throw FRONTEND::FrontendException("Too many tuner changes pending");
 }
 
 double RDC_i::getTunerCenterFrequency(const std::string& allocation_id) {
@@ -1019,22 +3167,28 @@ double RDC_i::getTunerBandwidth(const std::string& allocation_id) {
 
 void RDC_i::setTunerAgcEnable(const std::string& allocation_id, bool enable)
 {
-    throw FRONTEND::NotSupportedException("setTunerAgcEnable not supported");
+    // the capture thread picks this up on its next buffer
+    this->rx_agc_enable = enable;
 }
 
 bool RDC_i::getTunerAgcEnable(const std::string& allocation_id)
 {
-    throw FRONTEND::NotSupportedException("getTunerAgcEnable not supported");
+    return this->rx_agc_enable;
 }
 
 void RDC_i::setTunerGain(const std::string& allocation_id, float gain)
 {
-    throw FRONTEND::NotSupportedException("setTunerGain not supported");
+    if (usrp_device_ptr.get() == NULL) throw FRONTEND::FrontendException("No radio to set the gain of");
+    if (!frontend::validateRequest(device_characteristics.gain_min, device_characteristics.gain_max, gain))
+        throw FRONTEND::BadParameterException("Gain is outside of the device's range");
+    // device_gain follows once the samples at the new gain go out
+    if (not updateDeviceRxGain(gain, true))
+        throw FRONTEND::FrontendException("Too many tuner changes pending");
 }
 
 float RDC_i::getTunerGain(const std::string& allocation_id)
 {
-    throw FRONTEND::NotSupportedException("getTunerGain not supported");
+    return device_gain;
 }
 
 void RDC_i::setTunerReferenceSource(const std::string& allocation_id, long source)
@@ -1050,6 +3204,7 @@ long RDC_i::getTunerReferenceSource(const std::string& allocation_id)
 void RDC_i::setTunerEnable(const std::string& allocation_id, bool enable) {
     // set hardware to new value. Raise an exception if it's not possible
     this->frontend_tuner_status[0].enabled = enable;
+    snapshotAllocations();
 }
 
 bool RDC_i::getTunerEnable(const std::string& allocation_id) {
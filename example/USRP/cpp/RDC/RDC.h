@@ -2,10 +2,41 @@
 #define RDC_I_IMPL_H
 
 #include "RDC_base.h"
-#include <uhd/usrp/multi_usrp.hpp>
+#include "../radio.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include "../uhd_access.h"
+#include "../sdds_packetizer.h"
+#include "../latency_histogram.h"
+#include "../status_dispatcher.h"
+#include "../scan_plan.h"
+#include "agc_engine.h"
+#include "pfb_channelizer.h"
+#include "rational_resampler.h"
+#include "listener_fanout.h"
+#include "spectrum_tap.h"
+#include "burst_detector.h"
+#include "iq_recorder.h"
+
+namespace DDC_ns {
+class DDC_i;
+};
+namespace SRDC_ns {
+class SRDC_i;
+};
+namespace DRDC_ns {
+class DRDC_i;
+};
 
 namespace RDC_ns {
+// DeviceStatus_out events repeat per allocation, status and message; coalesced
+// ones carry COUNT and FIRST_/LAST_WSEC/FSEC props
+struct deviceStatusTraits {
+    typedef CF::DeviceStatusType status_type;
+    typedef CF::UTCTime time_type;
+    static uint64_t key(const CF::DeviceStatusType& status);
+    static void coalesce(CF::DeviceStatusType& status, const CF::UTCTime& last, uint64_t count);
+};
+
 class RDC_i : public RDC_base
 {
     ENABLE_LOGGING
@@ -19,12 +50,78 @@ class RDC_i : public RDC_base
 
         void constructor();
 
+        void start() throw (CF::Resource::StartError, CORBA::SystemException);
+        void stop() throw (CF::Resource::StopError, CORBA::SystemException);
+        CF::Device::Allocations* allocate (const CF::Properties& capacities)
+            throw (CF::Device::InvalidState, CF::Device::InvalidCapacity,
+                   CF::Device::InsufficientCapacity, CORBA::SystemException);
+        void deallocate (const char* alloc_id)
+            throw (CF::Device::InvalidState, CF::Device::InvalidCapacity,
+                   CORBA::SystemException);
+
         int serviceFunction();
 
         void setTunerNumber(size_t tuner_number);
-        void setUHDptr(const uhd::usrp::multi_usrp::sptr parent_device_ptr);
+        void setRadio(const usrpRadio::sptr& radio);
+        void setCommandLock(const usrp_command_lock_t& command_lock);
+        void setCommandLog(const usrp_command_log_t& command_log);
+        void expectChange(const usrpTimedChange& change);
         void updateDeviceCharacteristics();
 
+        // coherent RX group support (see usrpRxGroup); the group holds tunerLock()
+        // around groupRecvBuffer()/recv()/groupReceived()
+        int tunerNumber() const {
+            return _tuner_number;
+        }
+        // answered from the allocation snapshot, so safe from any thread
+        bool hasAllocation(const std::string& allocation_id);
+        bool isController(const std::string& allocation_id);
+        bool validateTimedCommand(double center_frequency, double sample_rate, bool set_gain, double gain, std::string& error);
+        double rxSampleRate() const {
+            return rx_hardware_sample_rate;
+        }
+        std::string wireFormat() const {
+            return (device_mode == "8bit") ? "sc8" : "sc16";
+        }
+        ticket_lock_t& tunerLock() {
+            return usrp_tuner.lock;
+        }
+        void waitLoLocked();
+        void joinRxGroup();
+        void leaveRxGroup();
+        short* groupRecvBuffer(size_t& samps);
+        void groupReceived(size_t num_samps, const uhd::rx_metadata_t& metadata);
+
+        // polyphase filterbank feeding one DDC child per channel (see pfbChannelizer)
+        bool enableChannelizer(size_t channels, size_t taps_per_channel, const std::vector<DDC_ns::DDC_i*>& ddcs);
+        bool channelizerInput(double& center_frequency, double& sample_rate);
+        size_t channelizerChannels() const {
+            return _channelizer.channels();
+        }
+        double channelizerUsableBandwidth() const {
+            return _channelizer.usableBandwidth();
+        }
+
+        // snapshot capture for an SRDC child (see SRDC_i)
+        void enableSnapshots(SRDC_ns::SRDC_i* srdc);
+        bool sourceTuning(double& center_frequency, double& bandwidth, double& sample_rate);
+        bool reserveSnapshot(const frontend::frontend_tuner_allocation_struct &request, double& center_frequency, double& bandwidth, double& sample_rate);
+        void releaseSnapshot();
+        bool captureSnapshot(const BULKIO::PrecisionUTCTime* start, redhawk::buffer<short>& out, BULKIO::PrecisionUTCTime& first);
+        uint16_t fullScale() const; // largest sample magnitude for the current device_mode
+
+        // time-delayed replay by a DRDC child (see DRDC_i)
+        void enableDelay(DRDC_ns::DRDC_i* drdc);
+
+        // scanning for RX_SCANNER_DIGITIZER allocations, which USRP_i hands to an RDC
+        // with the scanner allocation set; the capture thread makes the hops
+        void setScanRequest(const frontend::frontend_scanner_allocation_struct& scan_request);
+        void clearScanRequest();
+        bool isScanner(const std::string& allocation_id);
+        void setScanStrategy(const frontend::ScanStrategy& strategy);
+        void setScanStartTime(const BULKIO::PrecisionUTCTime& start_time);
+        frontend::ScanStatus getScanStatus();
+
     protected:
         std::string getTunerType(const std::string& allocation_id);
         bool getTunerDeviceControl(const std::string& allocation_id);
@@ -51,20 +148,255 @@ class RDC_i : public RDC_base
         frontend::RFInfoPkt get_rfinfo_pkt(const std::string& port_name);
         void set_rfinfo_pkt(const std::string& port_name, const frontend::RFInfoPkt& pkt);
 
-        uhd::rx_streamer::sptr usrp_rx_streamer;
+        usrpRxStream::sptr usrp_rx_streamer;
         usrpTunerStruct usrp_tuner; // data buffer/timestamps, lock
         bool usrpCreateRxStream();
         int _tuner_number;
         std::string _stream_id;
-        uhd::usrp::multi_usrp::sptr usrp_device_ptr;
+        usrpRadio::sptr usrp_device_ptr;
         long usrpReceive(double timeout);
+        long usrpReceived(size_t num_samps, const uhd::rx_metadata_t& metadata);
+        void restartRxStream();
+        std::atomic<bool> _rx_grouped;
+
+        // capture thread: recv() into usrp_tuner, hand full buffers to the service function via rx_ring
+        usrpRxRing rx_ring;
+        usrpRxBlock _capture_block; // owned by the capture thread
+        bool _capture_overrun;      // capture thread: rx_ring has been full since
+        size_t _overrun_drops;      // rx_ring.dropped() was this
+        usrpRxBlock _egress_block;  // owned by the service function
+        usrpTypedBufferPool<unsigned char> _octet_pool; // service function output for
+        usrpTypedBufferPool<float> _float_pool;         // the sc8 and fc32 ports
+        boost::thread* _capture_thread;
+        std::atomic<bool> _capture_running;
+        // allocation ids (the controlling one first) and enabled flag, copied from
+        // frontend_tuner_status whenever the allocating threads change them; the
+        // capture and group threads and USRP_i only ever read this copy
+        boost::mutex _allocation_lock;
+        std::vector<std::string> _allocation_ids;
+        bool _allocation_enabled;
+        void snapshotAllocations();
+        std::string controllingAllocation();
+        bool captureEnabled();
+        void startCapture();
+        void stopCapture();
+        void captureThread();
+        bool captureBuffer();
+        bool completeCapture(long num_samps);
+        boost::posix_time::ptime _oldest_sample_wall; // host time the first sample of the current buffer was taken
+        double captureTimeout();
+
+        // retunes asked for by control calls, queued so they never wait on a recv();
+        // the capture thread issues them as timed commands
+        usrpTuneQueue _tune_queue;
+        bool queueTuneCommand(usrpTuneCommand::kind_t kind, double value);
+        void applyTuneCommands(bool timed);
+
+        // timed changes from applyTuneCommands() or USRP_i (expectChange()); the
+        // capture thread ends the buffer being filled where each lands and flags
+        // the next one (usrpRxBlock::retuned)
+        boost::mutex _expected_lock;
+        std::vector<usrpTimedChange> _expected;     // protected by _expected_lock
+        std::atomic<bool> _expecting;
+        std::deque<usrpTimedChange> _changes;       // capture thread, in time order
+        usrp_command_log_t _command_log;
+        void takeExpectedChanges();
+        void addChange(const usrpTimedChange& change);
+        void landChange(const usrpTimedChange& change);
+        void landDueChanges();
+        bool changeDue() const;
+        size_t capToChange(size_t samps) const;
+        uhd::time_spec_t nextChangeTime() const;
+        bool _retune_landed;            // the next block pushed starts at _landed
+        bool _gain_landed;              // the next block pushed starts at a new gain
+        usrpTimedChange _landed;
+        bool _landed_rate_changed;
+        bool _rx_next_valid;
+        uhd::time_spec_t _rx_next_time; // time of the next sample recv() returns
+        int64_t _rx_next_index;         // and its index from the start of the stream
+
+        // retunes that leave the LO where it is when they can (fast_retune), and
+        // how long the LO took to lock when it did move (retune_history)
+        usrpTuneCache _tune_cache;
+        double _lo_frequency;           // 0 if not known
+        double _rx_analog_bandwidth;
+        double _needed_bandwidth;       // the allocation's, which the passband has to hold
+        bool _lo_settling;              // _settling moved the LO, which hasn't reported lock yet
+        uhd::time_spec_t _lo_moved_at;
+        usrpLockBackoff _lock_backoff;  // when to poll lo_locked while _lo_settling
+        bool _start_pending;            // enabled, but the stream waits for the LO (capture thread)
+        retune_record_struct _settling;
+        boost::mutex _retune_history_lock;
+        std::deque<retune_record_struct> _retune_history; // protected by _retune_history_lock
+        uhd::tune_request_t planTune(double frequency, double passband, double needed_bandwidth, bool& cached);
+        void noteRetune(double frequency, const uhd::tune_result_t& result, bool cached, const uhd::time_spec_t& when);
+        void checkLoSettled();
+        bool pollLoLock();
+        bool startPendingStream();
+        void loSettled(double settle_time);
+        void addRetuneRecord(const retune_record_struct& record);
+        std::vector<retune_record_struct> getRetuneHistory();
+
+        // scan state, protected by tuner_lock
+        bool _scan_request_set;         // the allocation being made is a scanner allocation
+        frontend::frontend_scanner_allocation_struct _scan_request;
+        bool _scan_allocated;
+        frontend::frontend_scanner_allocation_struct _scan_allocation;
+        boost::shared_ptr<frontend::ScanStrategy> _scan_strategy;
+        BULKIO::PrecisionUTCTime _scan_start_time; // tcstatus TCS_INVALID to start right away
+        usrpScanPlan _scan_plan;
+        uint64_t _scan_dwell;           // hardware samples per hop
+        bool _scan_armed;               // hops still to issue
+        bool _scan_scheduled;           // _scan_origin and _scan_hops are set
+        uhd::time_spec_t _scan_origin;  // hop n lands at _scan_origin + n*_scan_dwell samples
+        uint64_t _scan_hops;            // the next hop to issue
+        uhd::time_spec_t _scan_first;   // the first hop issued
+        bool validateScanRequest(const frontend::frontend_tuner_allocation_struct& request);
+        void resetScan();
+        void scheduleScanHops();
+
         float auto_gain();
-        void updateDeviceRxGain(double gain, bool lock);
+        bool updateDeviceRxGain(double gain, bool lock);
+        void updateDeviceRxGainTimed(double gain, const uhd::time_spec_t& when);
+        usrp_command_lock_t _command_lock;
+
+        // continuous AGC, run by the capture thread
+        AgcEngine _agc;
+        bool _agc_running;
+        bool _agc_pending; // a timed gain change has been issued but not yet seen in the data
+        uhd::time_spec_t _agc_pending_time;
+        void runAgc(const usrpRxBlock& block);
         void getStreamId();
+        void pushOutputSRI(const BULKIO::StreamSRI& sri);
+        void deviceModeChanged(std::string old_value, std::string new_value);
+
+        // samples were lost between the previous block and this one, so filter history is stale
+        bool egressDiscontinuity();
+        bool _egress_gap;
+        size_t _egress_drops;
+
+        // software resampling to the allocated rate (rx_exact_rate), run by the service function
+        rationalResampler _resampler;
+        bool _resampling;
+        boost::mutex _resampler_lock;
+        usrpBufferPool _resample_pool;
+        redhawk::shared_buffer<short> resample(const redhawk::shared_buffer<short>& data, bool discontinuity, BULKIO::PrecisionUTCTime& time);
+
+        // filterbank, run by the service function while any of its DDCs is active
+        pfbChannelizer _channelizer;
+        std::vector<DDC_ns::DDC_i*> _ddcs;
+        std::atomic<bool> _tuned;               // this RDC holds a tuning its DDCs, SRDC and DRDC can use
+        std::atomic<bool> _channelizer_restart; // drop the filter history before the next block
+        void runChannelizer(const redhawk::shared_buffer<short>& data, bool discontinuity, const BULKIO::PrecisionUTCTime& time);
+        void notifyChildren(bool tuned);
+
+        // SRDC fed by the service function, or holding the channel for timed bursts while this RDC is unallocated
+        SRDC_ns::SRDC_i* _srdc;
+        bool _snapshot_reserved; // protected by tuner_lock
+
+        // DRDC fed by the service function
+        DRDC_ns::DRDC_i* _drdc;
+
+        // per-connection queues for dataShort_out (listener_fanout), fed by the service function
+        listenerFanout _fanout;
+        std::atomic<bool> _fanout_enabled; // changed only by the service function
+        std::atomic<bool> _fanout_sync;    // connections changed; resync before the next write
+        void updateFanout();
+        void configureListeners();
+        void listenerConnected(const std::string& connection_id);
+        void listenerDisconnected(const std::string& connection_id);
+        void listenerPolicyChanged(std::string old_value, std::string new_value);
+        void listenerSizeChanged(CORBA::ULong old_value, CORBA::ULong new_value);
+        void listenerPoliciesChanged(const std::vector<listener_policy_struct_struct>& old_value, const std::vector<listener_policy_struct_struct>& new_value);
+        std::vector<listener_status_struct_struct> getListenerStatus();
+
+        // time spent in each stage of the RX path (latency_stats), always recorded
+        enum latencyStage {
+            LATENCY_RECV,
+            LATENCY_AUTO_GAIN,
+            LATENCY_CAPTURE,
+            LATENCY_RING,
+            LATENCY_SRI,
+            LATENCY_RESAMPLE,
+            LATENCY_WRITE,
+            LATENCY_SERVICE,
+            LATENCY_STAGES
+        };
+        latencyHistogram _latency[LATENCY_STAGES];
+        std::vector<latency_stat_struct_struct> getLatencyStats();
+        void latencyResetChanged(bool old_value, bool new_value);
+
+        // DeviceStatus_out events, sent from the dispatcher's thread so the capture
+        // and service threads never wait on a consumer
+        statusDispatcher<deviceStatusTraits> _status;
+        void postStatus(CF::DeviceStatusCode code, const std::string& message);
+        void sendStatus(const CF::DeviceStatusType& status, const std::string& connection_id);
+        std::vector<std::string> statusConnections();
+        void statusMaxRateChanged(float old_value, float new_value);
+
+        // SigMF recording of the captured buffers (record_enable), fed by the capture thread.
+        // A recording is closed (its backlog drained) on a thread of its own, so neither
+        // the capture thread nor the service function waits on the disk
+        boost::mutex _recorder_lock;            // down to _recorder_closers
+        boost::shared_ptr<iqRecorder> _recorder;        // being fed
+        boost::shared_ptr<iqRecorder> _recorder_last;   // fed last, for the record_ statistics
+        std::vector<boost::shared_ptr<boost::thread> > _recorder_closers;
+        std::atomic<bool> _record_wanted;       // record_enable, for the capture thread
+        std::atomic<bool> _record_failed;       // the service function turns record_enable off
+        bool _record_dropping;                  // capture thread: the recorder dropped the last buffer offered
+        bool _record_gap;                       // capture thread: the last buffer was cut short by an overflow
+        bool recordBlock(const usrpRxBlock& block);
+        boost::shared_ptr<iqRecorder> openRecorder(const BULKIO::PrecisionUTCTime& time);
+        void retireRecorder();
+        void closeRecorder(boost::shared_ptr<iqRecorder> recorder);
+        void joinRecorderClosers();
+        void recordEnableChanged(bool old_value, bool new_value);
+        boost::shared_ptr<iqRecorder> reportedRecorder(bool& current);
+        std::string getRecordFile();
+        std::string getRecordIoMode();
+        CORBA::ULong getRecordBacklog();
+        CORBA::ULong getRecordDroppedBlocks();
+        CORBA::ULongLong getRecordBytesWritten();
+
+        // bursts on dataBurst_out (burst_detect_enable), cut out by the service function
+        burstDetector _bursts;
+        burstSettings _burst_settings;          // as last configured
+        bool _burst_configured;
+        bulkio::OutShortStream _burst_stream;
+        BULKIO::PrecisionUTCTime _burst_start_time;
+        void runBurstDetector(const redhawk::shared_buffer<short>& data, const sc16Stats* stats, bool discontinuity, const BULKIO::PrecisionUTCTime& time);
+        void sendBurstStatus(const burstChunk& chunk, const std::string& stream_id, const BULKIO::PrecisionUTCTime& end_time);
+
+        // averaged spectra on dataPSD_out (psd_enable); the service function offers the spectrum
+        // thread a block whenever it wants one, and never waits for it
+        spectrumTap _spectrum;                  // owned by the spectrum thread
+        boost::thread* _spectrum_thread;
+        std::atomic<bool> _spectrum_wanted;
+        boost::mutex _spectrum_lock;            // everything down to _spectrum_cond
+        bool _spectrum_running;
+        bool _spectrum_pending;                 // a block is waiting for the spectrum thread
+        redhawk::shared_buffer<short> _spectrum_data;
+        BULKIO::PrecisionUTCTime _spectrum_time;
+        std::string _spectrum_stream_id;        // output stream the block came from
+        double _spectrum_center_frequency;
+        double _spectrum_sample_rate;
+        boost::condition_variable _spectrum_cond;
+        void startSpectrum();
+        void stopSpectrum();
+        void spectrumThread();
+        void offerSpectrum(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time);
+
+        // SDDS output, sent by the service function straight from the ring buffers
+        sddsPacketizer _sdds;
+        boost::mutex _sdds_lock;
+        void startSdds();
+        void stopSdds();
         bool usrpEnable();
         usrpRangesStruct usrp_range;    // freq/bw/sr/gain ranges supported by each tuner channel
                                         // indices map to tuner_id
                                         // protected by prop_lock
+        bool validateTuning(const frontend::frontend_tuner_allocation_struct &request);
+        void tuneHardware(const frontend::frontend_tuner_allocation_struct &request, double& center_frequency, double& bandwidth, double& sample_rate);
         double optimizeRate(const double& req_rate);
         double optimizeBandwidth(const double& req_bw);
 
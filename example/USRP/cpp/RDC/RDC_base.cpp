@@ -52,6 +52,14 @@ RDC_base::~RDC_base()
     dataShort_out = 0;
     dataSDDS_out->_remove_ref();
     dataSDDS_out = 0;
+    dataOctet_out->_remove_ref();
+    dataOctet_out = 0;
+    dataFloat_out->_remove_ref();
+    dataFloat_out = 0;
+    dataPSD_out->_remove_ref();
+    dataPSD_out = 0;
+    dataBurst_out->_remove_ref();
+    dataBurst_out = 0;
 }
 
 void RDC_base::construct()
@@ -73,6 +81,18 @@ void RDC_base::construct()
     dataSDDS_out = new bulkio::OutSDDSPort("dataSDDS_out");
     dataSDDS_out->setLogger(this->_baseLog->getChildLogger("dataSDDS_out", "ports"));
     addPort("dataSDDS_out", dataSDDS_out);
+    dataOctet_out = new bulkio::OutOctetPort("dataOctet_out");
+    dataOctet_out->setLogger(this->_baseLog->getChildLogger("dataOctet_out", "ports"));
+    addPort("dataOctet_out", dataOctet_out);
+    dataFloat_out = new bulkio::OutFloatPort("dataFloat_out");
+    dataFloat_out->setLogger(this->_baseLog->getChildLogger("dataFloat_out", "ports"));
+    addPort("dataFloat_out", dataFloat_out);
+    dataPSD_out = new bulkio::OutFloatPort("dataPSD_out");
+    dataPSD_out->setLogger(this->_baseLog->getChildLogger("dataPSD_out", "ports"));
+    addPort("dataPSD_out", dataPSD_out);
+    dataBurst_out = new bulkio::OutShortPort("dataBurst_out");
+    dataBurst_out->setLogger(this->_baseLog->getChildLogger("dataBurst_out", "ports"));
+    addPort("dataBurst_out", dataBurst_out);
     this->setHost(this);
 
 }
@@ -155,6 +175,515 @@ void RDC_base::loadProperties()
                 "external",
                 "property");
 
+    addProperty(rx_ring_depth,
+                16,
+                "rx_ring_depth",
+                "rx_ring_depth",
+                "readwrite",
+                "buffers",
+                "external",
+                "property");
+
+    addProperty(rx_ring_fill,
+                0,
+                "rx_ring_fill",
+                "rx_ring_fill",
+                "readonly",
+                "buffers",
+                "external",
+                "property");
+
+    addProperty(rx_ring_drops,
+                0,
+                "rx_ring_drops",
+                "rx_ring_drops",
+                "readonly",
+                "buffers",
+                "external",
+                "property");
+
+    addProperty(rx_peak_magnitude,
+                0,
+                "rx_peak_magnitude",
+                "rx_peak_magnitude",
+                "readonly",
+                "",
+                "external",
+                "property");
+
+    addProperty(rx_power_dbfs,
+                -200,
+                "rx_power_dbfs",
+                "rx_power_dbfs",
+                "readonly",
+                "dBFS",
+                "external",
+                "property");
+
+    addProperty(rx_clip_count,
+                0,
+                "rx_clip_count",
+                "rx_clip_count",
+                "readonly",
+                "",
+                "external",
+                "property");
+
+    addProperty(rx_agc_enable,
+                false,
+                "rx_agc_enable",
+                "rx_agc_enable",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(rx_agc_target_dbfs,
+                -15,
+                "rx_agc_target_dbfs",
+                "rx_agc_target_dbfs",
+                "readwrite",
+                "dBFS",
+                "external",
+                "property");
+
+    addProperty(rx_agc_attack_db,
+                6,
+                "rx_agc_attack_db",
+                "rx_agc_attack_db",
+                "readwrite",
+                "dB",
+                "external",
+                "property");
+
+    addProperty(rx_agc_decay_db,
+                1,
+                "rx_agc_decay_db",
+                "rx_agc_decay_db",
+                "readwrite",
+                "dB",
+                "external",
+                "property");
+
+    addProperty(rx_agc_hysteresis_db,
+                3,
+                "rx_agc_hysteresis_db",
+                "rx_agc_hysteresis_db",
+                "readwrite",
+                "dB",
+                "external",
+                "property");
+
+    addProperty(rx_agc_max_rate,
+                5,
+                "rx_agc_max_rate",
+                "rx_agc_max_rate",
+                "readwrite",
+                "Hz",
+                "external",
+                "property");
+
+    addProperty(rx_agc_decimation,
+                4,
+                "rx_agc_decimation",
+                "rx_agc_decimation",
+                "readwrite",
+                "buffers",
+                "external",
+                "property");
+
+    addProperty(max_latency_ms,
+                0,
+                "max_latency_ms",
+                "max_latency_ms",
+                "readwrite",
+                "ms",
+                "external",
+                "property");
+
+    addProperty(sdds_ip_address,
+                "",
+                "sdds_ip_address",
+                "sdds_ip_address",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(sdds_port,
+                29495,
+                "sdds_port",
+                "sdds_port",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(sdds_interface,
+                "",
+                "sdds_interface",
+                "sdds_interface",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(sdds_ttl,
+                1,
+                "sdds_ttl",
+                "sdds_ttl",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(sdds_frames_sent,
+                0,
+                "sdds_frames_sent",
+                "sdds_frames_sent",
+                "readonly",
+                "frames",
+                "external",
+                "property");
+
+    addProperty(sdds_send_errors,
+                0,
+                "sdds_send_errors",
+                "sdds_send_errors",
+                "readonly",
+                "frames",
+                "external",
+                "property");
+
+    addProperty(rx_exact_rate,
+                false,
+                "rx_exact_rate",
+                "rx_exact_rate",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(rx_hardware_sample_rate,
+                0,
+                "rx_hardware_sample_rate",
+                "rx_hardware_sample_rate",
+                "readonly",
+                "Hz",
+                "external",
+                "property");
+
+    addProperty(listener_fanout,
+                false,
+                "listener_fanout",
+                "listener_fanout",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(listener_policy,
+                "block",
+                "listener_policy",
+                "listener_policy",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(listener_queue_depth,
+                32,
+                "listener_queue_depth",
+                "listener_queue_depth",
+                "readwrite",
+                "packets",
+                "external",
+                "property");
+
+    addProperty(listener_decimation,
+                4,
+                "listener_decimation",
+                "listener_decimation",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(listener_policies,
+                "listener_policies",
+                "listener_policies",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(listener_status,
+                "listener_status",
+                "listener_status",
+                "readonly",
+                "",
+                "external",
+                "property");
+
+    addProperty(psd_enable,
+                false,
+                "psd_enable",
+                "psd_enable",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(psd_fft_size,
+                1024,
+                "psd_fft_size",
+                "psd_fft_size",
+                "readwrite",
+                "samples",
+                "external",
+                "property");
+
+    addProperty(psd_overlap,
+                0.5,
+                "psd_overlap",
+                "psd_overlap",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(psd_averages,
+                8,
+                "psd_averages",
+                "psd_averages",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(psd_frame_rate,
+                10.0,
+                "psd_frame_rate",
+                "psd_frame_rate",
+                "readwrite",
+                "Hz",
+                "external",
+                "property");
+
+    addProperty(burst_detect_enable,
+                false,
+                "burst_detect_enable",
+                "burst_detect_enable",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(burst_threshold_dbfs,
+                -40.0,
+                "burst_threshold_dbfs",
+                "burst_threshold_dbfs",
+                "readwrite",
+                "dBFS",
+                "external",
+                "property");
+
+    addProperty(burst_hysteresis_db,
+                3.0,
+                "burst_hysteresis_db",
+                "burst_hysteresis_db",
+                "readwrite",
+                "dB",
+                "external",
+                "property");
+
+    addProperty(burst_window,
+                256,
+                "burst_window",
+                "burst_window",
+                "readwrite",
+                "samples",
+                "external",
+                "property");
+
+    addProperty(burst_trigger_windows,
+                2,
+                "burst_trigger_windows",
+                "burst_trigger_windows",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(burst_hangover,
+                0.001,
+                "burst_hangover",
+                "burst_hangover",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(burst_pre_trigger,
+                0.0005,
+                "burst_pre_trigger",
+                "burst_pre_trigger",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(burst_max_length,
+                0.0,
+                "burst_max_length",
+                "burst_max_length",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(burst_status_events,
+                false,
+                "burst_status_events",
+                "burst_status_events",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(burst_only,
+                false,
+                "burst_only",
+                "burst_only",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(bursts_detected,
+                0,
+                "bursts_detected",
+                "bursts_detected",
+                "readonly",
+                "",
+                "external",
+                "property");
+
+    addProperty(record_enable,
+                false,
+                "record_enable",
+                "record_enable",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(record_directory,
+                "/var/tmp",
+                "record_directory",
+                "record_directory",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(record_queue_depth,
+                64,
+                "record_queue_depth",
+                "record_queue_depth",
+                "readwrite",
+                "buffers",
+                "external",
+                "property");
+
+    addProperty(record_file,
+                "",
+                "record_file",
+                "record_file",
+                "readonly",
+                "",
+                "external",
+                "property");
+
+    addProperty(record_io_mode,
+                "",
+                "record_io_mode",
+                "record_io_mode",
+                "readonly",
+                "",
+                "external",
+                "property");
+
+    addProperty(record_backlog,
+                0,
+                "record_backlog",
+                "record_backlog",
+                "readonly",
+                "buffers",
+                "external",
+                "property");
+
+    addProperty(record_dropped_blocks,
+                0,
+                "record_dropped_blocks",
+                "record_dropped_blocks",
+                "readonly",
+                "buffers",
+                "external",
+                "property");
+
+    addProperty(record_bytes_written,
+                0,
+                "record_bytes_written",
+                "record_bytes_written",
+                "readonly",
+                "bytes",
+                "external",
+                "property");
+
+    addProperty(status_max_rate,
+                10,
+                "status_max_rate",
+                "status_max_rate",
+                "readwrite",
+                "Hz",
+                "external",
+                "property");
+
+    addProperty(latency_reset,
+                false,
+                "latency_reset",
+                "latency_reset",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(latency_stats,
+                "latency_stats",
+                "latency_stats",
+                "readonly",
+                "",
+                "external",
+                "property");
+
+    addProperty(fast_retune,
+                true,
+                "fast_retune",
+                "fast_retune",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(retune_history,
+                "retune_history",
+                "retune_history",
+                "readonly",
+                "",
+                "external",
+                "property");
+
     frontend_listener_allocation = frontend::frontend_listener_allocation_struct();
     frontend_tuner_allocation = frontend::frontend_tuner_allocation_struct();
     addProperty(device_characteristics,
@@ -51,6 +51,120 @@ class RDC_base : public frontend::FrontendTunerDevice<frontend_tuner_status_stru
         float device_gain;
         /// Property: device_mode
         std::string device_mode;
+        /// Property: rx_ring_depth
+        CORBA::ULong rx_ring_depth;
+        /// Property: rx_ring_fill
+        CORBA::ULong rx_ring_fill;
+        /// Property: rx_ring_drops
+        CORBA::ULong rx_ring_drops;
+        /// Property: rx_peak_magnitude
+        unsigned short rx_peak_magnitude;
+        /// Property: rx_power_dbfs
+        float rx_power_dbfs;
+        /// Property: rx_clip_count
+        CORBA::ULong rx_clip_count;
+        /// Property: rx_agc_enable
+        bool rx_agc_enable;
+        /// Property: rx_agc_target_dbfs
+        float rx_agc_target_dbfs;
+        /// Property: rx_agc_attack_db
+        float rx_agc_attack_db;
+        /// Property: rx_agc_decay_db
+        float rx_agc_decay_db;
+        /// Property: rx_agc_hysteresis_db
+        float rx_agc_hysteresis_db;
+        /// Property: rx_agc_max_rate
+        float rx_agc_max_rate;
+        /// Property: rx_agc_decimation
+        CORBA::ULong rx_agc_decimation;
+        /// Property: max_latency_ms
+        CORBA::ULong max_latency_ms;
+        /// Property: sdds_ip_address
+        std::string sdds_ip_address;
+        /// Property: sdds_port
+        unsigned short sdds_port;
+        /// Property: sdds_interface
+        std::string sdds_interface;
+        /// Property: sdds_ttl
+        unsigned short sdds_ttl;
+        /// Property: sdds_frames_sent
+        CORBA::ULong sdds_frames_sent;
+        /// Property: sdds_send_errors
+        CORBA::ULong sdds_send_errors;
+        /// Property: rx_exact_rate
+        bool rx_exact_rate;
+        /// Property: rx_hardware_sample_rate
+        double rx_hardware_sample_rate;
+        /// Property: listener_fanout
+        bool listener_fanout;
+        /// Property: listener_policy
+        std::string listener_policy;
+        /// Property: listener_queue_depth
+        CORBA::ULong listener_queue_depth;
+        /// Property: listener_decimation
+        CORBA::ULong listener_decimation;
+        /// Property: listener_policies
+        std::vector<listener_policy_struct_struct> listener_policies;
+        /// Property: listener_status
+        std::vector<listener_status_struct_struct> listener_status;
+        /// Property: psd_enable
+        bool psd_enable;
+        /// Property: psd_fft_size
+        CORBA::ULong psd_fft_size;
+        /// Property: psd_overlap
+        float psd_overlap;
+        /// Property: psd_averages
+        CORBA::ULong psd_averages;
+        /// Property: psd_frame_rate
+        float psd_frame_rate;
+        /// Property: burst_detect_enable
+        bool burst_detect_enable;
+        /// Property: burst_threshold_dbfs
+        float burst_threshold_dbfs;
+        /// Property: burst_hysteresis_db
+        float burst_hysteresis_db;
+        /// Property: burst_window
+        CORBA::ULong burst_window;
+        /// Property: burst_trigger_windows
+        CORBA::ULong burst_trigger_windows;
+        /// Property: burst_hangover
+        double burst_hangover;
+        /// Property: burst_pre_trigger
+        double burst_pre_trigger;
+        /// Property: burst_max_length
+        double burst_max_length;
+        /// Property: burst_status_events
+        bool burst_status_events;
+        /// Property: burst_only
+        bool burst_only;
+        /// Property: bursts_detected
+        CORBA::ULong bursts_detected;
+        /// Property: record_enable
+        bool record_enable;
+        /// Property: record_directory
+        std::string record_directory;
+        /// Property: record_queue_depth
+        CORBA::ULong record_queue_depth;
+        /// Property: record_file
+        std::string record_file;
+        /// Property: record_io_mode
+        std::string record_io_mode;
+        /// Property: record_backlog
+        CORBA::ULong record_backlog;
+        /// Property: record_dropped_blocks
+        CORBA::ULong record_dropped_blocks;
+        /// Property: record_bytes_written
+        CORBA::ULongLong record_bytes_written;
+        /// Property: status_max_rate
+        float status_max_rate;
+        /// Property: latency_reset
+        bool latency_reset;
+        /// Property: latency_stats
+        std::vector<latency_stat_struct_struct> latency_stats;
+        /// Property: fast_retune
+        bool fast_retune;
+        /// Property: retune_history
+        std::vector<retune_record_struct> retune_history;
         /// Property: device_characteristics
         device_characteristics_struct device_characteristics;
 
@@ -65,6 +179,14 @@ class RDC_base : public frontend::FrontendTunerDevice<frontend_tuner_status_stru
         bulkio::OutShortPort *dataShort_out;
         /// Port: dataSDDS_out
         bulkio::OutSDDSPort *dataSDDS_out;
+        /// Port: dataOctet_out
+        bulkio::OutOctetPort *dataOctet_out;
+        /// Port: dataFloat_out
+        bulkio::OutFloatPort *dataFloat_out;
+        /// Port: dataPSD_out
+        bulkio::OutFloatPort *dataPSD_out;
+        /// Port: dataBurst_out
+        bulkio::OutShortPort *dataBurst_out;
 
         std::map<std::string, std::string> listeners;
 
@@ -0,0 +1,63 @@
+#include "agc_engine.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace RDC_ns;
+
+AgcEngine::AgcEngine()
+{
+    reset();
+}
+
+void AgcEngine::reset()
+{
+    _buffers = 0;
+    _window.reset();
+    _measured_dbfs = -200;
+    _last_change = 0;
+    _changed = false;
+}
+
+bool AgcEngine::update(const agcSettings& settings, const sc16Stats& stats, uint16_t full_scale, double buffer_time,
+                       float current_gain, float min_gain, float max_gain, float& new_gain)
+{
+    // accumulate the decimation window
+    _window.num_samps += stats.num_samps;
+    _window.power_sum += stats.power_sum;
+    _window.clip_count += stats.clip_count;
+    _window.peak = std::max(_window.peak, stats.peak);
+    if (++_buffers < std::max(settings.decimation, size_t(1)))
+        return false;
+
+    _measured_dbfs = _window.powerDbfs(full_scale);
+    const bool clipped = (_window.clip_count > 0);
+    _buffers = 0;
+    _window.reset();
+
+    // rate limit against sample time so a backlog of buffers doesn't bunch up changes
+    if (_changed and (settings.max_rate > 0) and ((buffer_time - _last_change) < (1.0/settings.max_rate)))
+        return false;
+
+    float step = 0;
+    if (clipped) {
+        step = -settings.attack_db;
+    } else {
+        const float error = settings.target_dbfs - _measured_dbfs;
+        if (std::fabs(error) <= settings.hysteresis_db)
+            return false;
+        if (error > 0) {
+            step = std::min(error, settings.decay_db);
+        } else {
+            step = std::max(error, -settings.attack_db);
+        }
+    }
+
+    new_gain = std::max(min_gain, std::min(max_gain, current_gain+step));
+    if (new_gain == current_gain)
+        return false;
+
+    _last_change = buffer_time;
+    _changed = true;
+    return true;
+}
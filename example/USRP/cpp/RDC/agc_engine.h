@@ -0,0 +1,61 @@
+#ifndef AGC_ENGINE_H
+#define AGC_ENGINE_H
+
+#include <cstddef>
+#include "../sample_stats.h"
+
+namespace RDC_ns {
+
+struct agcSettings {
+    agcSettings(){
+        target_dbfs = -15;
+        attack_db = 6;
+        decay_db = 1;
+        hysteresis_db = 3;
+        max_rate = 5;
+        decimation = 4;
+    }
+
+    float target_dbfs;   // desired mean power
+    float attack_db;     // largest gain reduction applied in one step
+    float decay_db;      // largest gain increase applied in one step
+    float hysteresis_db; // no change while the level is within this of the target
+    float max_rate;      // most gain changes per second of sample time
+    size_t decimation;   // buffers of statistics averaged per decision
+};
+
+/*
+ * Closed-loop AGC working off the per-buffer sc16 statistics.
+ *  - statistics are averaged over settings.decimation buffers
+ *  - any clipping in the window forces a full attack step
+ *  - otherwise the gain moves toward the target by at most attack_db/decay_db
+ *  - decisions are rate limited against the (device) timestamps of the buffers
+ */
+class AgcEngine {
+    public:
+        AgcEngine();
+
+        void reset();
+
+        /* feed one buffer's statistics, timestamped in seconds of sample time
+         * returns true and sets new_gain when a gain change is warranted
+         */
+        bool update(const agcSettings& settings, const sc16Stats& stats, uint16_t full_scale, double buffer_time,
+                    float current_gain, float min_gain, float max_gain, float& new_gain);
+
+        // level (dBFS) the last decision was based on
+        float measuredLevel() const {
+            return _measured_dbfs;
+        }
+
+    private:
+        size_t _buffers;
+        sc16Stats _window;
+        float _measured_dbfs;
+        double _last_change;
+        bool _changed;
+};
+
+};
+
+#endif // AGC_ENGINE_H
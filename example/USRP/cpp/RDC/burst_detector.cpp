@@ -0,0 +1,154 @@
+#include "burst_detector.h"
+
+#include <algorithm>
+
+using namespace RDC_ns;
+
+burstDetector::burstDetector() :
+    _position(0),
+    _active(false),
+    _burst_id(0),
+    _burst_start(0),
+    _emitted(0),
+    _last_hot_end(0),
+    _peak_power(0),
+    _first_pending(false),
+    _hot_run(0),
+    _run_start(0)
+{
+}
+
+bool burstDetector::configure(const burstSettings& settings)
+{
+    if (settings.window == 0)
+        return false;
+    _settings = settings;
+    _settings.trigger_windows = std::max(settings.trigger_windows, size_t(1));
+    reset();
+    return true;
+}
+
+void burstDetector::reset()
+{
+    _previous = redhawk::shared_buffer<short>();
+    _position = 0;
+    _active = false;
+    _hot_run = 0;
+}
+
+void burstDetector::process(const redhawk::shared_buffer<short>& data, const sc16Stats* stats, bool discontinuity, std::vector<burstChunk>& chunks)
+{
+    if (_settings.window == 0)
+        return;
+
+    if (discontinuity) {
+        if (_active) {
+            emit(_emitted, true, data, chunks);
+            _active = false;
+        }
+        _previous = redhawk::shared_buffer<short>();
+        _hot_run = 0;
+    }
+
+    const size_t num_samps = data.size()/2;
+    const uint64_t base = _position;
+    const uint64_t earliest = base - _previous.size()/2;
+
+    // no window can reach on_power if twice the peak squared (full scale I and Q) doesn't
+    bool quiet = false;
+    if ((not _active) and (stats != NULL)) {
+        const double peak = stats->peak;
+        quiet = (2*peak*peak < _settings.on_power);
+    }
+
+    sc16Stats window_stats;
+    for (size_t w=0; (w<num_samps) and (not quiet); w+=_settings.window) {
+        const size_t len = std::min(_settings.window, num_samps-w);
+        sc16_stats(data.data()+2*w, 2*len, 0xffff, window_stats);
+        const double power = window_stats.meanPower();
+        const uint64_t window_start = base + w;
+        const uint64_t window_end = window_start + len;
+
+        if (not _active) {
+            if (power < _settings.on_power) {
+                _hot_run = 0;
+                continue;
+            }
+            if (_hot_run++ == 0)
+                _run_start = window_start;
+            if (_hot_run < _settings.trigger_windows)
+                continue;
+            _active = true;
+            _burst_id++;
+            _burst_start = std::max(earliest, (_run_start > _settings.pre_trigger) ? _run_start-_settings.pre_trigger : 0);
+            _emitted = _burst_start;
+            _last_hot_end = window_end;
+            _peak_power = power;
+            _first_pending = true;
+            _hot_run = 0;
+            continue;
+        }
+
+        if (power >= _settings.off_power) {
+            _last_hot_end = window_end;
+            _peak_power = std::max(_peak_power, power);
+        }
+        const uint64_t end = _last_hot_end + _settings.hangover;
+        if (window_end >= end) {
+            emit(end, true, data, chunks);
+            _active = false;
+        } else if ((_settings.max_length > 0) and (window_end - _burst_start >= _settings.max_length)) {
+            emit(window_end, true, data, chunks);
+            _active = false;
+        }
+    }
+    if (quiet)
+        _hot_run = 0;
+
+    // hand out what the block holds of a burst still in progress
+    if (_active)
+        emit(base + num_samps, false, data, chunks);
+
+    _previous = data;
+    _position += num_samps;
+}
+
+/* hands out the burst from _emitted up to to, as a slice of the previous
+ * block and/or one of data
+ */
+void burstDetector::emit(uint64_t to, bool last, const redhawk::shared_buffer<short>& data, std::vector<burstChunk>& chunks)
+{
+    const uint64_t base = _position;
+    const uint64_t previous_start = base - _previous.size()/2;
+
+    burstChunk chunk;
+    chunk.burst_id = _burst_id;
+    chunk.peak_power = _peak_power;
+
+    bool ended = false;
+    if ((_emitted < base) and (_emitted < to)) {
+        const uint64_t stop = std::min(to, base);
+        chunk.data = _previous.slice(2*(_emitted-previous_start), 2*(stop-previous_start));
+        chunk.offset = -long(base - _emitted);
+        chunk.first = _first_pending;
+        chunk.last = ended = (last and (stop == to));
+        chunk.length = stop - _burst_start;
+        chunks.push_back(chunk);
+        _first_pending = false;
+        _emitted = stop;
+    }
+    if ((_emitted < to) or (last and not ended)) {
+        if (_emitted < to) {
+            chunk.data = data.slice(2*(_emitted-base), 2*(to-base));
+        } else {
+            chunk.data = redhawk::shared_buffer<short>();
+        }
+        chunk.offset = long(_emitted) - long(base);
+        chunk.first = _first_pending;
+        chunk.last = last;
+        chunk.length = to - _burst_start;
+        chunks.push_back(chunk);
+        _first_pending = false;
+        _emitted = to;
+    }
+}
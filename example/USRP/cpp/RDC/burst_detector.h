@@ -0,0 +1,91 @@
+#ifndef BURST_DETECTOR_H
+#define BURST_DETECTOR_H
+
+#include <ossie/shared_buffer.h>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+#include "../sample_stats.h"
+
+namespace RDC_ns {
+
+struct burstSettings {
+    burstSettings() : window(0), on_power(0), off_power(0), trigger_windows(1), hangover(0), pre_trigger(0), max_length(0) {}
+    size_t window;          // samples per power measurement
+    double on_power;        // mean I^2+Q^2 over a window that counts toward starting a burst
+    double off_power;       // ... that keeps a burst going
+    size_t trigger_windows; // consecutive windows at on_power that start a burst
+    size_t hangover;        // samples below off_power before a burst ends; they are part of the burst
+    size_t pre_trigger;     // samples ahead of the first triggering window included in the burst
+    size_t max_length;      // samples after which a burst is cut; 0 for no limit
+
+    bool operator!=(const burstSettings& other) const {
+        return (window != other.window) or (on_power != other.on_power) or (off_power != other.off_power) or
+               (trigger_windows != other.trigger_windows) or (hangover != other.hangover) or
+               (pre_trigger != other.pre_trigger) or (max_length != other.max_length);
+    }
+};
+
+// part of a burst found in one call to burstDetector::process()
+struct burstChunk {
+    uint64_t burst_id;
+    redhawk::shared_buffer<short> data; // slice of the block (or the one before it)
+    long offset;                        // first sample, relative to the first sample of the block
+    bool first;                         // data starts the burst
+    bool last;                          // data ends the burst (and may be empty)
+    size_t length;                      // samples in the burst so far
+    double peak_power;                  // highest window power in the burst so far
+};
+
+/*
+ * Energy detector that cuts bursts out of a complex sc16 stream.
+ *  - power is measured over fixed windows with sc16_stats(), and a block whose
+ *    capture stats rule out any window reaching on_power is skipped outright
+ *    while no burst is in progress
+ *  - a burst starts pre_trigger samples before trigger_windows consecutive
+ *    windows at on_power, and ends hangover samples after the last window at
+ *    off_power (or after max_length samples)
+ *  - the chunks refer to the blocks passed in, so no samples are copied; the
+ *    pre-trigger samples may come from the previous block, which is held
+ *    until the next call
+ */
+class burstDetector {
+    public:
+        burstDetector();
+
+        // window must be >= 1
+        bool configure(const burstSettings& settings);
+        // forgets the previous block and any burst in progress, without ending it
+        void reset();
+
+        bool active() const {
+            return _active;
+        }
+
+        /* examines data, a block that follows the previous one unless
+         * discontinuity is set; stats are its capture statistics, or NULL if
+         * they don't describe data. A burst in progress at a discontinuity ends
+         * with an empty chunk
+         */
+        void process(const redhawk::shared_buffer<short>& data, const sc16Stats* stats, bool discontinuity, std::vector<burstChunk>& chunks);
+
+    private:
+        void emit(uint64_t to, bool last, const redhawk::shared_buffer<short>& data, std::vector<burstChunk>& chunks);
+
+        burstSettings _settings;
+        redhawk::shared_buffer<short> _previous;
+        uint64_t _position;         // sample count at the start of the block being processed
+        bool _active;
+        uint64_t _burst_id;
+        uint64_t _burst_start;
+        uint64_t _emitted;          // next sample of the burst to hand out
+        uint64_t _last_hot_end;     // end of the last window at off_power
+        double _peak_power;
+        bool _first_pending;        // no chunk of the burst has been handed out yet
+        size_t _hot_run;            // consecutive windows at on_power while idle
+        uint64_t _run_start;
+};
+
+};
+
+#endif // BURST_DETECTOR_H
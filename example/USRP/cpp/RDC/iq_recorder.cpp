@@ -0,0 +1,419 @@
+#include "iq_recorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace RDC_ns;
+
+namespace {
+    std::string isoTime(const BULKIO::PrecisionUTCTime& time)
+    {
+        time_t whole = time_t(time.twsec);
+        double frac = (time.twsec - whole) + time.tfsec;
+        if (frac >= 1.0) {
+            whole += 1;
+            frac -= 1.0;
+        }
+        struct tm utc;
+        gmtime_r(&whole, &utc);
+        char date[32];
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &utc);
+        char nanos[16];
+        snprintf(nanos, sizeof(nanos), ".%09ld", std::min(long(frac*1e9 + 0.5), 999999999L));
+        return std::string(date) + nanos + "Z";
+    }
+}
+
+iqRecorder::iqRecorder() :
+    _sample_rate(0),
+    _io_mode("buffered"),
+    _fd(-1),
+    _thread(NULL),
+    _current(NULL),
+    _fill(0),
+    _file_offset(0),
+    _samples(0),
+    _in_flight(0),
+    _captures_written(0),
+#ifdef HAVE_LIBURING
+    _uring(false),
+#endif
+    _running(false),
+    _depth(0),
+    _gap(false),
+    _last_frequency(0),
+    _dropped(0),
+    _written(0),
+    _failed(false)
+{
+}
+
+iqRecorder::~iqRecorder()
+{
+    close();
+}
+
+bool iqRecorder::open(const std::string& path, double sample_rate, size_t queue_depth, std::string& error)
+{
+    close();
+    if ((sample_rate <= 0) or (queue_depth == 0)) {
+        error = "the recording needs a sample rate and a queue";
+        return false;
+    }
+
+    const std::string data_path = path + ".sigmf-data";
+    _io_mode = "O_DIRECT";
+    int fd = ::open(data_path.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_DIRECT, 0644);
+    if ((fd < 0) and (errno == EINVAL)) {
+        // e.g. tmpfs
+        _io_mode = "buffered";
+        fd = ::open(data_path.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    }
+    if (fd < 0) {
+        error = "unable to create " + data_path + ": " + strerror(errno);
+        return false;
+    }
+
+    for (size_t i=0; i<STAGING_COUNT; i++) {
+        void* buffer = NULL;
+        if (posix_memalign(&buffer, ALIGNMENT, STAGING_BYTES) != 0) {
+            for (size_t j=0; j<_staging.size(); j++)
+                free(_staging[j]);
+            _staging.clear();
+            ::close(fd);
+            error = "unable to allocate the staging buffers";
+            return false;
+        }
+        _staging.push_back(static_cast<char*>(buffer));
+    }
+    _free = _staging;
+    _current = _free.back();
+    _free.pop_back();
+
+#ifdef HAVE_LIBURING
+    _uring = (io_uring_queue_init(STAGING_COUNT, &_ring, 0) == 0);
+    if (_uring)
+        _io_mode = "io_uring";
+#endif
+
+    _path = path;
+    _sample_rate = sample_rate;
+    _fd = fd;
+    _fill = 0;
+    _file_offset = 0;
+    _samples = 0;
+    _in_flight = 0;
+    _pending.clear();
+    _captures.clear();
+    _captures_written = 0;
+    _queue.clear();
+    _depth = queue_depth;
+    _gap = true;
+    _last_frequency = 0;
+    _dropped = 0;
+    _written = 0;
+    _failed = false;
+    _error.clear();
+    _running = true;
+    _thread = new boost::thread(&iqRecorder::run, this);
+    return true;
+}
+
+void iqRecorder::close()
+{
+    if (_thread == NULL)
+        return;
+    {
+        boost::mutex::scoped_lock lock(_lock);
+        _running = false;
+        _not_empty.notify_all();
+    }
+    // the writer drains the queue first
+    _thread->join();
+    delete _thread;
+    _thread = NULL;
+
+#ifdef HAVE_LIBURING
+    if (_uring)
+        io_uring_queue_exit(&_ring);
+    _uring = false;
+#endif
+    ::close(_fd);
+    _fd = -1;
+    for (size_t i=0; i<_staging.size(); i++)
+        free(_staging[i]);
+    _staging.clear();
+    _free.clear();
+    _current = NULL;
+}
+
+bool iqRecorder::write(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time, double center_frequency, bool discontinuity)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    if ((not _running) or _failed)
+        return false;
+    if (_queue.size() >= _depth) {
+        _dropped++;
+        _gap = true;
+        return false;
+    }
+    block next;
+    next.data = data;
+    next.time = time;
+    next.center_frequency = center_frequency;
+    next.new_capture = _gap or discontinuity or (center_frequency != _last_frequency);
+    _queue.push_back(next);
+    _gap = false;
+    _last_frequency = center_frequency;
+    _not_empty.notify_one();
+    return true;
+}
+
+size_t iqRecorder::backlog() const
+{
+    boost::mutex::scoped_lock lock(_lock);
+    return _queue.size();
+}
+
+uint64_t iqRecorder::dropped() const
+{
+    boost::mutex::scoped_lock lock(_lock);
+    return _dropped;
+}
+
+uint64_t iqRecorder::bytesWritten() const
+{
+    boost::mutex::scoped_lock lock(_lock);
+    return _written;
+}
+
+bool iqRecorder::failed(std::string& error) const
+{
+    boost::mutex::scoped_lock lock(_lock);
+    if (_failed)
+        error = _error;
+    return _failed;
+}
+
+void iqRecorder::fail(const std::string& error)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    if (not _failed)
+        _error = error;
+    _failed = true;
+    _queue.clear();
+}
+
+void iqRecorder::run()
+{
+    bool ok = true;
+    while (true) {
+        block next;
+        {
+            boost::mutex::scoped_lock lock(_lock);
+            while (_running and _queue.empty()) {
+                _not_empty.wait(lock);
+            }
+            if (_queue.empty())
+                break;
+            next = _queue.front();
+            _queue.pop_front();
+        }
+        if (not ok)
+            continue;
+
+        if (next.new_capture) {
+            capture entry;
+            entry.sample_start = _samples;
+            entry.time = next.time;
+            entry.center_frequency = next.center_frequency;
+            _captures.push_back(entry);
+            if ((_captures_written == 0) or (_captures.size() - _captures_written >= METADATA_CAPTURES))
+                writeMetadata();
+        }
+        const size_t bytes = next.data.size()*sizeof(short);
+        ok = append(reinterpret_cast<const char*>(next.data.data()), bytes);
+        _samples += next.data.size()/2;
+        boost::mutex::scoped_lock lock(_lock);
+        _written += bytes;
+    }
+    if (ok)
+        finish();
+    writeMetadata();
+}
+
+/* copies bytes into the staging buffers, sending each to disk as it fills */
+bool iqRecorder::append(const char* data, size_t bytes)
+{
+    while (bytes > 0) {
+        const size_t chunk = std::min(bytes, STAGING_BYTES - _fill);
+        memcpy(_current + _fill, data, chunk);
+        _fill += chunk;
+        data += chunk;
+        bytes -= chunk;
+        if ((_fill == STAGING_BYTES) and not submit(STAGING_BYTES))
+            return false;
+    }
+    return true;
+}
+
+/* writes the first bytes of _current at _file_offset and moves on to a free
+ * staging buffer
+ */
+bool iqRecorder::submit(size_t bytes)
+{
+#ifdef HAVE_LIBURING
+    if (_uring) {
+        struct io_uring_sqe* sqe = io_uring_get_sqe(&_ring);
+        while (sqe == NULL) {
+            if (not reap(true))
+                return false;
+            sqe = io_uring_get_sqe(&_ring);
+        }
+        io_uring_prep_write(sqe, _fd, _current, bytes, _file_offset);
+        io_uring_sqe_set_data(sqe, _current);
+        const int status = io_uring_submit(&_ring);
+        if (status < 0) {
+            fail(std::string("io_uring_submit failed: ") + strerror(-status));
+            return false;
+        }
+        _pending[_current] = bytes;
+        _in_flight++;
+        _file_offset += bytes;
+        _current = NULL;
+        while (_free.empty()) {
+            if (not reap(true))
+                return false;
+        }
+        _current = _free.back();
+        _free.pop_back();
+        _fill = 0;
+        return true;
+    }
+#endif
+    size_t done = 0;
+    while (done < bytes) {
+        const ssize_t count = pwrite(_fd, _current + done, bytes - done, _file_offset + done);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            fail(std::string("write failed: ") + strerror(errno));
+            return false;
+        }
+        done += count;
+    }
+    _file_offset += bytes;
+    _fill = 0;
+    return true;
+}
+
+/* collects a completed io_uring write, waiting for one if wait is set */
+bool iqRecorder::reap(bool wait)
+{
+#ifdef HAVE_LIBURING
+    if (_uring and (_in_flight > 0)) {
+        struct io_uring_cqe* cqe = NULL;
+        const int status = wait ? io_uring_wait_cqe(&_ring, &cqe) : io_uring_peek_cqe(&_ring, &cqe);
+        if (status == -EAGAIN)
+            return true;
+        if (status < 0) {
+            fail(std::string("io_uring_wait_cqe failed: ") + strerror(-status));
+            return false;
+        }
+        char* buffer = static_cast<char*>(io_uring_cqe_get_data(cqe));
+        const int result = cqe->res;
+        io_uring_cqe_seen(&_ring, cqe);
+        _in_flight--;
+        _free.push_back(buffer);
+        const size_t expected = _pending[buffer];
+        _pending.erase(buffer);
+        if (result < 0) {
+            fail(std::string("write failed: ") + strerror(-result));
+            return false;
+        }
+        if (size_t(result) != expected) {
+            fail("short write");
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+/* writes out the partly filled staging buffer, padded to the O_DIRECT
+ * alignment, waits for every write and trims the padding off the file
+ */
+bool iqRecorder::finish()
+{
+    bool ok = true;
+    if (_fill > 0) {
+        size_t bytes = _fill;
+        if (std::string(_io_mode) != "buffered") {
+            bytes = ((_fill + ALIGNMENT - 1)/ALIGNMENT)*ALIGNMENT;
+            memset(_current + _fill, 0, bytes - _fill);
+        }
+        ok = submit(bytes);
+    }
+    while (ok and (_in_flight > 0)) {
+        ok = reap(true);
+    }
+    if (ok and (ftruncate(_fd, _samples*2*sizeof(short)) != 0)) {
+        fail(std::string("unable to trim the recording: ") + strerror(errno));
+        ok = false;
+    }
+    return ok;
+}
+
+/* replaces <path>.sigmf-meta, through a temporary file so readers never see
+ * a partial one
+ */
+void iqRecorder::writeMetadata()
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    const char* datatype = "ci16_be";
+#else
+    const char* datatype = "ci16_le";
+#endif
+    _captures_written = _captures.size();
+    std::ostringstream meta;
+    meta << std::setprecision(15);
+    meta << "{\n";
+    meta << "  \"global\": {\n";
+    meta << "    \"core:datatype\": \"" << datatype << "\",\n";
+    meta << "    \"core:sample_rate\": " << _sample_rate << ",\n";
+    meta << "    \"core:version\": \"1.0.0\",\n";
+    meta << "    \"core:hw\": \"USRP\",\n";
+    meta << "    \"core:recorder\": \"USRP RDC\"\n";
+    meta << "  },\n";
+    meta << "  \"captures\": [";
+    for (size_t i=0; i<_captures.size(); i++) {
+        meta << ((i == 0) ? "\n" : ",\n");
+        meta << "    {\n";
+        meta << "      \"core:sample_start\": " << _captures[i].sample_start << ",\n";
+        meta << "      \"core:datetime\": \"" << isoTime(_captures[i].time) << "\",\n";
+        meta << "      \"core:frequency\": " << _captures[i].center_frequency << "\n";
+        meta << "    }";
+    }
+    meta << "\n  ],\n";
+    meta << "  \"annotations\": []\n";
+    meta << "}\n";
+
+    const std::string meta_path = _path + ".sigmf-meta";
+    const std::string temp_path = meta_path + ".tmp";
+    {
+        std::ofstream out(temp_path.c_str());
+        out << meta.str();
+        if (not out)
+            return;
+    }
+    rename(temp_path.c_str(), meta_path.c_str());
+}
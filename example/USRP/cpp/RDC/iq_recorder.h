@@ -0,0 +1,127 @@
+#ifndef IQ_RECORDER_H
+#define IQ_RECORDER_H
+
+#include <boost/thread.hpp>
+#include <bulkio/bulkio.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+namespace RDC_ns {
+
+/*
+ * Records sc16 blocks to a SigMF recording: <path>.sigmf-data holds the raw
+ * samples and <path>.sigmf-meta the sample rate plus one capture (first
+ * sample, time and center frequency) per retune or gap.
+ *  - write() only queues a reference to the block; a full queue drops it
+ *    rather than wait, and the next block starts a new capture
+ *  - a writer thread copies the blocks into aligned staging buffers that go
+ *    to disk with O_DIRECT, through io_uring with several writes in flight
+ *    when built with liburing, or pwrite() otherwise. Filesystems that refuse
+ *    O_DIRECT get buffered writes
+ *  - the metadata is written when the first capture is added, then every
+ *    METADATA_CAPTURES captures, and complete on close(), so scans and
+ *    frequent retunes don't rewrite it for every segment
+ */
+class iqRecorder {
+    public:
+        iqRecorder();
+        ~iqRecorder();
+
+        bool open(const std::string& path, double sample_rate, size_t queue_depth, std::string& error);
+        // writes out what is queued and the final metadata
+        void close();
+
+        bool isOpen() const {
+            return _thread != NULL;
+        }
+        double sampleRate() const {
+            return _sample_rate;
+        }
+        std::string dataPath() const {
+            return _path + ".sigmf-data";
+        }
+        // "io_uring", "O_DIRECT" or "buffered"
+        const char* ioMode() const {
+            return _io_mode;
+        }
+
+        // returns false if the block was dropped
+        bool write(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time, double center_frequency, bool discontinuity);
+
+        size_t backlog() const;
+        uint64_t dropped() const;
+        uint64_t bytesWritten() const;
+        // true once a write has failed; nothing more is recorded
+        bool failed(std::string& error) const;
+
+    private:
+        static const size_t ALIGNMENT = 4096;
+        static const size_t STAGING_BYTES = 4 << 20;
+        static const size_t STAGING_COUNT = 4;
+        static const size_t METADATA_CAPTURES = 64;
+
+        struct block {
+            redhawk::shared_buffer<short> data;
+            BULKIO::PrecisionUTCTime time;
+            double center_frequency;
+            bool new_capture;
+        };
+        struct capture {
+            uint64_t sample_start;
+            BULKIO::PrecisionUTCTime time;
+            double center_frequency;
+        };
+
+        void run();
+        bool append(const char* data, size_t bytes);
+        bool submit(size_t bytes);
+        bool reap(bool wait);
+        bool finish();
+        void fail(const std::string& error);
+        void writeMetadata();
+
+        std::string _path;
+        double _sample_rate;
+        const char* _io_mode;
+        int _fd;
+        boost::thread* _thread;
+
+        // writer thread only
+        std::vector<char*> _staging;
+        std::vector<char*> _free;   // staging buffers not being written
+        char* _current;             // staging buffer being filled
+        size_t _fill;
+        uint64_t _file_offset;      // where _current goes
+        uint64_t _samples;          // samples handed to append() so far
+        size_t _in_flight;
+        std::map<char*, size_t> _pending; // bytes of each staging buffer being written
+        std::vector<capture> _captures;
+        size_t _captures_written;   // in the metadata on disk
+#ifdef HAVE_LIBURING
+        struct io_uring _ring;
+        bool _uring;
+#endif
+
+        mutable boost::mutex _lock; // everything below
+        boost::condition_variable _not_empty;
+        bool _running;
+        size_t _depth;
+        std::deque<block> _queue;
+        bool _gap;                  // a block was dropped; the next one starts a capture
+        double _last_frequency;
+        uint64_t _dropped;
+        uint64_t _written;
+        bool _failed;
+        std::string _error;
+};
+
+};
+
+#endif // IQ_RECORDER_H
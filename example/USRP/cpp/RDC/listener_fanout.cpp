@@ -0,0 +1,324 @@
+#include "listener_fanout.h"
+
+#include <set>
+#include <algorithm>
+
+using namespace RDC_ns;
+
+listenerFanout::listener::listener(const std::string& connection_id, BULKIO::dataShort_ptr port, const listenerSettings& settings) :
+    _connection_id(connection_id),
+    _port(BULKIO::dataShort::_duplicate(port)),
+    _thread(NULL),
+    _running(false),
+    _end_of_stream(false),
+    _settings(settings),
+    _skip(0),
+    _sent(0),
+    _dropped(0),
+    _errors(0)
+{
+}
+
+listenerFanout::listener::~listener()
+{
+    stop(false);
+}
+
+void listenerFanout::listener::start()
+{
+    boost::mutex::scoped_lock lock(_lock);
+    if (_thread != NULL)
+        return;
+    _running = true;
+    _thread = new boost::thread(&listenerFanout::listener::run, this);
+}
+
+void listenerFanout::listener::stop(bool end_of_stream)
+{
+    {
+        boost::mutex::scoped_lock lock(_lock);
+        if (_thread == NULL)
+            return;
+        _running = false;
+        _end_of_stream = end_of_stream;
+        _queue.clear();
+        _not_empty.notify_all();
+        _not_full.notify_all();
+    }
+    // waits for a push in progress, and the EOS, to return
+    _thread->join();
+    delete _thread;
+    _thread = NULL;
+}
+
+void listenerFanout::listener::setSettings(const listenerSettings& settings)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    _settings = settings;
+    _skip = 0;
+    while (_queue.size() > std::max(_settings.depth, size_t(1))) {
+        _queue.pop_front();
+        _dropped++;
+    }
+    _not_full.notify_all();
+}
+
+void listenerFanout::listener::push(const packet& next)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    const size_t depth = std::max(_settings.depth, size_t(1));
+    switch (_settings.policy) {
+        case LISTENER_BLOCK:
+            while (_running and (_queue.size() >= depth)) {
+                _not_full.wait(lock);
+            }
+            if (not _running)
+                return;
+            break;
+        case LISTENER_DROP_OLDEST:
+            while (_queue.size() >= depth) {
+                _queue.pop_front();
+                _dropped++;
+            }
+            break;
+        case LISTENER_DECIMATE:
+            if (_queue.size() >= depth) {
+                _dropped++;
+                return;
+            }
+            if (2*_queue.size() >= depth) {
+                if ((_skip++ % std::max(_settings.decimation, size_t(1))) != 0) {
+                    _dropped++;
+                    return;
+                }
+            } else {
+                _skip = 0;
+            }
+            break;
+    }
+    _queue.push_back(next);
+    _newest = next.time;
+    _not_empty.notify_one();
+}
+
+void listenerFanout::listener::run()
+{
+    boost::shared_ptr<const BULKIO::StreamSRI> last_sri;
+    boost::shared_ptr<const BULKIO::StreamSRI> stream_sri; // of the last packet sent
+    while (true) {
+        packet next;
+        {
+            boost::mutex::scoped_lock lock(_lock);
+            while (_running and _queue.empty()) {
+                _not_empty.wait(lock);
+            }
+            if (not _running) {
+                const bool end_of_stream = _end_of_stream;
+                lock.unlock();
+                // a listener that was never sent a packet has no stream to end
+                if (end_of_stream and stream_sri)
+                    sendEOS(*stream_sri);
+                return;
+            }
+            next = _queue.front();
+            _queue.pop_front();
+            _not_full.notify_one();
+        }
+
+        try {
+            if (next.sri != last_sri) {
+                _port->pushSRI(*next.sri);
+                last_sri = next.sri;
+            }
+            // borrows the samples; the packet holds them until the push returns
+            const CORBA::ULong length = next.data.size();
+            PortTypes::ShortSequence samples(length, length, const_cast<CORBA::Short*>(next.data.data()), false);
+            _port->pushPacket(samples, next.time, false, next.sri->streamID.in());
+            stream_sri = next.sri;
+            boost::mutex::scoped_lock lock(_lock);
+            _sent++;
+        } catch (const CORBA::Exception&) {
+            // the connection may have been replaced; send the SRI again with the next packet
+            last_sri.reset();
+            boost::mutex::scoped_lock lock(_lock);
+            _errors++;
+        }
+    }
+}
+
+void listenerFanout::listener::sendEOS(const BULKIO::StreamSRI& sri)
+{
+    try {
+        PortTypes::ShortSequence empty;
+        _port->pushPacket(empty, bulkio::time::utils::notSet(), true, sri.streamID.in());
+    } catch (const CORBA::Exception&) {
+        boost::mutex::scoped_lock lock(_lock);
+        _errors++;
+    }
+}
+
+listenerStats listenerFanout::listener::stats() const
+{
+    boost::mutex::scoped_lock lock(_lock);
+    listenerStats stats;
+    stats.connection_id = _connection_id;
+    stats.settings = _settings;
+    stats.queued = _queue.size();
+    stats.lag_seconds = _queue.empty() ? 0.0 : (_newest - _queue.front().time);
+    stats.sent = _sent;
+    stats.dropped = _dropped;
+    stats.errors = _errors;
+    return stats;
+}
+
+listenerFanout::listenerFanout()
+{
+}
+
+listenerFanout::~listenerFanout()
+{
+    stop(true);
+}
+
+bool listenerFanout::policyFromString(const std::string& name, listenerPolicy& policy)
+{
+    if (name == "block") {
+        policy = LISTENER_BLOCK;
+    } else if (name == "drop_oldest") {
+        policy = LISTENER_DROP_OLDEST;
+    } else if (name == "decimate") {
+        policy = LISTENER_DECIMATE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string listenerFanout::policyName(listenerPolicy policy)
+{
+    switch (policy) {
+        case LISTENER_DROP_OLDEST:
+            return "drop_oldest";
+        case LISTENER_DECIMATE:
+            return "decimate";
+        default:
+            return "block";
+    }
+}
+
+void listenerFanout::sync(bulkio::OutShortPort* port)
+{
+    ExtendedCF::UsesConnectionSequence_var connections = port->connections();
+    std::vector<listenerPtr> removed;
+    {
+        boost::mutex::scoped_lock lock(_lock);
+        std::set<std::string> present;
+        for (CORBA::ULong i=0; i<connections->length(); i++) {
+            const std::string connection_id(connections[i].connectionId.in());
+            present.insert(connection_id);
+            if (_listeners.find(connection_id) != _listeners.end())
+                continue;
+            BULKIO::dataShort_var ref = BULKIO::dataShort::_narrow(connections[i].port);
+            if (CORBA::is_nil(ref))
+                continue;
+            listenerPtr added(new listener(connection_id, ref, settingsFor(connection_id)));
+            added->start();
+            _listeners[connection_id] = added;
+        }
+        for (std::map<std::string, listenerPtr>::iterator it=_listeners.begin(); it!=_listeners.end(); ) {
+            if (present.find(it->first) == present.end()) {
+                removed.push_back(it->second);
+                _listeners.erase(it++);
+            } else {
+                it++;
+            }
+        }
+    }
+    // outside the lock; a push in progress may take a while to give up
+    for (std::vector<listenerPtr>::iterator it=removed.begin(); it!=removed.end(); it++) {
+        (*it)->stop(false);
+    }
+}
+
+void listenerFanout::configure(const listenerSettings& defaults, const std::map<std::string, listenerSettings>& overrides)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    _defaults = defaults;
+    _overrides = overrides;
+    for (std::map<std::string, listenerPtr>::iterator it=_listeners.begin(); it!=_listeners.end(); it++) {
+        it->second->setSettings(settingsFor(it->first));
+    }
+}
+
+void listenerFanout::stop(bool end_of_stream)
+{
+    std::map<std::string, listenerPtr> removed;
+    {
+        boost::mutex::scoped_lock lock(_lock);
+        removed.swap(_listeners);
+    }
+    for (std::map<std::string, listenerPtr>::iterator it=removed.begin(); it!=removed.end(); it++) {
+        it->second->stop(end_of_stream);
+    }
+}
+
+bool listenerFanout::hasSRI() const
+{
+    boost::mutex::scoped_lock lock(_lock);
+    return _sri.get() != NULL;
+}
+
+void listenerFanout::pushSRI(const BULKIO::StreamSRI& sri)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    _sri.reset(new BULKIO::StreamSRI(sri));
+}
+
+void listenerFanout::setKeyword(const std::string& id, const redhawk::Value& value)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    if (_sri.get() == NULL)
+        return;
+    // packets already queued keep the SRI they were written with
+    BULKIO::StreamSRI* sri = new BULKIO::StreamSRI(*_sri);
+    redhawk::PropertyMap::cast(sri->keywords)[id] = value;
+    _sri.reset(sri);
+}
+
+void listenerFanout::write(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time)
+{
+    packet next;
+    std::vector<listenerPtr> targets;
+    {
+        boost::mutex::scoped_lock lock(_lock);
+        if (_sri.get() == NULL)
+            return;
+        next.data = data;
+        next.time = time;
+        next.sri = _sri;
+        for (std::map<std::string, listenerPtr>::iterator it=_listeners.begin(); it!=_listeners.end(); it++) {
+            targets.push_back(it->second);
+        }
+    }
+    // a blocking listener holds up the writer, but not the other listeners' senders
+    for (std::vector<listenerPtr>::iterator it=targets.begin(); it!=targets.end(); it++) {
+        (*it)->push(next);
+    }
+}
+
+std::vector<listenerStats> listenerFanout::stats() const
+{
+    std::vector<listenerStats> all;
+    boost::mutex::scoped_lock lock(_lock);
+    for (std::map<std::string, listenerPtr>::const_iterator it=_listeners.begin(); it!=_listeners.end(); it++) {
+        all.push_back(it->second->stats());
+    }
+    return all;
+}
+
+// called with _lock held
+listenerSettings listenerFanout::settingsFor(const std::string& connection_id) const
+{
+    std::map<std::string, listenerSettings>::const_iterator it = _overrides.find(connection_id);
+    return (it != _overrides.end()) ? it->second : _defaults;
+}
@@ -0,0 +1,127 @@
+#ifndef LISTENER_FANOUT_H
+#define LISTENER_FANOUT_H
+
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <bulkio/bulkio.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace RDC_ns {
+
+// what a listener's queue does when it is full
+enum listenerPolicy {
+    LISTENER_BLOCK,       // the writer waits for room, so the listener sees every packet
+    LISTENER_DROP_OLDEST, // the oldest queued packet is discarded
+    LISTENER_DECIMATE     // past half full only one packet in decimation is queued; new packets are discarded when full
+};
+
+struct listenerSettings {
+    listenerSettings() : policy(LISTENER_BLOCK), depth(32), decimation(4) {}
+    listenerPolicy policy;
+    size_t depth;       // packets
+    size_t decimation;
+};
+
+struct listenerStats {
+    std::string connection_id;
+    listenerSettings settings;
+    size_t queued;
+    double lag_seconds; // from the oldest queued sample to the newest written
+    uint64_t sent;
+    uint64_t dropped;
+    uint64_t errors;
+};
+
+/*
+ * Fan-out of one stream to every connection of a BulkIO short port, each
+ * through its own bounded queue and sender thread, so a slow listener only
+ * backs up its own queue.
+ *  - every queue holds a reference to the same shared_buffer, and the CORBA
+ *    sequence given to pushPacket() borrows it, so nothing is copied here
+ *  - the SRI travels with each packet and is pushed to a connection ahead of
+ *    the first packet that uses it
+ *  - sync() and write() are called from one thread; configure() and stats()
+ *    may be called from any
+ */
+class listenerFanout {
+    public:
+        listenerFanout();
+        ~listenerFanout();
+
+        static bool policyFromString(const std::string& name, listenerPolicy& policy);
+        static std::string policyName(listenerPolicy policy);
+
+        // starts a listener for each new connection of port and stops those of connections that are gone
+        void sync(bulkio::OutShortPort* port);
+        // settings for the connections in overrides, defaults for the rest
+        void configure(const listenerSettings& defaults, const std::map<std::string, listenerSettings>& overrides);
+        /* stops every listener, discarding what is queued; with end_of_stream,
+         * each first ends the stream it was sending with an EOS packet
+         */
+        void stop(bool end_of_stream);
+
+        bool hasSRI() const;
+        void pushSRI(const BULKIO::StreamSRI& sri);
+        // applies to the packets written from now on
+        void setKeyword(const std::string& id, const redhawk::Value& value);
+        void write(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time);
+
+        std::vector<listenerStats> stats() const;
+
+    private:
+        struct packet {
+            redhawk::shared_buffer<short> data;
+            BULKIO::PrecisionUTCTime time;
+            boost::shared_ptr<const BULKIO::StreamSRI> sri;
+        };
+
+        class listener {
+            public:
+                listener(const std::string& connection_id, BULKIO::dataShort_ptr port, const listenerSettings& settings);
+                ~listener();
+
+                void start();
+                void stop(bool end_of_stream);
+                void setSettings(const listenerSettings& settings);
+                void push(const packet& next);
+                listenerStats stats() const;
+
+            private:
+                void run();
+                void sendEOS(const BULKIO::StreamSRI& sri);
+
+                const std::string _connection_id;
+                BULKIO::dataShort_var _port;
+                boost::thread* _thread;
+
+                mutable boost::mutex _lock; // everything below
+                boost::condition_variable _not_empty;
+                boost::condition_variable _not_full;
+                bool _running;
+                bool _end_of_stream;        // send an EOS on the way out
+                listenerSettings _settings;
+                std::deque<packet> _queue;
+                size_t _skip;                // packets since the last one queued while decimating
+                BULKIO::PrecisionUTCTime _newest;
+                uint64_t _sent;
+                uint64_t _dropped;
+                uint64_t _errors;
+        };
+        typedef boost::shared_ptr<listener> listenerPtr;
+
+        listenerSettings settingsFor(const std::string& connection_id) const;
+
+        mutable boost::mutex _lock; // everything below
+        std::map<std::string, listenerPtr> _listeners;
+        listenerSettings _defaults;
+        std::map<std::string, listenerSettings> _overrides;
+        boost::shared_ptr<const BULKIO::StreamSRI> _sri;
+};
+
+};
+
+#endif // LISTENER_FANOUT_H
@@ -0,0 +1,167 @@
+#include "pfb_channelizer.h"
+#include "../sample_convert.h"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#define PFB_CHANNELIZER_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace RDC_ns;
+
+pfbChannelizer::pfbChannelizer() :
+    _M(0),
+    _P(0),
+    _hist(0),
+    _next(0),
+    _out_stride(0),
+    _out_offset(0)
+{
+}
+
+bool pfbChannelizer::configure(size_t channels, size_t taps_per_channel)
+{
+    if ((channels < 2) or ((channels & (channels-1)) != 0) or (taps_per_channel < 2))
+        return false;
+    _M = channels;
+    _P = taps_per_channel;
+
+    // windowed-sinc prototype, cut off at half the channel spacing, unity gain at DC
+    const size_t N = _M*_P;
+    std::vector<double> h(N);
+    double sum = 0;
+    for (size_t n=0; n<N; n++) {
+        const double x = (double(n) - (N-1)/2.0) / _M;
+        const double sinc = (x == 0) ? 1.0 : sin(M_PI*x)/(M_PI*x);
+        const double window = 0.42 - 0.5*cos(2*M_PI*n/(N-1)) + 0.08*cos(4*M_PI*n/(N-1));
+        h[n] = sinc*window;
+        sum += h[n];
+    }
+
+    /* segment p holds h[p*M + M-1-c] at c so that it lines up with the M input
+     * samples ending p*M samples before the newest one, oldest first
+     */
+    _taps.resize(2*N);
+    for (size_t p=0; p<_P; p++) {
+        for (size_t c=0; c<_M; c++) {
+            const float tap = h[p*_M + _M-1-c] / sum;
+            _taps[2*(p*_M+c)] = tap;
+            _taps[2*(p*_M+c)+1] = tap;
+        }
+    }
+
+    _acc.resize(2*_M);
+    _v.resize(_M);
+    _twiddle.resize(_M/2);
+    for (size_t i=0; i<_M/2; i++)
+        _twiddle[i] = std::polar(1.0f, float(2*M_PI*i/_M));
+    size_t bits = 0;
+    while ((size_t(1) << bits) < _M)
+        bits++;
+    _bitrev.resize(_M);
+    for (size_t i=0; i<_M; i++) {
+        size_t r = 0;
+        for (size_t b=0; b<bits; b++)
+            r |= ((i >> b) & 1) << (bits-1-b);
+        _bitrev[i] = r;
+    }
+
+    reset();
+    return true;
+}
+
+void pfbChannelizer::reset()
+{
+    _hist = _M*_P - 1;
+    _next = _hist;
+    _work.assign(2*_hist, 0);
+    _out_offset = 0;
+}
+
+double pfbChannelizer::usableBandwidth() const
+{
+    // the Blackman transition band is ~5.5/N wide, centered on the channel edge
+    if (_P == 0)
+        return 0;
+    return std::max(0.0, 1.0 - 5.5/_P);
+}
+
+size_t pfbChannelizer::process(const short* data, size_t len, float scale)
+{
+    if (_M == 0)
+        return 0;
+
+    const size_t num_samps = len/2;
+    const size_t total = _hist + num_samps;
+    _work.resize(2*total);
+    sc16_to_fc32(data, 2*num_samps, scale, &_work[2*_hist]);
+
+    const size_t count = (_next < total) ? (total-1-_next)/_M + 1 : 0;
+    _out_offset = long(_next) - long(_hist);
+    _out_stride = 2*count;
+    _out.resize(_M*_out_stride);
+
+    for (size_t j=0; j<count; j++) {
+        filter(&_work[2*(_next + j*_M)], &_v[0]);
+        fft(&_v[0]);
+        for (size_t k=0; k<_M; k++) {
+            _out[k*_out_stride + 2*j] = _v[k].real();
+            _out[k*_out_stride + 2*j+1] = _v[k].imag();
+        }
+    }
+
+    // keep what the next output's filter reaches back to
+    const size_t keep_from = _next + count*_M - (_M*_P - 1);
+    std::copy(_work.begin()+2*keep_from, _work.end(), _work.begin());
+    _work.resize(2*(total-keep_from));
+    _hist = total - keep_from;
+    _next = _M*_P - 1;
+    return count;
+}
+
+void pfbChannelizer::filter(const float* newest, std::complex<float>* v)
+{
+    const size_t width = 2*_M;
+    float* acc = &_acc[0];
+    std::fill(_acc.begin(), _acc.end(), 0.0f);
+    for (size_t p=0; p<_P; p++) {
+        const float* taps = &_taps[p*width];
+        const float* in = newest - 2*(p*_M + _M-1);
+#ifdef PFB_CHANNELIZER_SSE
+        // width is a multiple of 4 since M >= 2
+        for (size_t i=0; i<width; i+=4) {
+            const __m128 x = _mm_loadu_ps(in+i);
+            const __m128 t = _mm_loadu_ps(taps+i);
+            _mm_storeu_ps(acc+i, _mm_add_ps(_mm_loadu_ps(acc+i), _mm_mul_ps(x, t)));
+        }
+#else
+        for (size_t i=0; i<width; i++)
+            acc[i] += in[i]*taps[i];
+#endif
+    }
+    // branch r ends up at position M-1-r, loaded in bit reversed order for the FFT
+    for (size_t r=0; r<_M; r++) {
+        const size_t c = _M-1-r;
+        v[_bitrev[r]] = std::complex<float>(acc[2*c], acc[2*c+1]);
+    }
+}
+
+/* in-place radix-2 sum over the branches with e^{+j2pi*k*r/M}, input already
+ * in bit reversed order; no 1/M since the prototype has unity gain
+ */
+void pfbChannelizer::fft(std::complex<float>* v)
+{
+    for (size_t len=2; len<=_M; len<<=1) {
+        const size_t half = len/2;
+        const size_t step = _M/len;
+        for (size_t i=0; i<_M; i+=len) {
+            for (size_t j=0; j<half; j++) {
+                const std::complex<float> t = _twiddle[j*step]*v[i+j+half];
+                v[i+j+half] = v[i+j] - t;
+                v[i+j] += t;
+            }
+        }
+    }
+}
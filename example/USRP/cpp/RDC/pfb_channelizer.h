@@ -0,0 +1,75 @@
+#ifndef PFB_CHANNELIZER_H
+#define PFB_CHANNELIZER_H
+
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+namespace RDC_ns {
+
+/*
+ * Critically sampled polyphase filterbank channelizer.
+ *  - splits a complex stream at fs into M channels of fs/M each; channel k is
+ *    centered at +k*fs/M (channels above M/2 are the negative frequencies)
+ *  - each channel is mixed to baseband, lowpass filtered by a windowed-sinc
+ *    prototype of M*taps_per_channel taps and decimated by M
+ *  - the M filter branches are run as one contiguous multiply-accumulate pass
+ *    per output (SSE where available), followed by one M-point FFT
+ *  - state carries across calls, so buffers of any length can be fed in
+ */
+class pfbChannelizer {
+    public:
+        pfbChannelizer();
+
+        // channels must be a power of two >= 2, taps_per_channel >= 2
+        bool configure(size_t channels, size_t taps_per_channel);
+        void reset();
+
+        size_t channels() const {
+            return _M;
+        }
+        // fraction of the channel spacing that is inside the prototype's passband
+        double usableBandwidth() const;
+
+        /* filters len shorts (len/2 complex samples) scaled by scale; returns the
+         * number of samples produced on every channel. The outputs are valid until
+         * the next call
+         */
+        size_t process(const short* data, size_t len, float scale);
+
+        // interleaved complex float output of channel k
+        const float* output(size_t channel) const {
+            return &_out[channel*_out_stride];
+        }
+        // offset (in input samples) of the first output of the last process()
+        // call from the first sample of its input
+        long outputOffset() const {
+            return _out_offset;
+        }
+        // delay (in input samples) of the prototype filter
+        double groupDelay() const {
+            return (_M*_P - 1)/2.0;
+        }
+
+    private:
+        void filter(const float* newest, std::complex<float>* v);
+        void fft(std::complex<float>* v);
+
+        size_t _M;
+        size_t _P;
+        std::vector<float> _taps;   // P segments of 2*M floats, reversed and duplicated for I/Q
+        std::vector<float> _work;   // history followed by the current input, interleaved
+        size_t _hist;               // samples of history at the front of _work
+        size_t _next;               // sample index in _work of the next output's newest sample
+        std::vector<float> _acc;
+        std::vector<std::complex<float> > _v;
+        std::vector<std::complex<float> > _twiddle;
+        std::vector<size_t> _bitrev;
+        std::vector<float> _out;
+        size_t _out_stride;
+        long _out_offset;
+};
+
+};
+
+#endif // PFB_CHANNELIZER_H
@@ -0,0 +1,194 @@
+#include "rational_resampler.h"
+#include "../sample_convert.h"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#define RATIONAL_RESAMPLER_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace RDC_ns;
+
+namespace {
+    // smallest L/M equal to ratio (< 1) with L <= max_num, found from the continued fraction
+    bool exact_fraction(double ratio, uint64_t max_num, uint64_t& num, uint64_t& den)
+    {
+        uint64_t h0 = 0, h1 = 1, k0 = 1, k1 = 0;
+        double x = ratio;
+        for (int i=0; i<32; i++) {
+            const double a = std::floor(x);
+            const uint64_t h2 = uint64_t(a)*h1 + h0;
+            const uint64_t k2 = uint64_t(a)*k1 + k0;
+            if (h2 > max_num)
+                return false;
+            if (std::fabs(double(h2)/double(k2) - ratio) <= 1e-12*ratio) {
+                num = h2;
+                den = k2;
+                return true;
+            }
+            if (x - a <= 0)
+                return false;
+            x = 1.0/(x - a);
+            h0 = h1; h1 = h2;
+            k0 = k1; k1 = k2;
+        }
+        return false;
+    }
+
+    inline short saturate(float value)
+    {
+        const long rounded = lrintf(value);
+        return short(std::max(-32768L, std::min(32767L, rounded)));
+    }
+}
+
+rationalResampler::rationalResampler() :
+    _in_rate(0),
+    _out_rate(0),
+    _N(0),
+    _K(0),
+    _D(1),
+    _S(1),
+    _hist(0),
+    _n(0),
+    _acc(0),
+    _out_offset(0)
+{
+}
+
+bool rationalResampler::configure(double in_rate, double out_rate)
+{
+    if ((out_rate <= 0) or (out_rate > in_rate) or (in_rate > out_rate*MAX_RATIO))
+        return false;
+
+    uint64_t num, den;
+    if (exact_fraction(out_rate/in_rate, MAX_RATIONAL_PHASES, num, den)) {
+        _N = num;
+        _D = num;
+        _S = den;
+    } else {
+        _N = ARBITRARY_PHASES;
+        _D = uint64_t(1) << 32;
+        _S = uint64_t(llround(in_rate/out_rate * double(_D)));
+    }
+    _in_rate = in_rate;
+    _out_rate = in_rate * double(_D) / double(_S);
+
+    /* Blackman windowed sinc at N times the input rate; the transition band
+     * (~5.5/length) spans 0.4 to 0.5 of the output rate
+     */
+    _K = size_t(std::ceil(55.0*in_rate/out_rate));
+    _K += _K & 1;
+    const size_t length = _N*_K;
+    const double fc = 0.45*out_rate/(in_rate*_N);
+    std::vector<double> g(length+1, 0.0);
+    double sum = 0;
+    for (size_t n=0; n<length; n++) {
+        const double x = double(n) - (length-1)/2.0;
+        const double sinc = (x == 0) ? 1.0 : sin(2*M_PI*fc*x)/(2*M_PI*fc*x);
+        const double window = 0.42 - 0.5*cos(2*M_PI*n/(length-1)) + 0.08*cos(4*M_PI*n/(length-1));
+        g[n] = sinc*window;
+        sum += g[n];
+    }
+
+    // phase p is g[p], g[p+N], ... newest sample first; phase N is only used for interpolating
+    _taps.resize((_N+1)*2*_K);
+    for (size_t p=0; p<=_N; p++) {
+        for (size_t c=0; c<_K; c++) {
+            const float tap = g[(_K-1-c)*_N + p] * _N / sum;
+            _taps[p*2*_K + 2*c] = tap;
+            _taps[p*2*_K + 2*c+1] = tap;
+        }
+    }
+
+    reset();
+    return true;
+}
+
+void rationalResampler::reset()
+{
+    _hist = (_K > 0) ? _K-1 : 0;
+    _n = _hist;
+    _acc = 0;
+    _work.assign(2*_hist, 0);
+    _out_offset = 0;
+}
+
+size_t rationalResampler::maxOutput(size_t len) const
+{
+    if (_S == 0)
+        return 0;
+    return (len/2 + _hist) * _D / _S + 2;
+}
+
+size_t rationalResampler::process(const short* data, size_t len, short* out)
+{
+    if (_N == 0)
+        return 0;
+
+    const size_t num_samps = len/2;
+    const size_t total = _hist + num_samps;
+    _work.resize(2*total);
+    sc16_to_fc32(data, 2*num_samps, 1.0f, &_work[2*_hist]);
+
+    const double delay = (double(_N*_K) - 1)/(2.0*_N);
+    size_t count = 0;
+    while (_n < total) {
+        const uint64_t position = _acc * _N;
+        const size_t phase = position / _D;
+        const uint64_t frac = position % _D;
+        const float* window = &_work[2*(_n - (_K-1))];
+
+        float re, im;
+        dot(&_taps[phase*2*_K], window, re, im);
+        if (frac != 0) {
+            float next_re, next_im;
+            dot(&_taps[(phase+1)*2*_K], window, next_re, next_im);
+            const float mu = float(double(frac)/double(_D));
+            re += mu*(next_re-re);
+            im += mu*(next_im-im);
+        }
+        if (count == 0)
+            _out_offset = double(_n) - double(_hist) + double(_acc)/double(_D) - delay;
+        out[2*count] = saturate(re);
+        out[2*count+1] = saturate(im);
+        count++;
+
+        _acc += _S;
+        _n += _acc / _D;
+        _acc %= _D;
+    }
+
+    // keep what the next output's window reaches back to
+    const size_t keep_from = std::min(_n - (_K-1), total);
+    std::copy(_work.begin()+2*keep_from, _work.end(), _work.begin());
+    _work.resize(2*(total-keep_from));
+    _hist = total - keep_from;
+    _n -= keep_from;
+    return count;
+}
+
+void rationalResampler::dot(const float* taps, const float* in, float& re, float& im) const
+{
+    const size_t width = 2*_K;
+#ifdef RATIONAL_RESAMPLER_SSE
+    // width is a multiple of 4 since K is even; lanes hold I,Q,I,Q
+    __m128 acc = _mm_setzero_ps();
+    for (size_t i=0; i<width; i+=4) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(in+i), _mm_loadu_ps(taps+i)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    re = lanes[0]+lanes[2];
+    im = lanes[1]+lanes[3];
+#else
+    re = 0;
+    im = 0;
+    for (size_t i=0; i<width; i+=2) {
+        re += in[i]*taps[i];
+        im += in[i+1]*taps[i+1];
+    }
+#endif
+}
@@ -0,0 +1,78 @@
+#ifndef RATIONAL_RESAMPLER_H
+#define RATIONAL_RESAMPLER_H
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+namespace RDC_ns {
+
+/*
+ * Polyphase resampler for interleaved sc16 data, from the hardware rate down
+ * to an exact requested rate.
+ *  - when out/in is a ratio L/M with L <= MAX_RATIONAL_PHASES the filter has L
+ *    phases and the output lands exactly on them
+ *  - otherwise the filter has ARBITRARY_PHASES phases, consecutive phases are
+ *    linearly interpolated and the output position advances in steps of
+ *    2^-32 input samples, so the rate is exact to within 1 part in 2^32
+ *  - each phase is one contiguous multiply-accumulate pass (SSE where available)
+ *  - state carries across calls, so buffers of any length can be fed in
+ */
+class rationalResampler {
+    public:
+        static const size_t MAX_RATIONAL_PHASES = 256;
+        static const size_t ARBITRARY_PHASES = 64;
+        static const size_t MAX_RATIO = 16; // largest in/out handled
+
+        rationalResampler();
+
+        // returns false if out_rate is above in_rate or more than MAX_RATIO below it
+        bool configure(double in_rate, double out_rate);
+        void reset();
+
+        double outputRate() const {
+            return _out_rate;
+        }
+        // two-sided bandwidth (Hz) passed without attenuation
+        double passband() const {
+            return 0.8*_out_rate;
+        }
+        bool isRational() const {
+            return _D == _N;
+        }
+
+        // upper bound on the complex samples process() produces from len shorts
+        size_t maxOutput(size_t len) const;
+
+        /* resamples len shorts (len/2 complex samples) into out, returning the
+         * number of complex samples written
+         */
+        size_t process(const short* data, size_t len, short* out);
+
+        /* time (in input samples) of the first output of the last process() call
+         * relative to the first sample of its input; the filter delay is included
+         */
+        double outputOffset() const {
+            return _out_offset;
+        }
+
+    private:
+        void dot(const float* taps, const float* in, float& re, float& im) const;
+
+        double _in_rate;
+        double _out_rate;
+        size_t _N;      // filter phases
+        size_t _K;      // taps per phase (even)
+        uint64_t _D;    // output position units per input sample
+        uint64_t _S;    // output position step, in 1/_D input samples
+        std::vector<float> _taps;  // N+1 phases of 2*K floats, oldest sample first, duplicated for I/Q
+        std::vector<float> _work;  // history followed by the current input, interleaved
+        size_t _hist;
+        size_t _n;      // sample index in _work the next output's window ends at
+        uint64_t _acc;  // position of the next output past _n, in 1/_D input samples
+        double _out_offset;
+};
+
+};
+
+#endif // RATIONAL_RESAMPLER_H
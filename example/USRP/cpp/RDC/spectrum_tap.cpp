@@ -0,0 +1,103 @@
+#include "spectrum_tap.h"
+#include "../sample_convert.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace RDC_ns;
+
+spectrumTap::spectrumTap() :
+    _N(0),
+    _hop(0),
+    _averages(0),
+    _norm(0),
+    _count(0)
+{
+}
+
+bool spectrumTap::configure(size_t fft_size, double overlap, size_t averages)
+{
+    if ((fft_size < 2) or ((fft_size & (fft_size-1)) != 0) or (overlap < 0) or (overlap >= 1) or (averages < 1))
+        return false;
+    _N = fft_size;
+    _hop = std::max(size_t(1), size_t(_N*(1.0-overlap) + 0.5));
+    _averages = averages;
+
+    _window.resize(_N);
+    double sum = 0;
+    for (size_t n=0; n<_N; n++) {
+        _window[n] = 0.42 - 0.5*cos(2*M_PI*n/_N) + 0.08*cos(4*M_PI*n/_N);
+        sum += _window[n];
+    }
+    _norm = 1.0/(sum*sum);
+
+    _twiddle.resize(_N/2);
+    for (size_t i=0; i<_N/2; i++)
+        _twiddle[i] = std::polar(1.0f, float(-2*M_PI*i/_N));
+    size_t bits = 0;
+    while ((size_t(1) << bits) < _N)
+        bits++;
+    _bitrev.resize(_N);
+    for (size_t i=0; i<_N; i++) {
+        size_t r = 0;
+        for (size_t b=0; b<bits; b++)
+            r |= ((i >> b) & 1) << (bits-1-b);
+        _bitrev[i] = r;
+    }
+
+    _in.resize(2*_N);
+    _v.resize(_N);
+    _frame.resize(_N);
+    reset();
+    return true;
+}
+
+void spectrumTap::reset()
+{
+    _power.assign(_N, 0);
+    _count = 0;
+}
+
+bool spectrumTap::process(const short* data, size_t len, float scale)
+{
+    if (_N == 0)
+        return false;
+
+    const size_t num_samps = len/2;
+    for (size_t start=0; (start+_N <= num_samps) and (_count < _averages); start+=_hop) {
+        sc16_to_fc32(data + 2*start, 2*_N, scale, &_in[0]);
+        for (size_t n=0; n<_N; n++)
+            _v[_bitrev[n]] = std::complex<float>(_in[2*n]*_window[n], _in[2*n+1]*_window[n]);
+        fft(&_v[0]);
+        for (size_t k=0; k<_N; k++)
+            _power[k] += std::norm(_v[k]);
+        _count++;
+    }
+    if (_count < _averages)
+        return false;
+
+    // bin N/2 (-fs/2) first
+    const double norm = _norm/_count;
+    for (size_t k=0; k<_N; k++) {
+        const double power = _power[(k + _N/2) % _N]*norm;
+        _frame[k] = (power > 0) ? 10*log10(power) : -300.0f;
+    }
+    reset();
+    return true;
+}
+
+/* in-place radix-2 forward transform, input already in bit reversed order */
+void spectrumTap::fft(std::complex<float>* v)
+{
+    for (size_t len=2; len<=_N; len<<=1) {
+        const size_t half = len/2;
+        const size_t step = _N/len;
+        for (size_t i=0; i<_N; i+=len) {
+            for (size_t j=0; j<half; j++) {
+                const std::complex<float> t = _twiddle[j*step]*v[i+j+half];
+                v[i+j+half] = v[i+j] - t;
+                v[i+j] += t;
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef SPECTRUM_TAP_H
+#define SPECTRUM_TAP_H
+
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+namespace RDC_ns {
+
+/*
+ * Averaged power spectrum of a complex stream.
+ *  - each FFT covers fft_size samples under a Blackman window; successive FFTs
+ *    start fft_size*(1-overlap) samples apart
+ *  - FFTs never span two calls to process(), so blocks that aren't contiguous
+ *    can be fed in without any bookkeeping
+ *  - a frame is the mean power of averages FFTs, in dB relative to a full
+ *    scale tone, with the bins ordered from -fs/2 to +fs/2
+ */
+class spectrumTap {
+    public:
+        spectrumTap();
+
+        // fft_size must be a power of two >= 2, 0 <= overlap < 1, averages >= 1
+        bool configure(size_t fft_size, double overlap, size_t averages);
+        // discards the FFTs of the frame in progress
+        void reset();
+
+        size_t fftSize() const {
+            return _N;
+        }
+        // FFTs in the frame in progress
+        size_t accumulated() const {
+            return _count;
+        }
+
+        /* adds the FFTs that fit in len shorts (len/2 complex samples) scaled by
+         * scale, until the frame is complete; returns true if it is. The frame
+         * is valid until the next call
+         */
+        bool process(const short* data, size_t len, float scale);
+        const std::vector<float>& frame() const {
+            return _frame;
+        }
+
+    private:
+        void fft(std::complex<float>* v);
+
+        size_t _N;
+        size_t _hop;
+        size_t _averages;
+        std::vector<float> _window;
+        float _norm;                // 1/(sum of the window)^2
+        std::vector<std::complex<float> > _twiddle;
+        std::vector<size_t> _bitrev;
+        std::vector<float> _in;
+        std::vector<std::complex<float> > _v;
+        std::vector<double> _power;
+        size_t _count;
+        std::vector<float> _frame;
+};
+
+};
+
+#endif // SPECTRUM_TAP_H
@@ -0,0 +1,592 @@
+/**************************************************************************
+
+    This is the device code. This file contains the child class where
+    custom functionality can be added to the device. Custom
+    functionality to the base class can be extended here. Access to
+    the ports can also be done from this class
+
+**************************************************************************/
+
+#include "SRDC.h"
+#include "../RDC/RDC.h"
+
+#include <cmath>
+#include <new>
+
+using namespace SRDC_ns;
+
+PREPARE_LOGGING(SRDC_i)
+
+SRDC_i::SRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl) :
+    SRDC_base(devMgr_ior, id, lbl, sftwrPrfl)
+{
+}
+
+SRDC_i::SRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev) :
+    SRDC_base(devMgr_ior, id, lbl, sftwrPrfl, compDev)
+{
+}
+
+SRDC_i::SRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities) :
+    SRDC_base(devMgr_ior, id, lbl, sftwrPrfl, capacities)
+{
+}
+
+SRDC_i::SRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev) :
+    SRDC_base(devMgr_ior, id, lbl, sftwrPrfl, capacities, compDev)
+{
+}
+
+SRDC_i::~SRDC_i()
+{
+}
+
+namespace {
+    // timed bursts are only committed to the hardware this far ahead, so a
+    // deallocation never waits on a trigger that is still far off
+    const double BURST_LEAD_SECONDS = 1.0;
+    // the history holds this much more than snapshot_history_seconds, so the
+    // samples of an open snapshot are still there when the service function gets to them
+    const double SEND_SLACK_SECONDS = 0.1;
+
+    BULKIO::PrecisionUTCTime j1970(double seconds)
+    {
+        const double whole = floor(seconds);
+        return bulkio::time::utils::create(whole, seconds-whole);
+    }
+}
+
+void SRDC_i::constructor()
+{
+    /***********************************************************************************
+     This is the RH constructor. All properties are properly initialized before this function is called
+
+     For a tuner device, the structure frontend_tuner_status needs to match the number
+     of tuners that this device controls and what kind of device it is.
+     The options for devices are: TX, RX, RX_DIGITIZER, CHANNELIZER, DDC, RX_DIGITIZER_CHANNELIZER
+    ***********************************************************************************/
+    this->addChannels(1, "SRDC");
+    this->setDataPort(dataShort_out->_this());
+    this->setControlPort(DigitalTuner_in->_this());
+    this->setThreadDelay(0.01);
+    _source = NULL;
+    _mode = SNAPSHOT_IDLE;
+    _restart = true;
+    _ref_index = 0;
+    _energy_armed = true;
+    _next_window = false;
+    _window_pending = false;
+    _capturing = false;
+    _capture_next = 0;
+    _capture_stop = 0;
+    _stream_open = false;
+}
+
+/***********************************************************************************************
+
+    With the RDC allocated, its service function copies every block into the history (see
+    pushHistory) and this thread writes the open snapshot out of it. Otherwise this thread waits
+    for the next trigger and receives it as one hardware burst.
+
+***********************************************************************************************/
+int SRDC_i::serviceFunction()
+{
+    if (sendSnapshot())
+        return NORMAL;
+    return captureBurst() ? NORMAL : NOOP;
+}
+
+void SRDC_i::setSource(RDC_ns::RDC_i* source)
+{
+    _source = source;
+}
+
+void SRDC_i::setSnapshotWindow(const BULKIO::PrecisionUTCTime& start, const BULKIO::PrecisionUTCTime& stop)
+{
+    boost::mutex::scoped_lock lock(_history_lock);
+    _next_window = true;
+    _next_window_start = start;
+    _next_window_stop = stop;
+}
+
+void SRDC_i::clearSnapshotWindow()
+{
+    boost::mutex::scoped_lock lock(_history_lock);
+    _next_window = false;
+}
+
+int64_t SRDC_i::indexOf(const BULKIO::PrecisionUTCTime& time) const
+{
+    return int64_t(_ref_index) + llround((time - _ref_time) * frontend_tuner_status[0].sample_rate);
+}
+
+BULKIO::PrecisionUTCTime SRDC_i::timeOf(uint64_t index) const
+{
+    return _ref_time + (double(index) - double(_ref_index)) / frontend_tuner_status[0].sample_rate;
+}
+
+size_t SRDC_i::historyCapacity(double sample_rate) const
+{
+    return size_t((std::max(0.0, snapshot_history_seconds) + SEND_SLACK_SECONDS)*sample_rate);
+}
+
+void SRDC_i::pushHistory(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time, bool discontinuity)
+{
+    boost::mutex::scoped_lock lock(_history_lock);
+    if ((_mode != SNAPSHOT_HISTORY) or (not frontend_tuner_status[0].enabled))
+        return;
+
+    // the history only holds contiguous samples
+    if (_restart or discontinuity) {
+        if (_capturing and (_capture_next < _capture_stop)) {
+            RH_WARN(this->_baseLog, "pushHistory|samples were lost; snapshot ends early");
+            endSnapshot();
+        }
+        _history.clear();
+        _restart = false;
+    }
+    _ref_index = _history.end();
+    _ref_time = time;
+
+    // only marks the snapshot; the service function writes it out of the history
+    if (not _capturing)
+        checkTriggers(data.data(), data.size()/2);
+    _history.write(data.data(), data.size()/2);
+}
+
+size_t SRDC_i::findEnergy(const short* data, size_t num_samps) const
+{
+    // a full scale complex sinusoid has I^2+Q^2 == full_scale^2
+    const double full_scale = _source->fullScale();
+    const int64_t level = int64_t(ceil(full_scale*full_scale*pow(10.0, snapshot_threshold_dbfs/10.0)));
+    for (size_t i=0; i<num_samps; i++) {
+        const int64_t power = int64_t(data[2*i])*data[2*i] + int64_t(data[2*i+1])*data[2*i+1];
+        if (power >= level)
+            return i;
+    }
+    return num_samps;
+}
+
+/* starts a snapshot if a trigger falls on or before the last of the num_samps
+ * samples at _ref_index; called with _history_lock held
+ */
+bool SRDC_i::checkTriggers(const short* data, size_t num_samps)
+{
+    const double rate = frontend_tuner_status[0].sample_rate;
+    const int64_t block_start = _ref_index;
+    const int64_t block_end = block_start + num_samps;
+    const int64_t pre = llround(std::max(0.0, std::min(snapshot_pre_trigger_seconds, snapshot_history_seconds))*rate);
+    const int64_t post = llround(std::max(0.0, snapshot_post_trigger_seconds)*rate);
+
+    if (_window_pending) {
+        const int64_t from = indexOf(_window_start);
+        if (from < block_end) {
+            _window_pending = false;
+            startSnapshot(from, indexOf(_window_stop), from);
+            return true;
+        }
+    }
+    if (snapshot_trigger) {
+        snapshot_trigger = false;
+        startSnapshot(block_start-pre, block_start+post, block_start);
+        return true;
+    }
+    if (snapshot_trigger_time > 0) {
+        const int64_t trigger = indexOf(j1970(snapshot_trigger_time));
+        if (trigger < block_end) {
+            snapshot_trigger_time = 0;
+            startSnapshot(trigger-pre, trigger+post, trigger);
+            return true;
+        }
+    }
+    if (snapshot_threshold_dbfs < 0) {
+        const size_t crossing = findEnergy(data, num_samps);
+        if (crossing == num_samps) {
+            _energy_armed = true;
+        } else if (_energy_armed) {
+            _energy_armed = false;
+            const int64_t trigger = block_start + crossing;
+            startSnapshot(trigger-pre, trigger+post, trigger);
+            return true;
+        }
+    }
+    return false;
+}
+
+// called with _history_lock held
+void SRDC_i::startSnapshot(int64_t from, int64_t stop, int64_t trigger)
+{
+    const int64_t oldest = _history.begin();
+    if (from < oldest) {
+        RH_WARN(this->_baseLog, "startSnapshot|history is " << oldest-from << " samples short; snapshot starts late");
+        from = oldest;
+    }
+    if (stop <= from) {
+        RH_WARN(this->_baseLog, "startSnapshot|snapshot ends before the oldest sample held; nothing to send");
+        return;
+    }
+    _capture_next = from;
+    _capture_stop = stop;
+    _capture_sri = snapshotSRI((trigger > from) ? trigger-from : 0);
+    _capturing = true;
+    RH_DEBUG(this->_baseLog, "startSnapshot|" << stop-from << " samples, " << std::max(trigger-from, int64_t(0)) << " of them before the trigger");
+}
+
+/* writes what the history holds of the open snapshot, and closes the stream
+ * once the snapshot is complete or was cut short; returns false if there was
+ * nothing to do. Only the copy out of the history is done under _history_lock
+ */
+bool SRDC_i::sendSnapshot()
+{
+    bool open = false;
+    BULKIO::StreamSRI sri;
+    redhawk::buffer<short> out;
+    BULKIO::PrecisionUTCTime time;
+    bool done;
+    {
+        boost::mutex::scoped_lock lock(_history_lock);
+        if (not _capturing)
+            return false;
+        if (not _stream_open) {
+            open = true;
+            sri = _capture_sri;
+        }
+        const uint64_t oldest = _history.begin();
+        if ((_capture_next < _capture_stop) and (_capture_next < oldest)) {
+            RH_WARN(this->_baseLog, "sendSnapshot|fell " << oldest-_capture_next << " samples behind the history; snapshot ends early");
+            _capture_stop = _capture_next;
+        }
+        const uint64_t last = std::min(_capture_stop, _history.end());
+        if (_capture_next < last) {
+            out = redhawk::buffer<short>(2*(last-_capture_next));
+            _history.read(_capture_next, last-_capture_next, out.data());
+            time = timeOf(_capture_next);
+            _capture_next = last;
+        }
+        done = (_capture_next >= _capture_stop);
+        if (done) {
+            // no new snapshot starts before this one is closed; this thread is the only one writing
+            _capturing = false;
+            snapshots_sent++;
+        }
+    }
+
+    if (open) {
+        _capture_stream = dataShort_out->createStream(sri);
+        _stream_open = true;
+    }
+    if (out.size() > 0)
+        _capture_stream.write(out, time);
+    if (done) {
+        _capture_stream.close();
+        _capture_stream = bulkio::OutShortStream();
+        _stream_open = false;
+    }
+    return open or (out.size() > 0) or done;
+}
+
+/* cuts the open snapshot short; the service function closes its stream.
+ * Called with _history_lock held
+ */
+void SRDC_i::endSnapshot()
+{
+    _capture_stop = _capture_next;
+}
+
+// called with _history_lock held
+BULKIO::StreamSRI SRDC_i::snapshotSRI(size_t trigger_offset)
+{
+    std::ostringstream id;
+    id<<"snapshot_freq_"<<long(frontend_tuner_status[0].center_frequency)<<"_Hz_"<<frontend::uuidGenerator();
+    std::string stream_id = id.str();
+    BULKIO::StreamSRI sri = this->create(stream_id, frontend_tuner_status[0], -1.0);
+    sri.mode = 1; // complex
+    redhawk::PropertyMap::cast(sri.keywords)["SNAPSHOT_TRIGGER_OFFSET"] = CORBA::ULong(trigger_offset);
+    return sri;
+}
+
+/* takes the next due trigger of a timed allocation as one hardware burst;
+ * returns false if nothing was due
+ */
+bool SRDC_i::captureBurst()
+{
+    BULKIO::PrecisionUTCTime start;
+    bool now = false;
+    size_t num_samps = 0;
+    {
+        boost::mutex::scoped_lock lock(_history_lock);
+        if ((_mode != SNAPSHOT_TIMED) or (not frontend_tuner_status[0].enabled))
+            return false;
+
+        const double rate = frontend_tuner_status[0].sample_rate;
+        if (snapshot_trigger) {
+            snapshot_trigger = false;
+            now = true;
+            num_samps = llround(std::max(0.0, snapshot_post_trigger_seconds)*rate);
+        } else {
+            if (_window_pending) {
+                start = _window_start;
+                num_samps = llround((_window_stop - _window_start)*rate);
+            } else if (snapshot_trigger_time > 0) {
+                start = j1970(snapshot_trigger_time);
+                num_samps = llround(std::max(0.0, snapshot_post_trigger_seconds)*rate);
+            } else {
+                return false;
+            }
+            if (start - bulkio::time::utils::now() > BURST_LEAD_SECONDS)
+                return false;
+            if (_window_pending) {
+                _window_pending = false;
+            } else {
+                snapshot_trigger_time = 0;
+            }
+        }
+    }
+    if (num_samps == 0)
+        return true;
+
+    // receive blocks until the burst is complete, so only the SRI is made under the lock
+    redhawk::buffer<short> out(2*num_samps);
+    BULKIO::PrecisionUTCTime first;
+    if (not _source->captureSnapshot(now ? NULL : &start, out, first)) {
+        RH_WARN(this->_baseLog, "captureBurst|snapshot of " << num_samps << " samples was not received");
+        return true;
+    }
+    BULKIO::StreamSRI sri;
+    {
+        boost::mutex::scoped_lock lock(_history_lock);
+        sri = snapshotSRI(0);
+    }
+    bulkio::OutShortStream stream = dataShort_out->createStream(sri);
+    stream.write(out, first);
+    stream.close();
+    boost::mutex::scoped_lock lock(_history_lock);
+    snapshots_sent++;
+    return true;
+}
+
+void SRDC_i::sourceChanged(bool tuned)
+{
+    boost::mutex::scoped_lock lock(_history_lock);
+    if (_mode != SNAPSHOT_HISTORY)
+        return;
+    if (_capturing and (_capture_next < _capture_stop)) {
+        RH_WARN(this->_baseLog, "sourceChanged|parent RDC changed; snapshot ends early");
+        endSnapshot();
+    }
+    _restart = true;
+    if (not tuned) {
+        RH_WARN(this->_baseLog, "sourceChanged|parent RDC lost its allocation; no snapshots until it is allocated again");
+        return;
+    }
+
+    double center_frequency, bandwidth, sample_rate;
+    if (_source->sourceTuning(center_frequency, bandwidth, sample_rate)) {
+        if (sample_rate != frontend_tuner_status[0].sample_rate)
+            _history.allocate(historyCapacity(sample_rate));
+        frontend_tuner_status[0].center_frequency = center_frequency;
+        frontend_tuner_status[0].bandwidth = bandwidth;
+        frontend_tuner_status[0].sample_rate = sample_rate;
+    }
+}
+
+/*************************************************************
+Functions supporting tuning allocation
+*************************************************************/
+void SRDC_i::deviceEnable(frontend_tuner_status_struct_struct &fts, size_t tuner_id){
+    fts.enabled = true;
+    return;
+}
+void SRDC_i::deviceDisable(frontend_tuner_status_struct_struct &fts, size_t tuner_id){
+    fts.enabled = false;
+    return;
+}
+bool SRDC_i::deviceSetTuning(const frontend::frontend_tuner_allocation_struct &request, frontend_tuner_status_struct_struct &fts, size_t tuner_id){
+    /************************************************************
+    Shares the RDC's tuning while it is allocated (the request has to fit inside
+    it); otherwise takes the channel and tunes it to the request
+    ************************************************************/
+    if (_source == NULL)
+        return false;
+
+    bool window;
+    BULKIO::PrecisionUTCTime window_start, window_stop;
+    {
+        boost::mutex::scoped_lock lock(_history_lock);
+        window = _next_window;
+        window_start = _next_window_start;
+        window_stop = _next_window_stop;
+        _next_window = false;
+    }
+    if (window and (window_stop - window_start <= 0)) {
+        RH_INFO(this->_baseLog, "deviceSetTuning|snapshot window ends before it starts");
+        return false;
+    }
+
+    // the RDC is not called with _history_lock held; it holds its tuner lock while notifying us
+    double center_frequency, bandwidth, sample_rate;
+    snapshotMode mode;
+    if (_source->sourceTuning(center_frequency, bandwidth, sample_rate)) {
+        try {
+            if (not frontend::validateRequest(center_frequency-bandwidth/2, center_frequency+bandwidth/2,
+                                              request.center_frequency-request.bandwidth/2, request.center_frequency+request.bandwidth/2)) {
+                throw FRONTEND::BadParameterException("INVALID REQUEST -- request is not within the RDC's band");
+            }
+            if ((request.sample_rate > sample_rate) or
+                ((request.sample_rate > 0) and (request.sample_rate_tolerance > 0) and (sample_rate > request.sample_rate*(1+request.sample_rate_tolerance/100.0)))) {
+                throw FRONTEND::BadParameterException("INVALID REQUEST -- RDC rate does not match sr request");
+            }
+        } catch(FRONTEND::BadParameterException& e){
+            RH_DEBUG(this->_baseLog,"deviceSetTuning|sharing RDC at " << center_frequency << " Hz|" << e.msg);
+            return false;
+        }
+        mode = SNAPSHOT_HISTORY;
+    } else {
+        if (window and (window_start - bulkio::time::utils::now() < 0)) {
+            RH_INFO(this->_baseLog, "deviceSetTuning|snapshot window has already started and there is no history to take it from");
+            return false;
+        }
+        if (not _source->reserveSnapshot(request, center_frequency, bandwidth, sample_rate))
+            return false;
+        mode = SNAPSHOT_TIMED;
+    }
+
+    {
+        boost::mutex::scoped_lock lock(_history_lock);
+        fts.center_frequency = center_frequency;
+        fts.bandwidth = bandwidth;
+        fts.sample_rate = sample_rate;
+        fts.bandwidth_tolerance = request.bandwidth_tolerance;
+        fts.sample_rate_tolerance = request.sample_rate_tolerance;
+
+        try {
+            _history.allocate((mode == SNAPSHOT_HISTORY) ? historyCapacity(sample_rate) : 0);
+        } catch (const std::bad_alloc&) {
+            RH_ERROR(this->_baseLog, "deviceSetTuning|unable to allocate " << snapshot_history_seconds << " seconds of history");
+            lock.unlock();
+            if (mode == SNAPSHOT_TIMED)
+                _source->releaseSnapshot();
+            return false;
+        }
+        _mode = mode;
+        _restart = true;
+        _energy_armed = true;
+        // a snapshot cut short by the last deallocation is still closed by the service function
+        _window_pending = window;
+        _window_start = window_start;
+        _window_stop = window_stop;
+        snapshots_sent = 0;
+    }
+    RH_DEBUG(this->_baseLog,"deviceSetTuning|" << ((mode == SNAPSHOT_HISTORY) ? "sharing RDC" : "timed bursts") << " at "
+             << center_frequency << " Hz, " << sample_rate << " sps");
+    this->start();
+    return true;
+}
+
+bool SRDC_i::deviceDeleteTuning(frontend_tuner_status_struct_struct &fts, size_t tuner_id) {
+    snapshotMode mode;
+    {
+        boost::mutex::scoped_lock lock(_history_lock);
+        if (_capturing)
+            endSnapshot();
+        mode = _mode;
+        _mode = SNAPSHOT_IDLE;
+        _window_pending = false;
+        _history.allocate(0);
+    }
+    // waits for a burst in progress to complete
+    if (mode == SNAPSHOT_TIMED)
+        _source->releaseSnapshot();
+    return true;
+}
+
+/*************************************************************
+Functions servicing the tuner control port
+*************************************************************/
+std::string SRDC_i::getTunerType(const std::string& allocation_id) {
+    return frontend_tuner_status[0].tuner_type;
+}
+
+bool SRDC_i::getTunerDeviceControl(const std::string& allocation_id) {
+    return true;
+}
+
+std::string SRDC_i::getTunerGroupId(const std::string& allocation_id) {
+    return frontend_tuner_status[0].group_id;
+}
+
+std::string SRDC_i::getTunerRfFlowId(const std::string& allocation_id) {
+    return frontend_tuner_status[0].rf_flow_id;
+}
+
+void SRDC_i::setTunerCenterFrequency(const std::string& allocation_id, double freq) {
+    throw FRONTEND::NotSupportedException("setTunerCenterFrequency not supported; the SRDC is tuned through its allocation or its RDC");
+}
+
+double SRDC_i::getTunerCenterFrequency(const std::string& allocation_id) {
+    return frontend_tuner_status[0].center_frequency;
+}
+
+void SRDC_i::setTunerBandwidth(const std::string& allocation_id, double bw) {
+    throw FRONTEND::NotSupportedException("setTunerBandwidth not supported");
+}
+
+double SRDC_i::getTunerBandwidth(const std::string& allocation_id) {
+    return frontend_tuner_status[0].bandwidth;
+}
+
+void SRDC_i::setTunerAgcEnable(const std::string& allocation_id, bool enable)
+{
+    throw FRONTEND::NotSupportedException("setTunerAgcEnable not supported");
+}
+
+bool SRDC_i::getTunerAgcEnable(const std::string& allocation_id)
+{
+    throw FRONTEND::NotSupportedException("getTunerAgcEnable not supported");
+}
+
+void SRDC_i::setTunerGain(const std::string& allocation_id, float gain)
+{
+    throw FRONTEND::NotSupportedException("setTunerGain not supported");
+}
+
+float SRDC_i::getTunerGain(const std::string& allocation_id)
+{
+    throw FRONTEND::NotSupportedException("getTunerGain not supported");
+}
+
+void SRDC_i::setTunerReferenceSource(const std::string& allocation_id, long source)
+{
+    throw FRONTEND::NotSupportedException("setTunerReferenceSource not supported");
+}
+
+long SRDC_i::getTunerReferenceSource(const std::string& allocation_id)
+{
+    throw FRONTEND::NotSupportedException("getTunerReferenceSource not supported");
+}
+
+void SRDC_i::setTunerEnable(const std::string& allocation_id, bool enable) {
+    this->frontend_tuner_status[0].enabled = enable;
+}
+
+bool SRDC_i::getTunerEnable(const std::string& allocation_id) {
+    return frontend_tuner_status[0].enabled;
+}
+
+void SRDC_i::setTunerOutputSampleRate(const std::string& allocation_id, double sr) {
+    throw FRONTEND::NotSupportedException("setTunerOutputSampleRate not supported");
+}
+
+double SRDC_i::getTunerOutputSampleRate(const std::string& allocation_id){
+    return frontend_tuner_status[0].sample_rate;
+}
+
+void SRDC_i::configureTuner(const std::string& id, const CF::Properties& tunerSettings){
+    // set the appropriate tuner settings
+}
+
+CF::Properties* SRDC_i::getTunerSettings(const std::string& id){
+    // return the tuner settings
+    redhawk::PropertyMap* tuner_settings = new redhawk::PropertyMap();
+    return tuner_settings;
+}
@@ -0,0 +1,134 @@
+#ifndef SRDC_I_IMPL_H
+#define SRDC_I_IMPL_H
+
+#include "SRDC_base.h"
+#include "snapshot_history.h"
+
+namespace RDC_ns {
+class RDC_i;
+};
+
+namespace SRDC_ns {
+/*
+ * Snapshot channel on one RDC's capture path. Each trigger produces one
+ * bounded stream on dataShort_out, closed with an end-of-stream.
+ *  - while the RDC is allocated the SRDC shares its tuning; the RDC's service
+ *    function hands every block to pushHistory(), which keeps the last
+ *    snapshot_history_seconds in a preallocated ring so a snapshot can reach
+ *    back before its trigger. pushHistory() only copies the block and marks a
+ *    triggered snapshot; this device's service function writes it out of the
+ *    ring, so a slow snapshot consumer never holds up the RDC. Triggers are snapshot_trigger, snapshot_trigger_time,
+ *    snapshot_threshold_dbfs or a FRONTEND::snapshot window
+ *  - while the RDC is idle the SRDC tunes the channel itself and captures each
+ *    snapshot straight from the hardware as one timed STREAM_MODE_NUM_SAMPS_AND_DONE
+ *    burst, so nothing streams between snapshots; there is no history, so only
+ *    the window and the snapshot_trigger/snapshot_trigger_time triggers apply
+ */
+class SRDC_i : public SRDC_base
+{
+    ENABLE_LOGGING
+    public:
+        SRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl);
+        SRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev);
+        SRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities);
+        SRDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev);
+        ~SRDC_i();
+
+        void constructor();
+
+        int serviceFunction();
+
+        void setSource(RDC_ns::RDC_i* source);
+
+        // FRONTEND::snapshot window for the allocation about to be made (see USRP_i::allocate)
+        void setSnapshotWindow(const BULKIO::PrecisionUTCTime& start, const BULKIO::PrecisionUTCTime& stop);
+        void clearSnapshotWindow();
+
+        // a block of the RDC's output, its first sample taken at time
+        void pushHistory(const redhawk::shared_buffer<short>& data, const BULKIO::PrecisionUTCTime& time, bool discontinuity);
+        // the RDC was retuned (tuned true) or lost its allocation (tuned false)
+        void sourceChanged(bool tuned);
+
+    protected:
+        std::string getTunerType(const std::string& allocation_id);
+        bool getTunerDeviceControl(const std::string& allocation_id);
+        std::string getTunerGroupId(const std::string& allocation_id);
+        std::string getTunerRfFlowId(const std::string& allocation_id);
+        double getTunerCenterFrequency(const std::string& allocation_id);
+        void setTunerCenterFrequency(const std::string& allocation_id, double freq);
+        double getTunerBandwidth(const std::string& allocation_id);
+        void setTunerBandwidth(const std::string& allocation_id, double bw);
+        bool getTunerAgcEnable(const std::string& allocation_id);
+        void setTunerAgcEnable(const std::string& allocation_id, bool enable);
+        float getTunerGain(const std::string& allocation_id);
+        void setTunerGain(const std::string& allocation_id, float gain);
+        long getTunerReferenceSource(const std::string& allocation_id);
+        void setTunerReferenceSource(const std::string& allocation_id, long source);
+        bool getTunerEnable(const std::string& allocation_id);
+        void setTunerEnable(const std::string& allocation_id, bool enable);
+        double getTunerOutputSampleRate(const std::string& allocation_id);
+        void setTunerOutputSampleRate(const std::string& allocation_id, double sr);
+        void configureTuner(const std::string& id, const CF::Properties& tunerSettings);
+        CF::Properties* getTunerSettings(const std::string& id);
+
+        enum snapshotMode {
+            SNAPSHOT_IDLE,      // not allocated
+            SNAPSHOT_HISTORY,   // fed by the allocated RDC
+            SNAPSHOT_TIMED      // holds the channel, captures bursts from the hardware
+        };
+
+        // history index of the sample taken at time, and the other way around
+        int64_t indexOf(const BULKIO::PrecisionUTCTime& time) const;
+        BULKIO::PrecisionUTCTime timeOf(uint64_t index) const;
+        // history samples to hold at sample_rate
+        size_t historyCapacity(double sample_rate) const;
+        // first of num_samps samples at or above snapshot_threshold_dbfs, num_samps if none
+        size_t findEnergy(const short* data, size_t num_samps) const;
+        bool checkTriggers(const short* data, size_t num_samps);
+        void startSnapshot(int64_t from, int64_t stop, int64_t trigger);
+        bool sendSnapshot();
+        void endSnapshot();
+        BULKIO::StreamSRI snapshotSRI(size_t trigger_offset);
+        bool captureBurst();
+
+        RDC_ns::RDC_i* _source;
+        snapshotMode _mode;
+        boost::mutex _history_lock; // everything below; the RDC's service function feeds it
+
+        snapshotHistory _history;
+        bool _restart;              // drop the history before the next block
+        uint64_t _ref_index;        // history index of the sample taken at _ref_time
+        BULKIO::PrecisionUTCTime _ref_time;
+        bool _energy_armed;         // threshold crossed, waiting for a block entirely below it
+
+        bool _next_window;          // window for the allocation in progress
+        BULKIO::PrecisionUTCTime _next_window_start;
+        BULKIO::PrecisionUTCTime _next_window_stop;
+        bool _window_pending;       // window of this allocation, not yet reached
+        BULKIO::PrecisionUTCTime _window_start;
+        BULKIO::PrecisionUTCTime _window_stop;
+
+        bool _capturing;            // a snapshot is triggered and not yet closed
+        uint64_t _capture_next;     // next history index to send
+        uint64_t _capture_stop;
+        BULKIO::StreamSRI _capture_sri;
+
+        // the service function's own
+        bool _stream_open;
+        bulkio::OutShortStream _capture_stream;
+
+    private:
+        ////////////////////////////////////////
+        // Required device specific functions // -- to be implemented by device developer
+        ////////////////////////////////////////
+
+        // these are pure virtual, must be implemented here
+        void deviceEnable(frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+        void deviceDisable(frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+        bool deviceSetTuning(const frontend::frontend_tuner_allocation_struct &request, frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+        bool deviceDeleteTuning(frontend_tuner_status_struct_struct &fts, size_t tuner_id);
+
+};
+};
+
+#endif // SRDC_I_IMPL_H
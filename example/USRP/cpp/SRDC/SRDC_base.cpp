@@ -0,0 +1,204 @@
+#include "SRDC_base.h"
+
+/*******************************************************************************************
+
+    AUTO-GENERATED CODE. DO NOT MODIFY
+
+    The following class functions are for the base class for the device class. To
+    customize any of these functions, do not modify them here. Instead, overload them
+    on the child class
+
+******************************************************************************************/
+
+using namespace SRDC_ns;
+
+SRDC_base::SRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl) :
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>(devMgr_ior, id, lbl, sftwrPrfl),
+    ThreadedComponent()
+{
+    construct();
+}
+
+SRDC_base::SRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev) :
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>(devMgr_ior, id, lbl, sftwrPrfl, compDev),
+    ThreadedComponent()
+{
+    construct();
+}
+
+SRDC_base::SRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities) :
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>(devMgr_ior, id, lbl, sftwrPrfl, capacities),
+    ThreadedComponent()
+{
+    construct();
+}
+
+SRDC_base::SRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev) :
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>(devMgr_ior, id, lbl, sftwrPrfl, capacities, compDev),
+    ThreadedComponent()
+{
+    construct();
+}
+
+SRDC_base::~SRDC_base()
+{
+    DigitalTuner_in->_remove_ref();
+    DigitalTuner_in = 0;
+    dataShort_out->_remove_ref();
+    dataShort_out = 0;
+}
+
+void SRDC_base::construct()
+{
+    loadProperties();
+
+    DigitalTuner_in = new frontend::InDigitalTunerPort("DigitalTuner_in", this);
+    DigitalTuner_in->setLogger(this->_baseLog->getChildLogger("DigitalTuner_in", "ports"));
+    addPort("DigitalTuner_in", DigitalTuner_in);
+    dataShort_out = new bulkio::OutShortPort("dataShort_out");
+    dataShort_out->setLogger(this->_baseLog->getChildLogger("dataShort_out", "ports"));
+    addPort("dataShort_out", dataShort_out);
+    this->setHost(this);
+
+}
+
+/*******************************************************************************************
+    Framework-level functions
+    These functions are generally called by the framework to perform housekeeping.
+*******************************************************************************************/
+void SRDC_base::start() throw (CORBA::SystemException, CF::Resource::StartError)
+{
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>::start();
+    ThreadedComponent::startThread();
+}
+
+void SRDC_base::stop() throw (CORBA::SystemException, CF::Resource::StopError)
+{
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>::stop();
+    if (!ThreadedComponent::stopThread()) {
+        throw CF::Resource::StopError(CF::CF_NOTSET, "Processing thread did not die");
+    }
+}
+
+void SRDC_base::releaseObject() throw (CORBA::SystemException, CF::LifeCycle::ReleaseError)
+{
+    // This function clears the device running condition so main shuts down everything
+    try {
+        stop();
+    } catch (CF::Resource::StopError& ex) {
+        // TODO - this should probably be logged instead of ignored
+    }
+
+    frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>::releaseObject();
+}
+
+void SRDC_base::loadProperties()
+{
+    device_kind = "FRONTEND::TUNER";
+    addProperty(snapshot_history_seconds,
+                1.0,
+                "snapshot_history_seconds",
+                "snapshot_history_seconds",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(snapshot_pre_trigger_seconds,
+                0.1,
+                "snapshot_pre_trigger_seconds",
+                "snapshot_pre_trigger_seconds",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(snapshot_post_trigger_seconds,
+                0.1,
+                "snapshot_post_trigger_seconds",
+                "snapshot_post_trigger_seconds",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(snapshot_trigger,
+                false,
+                "snapshot_trigger",
+                "snapshot_trigger",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(snapshot_trigger_time,
+                0.0,
+                "snapshot_trigger_time",
+                "snapshot_trigger_time",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(snapshot_threshold_dbfs,
+                0.0,
+                "snapshot_threshold_dbfs",
+                "snapshot_threshold_dbfs",
+                "readwrite",
+                "dBFS",
+                "external",
+                "property");
+
+    addProperty(snapshots_sent,
+                0,
+                "snapshots_sent",
+                "snapshots_sent",
+                "readonly",
+                "",
+                "external",
+                "property");
+
+    frontend_listener_allocation = frontend::frontend_listener_allocation_struct();
+    frontend_tuner_allocation = frontend::frontend_tuner_allocation_struct();
+
+}
+
+CF::Properties* SRDC_base::getTunerStatus(const std::string& allocation_id)
+{
+    CF::Properties* tmpVal = new CF::Properties();
+    long tuner_id = getTunerMapping(allocation_id);
+    if (tuner_id < 0)
+        throw FRONTEND::FrontendException(("ERROR: ID: " + std::string(allocation_id) + " IS NOT ASSOCIATED WITH ANY TUNER!").c_str());
+    CORBA::Any prop;
+    prop <<= *(static_cast<frontend_tuner_status_struct_struct*>(&this->frontend_tuner_status[tuner_id]));
+    prop >>= tmpVal;
+
+    CF::Properties_var tmp = new CF::Properties(*tmpVal);
+    return tmp._retn();
+}
+
+void SRDC_base::frontendTunerStatusChanged(const std::vector<frontend_tuner_status_struct_struct>* oldValue, const std::vector<frontend_tuner_status_struct_struct>* newValue)
+{
+    this->tuner_allocation_ids.resize(this->frontend_tuner_status.size());
+}
+
+void SRDC_base::assignListener(const std::string& listen_alloc_id, const std::string& allocation_id)
+{
+    // find control allocation_id
+    std::string existing_alloc_id = allocation_id;
+    std::map<std::string,std::string>::iterator existing_listener;
+    while ((existing_listener=listeners.find(existing_alloc_id)) != listeners.end())
+        existing_alloc_id = existing_listener->second;
+    listeners[listen_alloc_id] = existing_alloc_id;
+
+}
+
+void SRDC_base::removeListener(const std::string& listen_alloc_id)
+{
+    if (listeners.find(listen_alloc_id) != listeners.end()) {
+        listeners.erase(listen_alloc_id);
+    }
+}
+void SRDC_base::removeAllocationIdRouting(const size_t tuner_id) {
+}
+
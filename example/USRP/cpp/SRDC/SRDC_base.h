@@ -0,0 +1,68 @@
+#ifndef SRDC_BASE_IMPL_BASE_H
+#define SRDC_BASE_IMPL_BASE_H
+
+#include <boost/thread.hpp>
+#include <frontend/frontend.h>
+#include <ossie/ThreadedComponent.h>
+#include <ossie/DynamicComponent.h>
+
+#include <frontend/frontend.h>
+#include <bulkio/bulkio.h>
+#include "SRDC_struct_props.h"
+
+#define BOOL_VALUE_HERE 0
+
+namespace SRDC_ns {
+class SRDC_base : public frontend::FrontendTunerDevice<frontend_tuner_status_struct_struct>, public virtual frontend::digital_tuner_delegation, protected ThreadedComponent, public virtual DynamicComponent
+{
+    public:
+        SRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl);
+        SRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, char *compDev);
+        SRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities);
+        SRDC_base(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Properties capacities, char *compDev);
+        ~SRDC_base();
+
+        void start() throw (CF::Resource::StartError, CORBA::SystemException);
+
+        void stop() throw (CF::Resource::StopError, CORBA::SystemException);
+
+        void releaseObject() throw (CF::LifeCycle::ReleaseError, CORBA::SystemException);
+
+        void loadProperties();
+        void removeAllocationIdRouting(const size_t tuner_id);
+
+        virtual CF::Properties* getTunerStatus(const std::string& allocation_id);
+        virtual void assignListener(const std::string& listen_alloc_id, const std::string& allocation_id);
+        virtual void removeListener(const std::string& listen_alloc_id);
+        void frontendTunerStatusChanged(const std::vector<frontend_tuner_status_struct_struct>* oldValue, const std::vector<frontend_tuner_status_struct_struct>* newValue);
+
+    protected:
+        // Member variables exposed as properties
+        /// Property: snapshot_history_seconds
+        double snapshot_history_seconds;
+        /// Property: snapshot_pre_trigger_seconds
+        double snapshot_pre_trigger_seconds;
+        /// Property: snapshot_post_trigger_seconds
+        double snapshot_post_trigger_seconds;
+        /// Property: snapshot_trigger
+        bool snapshot_trigger;
+        /// Property: snapshot_trigger_time
+        double snapshot_trigger_time;
+        /// Property: snapshot_threshold_dbfs
+        float snapshot_threshold_dbfs;
+        /// Property: snapshots_sent
+        CORBA::ULong snapshots_sent;
+
+        // Ports
+        /// Port: DigitalTuner_in
+        frontend::InDigitalTunerPort *DigitalTuner_in;
+        /// Port: dataShort_out
+        bulkio::OutShortPort *dataShort_out;
+
+        std::map<std::string, std::string> listeners;
+
+    private:
+        void construct();
+};
+};
+#endif // SRDC_BASE_IMPL_BASE_H
@@ -0,0 +1,60 @@
+#include "snapshot_history.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace SRDC_ns;
+
+snapshotHistory::snapshotHistory() :
+    _capacity(0),
+    _end(0)
+{
+}
+
+void snapshotHistory::allocate(size_t capacity)
+{
+    // swap rather than assign, so shrinking gives the memory back
+    std::vector<short>(2*capacity, 0).swap(_samples);
+    _capacity = capacity;
+    _end = 0;
+}
+
+void snapshotHistory::clear()
+{
+    _end = 0;
+}
+
+void snapshotHistory::write(const short* data, size_t num_samps)
+{
+    if (_capacity == 0) {
+        _end += num_samps;
+        return;
+    }
+
+    // only the newest capacity samples survive the write
+    if (num_samps > _capacity) {
+        data += 2*(num_samps-_capacity);
+        _end += num_samps-_capacity;
+        num_samps = _capacity;
+    }
+    while (num_samps > 0) {
+        const size_t pos = _end % _capacity;
+        const size_t chunk = std::min(num_samps, _capacity-pos);
+        memcpy(&_samples[2*pos], data, 2*chunk*sizeof(short));
+        data += 2*chunk;
+        _end += chunk;
+        num_samps -= chunk;
+    }
+}
+
+void snapshotHistory::read(uint64_t from, size_t count, short* out) const
+{
+    while (count > 0) {
+        const size_t pos = from % _capacity;
+        const size_t chunk = std::min(count, _capacity-pos);
+        memcpy(out, &_samples[2*pos], 2*chunk*sizeof(short));
+        out += 2*chunk;
+        from += chunk;
+        count -= chunk;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef SNAPSHOT_HISTORY_H
+#define SNAPSHOT_HISTORY_H
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+namespace SRDC_ns {
+
+/*
+ * Circular history of the most recent interleaved sc16 samples.
+ *  - the storage is allocated once, by allocate(), and never grows
+ *  - samples are addressed by an absolute index that counts every sample
+ *    written since the last clear(), so a position stays valid for as long
+ *    as the sample is still held
+ *  - single writer; the caller serializes reads against writes
+ */
+class snapshotHistory {
+    public:
+        snapshotHistory();
+
+        // capacity in complex samples (0 keeps only the index); drops whatever was held
+        void allocate(size_t capacity);
+        // forgets the held samples and restarts the index at 0
+        void clear();
+
+        size_t capacity() const {
+            return _capacity;
+        }
+        // index one past the newest sample
+        uint64_t end() const {
+            return _end;
+        }
+        // index of the oldest sample still held
+        uint64_t begin() const {
+            return (_end > _capacity) ? _end-_capacity : 0;
+        }
+
+        // appends num_samps complex samples (2*num_samps shorts)
+        void write(const short* data, size_t num_samps);
+
+        /* copies count complex samples starting at index from into out;
+         * [from, from+count) must lie within [begin(), end())
+         */
+        void read(uint64_t from, size_t count, short* out) const;
+
+    private:
+        std::vector<short> _samples;
+        size_t _capacity;
+        uint64_t _end;
+};
+
+};
+
+#endif // SNAPSHOT_HISTORY_H
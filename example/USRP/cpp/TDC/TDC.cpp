@@ -35,6 +35,7 @@ TDC_i::TDC_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Propert
 
 TDC_i::~TDC_i()
 {
+    _status.stop();
 }
 
 void TDC_i::constructor()
@@ -66,10 +67,18 @@ void TDC_i::constructor()
 
     _tuner_number = -1;
     _error_state = false;
+    _command_lock.reset(new boost::mutex);
     if (usrp_tuner.lock.cond == NULL)
         usrp_tuner.lock.cond = new boost::condition_variable;
     if (usrp_tuner.lock.mutex == NULL)
         usrp_tuner.lock.mutex = new boost::mutex;
+
+    addPropertyListener(latency_reset, this, &TDC_i::latencyResetChanged);
+    setPropertyQueryImpl(latency_stats, this, &TDC_i::getLatencyStats);
+    addPropertyListener(status_max_rate, this, &TDC_i::statusMaxRateChanged);
+    _status.setMaxRate(status_max_rate);
+    _status.start(boost::bind(&TDC_i::sendStatus, this, _1, _2),
+                  boost::bind(&TDC_i::statusConnections, this));
 }
 
 void TDC_i::setTunerNumber(size_t tuner_number) {
@@ -77,11 +86,45 @@ void TDC_i::setTunerNumber(size_t tuner_number) {
     this->updateDeviceCharacteristics();
 }
 
-void TDC_i::setUHDptr(const uhd::usrp::multi_usrp::sptr parent_device_ptr) {
-    usrp_device_ptr = parent_device_ptr;
+void TDC_i::setRadio(const usrpRadio::sptr& radio) {
+    usrp_device_ptr = radio;
     this->updateDeviceCharacteristics();
 }
 
+void TDC_i::setCommandLock(const usrp_command_lock_t& command_lock) {
+    _command_lock = command_lock;
+}
+
+/* a timed change USRP_i has issued for this channel. The samples sent carry no
+ * time to find where it lands, so the tuner status takes it on now
+ */
+void TDC_i::expectChange(const usrpTimedChange& change) {
+    frontend_tuner_status[0].center_frequency = change.center_frequency;
+    frontend_tuner_status[0].sample_rate = change.sample_rate;
+}
+
+/* checks a timed_commands entry for this channel the way the tuner setters
+ * check their values; 0 is "unchanged" for center_frequency and sample_rate
+ */
+bool TDC_i::validateTimedCommand(double center_frequency, double sample_rate, bool set_gain, double gain, std::string& error)
+{
+    if ((center_frequency < 0) or ((center_frequency > 0) and
+            !frontend::validateRequest(device_characteristics.freq_min, device_characteristics.freq_max, center_frequency))) {
+        error = "center frequency is outside of the device's range";
+        return false;
+    }
+    if ((sample_rate < 0) or ((sample_rate > 0) and
+            !frontend::validateRequest(device_characteristics.rate_min, device_characteristics.rate_max, sample_rate))) {
+        error = "sample rate is outside of the device's range";
+        return false;
+    }
+    if (set_gain and !frontend::validateRequest(device_characteristics.gain_min, device_characteristics.gain_max, gain)) {
+        error = "gain is outside of the device's range";
+        return false;
+    }
+    return true;
+}
+
 void TDC_i::updateDeviceCharacteristics() {
     if ((usrp_device_ptr.get() != NULL) and (_tuner_number != -1))  {
         device_characteristics.tuner_type = "TDC";
@@ -108,7 +151,7 @@ void TDC_i::updateDeviceCharacteristics() {
         device_characteristics.freq_max = usrp_range.frequency.stop();
 
         try {
-            std::vector<double> rates = usrp_device_ptr->get_tx_dboard_iface(_tuner_number)->get_clock_rates(uhd::usrp::dboard_iface::UNIT_RX);
+            std::vector<double> rates = usrp_device_ptr->get_tx_clock_rates(_tuner_number);
             device_characteristics.clock_min = rates.back();
             device_characteristics.clock_max = rates.front();
         } catch (...) {
@@ -482,7 +525,7 @@ void TDC_i::verifyHWStatus(const std::string &stream_id, const BULKIO::Precision
                 status.status = CF::DEV_HARDWARE_FAILURE;
             }
             _error_state = true;
-            this->TransmitDeviceStatus_out->transmitStatusChanged(status);
+            _status.post(status);
         }
     }
 }
@@ -500,12 +543,13 @@ void TDC_i::verifyQueueStatus(const std::string &stream_id, const BULKIO::Precis
         status.queued_packets = 0;
         status.status = error_status[0].code;
         _error_state = true;
-        this->TransmitDeviceStatus_out->transmitStatusChanged(status);
+        _status.post(status);
     }
 }
 
 bool TDC_i::usrpTransmit(){
     RH_TRACE(this->_baseLog,__PRETTY_FUNCTION__);
+    const uint64_t transmit_start = latencyHistogram::now();
 
     bulkio::StreamQueue<bulkio::InShortPort>& queue = dataShortTX_in->getQueue();
 
@@ -539,6 +583,9 @@ bool TDC_i::usrpTransmit(){
     std::vector<bulkio::StreamStatus> error_status;
     BULKIO::PrecisionUTCTime ts_now = bulkio::time::utils::now();
     bulkio::ShortDataBlock block = queue.getNextBlock(ts_now, error_status);
+    if (block) {
+        _latency[LATENCY_DEQUEUE].since(transmit_start);
+    }
     std::string empty_string;
 
     verifyHWStatus(empty_string, ts_now);
@@ -556,16 +603,44 @@ bool TDC_i::usrpTransmit(){
                 RH_DEBUG(this->_baseLog,"usrpTransmit|tuner_number=" << _tuner_number << " got tx_streamer[" << _tuner_number << "]");
             }
             // Send in size/2 because it is complex
-            if( usrp_tx_streamer->send(&block.buffer()[0], block.buffer().size() / 2, _metadata, 0.1) != block.buffer().size() / 2) {
+            const uint64_t send_start = latencyHistogram::now();
+            const size_t sent = usrp_tx_streamer->send(&block.buffer()[0], block.buffer().size() / 2, _metadata, 0.1);
+            _latency[LATENCY_SEND].since(send_start);
+            if( sent != block.buffer().size() / 2) {
                 RH_WARN(this->_baseLog, "WARNING: THE USRP WAS UNABLE TO TRANSMIT " << block.buffer().size() / 2 << " NUMBER OF SAMPLES!");
                 return false;
             }
         }
         verifyHWStatus(stream_id, ts_now);
+        _latency[LATENCY_TRANSMIT].since(transmit_start);
     }
     return true;
 }
 
+std::vector<latency_stat_struct_struct> TDC_i::getLatencyStats() {
+    static const char* names[LATENCY_STAGES] = {"dequeue", "send", "transmit"};
+    std::vector<latency_stat_struct_struct> stats(LATENCY_STAGES);
+    for (size_t i=0; i<LATENCY_STAGES; i++) {
+        const latencyHistogram::summary summary = _latency[i].summarize();
+        stats[i].stage = names[i];
+        stats[i].count = summary.count;
+        stats[i].mean_us = summary.mean_us;
+        stats[i].p50_us = summary.p50_us;
+        stats[i].p99_us = summary.p99_us;
+        stats[i].p999_us = summary.p999_us;
+    }
+    return stats;
+}
+
+void TDC_i::latencyResetChanged(bool old_value, bool new_value) {
+    if (not new_value)
+        return;
+    for (size_t i=0; i<LATENCY_STAGES; i++)
+        _latency[i].reset();
+    latency_reset = false;
+    RH_DEBUG(this->_baseLog, "latencyResetChanged|latency histograms cleared");
+}
+
 /*************************************************************
 Functions supporting tuning allocation
 *************************************************************/
@@ -666,9 +741,12 @@ bool TDC_i::deviceSetTuning(const frontend::frontend_tuner_allocation_struct &re
     // adjust requested center frequency according to tx rfinfo packet
 
     // configure hw
-    usrp_device_ptr->set_tx_freq(request.center_frequency+if_offset, _tuner_number);
-    usrp_device_ptr->set_tx_bandwidth(opt_bw, _tuner_number);
-    usrp_device_ptr->set_tx_rate(opt_sr, _tuner_number);
+    {
+        boost::mutex::scoped_lock cmd_lock(*_command_lock);
+        usrp_device_ptr->set_tx_freq(request.center_frequency+if_offset, _tuner_number);
+        usrp_device_ptr->set_tx_bandwidth(opt_bw, _tuner_number);
+        usrp_device_ptr->set_tx_rate(opt_sr, _tuner_number);
+    }
 
     // update frontend_tuner_status with actual hw values
     fts.center_frequency = usrp_device_ptr->get_tx_freq(_tuner_number)+if_offset;
@@ -845,9 +923,47 @@ void TDC_i::reset(const std::string& allocation_id, const std::string& stream_id
     status.settling_time = 0;
     status.queued_packets = 0;
     status.status = CF::DEV_OK;
-    this->TransmitDeviceStatus_out->transmitStatusChanged(status);
+    // queued behind any error it clears
+    _status.post(status);
+}
+
+/* called from the status dispatcher's thread
+ */
+void TDC_i::sendStatus(const FRONTEND::TransmitStatusType& status, const std::string& connection_id)
+{
+    try {
+        this->TransmitDeviceStatus_out->transmitStatusChanged(status, connection_id);
+    } catch (...) {
+        RH_WARN(this->_baseLog, "sendStatus|unable to send the status of stream " << status.stream_id << " to " << connection_id);
+    }
+}
+
+std::vector<std::string> TDC_i::statusConnections()
+{
+    std::vector<std::string> ids;
+    ExtendedCF::UsesConnectionSequence_var connections = this->TransmitDeviceStatus_out->connections();
+    for (CORBA::ULong i=0; i<connections->length(); i++)
+        ids.push_back(std::string(connections[i].connectionId));
+    return ids;
+}
+
+void TDC_i::statusMaxRateChanged(float old_value, float new_value) {
+    _status.setMaxRate(new_value);
+}
+
+uint64_t transmitStatusTraits::key(const FRONTEND::TransmitStatusType& status)
+{
+    uint64_t hash = statusHash(status.allocation_id.in());
+    hash = statusHash(status.stream_id.in(), hash);
+    return hash ^ uint64_t(status.status);
 }
 
+void transmitStatusTraits::coalesce(FRONTEND::TransmitStatusType& status, const BULKIO::PrecisionUTCTime& last, uint64_t count)
+{
+    status.timestamp = last;
+}
+
+
 bool TDC_i::hold(const std::string& allocation_id, const std::string& stream_id) {
     bulkio::StreamQueue<bulkio::InShortPort>& queue = dataShortTX_in->getQueue();
     return queue.hold(stream_id);
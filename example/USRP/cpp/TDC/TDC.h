@@ -2,10 +2,22 @@
 #define TDC_I_IMPL_H
 
 #include "TDC_base.h"
-#include <uhd/usrp/multi_usrp.hpp>
+#include "../radio.h"
 #include "../uhd_access.h"
+#include "../latency_histogram.h"
+#include "../status_dispatcher.h"
 
 namespace TDC_ns {
+// TransmitDeviceStatus_out events repeat per allocation, stream and status;
+// TransmitStatusType has nowhere to put a count, so a coalesced event only
+// moves its timestamp to the last one
+struct transmitStatusTraits {
+    typedef FRONTEND::TransmitStatusType status_type;
+    typedef BULKIO::PrecisionUTCTime time_type;
+    static uint64_t key(const FRONTEND::TransmitStatusType& status);
+    static void coalesce(FRONTEND::TransmitStatusType& status, const BULKIO::PrecisionUTCTime& last, uint64_t count);
+};
+
 class TDC_i : public TDC_base
 {
     ENABLE_LOGGING
@@ -21,9 +33,24 @@ class TDC_i : public TDC_base
         int serviceFunction();
 
         void setTunerNumber(size_t tuner_number);
-        void setUHDptr(const uhd::usrp::multi_usrp::sptr parent_device_ptr);
+        void setRadio(const usrpRadio::sptr& radio);
+        void setCommandLock(const usrp_command_lock_t& command_lock);
+        void expectChange(const usrpTimedChange& change);
         void updateDeviceCharacteristics();
 
+        int tunerNumber() const {
+            return _tuner_number;
+        }
+        bool hasAllocation(const std::string& allocation_id) const {
+            return _allocationTracker.find(allocation_id) != _allocationTracker.end();
+        }
+        // the controlling allocation comes first in allocation_id_csv; the rest are listeners
+        bool isController(const std::string& allocation_id) const {
+            const std::string& ids = frontend_tuner_status[0].allocation_id_csv;
+            return (not allocation_id.empty()) and (ids.compare(0, ids.find(','), allocation_id) == 0);
+        }
+        bool validateTimedCommand(double center_frequency, double sample_rate, bool set_gain, double gain, std::string& error);
+
     protected:
         std::string getTunerType(const std::string& allocation_id);
         bool getTunerDeviceControl(const std::string& allocation_id);
@@ -52,14 +79,15 @@ class TDC_i : public TDC_base
         void setTransmitParemeters(const std::string& allocation_id, const frontend::TransmitParameters& transmit_parameters);
         frontend::TransmitParameters getTransmitParemeters(const std::string& allocation_id);
 
-        uhd::tx_streamer::sptr usrp_tx_streamer;
+        usrpTxStream::sptr usrp_tx_streamer;
         usrpTunerStruct usrp_tuner; // data buffer/timestamps, lock
         bool usrpCreateTxStream();
         bool usrpEnable();
         bool usrpTransmit();
         int _tuner_number;
         std::string _stream_id;
-        uhd::usrp::multi_usrp::sptr usrp_device_ptr;
+        usrpRadio::sptr usrp_device_ptr;
+        usrp_command_lock_t _command_lock;
         usrpRangesStruct usrp_range;    // freq/bw/sr/gain ranges supported by each tuner channel
                                         // indices map to tuner_id
                                         // protected by prop_lock
@@ -71,6 +99,24 @@ class TDC_i : public TDC_base
         void verifyQueueStatus(const std::string &stream_id, const BULKIO::PrecisionUTCTime &rightnow, const std::vector<bulkio::StreamStatus> &error_status);
         bool _error_state;
 
+        // TransmitDeviceStatus_out events, sent from the dispatcher's thread so the
+        // transmit thread never waits on a consumer
+        statusDispatcher<transmitStatusTraits> _status;
+        void sendStatus(const FRONTEND::TransmitStatusType& status, const std::string& connection_id);
+        std::vector<std::string> statusConnections();
+        void statusMaxRateChanged(float old_value, float new_value);
+
+        // time spent in each stage of the TX path (latency_stats), always recorded
+        enum latencyStage {
+            LATENCY_DEQUEUE,
+            LATENCY_SEND,
+            LATENCY_TRANSMIT,
+            LATENCY_STAGES
+        };
+        latencyHistogram _latency[LATENCY_STAGES];
+        std::vector<latency_stat_struct_struct> getLatencyStats();
+        void latencyResetChanged(bool old_value, bool new_value);
+
     private:
         ////////////////////////////////////////
         // Required device specific functions // -- to be implemented by device developer
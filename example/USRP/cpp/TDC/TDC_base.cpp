@@ -123,6 +123,32 @@ void TDC_base::loadProperties()
                 "external",
                 "property");
 
+    addProperty(status_max_rate,
+                10,
+                "status_max_rate",
+                "status_max_rate",
+                "readwrite",
+                "Hz",
+                "external",
+                "property");
+
+    addProperty(latency_reset,
+                false,
+                "latency_reset",
+                "latency_reset",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(latency_stats,
+                "latency_stats",
+                "latency_stats",
+                "readonly",
+                "",
+                "external",
+                "property");
+
     frontend_listener_allocation = frontend::frontend_listener_allocation_struct();
     frontend_transmitter_allocation = frontend::frontend_transmitter_allocation_struct();
     frontend_tuner_allocation = frontend::frontend_tuner_allocation_struct();
@@ -42,6 +42,12 @@ class TDC_base : public frontend::FrontendTunerDevice<frontend_tuner_status_stru
         float device_gain;
         /// Property: device_mode
         std::string device_mode;
+        /// Property: status_max_rate
+        float status_max_rate;
+        /// Property: latency_reset
+        bool latency_reset;
+        /// Property: latency_stats
+        std::vector<latency_stat_struct_struct> latency_stats;
         /// Property: device_characteristics
         device_characteristics_struct device_characteristics;
 
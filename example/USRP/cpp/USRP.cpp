@@ -9,11 +9,12 @@
 
 #include "USRP.h"
 #include <ios>
+#include <algorithm>
 
 PREPARE_LOGGING(USRP_i)
 
 namespace {
-    static inline void wait_pps(uhd::usrp::multi_usrp::sptr device)
+    static inline void wait_pps(usrpRadio::sptr device)
     {
         boost::system_time end_time = boost::get_system_time() + boost::posix_time::milliseconds(1100);
         uhd::time_spec_t time_start_last_pps = device->get_time_last_pps();
@@ -56,6 +57,8 @@ USRP_i::USRP_i(char *devMgr_ior, char *id, char *lbl, char *sftwrPrfl, CF::Prope
 
 USRP_i::~USRP_i()
 {
+    // hand reception back to the children before they go away
+    _rx_groups.clear();
 }
 
 void USRP_i::constructor()
@@ -80,6 +83,54 @@ void USRP_i::constructor()
 
     addPropertyListener(device_reference_source_global, this, &USRP_i::deviceReferenceSourceChanged);
 
+    if (radio_backend == "SIMULATED") {
+        createSimulatedRadio();
+    } else {
+        createUHDRadio();
+    }
+
+    if (usrp_device_ptr.get() != NULL) {
+        usrp_command_lock.reset(new boost::mutex);
+        _command_log.reset(new usrpCommandLog);
+        const size_t num_rx_channels = usrp_device_ptr->get_rx_num_channels();
+        const size_t num_tx_channels = usrp_device_ptr->get_tx_num_channels();
+        std::cout<<"number of rx channels: "<<num_rx_channels<<std::endl;
+        std::cout<<"number of tx channels: "<<num_tx_channels<<std::endl;
+        for (unsigned int i=0; i<num_rx_channels; i++) {
+            std::ostringstream rdc_name;
+            rdc_name << "RDC_" << i+1;
+            RDCs.push_back(this->addChild<RDC_ns::RDC_i>(rdc_name.str()));
+            RDCs.back()->setTunerNumber(i);
+            RDCs.back()->setRadio(usrp_device_ptr);
+            RDCs.back()->setCommandLock(usrp_command_lock);
+            RDCs.back()->setCommandLog(_command_log);
+        }
+        for (unsigned int i=0; i<num_tx_channels; i++) {
+            std::ostringstream tdc_name;
+            tdc_name << "TDC_" << i+1;
+            TDCs.push_back(this->addChild<TDC_ns::TDC_i>(tdc_name.str()));
+            TDCs.back()->setTunerNumber(i);
+            TDCs.back()->setRadio(usrp_device_ptr);
+            TDCs.back()->setCommandLock(usrp_command_lock);
+        }
+        if (channelizer_channels > 0)
+            createChannelizers();
+        if (srdc_enable)
+            createSnapshotChannels();
+        if (drdc_enable)
+            createDelayChannels();
+        std::cout<<"len RDC: "<<RDCs.size()<<std::endl;
+        std::cout<<"len TDC: "<<TDCs.size()<<std::endl;
+        RH_DEBUG(this->_baseLog, "constructor|" << DDCs.size() << " DDCs, " << SRDCs.size() << " SRDCs, " << DRDCs.size() << " DRDCs");
+    }
+    setPropertyQueryImpl(frontend_tuner_status, this, &USRP_i::get_fts);
+    addPropertyListener(timed_commands, this, &USRP_i::timedCommandsChanged);
+    setPropertyQueryImpl(timed_command_status, this, &USRP_i::getTimedCommandStatus);
+}
+
+/* finds the USRP (at ip_address, if set) and opens it */
+void USRP_i::createUHDRadio()
+{
     uhd::device_addr_t hint;
     if (not this->ip_address.empty()) {
         hint["addr"] = this->ip_address;
@@ -106,31 +157,223 @@ void USRP_i::constructor()
         ossie::corba::push_back(messages, errstr.c_str());
         throw CF::LifeCycle::InitializeError(messages);
     }
-    usrp_device_ptr = uhd::usrp::multi_usrp::make(dev_addrs[0]);
+    uhd::usrp::multi_usrp::sptr device = uhd::usrp::multi_usrp::make(dev_addrs[0]);
+    if (device.get() != NULL)
+        usrp_device_ptr.reset(new usrpUHDRadio(device));
+}
 
-    if (usrp_device_ptr.get() != NULL) {
-        const size_t num_rx_channels = usrp_device_ptr->get_rx_num_channels();
-        const size_t num_tx_channels = usrp_device_ptr->get_tx_num_channels();
-        std::cout<<"number of rx channels: "<<num_rx_channels<<std::endl;
-        std::cout<<"number of tx channels: "<<num_tx_channels<<std::endl;
-        for (unsigned int i=0; i<num_rx_channels; i++) {
-            std::ostringstream rdc_name;
-            rdc_name << "RDC_" << i+1;
-            RDCs.push_back(this->addChild<RDC_ns::RDC_i>(rdc_name.str()));
-            RDCs.back()->setTunerNumber(i);
-            RDCs.back()->setUHDptr(usrp_device_ptr);
+/* a radio with no hardware behind it, shaped by the sim_* properties */
+void USRP_i::createSimulatedRadio()
+{
+    RH_INFO(this->_baseLog, "createSimulatedRadio|" << sim_rx_channels << " RX and " << sim_tx_channels
+            << " TX channels at a " << sim_master_clock_rate << " Hz master clock, " << (sim_realtime ? "realtime" : "max speed"));
+    _sim_radio.reset(new usrpSimRadio(sim_rx_channels, sim_tx_channels, sim_master_clock_rate, simulationSettings()));
+    usrp_device_ptr = _sim_radio;
+
+    addPropertyListener(sim_realtime, this, &USRP_i::simulationFlagChanged);
+    addPropertyListener(sim_noise_level, this, &USRP_i::simulationValueChanged);
+    addPropertyListener(sim_fifo_time, this, &USRP_i::simulationValueChanged);
+    addPropertyListener(sim_overflow_interval, this, &USRP_i::simulationValueChanged);
+    addPropertyListener(sim_lo_lock_time, this, &USRP_i::simulationValueChanged);
+    addPropertyListener(sim_tones, this, &USRP_i::simulationTonesChanged);
+}
+
+usrpSimSettings USRP_i::simulationSettings() const
+{
+    usrpSimSettings settings;
+    settings.realtime = sim_realtime;
+    settings.noise_level = sim_noise_level;
+    settings.fifo_time = sim_fifo_time;
+    settings.overflow_interval = sim_overflow_interval;
+    settings.lo_lock_time = sim_lo_lock_time;
+    settings.seed = sim_seed;
+    for (std::vector<sim_tone_struct>::const_iterator it=sim_tones.begin(); it!=sim_tones.end(); it++) {
+        usrpSimTone tone;
+        tone.frequency = it->frequency;
+        tone.level = it->level;
+        settings.tones.push_back(tone);
+    }
+    return settings;
+}
+
+void USRP_i::simulationFlagChanged(bool old_value, bool new_value)
+{
+    if (_sim_radio)
+        _sim_radio->configure(simulationSettings());
+}
+
+void USRP_i::simulationValueChanged(double old_value, double new_value)
+{
+    if (_sim_radio)
+        _sim_radio->configure(simulationSettings());
+}
+
+void USRP_i::simulationTonesChanged(const std::vector<sim_tone_struct>& old_value, const std::vector<sim_tone_struct>& new_value)
+{
+    if (_sim_radio)
+        _sim_radio->configure(simulationSettings());
+}
+
+namespace {
+    bool commandBefore(const timed_command_struct& a, const timed_command_struct& b)
+    {
+        return (a.twsec < b.twsec) or ((a.twsec == b.twsec) and (a.tfsec < b.tfsec));
+    }
+}
+
+/* issues each group of timed_commands entries that share a time together */
+void USRP_i::timedCommandsChanged(const std::vector<timed_command_struct>& old_value, const std::vector<timed_command_struct>& new_value)
+{
+    if (usrp_device_ptr.get() == NULL) {
+        RH_WARN(this->_baseLog, "timedCommandsChanged|no radio to command");
+        return;
+    }
+    std::vector<timed_command_struct> commands(new_value);
+    std::stable_sort(commands.begin(), commands.end(), commandBefore);
+    std::vector<timed_command_struct>::iterator first = commands.begin();
+    while (first != commands.end()) {
+        std::vector<timed_command_struct>::iterator last = first;
+        while ((last != commands.end()) and (last->twsec == first->twsec) and (last->tfsec == first->tfsec))
+            last++;
+        scheduleCommands(uhd::time_spec_t(time_t(first->twsec), first->tfsec), std::vector<timed_command_struct>(first, last));
+        first = last;
+    }
+}
+
+/* issues commands under one command time, so every channel they name changes
+ * on the same sample. RX channels find that sample as they receive it
+ * (RDC_i::expectChange()); nothing restarts their streams. Every command must
+ * name a controlling allocation and pass its tuner's checks, or none is issued
+ */
+void USRP_i::scheduleCommands(const uhd::time_spec_t& when, const std::vector<timed_command_struct>& commands)
+{
+    std::vector<RDC_ns::RDC_i*> rdcs(commands.size(), NULL);
+    std::vector<TDC_ns::TDC_i*> tdcs(commands.size(), NULL);
+    std::vector<bool> failed(commands.size(), false);
+    for (size_t i=0; i<commands.size(); i++) {
+        for (std::vector<RDC_ns::RDC_i*>::iterator it=RDCs.begin(); it!=RDCs.end(); it++) {
+            if ((*it)->hasAllocation(commands[i].allocation_id))
+                rdcs[i] = *it;
         }
-        for (unsigned int i=0; i<num_tx_channels; i++) {
-            std::ostringstream tdc_name;
-            tdc_name << "TDC_" << i+1;
-            TDCs.push_back(this->addChild<TDC_ns::TDC_i>(tdc_name.str()));
-            TDCs.back()->setTunerNumber(i);
-            TDCs.back()->setUHDptr(usrp_device_ptr);
+        for (std::vector<TDC_ns::TDC_i*>::iterator it=TDCs.begin(); it!=TDCs.end(); it++) {
+            if ((*it)->hasAllocation(commands[i].allocation_id))
+                tdcs[i] = *it;
+        }
+        const timed_command_struct& command = commands[i];
+        std::string error;
+        if ((rdcs[i] == NULL) and (tdcs[i] == NULL)) {
+            error = "is not on this device";
+        } else if (not ((rdcs[i] != NULL) ? rdcs[i]->isController(command.allocation_id) : tdcs[i]->isController(command.allocation_id))) {
+            error = "is a listener, which can't change the tuner";
+        } else if (rdcs[i] != NULL) {
+            rdcs[i]->validateTimedCommand(command.center_frequency, command.sample_rate, command.set_gain, command.gain, error);
+        } else {
+            tdcs[i]->validateTimedCommand(command.center_frequency, command.sample_rate, command.set_gain, command.gain, error);
+        }
+        if (not error.empty()) {
+            RH_WARN(this->_baseLog, "scheduleCommands|allocation " << command.allocation_id << ": " << error);
+            failed[i] = true;
         }
-        std::cout<<"len RDC: "<<RDCs.size()<<std::endl;
-        std::cout<<"len TDC: "<<TDCs.size()<<std::endl;
     }
-    setPropertyQueryImpl(frontend_tuner_status, this, &USRP_i::get_fts);
+    // the commands change their channels together or not at all
+    if (std::find(failed.begin(), failed.end(), true) != failed.end()) {
+        RH_WARN(this->_baseLog, "scheduleCommands|not issuing the " << commands.size() << " command(s) for " << when.get_real_secs());
+        failed.assign(commands.size(), true);
+    }
+
+    bool late = false;
+    if (std::find(failed.begin(), failed.end(), false) != failed.end()) {
+        boost::mutex::scoped_lock lock(*usrp_command_lock);
+        if (usrp_device_ptr->get_time_now() >= when) {
+            RH_WARN(this->_baseLog, "scheduleCommands|" << when.get_real_secs() << " is already past; not issuing " << commands.size() << " command(s)");
+            failed.assign(commands.size(), true);
+        } else {
+            usrp_device_ptr->set_command_time(when);
+            for (size_t i=0; i<commands.size(); i++) {
+                if (failed[i])
+                    continue;
+                const timed_command_struct& command = commands[i];
+                try {
+                    if (rdcs[i] != NULL) {
+                        const size_t chan = rdcs[i]->tunerNumber();
+                        if (command.center_frequency > 0)
+                            usrp_device_ptr->set_rx_freq(uhd::tune_request_t(command.center_frequency), chan);
+                        if (command.sample_rate > 0)
+                            usrp_device_ptr->set_rx_rate(command.sample_rate, chan);
+                        if (command.set_gain)
+                            usrp_device_ptr->set_rx_gain(command.gain, chan);
+                    } else {
+                        const size_t chan = tdcs[i]->tunerNumber();
+                        if (command.center_frequency > 0)
+                            usrp_device_ptr->set_tx_freq(uhd::tune_request_t(command.center_frequency), chan);
+                        if (command.sample_rate > 0)
+                            usrp_device_ptr->set_tx_rate(command.sample_rate, chan);
+                        if (command.set_gain)
+                            usrp_device_ptr->set_tx_gain(command.gain, chan);
+                    }
+                } catch (uhd::exception& e) {
+                    RH_ERROR(this->_baseLog, "scheduleCommands|command for " << command.allocation_id << " failed: " << e.what());
+                    failed[i] = true;
+                }
+            }
+            usrp_device_ptr->clear_command_time();
+            late = (usrp_device_ptr->get_time_now() > when);
+        }
+    }
+    if (late)
+        RH_WARN(this->_baseLog, "scheduleCommands|commands for " << when.get_real_secs() << " were issued late and took effect after it");
+
+    for (size_t i=0; i<commands.size(); i++) {
+        usrpCommandLog::state_t state = usrpCommandLog::FAILED;
+        if (not failed[i])
+            state = (rdcs[i] != NULL) ? usrpCommandLog::SCHEDULED : usrpCommandLog::ISSUED;
+        const uint64_t id = _command_log->add(commands[i].allocation_id, when, state);
+        if (failed[i])
+            continue;
+        if (late)
+            _command_log->setLate(id);
+
+        // the channel's full state from 'when' on
+        usrpTimedChange change;
+        change.id = id;
+        change.when = when;
+        if (rdcs[i] != NULL) {
+            const size_t chan = rdcs[i]->tunerNumber();
+            change.center_frequency = usrp_device_ptr->get_rx_freq(chan);
+            change.sample_rate = usrp_device_ptr->get_rx_rate(chan);
+            change.gain = usrp_device_ptr->get_rx_gain(chan);
+            rdcs[i]->expectChange(change);
+        } else {
+            const size_t chan = tdcs[i]->tunerNumber();
+            change.center_frequency = usrp_device_ptr->get_tx_freq(chan);
+            change.sample_rate = usrp_device_ptr->get_tx_rate(chan);
+            change.gain = usrp_device_ptr->get_tx_gain(chan);
+            tdcs[i]->expectChange(change);
+        }
+    }
+    RH_DEBUG(this->_baseLog, "scheduleCommands|issued " << commands.size() << " command(s) for " << when.get_real_secs());
+}
+
+std::vector<timed_command_result_struct> USRP_i::getTimedCommandStatus()
+{
+    static const char* STATES[] = {"SCHEDULED", "LANDED", "ISSUED", "FAILED"};
+    std::vector<timed_command_result_struct> results;
+    if (not _command_log)
+        return results;
+    const std::vector<usrpCommandLog::entry> entries = _command_log->entries();
+    for (size_t i=0; i<entries.size(); i++) {
+        timed_command_result_struct result;
+        result.id = entries[i].id;
+        result.allocation_id = entries[i].allocation_id;
+        result.twsec = (double)entries[i].when.get_full_secs();
+        result.tfsec = entries[i].when.get_frac_secs();
+        result.state = STATES[entries[i].state];
+        result.late = entries[i].late;
+        result.sample_index = entries[i].sample_index;
+        results.push_back(result);
+    }
+    timed_command_status = results;
+    return results;
 }
 
 std::vector<frontend_tuner_status_struct_struct> USRP_i::get_fts()
@@ -172,6 +415,60 @@ std::vector<frontend_tuner_status_struct_struct> USRP_i::get_fts()
             }
         }
     }
+    for (std::vector<DDC_ns::DDC_i*>::iterator it=DDCs.begin(); it!=DDCs.end(); it++) {
+        Device_impl* dev = dynamic_cast<Device_impl*>(*it);
+        CF::Properties prop;
+        prop.length(1);
+        prop[0].value = CORBA::Any();
+        prop[0].id = CORBA::string_dup("FRONTEND::tuner_status");
+        if (dev) {
+            dev->query(prop);
+            CORBA::AnySeq *anySeqPtr;
+            frontend_tuner_status_struct_struct tmp;
+            if (prop[0].value >>= anySeqPtr) {
+                CORBA::AnySeq& anySeq = *anySeqPtr;
+                if (anySeq[0] >>= tmp) {
+                    frontend_tuner_status.push_back(tmp);
+                }
+            }
+        }
+    }
+    for (std::vector<SRDC_ns::SRDC_i*>::iterator it=SRDCs.begin(); it!=SRDCs.end(); it++) {
+        Device_impl* dev = dynamic_cast<Device_impl*>(*it);
+        CF::Properties prop;
+        prop.length(1);
+        prop[0].value = CORBA::Any();
+        prop[0].id = CORBA::string_dup("FRONTEND::tuner_status");
+        if (dev) {
+            dev->query(prop);
+            CORBA::AnySeq *anySeqPtr;
+            frontend_tuner_status_struct_struct tmp;
+            if (prop[0].value >>= anySeqPtr) {
+                CORBA::AnySeq& anySeq = *anySeqPtr;
+                if (anySeq[0] >>= tmp) {
+                    frontend_tuner_status.push_back(tmp);
+                }
+            }
+        }
+    }
+    for (std::vector<DRDC_ns::DRDC_i*>::iterator it=DRDCs.begin(); it!=DRDCs.end(); it++) {
+        Device_impl* dev = dynamic_cast<Device_impl*>(*it);
+        CF::Properties prop;
+        prop.length(1);
+        prop[0].value = CORBA::Any();
+        prop[0].id = CORBA::string_dup("FRONTEND::tuner_status");
+        if (dev) {
+            dev->query(prop);
+            CORBA::AnySeq *anySeqPtr;
+            frontend_tuner_status_struct_struct tmp;
+            if (prop[0].value >>= anySeqPtr) {
+                CORBA::AnySeq& anySeq = *anySeqPtr;
+                if (anySeq[0] >>= tmp) {
+                    frontend_tuner_status.push_back(tmp);
+                }
+            }
+        }
+    }
     return frontend_tuner_status;
 }
 
@@ -540,20 +837,63 @@ throw (CF::Device::InvalidState, CF::Device::InvalidCapacity, CF::Device::Insuff
     redhawk::PropertyMap& local_props = redhawk::PropertyMap::cast(local_capacities);
     local_props = props;
 
+    // allocation ids of existing RX tuners this one must be sample-aligned with
+    std::vector<std::string> coherent_feeds;
     if (local_props.find("FRONTEND::coherent_feeds") != local_props.end()) {
-        /*redhawk::PropertyMap& tuner_alloc = redhawk::PropertyMap::cast(local_props["FRONTEND::tuner_allocation"].asProperties());
-        if (tuner_alloc.find("FRONTEND::tuner_allocation::allocation_id") != tuner_alloc.end()) {
-            std::string requested_alloc = tuner_alloc["FRONTEND::tuner_allocation::allocation_id"].toString();
-            if (not requested_alloc.empty()) {
-                if (_delegatedAllocations.find(requested_alloc) == _delegatedAllocations.end()) {
-                    allocation_id = requested_alloc;
-                } else {
-                    allocation_id = "_"+allocation_id;
-                    allocation_id = requested_alloc+allocation_id;
-                }
-                tuner_alloc["FRONTEND::tuner_allocation::allocation_id"] = allocation_id;
+        const CF::StringSequence* feeds;
+        if (local_props["FRONTEND::coherent_feeds"] >>= feeds) {
+            for (CORBA::ULong i=0; i<feeds->length(); i++) {
+                coherent_feeds.push_back(std::string((*feeds)[i]));
             }
-        }*/
+        }
+        // handled here; the children only know tuner and listener allocations
+        local_props.erase("FRONTEND::coherent_feeds");
+    }
+    // a snapshot window makes this an SRDC allocation, whatever tuner type was asked for
+    bool snapshot = false;
+    BULKIO::PrecisionUTCTime snapshot_start, snapshot_stop;
+    if (local_props.find("FRONTEND::snapshot") != local_props.end()) {
+        frontend_snapshot_struct window;
+        window.snapshot_start_whole_seconds = window.snapshot_start_partial_seconds = 0;
+        window.snapshot_stop_whole_seconds = window.snapshot_stop_partial_seconds = 0;
+        if (local_props["FRONTEND::snapshot"] >>= window) {
+            snapshot = true;
+            snapshot_start = bulkio::time::utils::create(window.snapshot_start_whole_seconds, window.snapshot_start_partial_seconds);
+            snapshot_stop = bulkio::time::utils::create(window.snapshot_stop_whole_seconds, window.snapshot_stop_partial_seconds);
+        }
+        local_props.erase("FRONTEND::snapshot");
+        if (snapshot and (local_props.find("FRONTEND::tuner_allocation") != local_props.end())) {
+            redhawk::PropertyMap& tuner_alloc = redhawk::PropertyMap::cast(local_props["FRONTEND::tuner_allocation"].asProperties());
+            tuner_alloc["FRONTEND::tuner_allocation::tuner_type"] = "SRDC";
+        }
+    }
+    // likewise a delay makes it a DRDC allocation
+    bool delay = false;
+    frontend_delay_struct delay_request;
+    if (local_props.find("FRONTEND::delay") != local_props.end()) {
+        delay_request.delay_whole_seconds = delay_request.delay_partial_seconds = 0;
+        delay_request.delay_relative = true;
+        if (local_props["FRONTEND::delay"] >>= delay_request) {
+            delay = true;
+        }
+        local_props.erase("FRONTEND::delay");
+        if (delay and (local_props.find("FRONTEND::tuner_allocation") != local_props.end())) {
+            redhawk::PropertyMap& tuner_alloc = redhawk::PropertyMap::cast(local_props["FRONTEND::tuner_allocation"].asProperties());
+            tuner_alloc["FRONTEND::tuner_allocation::tuner_type"] = "DRDC";
+        }
+    }
+    // and a scanner allocation is an RDC allocation that the RDC runs the scan on
+    bool scanner = false;
+    frontend::frontend_scanner_allocation_struct scan_request;
+    if (local_props.find("FRONTEND::scanner_allocation") != local_props.end()) {
+        if (local_props["FRONTEND::scanner_allocation"] >>= scan_request) {
+            scanner = true;
+        }
+        local_props.erase("FRONTEND::scanner_allocation");
+        if (scanner and (local_props.find("FRONTEND::tuner_allocation") != local_props.end())) {
+            redhawk::PropertyMap& tuner_alloc = redhawk::PropertyMap::cast(local_props["FRONTEND::tuner_allocation"].asProperties());
+            tuner_alloc["FRONTEND::tuner_allocation::tuner_type"] = "RDC";
+        }
     }
     if (local_props.find("FRONTEND::tuner_allocation") != local_props.end()) {
         redhawk::PropertyMap& tuner_alloc = redhawk::PropertyMap::cast(local_props["FRONTEND::tuner_allocation"].asProperties());
@@ -602,7 +942,46 @@ throw (CF::Device::InvalidState, CF::Device::InvalidCapacity, CF::Device::Insuff
     }
 
     for (std::vector<RDC_ns::RDC_i*>::iterator it=RDCs.begin(); it!=RDCs.end(); it++) {
+        if (scanner)
+            (*it)->setScanRequest(scan_request);
+        result = (*it)->allocate(local_capacities);
+        (*it)->clearScanRequest();
+        if (result->length() > 0) {
+            if ((not coherent_feeds.empty()) and (not formRxGroup(*it, coherent_feeds))) {
+                (*it)->deallocate(allocation_id.c_str());
+                return new CF::Device::Allocations();
+            }
+            _delegatedAllocations[allocation_id] = result;
+            return result._retn();
+        }
+    }
+    if (scanner)
+        return result._retn();
+
+    for (std::vector<DDC_ns::DDC_i*>::iterator it=DDCs.begin(); it!=DDCs.end(); it++) {
+        result = (*it)->allocate(local_capacities);
+        if (result->length() > 0) {
+            _delegatedAllocations[allocation_id] = result;
+            return result._retn();
+        }
+    }
+
+    for (std::vector<SRDC_ns::SRDC_i*>::iterator it=SRDCs.begin(); it!=SRDCs.end(); it++) {
+        if (snapshot)
+            (*it)->setSnapshotWindow(snapshot_start, snapshot_stop);
+        result = (*it)->allocate(local_capacities);
+        (*it)->clearSnapshotWindow();
+        if (result->length() > 0) {
+            _delegatedAllocations[allocation_id] = result;
+            return result._retn();
+        }
+    }
+
+    for (std::vector<DRDC_ns::DRDC_i*>::iterator it=DRDCs.begin(); it!=DRDCs.end(); it++) {
+        if (delay)
+            (*it)->setDelayRequest(delay_request.delay_relative, delay_request.delay_whole_seconds, delay_request.delay_partial_seconds);
         result = (*it)->allocate(local_capacities);
+        (*it)->clearDelayRequest();
         if (result->length() > 0) {
             _delegatedAllocations[allocation_id] = result;
             return result._retn();
@@ -625,6 +1004,7 @@ throw (CF::Device::InvalidState, CF::Device::InvalidCapacity, CORBA::SystemExcep
 {
     std::string _alloc_id = ossie::corba::returnString(alloc_id);
     if (_delegatedAllocations.find(_alloc_id) != _delegatedAllocations.end()) {
+        releaseRxGroup(_alloc_id);
         for (size_t i=0; i<_delegatedAllocations[_alloc_id]->length(); i++) {
             CF::Device_ptr dev = _delegatedAllocations[_alloc_id][i].device_ref;
             dev->deallocate(alloc_id);
@@ -635,6 +1015,160 @@ throw (CF::Device::InvalidState, CF::Device::InvalidCapacity, CORBA::SystemExcep
     throw CF::Device::InvalidCapacity("Capacities do not match allocated ones in the child devices", invalidProps);
 }
 
+/* called from a coherent RX group's receive thread when recv() fails */
+void USRP_i::rxGroupError(const std::string& error, bool stopped)
+{
+    if (stopped) {
+        RH_ERROR(this->_baseLog, "rxGroupError|coherent RX group stopped after repeated receive errors (" << error << "); its tuners receive on their own");
+    } else {
+        RH_WARN(this->_baseLog, "rxGroupError|coherent RX group receive failed: " << error << "; retrying");
+    }
+}
+
+/* gives every RDC a filterbank of channelizer_channels DDC children, named
+ * DDC_<rdc>_<channel>
+ */
+void USRP_i::createChannelizers()
+{
+    if ((channelizer_channels < 2) or ((channelizer_channels & (channelizer_channels-1)) != 0) or (channelizer_taps_per_channel < 2)) {
+        RH_ERROR(this->_baseLog, "channelizer_channels must be a power of two and channelizer_taps_per_channel at least 2; no DDCs created");
+        return;
+    }
+    for (size_t i=0; i<RDCs.size(); i++) {
+        std::vector<DDC_ns::DDC_i*> ddcs;
+        for (size_t k=0; k<channelizer_channels; k++) {
+            std::ostringstream ddc_name;
+            ddc_name << "DDC_" << i+1 << "_" << k+1;
+            ddcs.push_back(this->addChild<DDC_ns::DDC_i>(ddc_name.str()));
+        }
+        RDCs[i]->enableChannelizer(channelizer_channels, channelizer_taps_per_channel, ddcs);
+        DDCs.insert(DDCs.end(), ddcs.begin(), ddcs.end());
+    }
+}
+
+/* gives every RDC an SRDC child, named SRDC_<rdc> */
+void USRP_i::createSnapshotChannels()
+{
+    for (size_t i=0; i<RDCs.size(); i++) {
+        std::ostringstream srdc_name;
+        srdc_name << "SRDC_" << i+1;
+        SRDCs.push_back(this->addChild<SRDC_ns::SRDC_i>(srdc_name.str()));
+        RDCs[i]->enableSnapshots(SRDCs.back());
+    }
+}
+
+/* gives every RDC a DRDC child, named DRDC_<rdc> */
+void USRP_i::createDelayChannels()
+{
+    for (size_t i=0; i<RDCs.size(); i++) {
+        std::ostringstream drdc_name;
+        drdc_name << "DRDC_" << i+1;
+        DRDCs.push_back(this->addChild<DRDC_ns::DRDC_i>(drdc_name.str()));
+        RDCs[i]->enableDelay(DRDCs.back());
+    }
+}
+
+/* puts rdc in one coherent RX group with the tuners holding the allocations in
+ * feeds (and with whatever groups those are already in). Returns false if the
+ * group can't be formed, in which case existing groups are left alone.
+ */
+bool USRP_i::formRxGroup(RDC_ns::RDC_i* rdc, const std::vector<std::string>& feeds)
+{
+    boost::mutex::scoped_lock lock(_rx_group_lock);
+
+    std::vector<RDC_ns::RDC_i*> members(1, rdc);
+    for (std::vector<std::string>::const_iterator feed=feeds.begin(); feed!=feeds.end(); feed++) {
+        RDC_ns::RDC_i* found = NULL;
+        for (std::vector<RDC_ns::RDC_i*>::iterator it=RDCs.begin(); it!=RDCs.end(); it++) {
+            if ((*it)->hasAllocation(*feed))
+                found = *it;
+        }
+        if (found == NULL) {
+            RH_WARN(this->_baseLog, "formRxGroup|coherent feed " << *feed << " is not an RX allocation on this device");
+            return false;
+        }
+        if (std::find(members.begin(), members.end(), found) == members.end())
+            members.push_back(found);
+    }
+
+    // a tuner can only be in one group, so overlapping groups merge into the new one
+    std::vector<std::vector<boost::shared_ptr<usrpRxGroup> >::iterator> merged;
+    for (std::vector<boost::shared_ptr<usrpRxGroup> >::iterator it=_rx_groups.begin(); it!=_rx_groups.end(); it++) {
+        bool overlaps = false;
+        for (size_t i=0; i<members.size(); i++) {
+            overlaps = overlaps or (*it)->contains(members[i]);
+        }
+        if (not overlaps)
+            continue;
+        merged.push_back(it);
+        const std::vector<RDC_ns::RDC_i*>& group_members = (*it)->members();
+        for (size_t i=0; i<group_members.size(); i++) {
+            if (std::find(members.begin(), members.end(), group_members[i]) == members.end())
+                members.push_back(group_members[i]);
+        }
+    }
+
+    for (size_t i=0; i<members.size(); i++) {
+        if (members[i]->rxSampleRate() != rdc->rxSampleRate()) {
+            RH_WARN(this->_baseLog, "formRxGroup|coherent tuners must share a sample rate (" << rdc->rxSampleRate()
+                    << " vs " << members[i]->rxSampleRate() << " on tuner " << members[i]->tunerNumber() << ")");
+            return false;
+        }
+    }
+
+    for (std::vector<std::vector<boost::shared_ptr<usrpRxGroup> >::iterator>::reverse_iterator it=merged.rbegin(); it!=merged.rend(); it++) {
+        (**it)->stop();
+        _rx_groups.erase(*it);
+    }
+
+    boost::shared_ptr<usrpRxGroup> group(new usrpRxGroup(usrp_device_ptr, usrp_command_lock, members,
+                                                      boost::bind(&USRP_i::rxGroupError, this, _1, _2)));
+    std::string error;
+    if (not group->start(error)) {
+        RH_ERROR(this->_baseLog, "formRxGroup|unable to start coherent RX group: " << error);
+        return false;
+    }
+    _rx_groups.push_back(group);
+    RH_DEBUG(this->_baseLog, "formRxGroup|receiving " << members.size() << " tuners coherently");
+    return true;
+}
+
+/* takes the tuner holding allocation_id out of its coherent RX group, if any;
+ * the rest of the group keeps streaming together as long as two remain
+ */
+void USRP_i::releaseRxGroup(const std::string& allocation_id)
+{
+    boost::mutex::scoped_lock lock(_rx_group_lock);
+    for (std::vector<boost::shared_ptr<usrpRxGroup> >::iterator it=_rx_groups.begin(); it!=_rx_groups.end(); it++) {
+        std::vector<RDC_ns::RDC_i*> remaining;
+        bool found = false;
+        const std::vector<RDC_ns::RDC_i*>& group_members = (*it)->members();
+        for (size_t i=0; i<group_members.size(); i++) {
+            if (group_members[i]->hasAllocation(allocation_id)) {
+                found = true;
+            } else {
+                remaining.push_back(group_members[i]);
+            }
+        }
+        if (not found)
+            continue;
+
+        (*it)->stop();
+        _rx_groups.erase(it);
+        if (remaining.size() > 1) {
+            boost::shared_ptr<usrpRxGroup> group(new usrpRxGroup(usrp_device_ptr, usrp_command_lock, remaining,
+                                                              boost::bind(&USRP_i::rxGroupError, this, _1, _2)));
+            std::string error;
+            if (group->start(error)) {
+                _rx_groups.push_back(group);
+            } else {
+                RH_ERROR(this->_baseLog, "releaseRxGroup|unable to restart coherent RX group: " << error);
+            }
+        }
+        return;
+    }
+}
+
 /*************************************************************
 Functions supporting tuning allocation
 *************************************************************/
@@ -652,7 +1186,8 @@ void USRP_i::deviceDisable(frontend_tuner_status_struct_struct &fts, size_t tune
 }
 bool USRP_i::deviceSetTuningScan(const frontend::frontend_tuner_allocation_struct &request, const frontend::frontend_scanner_allocation_struct &scan_request, frontend_tuner_status_struct_struct &fts, size_t tuner_id){
     /************************************************************
-     *  not used. All allocations delegated to children
+     *  not used. All allocations delegated to children; scanner
+     *  allocations go to an RDC, which runs the scan
     ************************************************************/
     return false;
 }
@@ -946,6 +1481,10 @@ CF::Properties* USRP_i::getTunerSettings(const std::string& allocation_id){
 }
 
 frontend::ScanStatus USRP_i::getScanStatus(const std::string& allocation_id) {
+    for (std::vector<RDC_ns::RDC_i*>::iterator it=RDCs.begin(); it!=RDCs.end(); it++) {
+        if ((*it)->isScanner(allocation_id))
+            return (*it)->getScanStatus();
+    }
     long idx = getTunerMapping(allocation_id);
     if (idx < 0) {
         if (_delegatedAllocations.find(allocation_id) != _delegatedAllocations.end()) {
@@ -1033,6 +1572,10 @@ frontend::ScanStatus USRP_i::getScanStatus(const std::string& allocation_id) {
 }
 
 void USRP_i::setScanStartTime(const std::string& allocation_id, const BULKIO::PrecisionUTCTime& start_time) {
+    for (std::vector<RDC_ns::RDC_i*>::iterator it=RDCs.begin(); it!=RDCs.end(); it++) {
+        if ((*it)->isScanner(allocation_id))
+            return (*it)->setScanStartTime(start_time);
+    }
     long idx = getTunerMapping(allocation_id);
     if (idx < 0) {
         if (_delegatedAllocations.find(allocation_id) != _delegatedAllocations.end()) {
@@ -1045,6 +1588,13 @@ void USRP_i::setScanStartTime(const std::string& allocation_id, const BULKIO::Pr
 }
 
 void USRP_i::setScanStrategy(const std::string& allocation_id, const frontend::ScanStrategy* scan_strategy) {
+    for (std::vector<RDC_ns::RDC_i*>::iterator it=RDCs.begin(); it!=RDCs.end(); it++) {
+        if ((*it)->isScanner(allocation_id)) {
+            if (scan_strategy == NULL)
+                throw FRONTEND::BadParameterException("No scan strategy");
+            return (*it)->setScanStrategy(*scan_strategy);
+        }
+    }
     long idx = getTunerMapping(allocation_id);
     if (idx < 0) {
         if (_delegatedAllocations.find(allocation_id) != _delegatedAllocations.end()) {
@@ -2,10 +2,15 @@
 #define USRP_I_IMPL_H
 
 #include "USRP_base.h"
-#include <uhd/usrp/multi_usrp.hpp>
+#include "radio_uhd.h"
+#include "radio_sim.h"
 
 #include "RDC/RDC.h"
 #include "TDC/TDC.h"
+#include "DDC/DDC.h"
+#include "SRDC/SRDC.h"
+#include "DRDC/DRDC.h"
+#include "rx_group.h"
 
 /*#include <uhd/types/ranges.hpp>
 #include <boost/algorithm/string.hpp> //for split
@@ -66,8 +71,36 @@ class USRP_i : public USRP_base
 
         std::vector<RDC_ns::RDC_i*> RDCs;
         std::vector<TDC_ns::TDC_i*> TDCs;
+        std::vector<DDC_ns::DDC_i*> DDCs; // filterbank channels of the RDCs, if channelizer_channels is set
+        std::vector<SRDC_ns::SRDC_i*> SRDCs; // one per RDC, if srdc_enable is set
+        std::vector<DRDC_ns::DRDC_i*> DRDCs; // one per RDC, if drdc_enable is set
         std::map<std::string, CF::Device::Allocations_var> _delegatedAllocations;
-        uhd::usrp::multi_usrp::sptr usrp_device_ptr;
+        usrpRadio::sptr usrp_device_ptr;
+        boost::shared_ptr<usrpSimRadio> _sim_radio; // usrp_device_ptr, if radio_backend is SIMULATED
+        usrp_command_lock_t usrp_command_lock;
+        void createUHDRadio();
+        void createSimulatedRadio();
+        usrpSimSettings simulationSettings() const;
+        void simulationFlagChanged(bool old_value, bool new_value);
+        void simulationValueChanged(double old_value, double new_value);
+        void simulationTonesChanged(const std::vector<sim_tone_struct>& old_value, const std::vector<sim_tone_struct>& new_value);
+
+        // timed_commands: changes issued with a command time so the channels
+        // they name all change on the same sample; outcomes in timed_command_status
+        usrp_command_log_t _command_log;
+        void timedCommandsChanged(const std::vector<timed_command_struct>& old_value, const std::vector<timed_command_struct>& new_value);
+        void scheduleCommands(const uhd::time_spec_t& when, const std::vector<timed_command_struct>& commands);
+        std::vector<timed_command_result_struct> getTimedCommandStatus();
+
+        // coherent RX groups formed from FRONTEND::coherent_feeds allocations
+        std::vector<boost::shared_ptr<usrpRxGroup> > _rx_groups;
+        boost::mutex _rx_group_lock;
+        bool formRxGroup(RDC_ns::RDC_i* rdc, const std::vector<std::string>& feeds);
+        void releaseRxGroup(const std::string& allocation_id);
+        void rxGroupError(const std::string& error, bool stopped);
+        void createChannelizers();
+        void createSnapshotChannels();
+        void createDelayChannels();
         // Try to synchronize the USRP time to its clock source
         bool _synchronizeClock(const std::string source);
 
@@ -138,6 +138,24 @@ void USRP_base::loadProperties()
                 "external",
                 "property");
 
+    addProperty(frontend_snapshot,
+                frontend_snapshot_struct(),
+                "FRONTEND::snapshot",
+                "frontend_snapshot",
+                "writeonly",
+                "",
+                "external",
+                "allocation");
+
+    addProperty(frontend_delay,
+                frontend_delay_struct(),
+                "FRONTEND::delay",
+                "frontend_delay",
+                "writeonly",
+                "",
+                "external",
+                "allocation");
+
     addProperty(frontend_coherent_feeds,
                 "FRONTEND::coherent_feeds",
                 "frontend_coherent_feeds",
@@ -146,6 +164,156 @@ void USRP_base::loadProperties()
                 "external",
                 "allocation");
 
+    addProperty(channelizer_channels,
+                0,
+                "channelizer_channels",
+                "channelizer_channels",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(channelizer_taps_per_channel,
+                16,
+                "channelizer_taps_per_channel",
+                "channelizer_taps_per_channel",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(srdc_enable,
+                false,
+                "srdc_enable",
+                "srdc_enable",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(drdc_enable,
+                false,
+                "drdc_enable",
+                "drdc_enable",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(radio_backend,
+                "UHD",
+                "radio_backend",
+                "radio_backend",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(sim_rx_channels,
+                2,
+                "sim_rx_channels",
+                "sim_rx_channels",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(sim_tx_channels,
+                1,
+                "sim_tx_channels",
+                "sim_tx_channels",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(sim_master_clock_rate,
+                100000000.0,
+                "sim_master_clock_rate",
+                "sim_master_clock_rate",
+                "readwrite",
+                "Hz",
+                "external",
+                "property");
+
+    addProperty(sim_seed,
+                1,
+                "sim_seed",
+                "sim_seed",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(sim_realtime,
+                true,
+                "sim_realtime",
+                "sim_realtime",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(sim_noise_level,
+                -70.0,
+                "sim_noise_level",
+                "sim_noise_level",
+                "readwrite",
+                "dBFS",
+                "external",
+                "property");
+
+    addProperty(sim_fifo_time,
+                0.1,
+                "sim_fifo_time",
+                "sim_fifo_time",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(sim_overflow_interval,
+                0.0,
+                "sim_overflow_interval",
+                "sim_overflow_interval",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(sim_lo_lock_time,
+                0.0005,
+                "sim_lo_lock_time",
+                "sim_lo_lock_time",
+                "readwrite",
+                "s",
+                "external",
+                "property");
+
+    addProperty(sim_tones,
+                "sim_tones",
+                "sim_tones",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(timed_commands,
+                "timed_commands",
+                "timed_commands",
+                "readwrite",
+                "",
+                "external",
+                "property");
+
+    addProperty(timed_command_status,
+                "timed_command_status",
+                "timed_command_status",
+                "readonly",
+                "",
+                "external",
+                "property");
+
     frontend_listener_allocation = frontend::frontend_listener_allocation_struct();
     frontend_tuner_allocation = frontend::frontend_tuner_allocation_struct();
     frontend_scanner_allocation = frontend::frontend_scanner_allocation_struct();
@@ -58,8 +58,46 @@ class USRP_base : public frontend::FrontendScanningTunerDevice<frontend_tuner_st
         std::string ip_address;
         /// Property: device_mode
         std::string device_mode;
+        /// Property: frontend_snapshot
+        frontend_snapshot_struct frontend_snapshot;
+        /// Property: frontend_delay
+        frontend_delay_struct frontend_delay;
         /// Property: frontend_coherent_feeds
         std::vector<std::string> frontend_coherent_feeds;
+        /// Property: channelizer_channels
+        CORBA::ULong channelizer_channels;
+        /// Property: channelizer_taps_per_channel
+        CORBA::ULong channelizer_taps_per_channel;
+        /// Property: srdc_enable
+        bool srdc_enable;
+        /// Property: drdc_enable
+        bool drdc_enable;
+        /// Property: radio_backend
+        std::string radio_backend;
+        /// Property: sim_rx_channels
+        CORBA::ULong sim_rx_channels;
+        /// Property: sim_tx_channels
+        CORBA::ULong sim_tx_channels;
+        /// Property: sim_master_clock_rate
+        double sim_master_clock_rate;
+        /// Property: sim_seed
+        CORBA::ULong sim_seed;
+        /// Property: sim_realtime
+        bool sim_realtime;
+        /// Property: sim_noise_level
+        double sim_noise_level;
+        /// Property: sim_fifo_time
+        double sim_fifo_time;
+        /// Property: sim_overflow_interval
+        double sim_overflow_interval;
+        /// Property: sim_lo_lock_time
+        double sim_lo_lock_time;
+        /// Property: sim_tones
+        std::vector<sim_tone_struct> sim_tones;
+        /// Property: timed_commands
+        std::vector<timed_command_struct> timed_commands;
+        /// Property: timed_command_status
+        std::vector<timed_command_result_struct> timed_command_status;
         /// Property: device_characteristics
         device_characteristics_struct device_characteristics;
 
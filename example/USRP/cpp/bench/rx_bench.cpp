@@ -0,0 +1,691 @@
+/* RX hot path benchmark: runs RDC_i capture (recv, rx_ring, serviceFunction,
+ * dataShort_out) against the simulated radio over a sweep of sample rates and
+ * buffer sizes, and prints one result per run as a JSON line (or CSV).
+ *
+ *   usrp_rx_bench [--rates=1e6,10e6] [--buffers=0,65536] [--modes=realtime,max]
+ *                 [--channels=1] [--duration=5] [--warmup=1] [--format=json|csv]
+ *
+ *  - buffers are in complex samples; 0 keeps the size the device picks
+ *  - realtime runs the radio off the clock, so samples_per_sec shows whether
+ *    the device keeps up at that rate (lost_samples, overflows); max runs it
+ *    as fast as it is read, which gives the ceiling of the hot path
+ *  - latency is from the recv() that completed a buffer returning to the
+ *    buffer reaching an in-process dataShort_out connection
+ *  - allocations are process-wide operator new calls; the CPU figures leave
+ *    out the sink threads, and the time spent making samples in the simulated
+ *    radio is reported separately as radio_cpu_percent_per_channel
+ */
+#include "../RDC/RDC.h"
+#include "../radio_sim.h"
+
+#include <ossie/CorbaUtils.h>
+#include <bulkio/bulkio.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <pthread.h>
+#include <time.h>
+
+/* every operator new in the process is counted */
+static std::atomic<uint64_t> g_allocations(0);
+static std::atomic<uint64_t> g_allocated_bytes(0);
+
+static void* countedAlloc(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+    void* ptr = countedAlloc(size);
+    if (ptr == NULL)
+        throw std::bad_alloc();
+    return ptr;
+}
+void* operator new[](size_t size)
+{
+    void* ptr = countedAlloc(size);
+    if (ptr == NULL)
+        throw std::bad_alloc();
+    return ptr;
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    free(ptr);
+}
+
+namespace {
+    int64_t clockNs(clockid_t clock)
+    {
+        struct timespec now;
+        clock_gettime(clock, &now);
+        return int64_t(now.tv_sec)*1000000000 + now.tv_nsec;
+    }
+
+    int64_t monotonicNs()
+    {
+        return clockNs(CLOCK_MONOTONIC);
+    }
+
+    int64_t processCpuNs()
+    {
+        return clockNs(CLOCK_PROCESS_CPUTIME_ID);
+    }
+
+    int64_t threadCpuNs(boost::thread& thread)
+    {
+        clockid_t clock;
+        if (pthread_getcpuclockid(thread.native_handle(), &clock) != 0)
+            return 0;
+        return clockNs(clock);
+    }
+
+    void sleepSeconds(double seconds)
+    {
+        boost::this_thread::sleep(boost::posix_time::microseconds(long(seconds*1e6)));
+    }
+}
+
+/* when each recv() returned, by the time of its first sample, so the sink can
+ * tell how long a buffer took to get from the radio to the output port
+ */
+class recvLog {
+    public:
+        struct entry {
+            time_t secs;
+            double frac;
+            int64_t returned_ns;
+        };
+
+        recvLog() : _head(0), _tail(0) {
+            _entries.resize(CAPACITY);
+        }
+
+        void push(const uhd::time_spec_t& time, int64_t returned_ns) {
+            boost::mutex::scoped_lock lock(_lock);
+            entry& slot = _entries[_tail % CAPACITY];
+            slot.secs = time.get_full_secs();
+            slot.frac = time.get_frac_secs();
+            slot.returned_ns = returned_ns;
+            _tail++;
+            if (_tail - _head > CAPACITY)
+                _head = _tail - CAPACITY;
+        }
+
+        /* drops the entries for samples before end and returns the last of
+         * them, which is the recv() that completed a buffer ending there
+         */
+        bool popUntil(const BULKIO::PrecisionUTCTime& end, entry& last) {
+            boost::mutex::scoped_lock lock(_lock);
+            bool found = false;
+            while (_head != _tail) {
+                const entry& oldest = _entries[_head % CAPACITY];
+                if ((double(oldest.secs) - end.twsec) + (oldest.frac - end.tfsec) >= 0)
+                    break;
+                last = oldest;
+                found = true;
+                _head++;
+            }
+            return found;
+        }
+
+    private:
+        static const uint64_t CAPACITY = 1 << 16;
+        boost::mutex _lock;
+        std::vector<entry> _entries;
+        uint64_t _head;
+        uint64_t _tail;
+};
+
+/* times the simulated radio's recv() so its CPU can be told apart from the device's */
+class benchRxStream : public usrpRxStream {
+    public:
+        benchRxStream(const usrpRxStream::sptr& stream, recvLog& log, std::atomic<int64_t>& cpu_ns, std::atomic<uint64_t>& overflows) :
+            _stream(stream), _log(log), _cpu_ns(cpu_ns), _overflows(overflows) {
+        }
+
+        size_t get_num_channels() const {
+            return _stream->get_num_channels();
+        }
+        size_t get_max_num_samps() const {
+            return _stream->get_max_num_samps();
+        }
+        size_t recv(const uhd::rx_streamer::buffs_type& buffs, const size_t nsamps_per_buff,
+                    uhd::rx_metadata_t& metadata, const double timeout, const bool one_packet) {
+            const int64_t cpu = clockNs(CLOCK_THREAD_CPUTIME_ID);
+            const size_t num_samps = _stream->recv(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+            _cpu_ns.fetch_add(clockNs(CLOCK_THREAD_CPUTIME_ID) - cpu, std::memory_order_relaxed);
+            if (metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_OVERFLOW)
+                _overflows.fetch_add(1, std::memory_order_relaxed);
+            if ((num_samps > 0) and metadata.has_time_spec)
+                _log.push(metadata.time_spec, monotonicNs());
+            return num_samps;
+        }
+        void issue_stream_cmd(const uhd::stream_cmd_t& stream_cmd) {
+            _stream->issue_stream_cmd(stream_cmd);
+        }
+
+    private:
+        usrpRxStream::sptr _stream;
+        recvLog& _log;
+        std::atomic<int64_t>& _cpu_ns;
+        std::atomic<uint64_t>& _overflows;
+};
+
+class benchRadio : public usrpSimRadio {
+    public:
+        benchRadio(size_t channels, double master_clock_rate, const usrpSimSettings& settings) :
+            usrpSimRadio(channels, 0, master_clock_rate, settings),
+            logs(channels),
+            cpu_ns(0),
+            overflows(0) {
+        }
+
+        usrpRxStream::sptr get_rx_stream(const uhd::stream_args_t& args) {
+            const usrpRxStream::sptr stream = usrpSimRadio::get_rx_stream(args);
+            const size_t chan = args.channels.empty() ? 0 : args.channels[0];
+            return usrpRxStream::sptr(new benchRxStream(stream, logs[chan], cpu_ns, overflows));
+        }
+
+        std::vector<recvLog> logs;
+        std::atomic<int64_t> cpu_ns;        // spent in recv()
+        std::atomic<uint64_t> overflows;
+};
+
+/* RDC_i with the knobs the sweep needs */
+class benchRDC : public RDC_ns::RDC_i {
+    public:
+        benchRDC(char* devMgr_ior, char* id, char* lbl, char* sftwrPrfl) :
+            RDC_i(devMgr_ior, id, lbl, sftwrPrfl) {
+        }
+
+        // 0 restores the size picked at allocation
+        size_t setBufferSamples(size_t samples) {
+            scoped_tuner_lock tuner_lock(usrp_tuner.lock);
+            if (samples == 0) {
+                usrp_tuner.setDefaultBufferSize();
+            } else {
+                usrp_tuner.updateBufferSize(2*samples);
+            }
+            return usrp_tuner.buffer_capacity/2;
+        }
+
+        CORBA::ULong ringDrops() const {
+            return rx_ring_drops;
+        }
+};
+
+
+/* reads one RDC's dataShort_out through an in-process connection */
+class benchSink {
+    public:
+        struct result {
+            uint64_t buffers;
+            uint64_t samples;
+            uint64_t lost_samples;   // missing from the timestamps between buffers
+            uint64_t unmatched;      // buffers no recv() could be found for
+            std::vector<double> latencies; // us
+        };
+
+        benchSink(benchRDC* rdc, recvLog& log, const std::string& connection_id) :
+            _log(log),
+            _connection_id(connection_id),
+            _running(true),
+            _measure_from(INT64_MAX),
+            _measure_to(INT64_MAX),
+            _sample_rate(0) {
+            _port = new bulkio::InShortPort("bench_in");
+            _port->setMaxQueueDepth(1000);
+            PortableServer::ObjectId_var oid = ossie::corba::RootPOA()->activate_object(_port);
+            CORBA::Object_var sink = _port->_this();
+            CORBA::Object_var source = rdc->getPort("dataShort_out");
+            _source = CF::Port::_narrow(source);
+            _source->connectPort(sink, _connection_id.c_str());
+            _thread = new boost::thread(&benchSink::run, this);
+        }
+
+        ~benchSink() {
+            _running = false;
+            _thread->join();
+            delete _thread;
+            _source->disconnectPort(_connection_id.c_str());
+        }
+
+        // counts the buffers arriving in [from, to) (monotonicNs())
+        void measure(int64_t from, int64_t to, double sample_rate) {
+            boost::mutex::scoped_lock lock(_lock);
+            _measure_from = from;
+            _measure_to = to;
+            _sample_rate = sample_rate;
+            _result.buffers = 0;
+            _result.samples = 0;
+            _result.lost_samples = 0;
+            _result.unmatched = 0;
+            _result.latencies.clear();
+            _result.latencies.reserve(1 << 20);
+            _have_next = false;
+        }
+
+        result collect() {
+            boost::mutex::scoped_lock lock(_lock);
+            return _result;
+        }
+
+        int64_t cpuNs() {
+            return threadCpuNs(*_thread);
+        }
+
+    private:
+        void run() {
+            while (_running) {
+                bulkio::InShortPort::dataTransfer* packet = _port->getPacket(0.1);
+                if (packet == NULL)
+                    continue;
+                account(*packet, monotonicNs());
+                delete packet;
+            }
+        }
+
+        void account(const bulkio::InShortPort::dataTransfer& packet, int64_t arrived) {
+            boost::mutex::scoped_lock lock(_lock);
+            const size_t num_samps = packet.dataBuffer.size()/2;
+            if ((num_samps == 0) or (_sample_rate <= 0))
+                return;
+            BULKIO::PrecisionUTCTime end = packet.T;
+            end.tfsec += num_samps/_sample_rate;
+            const double whole = std::floor(end.tfsec);
+            end.twsec += whole;
+            end.tfsec -= whole;
+
+            // keep the log in step even outside the window
+            recvLog::entry last;
+            const bool matched = _log.popUntil(end, last);
+            if ((arrived < _measure_from) or (arrived >= _measure_to))
+                return;
+
+            _result.buffers++;
+            _result.samples += num_samps;
+            if (matched) {
+                _result.latencies.push_back((arrived - last.returned_ns)/1e3);
+            } else {
+                _result.unmatched++;
+            }
+            if (_have_next) {
+                const double gap = ((packet.T.twsec - _next.twsec) + (packet.T.tfsec - _next.tfsec)) * _sample_rate;
+                if (gap > 0.5)
+                    _result.lost_samples += uint64_t(gap + 0.5);
+            }
+            _next = end;
+            _have_next = true;
+        }
+
+        recvLog& _log;
+        std::string _connection_id;
+        bulkio::InShortPort* _port;
+        CF::Port_var _source;
+        boost::thread* _thread;
+        std::atomic<bool> _running;
+
+        boost::mutex _lock; // everything below
+        int64_t _measure_from;
+        int64_t _measure_to;
+        double _sample_rate;
+        result _result;
+        bool _have_next;
+        BULKIO::PrecisionUTCTime _next; // where the next buffer should start
+};
+
+struct benchOptions {
+    benchOptions() : channels(1), duration(5), warmup(1), format("json") {
+        rates.push_back(1e6);
+        rates.push_back(5e6);
+        rates.push_back(10e6);
+        rates.push_back(25e6);
+        rates.push_back(50e6);
+        buffers.push_back(0);
+        buffers.push_back(16384);
+        buffers.push_back(131072);
+        modes.push_back("realtime");
+        modes.push_back("max");
+    }
+    std::vector<double> rates;
+    std::vector<size_t> buffers;
+    std::vector<std::string> modes;
+    size_t channels;
+    double duration;
+    double warmup;
+    std::string format;
+};
+
+struct benchResult {
+    std::string mode;
+    double sample_rate;
+    double hardware_rate;
+    size_t buffer_samples;
+    double seconds;
+    benchSink::result sink;
+    uint64_t overflows;
+    uint64_t ring_drops;
+    uint64_t allocations;
+    uint64_t allocated_bytes;
+    int64_t device_cpu_ns;
+    int64_t radio_cpu_ns;
+};
+
+namespace {
+    template <class T>
+    std::vector<T> parseList(const std::string& value)
+    {
+        std::vector<std::string> items;
+        boost::split(items, value, boost::is_any_of(","));
+        std::vector<T> out;
+        for (size_t i=0; i<items.size(); i++) {
+            if (not items[i].empty())
+                out.push_back(boost::lexical_cast<T>(boost::trim_copy(items[i])));
+        }
+        return out;
+    }
+
+    bool parseOptions(int argc, char* argv[], benchOptions& options)
+    {
+        try {
+            for (int i=1; i<argc; i++) {
+                const std::string arg(argv[i]);
+                const size_t eq = arg.find('=');
+                if ((arg.compare(0, 2, "--") != 0) or (eq == std::string::npos))
+                    continue; // ORB arguments
+                const std::string name = arg.substr(2, eq-2);
+                const std::string value = arg.substr(eq+1);
+                if (name == "rates") {
+                    options.rates = parseList<double>(value);
+                } else if (name == "buffers") {
+                    options.buffers = parseList<size_t>(value);
+                } else if (name == "modes") {
+                    options.modes = parseList<std::string>(value);
+                } else if (name == "channels") {
+                    options.channels = boost::lexical_cast<size_t>(value);
+                } else if (name == "duration") {
+                    options.duration = boost::lexical_cast<double>(value);
+                } else if (name == "warmup") {
+                    options.warmup = boost::lexical_cast<double>(value);
+                } else if (name == "format") {
+                    options.format = value;
+                } else {
+                    std::cerr << "unknown option " << arg << std::endl;
+                    return false;
+                }
+            }
+        } catch (const boost::bad_lexical_cast& e) {
+            std::cerr << "bad option value: " << e.what() << std::endl;
+            return false;
+        }
+        for (size_t i=0; i<options.modes.size(); i++) {
+            if ((options.modes[i] != "realtime") and (options.modes[i] != "max")) {
+                std::cerr << "unknown mode " << options.modes[i] << std::endl;
+                return false;
+            }
+        }
+        if ((options.format != "json") and (options.format != "csv")) {
+            std::cerr << "unknown format " << options.format << std::endl;
+            return false;
+        }
+        return (options.channels > 0) and (options.duration > 0);
+    }
+
+    CF::Properties tunerAllocation(size_t tuner, double sample_rate)
+    {
+        frontend::frontend_tuner_allocation_struct request;
+        request.tuner_type = "RDC";
+        request.allocation_id = "rx_bench_" + boost::lexical_cast<std::string>(tuner);
+        request.center_frequency = 1e9;
+        request.bandwidth = 0;
+        request.bandwidth_tolerance = 100;
+        request.sample_rate = sample_rate;
+        request.sample_rate_tolerance = 100;
+        request.device_control = true;
+        CF::Properties props;
+        props.length(1);
+        props[0].id = CORBA::string_dup("FRONTEND::tuner_allocation");
+        props[0].value <<= request;
+        return props;
+    }
+
+    template <class T>
+    std::string number(T value)
+    {
+        std::ostringstream out;
+        out << std::setprecision(10) << value;
+        return out.str();
+    }
+
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        return sorted[std::min(sorted.size()-1, size_t(fraction*(sorted.size()-1) + 0.5))];
+    }
+
+    void printResult(const benchOptions& options, const benchResult& result, bool first)
+    {
+        std::vector<double> latencies = result.sink.latencies;
+        std::sort(latencies.begin(), latencies.end());
+        double mean = 0;
+        for (size_t i=0; i<latencies.size(); i++)
+            mean += latencies[i];
+        if (not latencies.empty())
+            mean /= latencies.size();
+
+        const double channels = options.channels;
+        const double seconds = result.seconds;
+        const double buffers = std::max<double>(result.sink.buffers, 1);
+        std::vector<std::pair<std::string, std::string> > fields;
+        #define BENCH_FIELD(name, value) fields.push_back(std::make_pair(std::string(name), number(value)))
+        fields.push_back(std::make_pair(std::string("mode"), "\"" + result.mode + "\""));
+        BENCH_FIELD("channels", options.channels);
+        BENCH_FIELD("sample_rate", result.sample_rate);
+        BENCH_FIELD("hardware_rate", result.hardware_rate);
+        BENCH_FIELD("buffer_samples", result.buffer_samples);
+        BENCH_FIELD("seconds", seconds);
+        BENCH_FIELD("buffers", result.sink.buffers);
+        BENCH_FIELD("samples_per_sec", result.sink.samples/seconds);
+        BENCH_FIELD("samples_per_sec_per_channel", result.sink.samples/seconds/channels);
+        BENCH_FIELD("lost_samples", result.sink.lost_samples);
+        BENCH_FIELD("overflows", result.overflows);
+        BENCH_FIELD("ring_drops", result.ring_drops);
+        BENCH_FIELD("unmatched_buffers", result.sink.unmatched);
+        BENCH_FIELD("latency_count", latencies.size());
+        const char* quantiles[] = {"latency_p50_us", "latency_p90_us", "latency_p99_us", "latency_p999_us"};
+        const double fractions[] = {0.5, 0.9, 0.99, 0.999};
+        for (size_t i=0; i<4; i++) {
+            if (latencies.empty()) {
+                fields.push_back(std::make_pair(std::string(quantiles[i]), std::string("null")));
+            } else {
+                BENCH_FIELD(quantiles[i], percentile(latencies, fractions[i]));
+            }
+        }
+        if (latencies.empty()) {
+            fields.push_back(std::make_pair(std::string("latency_max_us"), std::string("null")));
+            fields.push_back(std::make_pair(std::string("latency_mean_us"), std::string("null")));
+        } else {
+            BENCH_FIELD("latency_max_us", latencies.back());
+            BENCH_FIELD("latency_mean_us", mean);
+        }
+        BENCH_FIELD("allocs_per_sec", result.allocations/seconds);
+        BENCH_FIELD("alloc_bytes_per_sec", result.allocated_bytes/seconds);
+        BENCH_FIELD("allocs_per_buffer", result.allocations/buffers);
+        BENCH_FIELD("cpu_percent_per_channel", 100.0*result.device_cpu_ns/1e9/seconds/channels);
+        BENCH_FIELD("radio_cpu_percent_per_channel", 100.0*result.radio_cpu_ns/1e9/seconds/channels);
+        #undef BENCH_FIELD
+
+        std::ostringstream line;
+        if (options.format == "csv") {
+            if (first) {
+                for (size_t i=0; i<fields.size(); i++)
+                    std::cout << (i ? "," : "") << fields[i].first;
+                std::cout << std::endl;
+            }
+            for (size_t i=0; i<fields.size(); i++) {
+                std::string value = fields[i].second;
+                if (value == "null")
+                    value.clear();
+                boost::erase_all(value, "\"");
+                line << (i ? "," : "") << value;
+            }
+        } else {
+            line << "{";
+            for (size_t i=0; i<fields.size(); i++)
+                line << (i ? ", " : "") << "\"" << fields[i].first << "\": " << fields[i].second;
+            line << "}";
+        }
+        std::cout << line.str() << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ossie::corba::CorbaInit(argc, argv);
+    benchOptions options;
+    if (not parseOptions(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--rates=1e6,10e6] [--buffers=0,65536] [--modes=realtime,max]"
+                  << " [--channels=1] [--duration=5] [--warmup=1] [--format=json|csv]" << std::endl;
+        return 1;
+    }
+
+    // one tone in every passband over the noise floor
+    usrpSimSettings settings;
+    usrpSimTone tone;
+    tone.frequency = 1e9 + 100e3;
+    tone.level = -20;
+    settings.tones.push_back(tone);
+    boost::shared_ptr<benchRadio> radio(new benchRadio(options.channels, 200e6, settings));
+    const usrp_command_lock_t command_lock(new boost::mutex);
+
+    std::vector<benchRDC*> rdcs;
+    std::vector<benchSink*> sinks;
+    for (size_t i=0; i<options.channels; i++) {
+        const std::string label = "RDC_" + boost::lexical_cast<std::string>(i+1);
+        const std::string id = "rx_bench:" + label;
+        benchRDC* rdc = new benchRDC(const_cast<char*>(""), const_cast<char*>(id.c_str()),
+                                     const_cast<char*>(label.c_str()), const_cast<char*>(""));
+        rdc->log_level(CF::LogLevels::ERROR);
+        rdc->initialize();
+        rdc->setTunerNumber(i);
+        rdc->setRadio(radio);
+        rdc->setCommandLock(command_lock);
+        rdcs.push_back(rdc);
+        sinks.push_back(new benchSink(rdc, radio->logs[i], "rx_bench_" + boost::lexical_cast<std::string>(i)));
+    }
+
+    bool first = true;
+    int status = 0;
+    for (size_t m=0; m<options.modes.size(); m++) {
+        settings.realtime = (options.modes[m] == "realtime");
+        radio->configure(settings);
+        for (size_t r=0; r<options.rates.size(); r++) {
+            for (size_t b=0; b<options.buffers.size(); b++) {
+                benchResult result;
+                result.mode = options.modes[m];
+                result.sample_rate = options.rates[r];
+                bool allocated = true;
+                for (size_t i=0; i<rdcs.size(); i++) {
+                    try {
+                        allocated = allocated and rdcs[i]->allocateCapacity(tunerAllocation(i, options.rates[r]));
+                    } catch (const CORBA::Exception& e) {
+                        allocated = false;
+                    }
+                    result.buffer_samples = rdcs[i]->setBufferSamples(options.buffers[b]);
+                }
+                result.hardware_rate = rdcs[0]->rxSampleRate();
+                if (allocated) {
+                    sleepSeconds(options.warmup);
+                    const int64_t from = monotonicNs();
+                    const int64_t to = from + int64_t(options.duration*1e9);
+                    for (size_t i=0; i<sinks.size(); i++)
+                        sinks[i]->measure(from, to, result.hardware_rate);
+
+                    const uint64_t overflows = radio->overflows;
+                    const int64_t radio_cpu = radio->cpu_ns;
+                    const uint64_t allocations = g_allocations;
+                    const uint64_t allocated_bytes = g_allocated_bytes;
+                    uint64_t ring_drops = 0;
+                    int64_t sink_cpu = 0;
+                    for (size_t i=0; i<rdcs.size(); i++) {
+                        ring_drops += rdcs[i]->ringDrops();
+                        sink_cpu += sinks[i]->cpuNs();
+                    }
+                    const int64_t process_cpu = processCpuNs();
+
+                    sleepSeconds(options.duration);
+
+                    result.seconds = (monotonicNs() - from)/1e9;
+                    result.allocations = g_allocations - allocations;
+                    result.allocated_bytes = g_allocated_bytes - allocated_bytes;
+                    result.radio_cpu_ns = radio->cpu_ns - radio_cpu;
+                    int64_t sink_cpu_used = -sink_cpu;
+                    result.ring_drops = 0;
+                    for (size_t i=0; i<rdcs.size(); i++) {
+                        result.ring_drops += rdcs[i]->ringDrops();
+                        sink_cpu_used += sinks[i]->cpuNs();
+                    }
+                    result.ring_drops -= ring_drops;
+                    result.device_cpu_ns = processCpuNs() - process_cpu - sink_cpu_used - result.radio_cpu_ns;
+                    result.overflows = radio->overflows - overflows;
+                    result.sink = sinks[0]->collect();
+                    for (size_t i=1; i<sinks.size(); i++) {
+                        const benchSink::result more = sinks[i]->collect();
+                        result.sink.buffers += more.buffers;
+                        result.sink.samples += more.samples;
+                        result.sink.lost_samples += more.lost_samples;
+                        result.sink.unmatched += more.unmatched;
+                        result.sink.latencies.insert(result.sink.latencies.end(), more.latencies.begin(), more.latencies.end());
+                    }
+                    printResult(options, result, first);
+                    first = false;
+                } else {
+                    std::cerr << options.modes[m] << " " << options.rates[r] << " S/s: allocation failed" << std::endl;
+                    status = 1;
+                }
+                for (size_t i=0; i<rdcs.size(); i++) {
+                    try {
+                        rdcs[i]->deallocateCapacity(tunerAllocation(i, options.rates[r]));
+                    } catch (const CORBA::Exception& e) {
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t i=0; i<sinks.size(); i++)
+        delete sinks[i];
+    for (size_t i=0; i<rdcs.size(); i++)
+        rdcs[i]->stop();
+    ossie::corba::OrbShutdown(true);
+    return status;
+}
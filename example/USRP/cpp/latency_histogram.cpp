@@ -0,0 +1,55 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+void latencyHistogram::reset()
+{
+    for (size_t i=0; i<BUCKETS; i++)
+        _buckets[i].store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+}
+
+double latencyHistogram::middle(size_t index)
+{
+    if (index < (1 << SUB_BITS))
+        return index;
+    const unsigned shift = (index >> SUB_BITS) - 1;
+    const uint64_t low = uint64_t((1 << SUB_BITS) + (index & ((1 << SUB_BITS) - 1))) << shift;
+    return low + ((uint64_t(1) << shift) - 1) / 2.0;
+}
+
+double latencyHistogram::percentile(const uint64_t* counts, uint64_t total, double fraction) const
+{
+    // nearest rank, counting from 1
+    const uint64_t rank = std::max(uint64_t(std::ceil(fraction*total)), uint64_t(1));
+    uint64_t seen = 0;
+    for (size_t i=0; i<BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank)
+            return middle(i);
+    }
+    return 0;
+}
+
+latencyHistogram::summary latencyHistogram::summarize() const
+{
+    uint64_t counts[BUCKETS];
+    uint64_t total = 0;
+    for (size_t i=0; i<BUCKETS; i++) {
+        counts[i] = _buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    summary out;
+    out.count = total;
+    out.mean_us = (total == 0) ? 0 : _sum.load(std::memory_order_relaxed) / 1e3 / total;
+    if (total == 0) {
+        out.p50_us = out.p99_us = out.p999_us = 0;
+        return out;
+    }
+    out.p50_us = percentile(counts, total, 0.5) / 1e3;
+    out.p99_us = percentile(counts, total, 0.99) / 1e3;
+    out.p999_us = percentile(counts, total, 0.999) / 1e3;
+    return out;
+}
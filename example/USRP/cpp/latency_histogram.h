@@ -0,0 +1,81 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <time.h>
+
+/* histogram of durations in nanoseconds, cheap enough to leave on in the hot path
+ *  - buckets are log2 octaves split 8 ways, so any recorded value lands in a
+ *    bucket less than 13% wide; values below 8 ns are exact
+ *  - record() is two relaxed atomic adds: no locks, and any thread may
+ *    summarize() or reset() while another records
+ *  - a summary taken while records are under way may be off by those records
+ */
+class latencyHistogram {
+    public:
+        latencyHistogram() {
+            reset();
+        }
+
+        // monotonic clock, ns
+        static uint64_t now() {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return uint64_t(ts.tv_sec)*1000000000 + ts.tv_nsec;
+        }
+
+        void record(uint64_t ns) {
+            _buckets[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+            _sum.fetch_add(ns, std::memory_order_relaxed);
+        }
+
+        // records the time since start, a now() value
+        void since(uint64_t start) {
+            record(now() - start);
+        }
+
+        void reset();
+
+        struct summary {
+            uint64_t count;
+            double mean_us;
+            double p50_us;
+            double p99_us;
+            double p999_us;
+        };
+        summary summarize() const;
+
+    private:
+        static const unsigned SUB_BITS = 3;
+        static const size_t BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+        static size_t bucket(uint64_t ns) {
+            if (ns < (1 << SUB_BITS))
+                return ns;
+            const unsigned shift = (63 - __builtin_clzll(ns)) - SUB_BITS;
+            return ((shift + 1) << SUB_BITS) + ((ns >> shift) & ((1 << SUB_BITS) - 1));
+        }
+        // middle of a bucket's range, ns
+        static double middle(size_t index);
+        double percentile(const uint64_t* counts, uint64_t total, double fraction) const;
+
+        std::atomic<uint64_t> _buckets[BUCKETS];
+        std::atomic<uint64_t> _sum;
+};
+
+/* records the time from construction to destruction */
+class latencyScope {
+    public:
+        latencyScope(latencyHistogram& histogram) : _histogram(histogram), _start(latencyHistogram::now()) {
+        }
+        ~latencyScope() {
+            _histogram.since(_start);
+        }
+    private:
+        latencyHistogram& _histogram;
+        const uint64_t _start;
+};
+
+#endif // LATENCY_HISTOGRAM_H
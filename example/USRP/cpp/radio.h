@@ -0,0 +1,110 @@
+#ifndef RADIO_H
+#define RADIO_H
+
+#include <uhd/stream.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/types/ranges.hpp>
+#include <uhd/types/sensors.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/types/tune_request.hpp>
+#include <uhd/types/tune_result.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+/* The radio the device and its children drive, so the same code runs against
+ * a USRP (usrpUHDRadio) or a simulated one (usrpSimRadio).
+ *  - the methods are named after, and behave like, their uhd::usrp::multi_usrp
+ *    counterparts, and UHD's value types (time specs, stream commands,
+ *    metadata, ranges, sensors) are used as is
+ *  - only what the device uses is covered
+ */
+class usrpRxStream {
+    public:
+        typedef boost::shared_ptr<usrpRxStream> sptr;
+        virtual ~usrpRxStream() {}
+
+        virtual size_t get_num_channels() const = 0;
+        virtual size_t get_max_num_samps() const = 0;
+        virtual size_t recv(const uhd::rx_streamer::buffs_type& buffs, const size_t nsamps_per_buff,
+                            uhd::rx_metadata_t& metadata, const double timeout = 0.1, const bool one_packet = false) = 0;
+        virtual void issue_stream_cmd(const uhd::stream_cmd_t& stream_cmd) = 0;
+};
+
+class usrpTxStream {
+    public:
+        typedef boost::shared_ptr<usrpTxStream> sptr;
+        virtual ~usrpTxStream() {}
+
+        virtual size_t get_num_channels() const = 0;
+        virtual size_t get_max_num_samps() const = 0;
+        virtual size_t send(const uhd::tx_streamer::buffs_type& buffs, const size_t nsamps_per_buff,
+                            const uhd::tx_metadata_t& metadata, const double timeout = 0.1) = 0;
+        virtual bool recv_async_msg(uhd::async_metadata_t& async_metadata, double timeout = 0.1) = 0;
+};
+
+class usrpRadio {
+    public:
+        typedef boost::shared_ptr<usrpRadio> sptr;
+        virtual ~usrpRadio() {}
+
+        // "UHD" or "SIMULATED"
+        virtual std::string get_backend() const = 0;
+
+        // streaming
+        virtual usrpRxStream::sptr get_rx_stream(const uhd::stream_args_t& args) = 0;
+        virtual usrpTxStream::sptr get_tx_stream(const uhd::stream_args_t& args) = 0;
+        virtual void issue_stream_cmd(const uhd::stream_cmd_t& stream_cmd, size_t chan) = 0;
+
+        // time
+        virtual uhd::time_spec_t get_time_now() = 0;
+        virtual uhd::time_spec_t get_time_last_pps() = 0;
+        virtual void set_time_next_pps(const uhd::time_spec_t& time_spec) = 0;
+        virtual void set_command_time(const uhd::time_spec_t& time_spec) = 0;
+        virtual void clear_command_time() = 0;
+        virtual void set_clock_source(const std::string& source, size_t mboard) = 0;
+        virtual void set_time_source(const std::string& source, size_t mboard) = 0;
+        virtual uhd::sensor_value_t get_mboard_sensor(const std::string& name, size_t mboard = 0) = 0;
+
+        // receive channels
+        virtual size_t get_rx_num_channels() = 0;
+        virtual std::string get_rx_subdev_name(size_t chan) = 0;
+        virtual std::string get_rx_antenna(size_t chan) = 0;
+        virtual std::vector<std::string> get_rx_antennas(size_t chan) = 0;
+        virtual uhd::tune_result_t set_rx_freq(const uhd::tune_request_t& tune_request, size_t chan) = 0;
+        virtual double get_rx_freq(size_t chan) = 0;
+        virtual uhd::freq_range_t get_rx_freq_range(size_t chan) = 0;
+        virtual void set_rx_rate(double rate, size_t chan) = 0;
+        virtual double get_rx_rate(size_t chan) = 0;
+        virtual uhd::meta_range_t get_rx_rates(size_t chan) = 0;
+        virtual void set_rx_bandwidth(double bandwidth, size_t chan) = 0;
+        virtual double get_rx_bandwidth(size_t chan) = 0;
+        virtual uhd::freq_range_t get_rx_bandwidth_range(size_t chan) = 0;
+        virtual void set_rx_gain(double gain, size_t chan) = 0;
+        virtual double get_rx_gain(size_t chan) = 0;
+        virtual uhd::gain_range_t get_rx_gain_range(size_t chan) = 0;
+        // daughterboard clock rates, highest first
+        virtual std::vector<double> get_rx_clock_rates(size_t chan) = 0;
+        virtual uhd::sensor_value_t get_rx_sensor(const std::string& name, size_t chan) = 0;
+
+        // transmit channels
+        virtual size_t get_tx_num_channels() = 0;
+        virtual std::string get_tx_subdev_name(size_t chan) = 0;
+        virtual std::string get_tx_antenna(size_t chan) = 0;
+        virtual std::vector<std::string> get_tx_antennas(size_t chan) = 0;
+        virtual uhd::tune_result_t set_tx_freq(const uhd::tune_request_t& tune_request, size_t chan) = 0;
+        virtual double get_tx_freq(size_t chan) = 0;
+        virtual uhd::freq_range_t get_tx_freq_range(size_t chan) = 0;
+        virtual void set_tx_rate(double rate, size_t chan) = 0;
+        virtual double get_tx_rate(size_t chan) = 0;
+        virtual uhd::meta_range_t get_tx_rates(size_t chan) = 0;
+        virtual void set_tx_bandwidth(double bandwidth, size_t chan) = 0;
+        virtual double get_tx_bandwidth(size_t chan) = 0;
+        virtual uhd::freq_range_t get_tx_bandwidth_range(size_t chan) = 0;
+        virtual void set_tx_gain(double gain, size_t chan) = 0;
+        virtual double get_tx_gain(size_t chan) = 0;
+        virtual uhd::gain_range_t get_tx_gain_range(size_t chan) = 0;
+        virtual std::vector<double> get_tx_clock_rates(size_t chan) = 0;
+};
+
+#endif // RADIO_H
@@ -0,0 +1,938 @@
+#include "radio_sim.h"
+
+#include <uhd/exception.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+
+namespace {
+    uhd::time_spec_t hostTime()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        return uhd::time_spec_t(time_t(now.tv_sec), long(now.tv_nsec), 1e9);
+    }
+
+    inline uint32_t xorshift(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    inline short clip(double value, double full_scale)
+    {
+        if (value >= full_scale)
+            return short(full_scale);
+        if (value <= -full_scale-1)
+            return short(-full_scale-1);
+        return short(lrint(value));
+    }
+
+    void sleepFor(double seconds)
+    {
+        boost::this_thread::sleep(boost::posix_time::microseconds(std::max(long(seconds*1e6), 20L)));
+    }
+
+    // locks the channels of a stream in index order, so streams sharing channels can't deadlock
+    template <class channel_t>
+    class channelLocks {
+        public:
+            channelLocks(std::vector<channel_t*> channels) {
+                std::sort(channels.begin(), channels.end());
+                for (size_t i=0; i<channels.size(); i++) {
+                    if ((i == 0) or (channels[i] != channels[i-1])) {
+                        channels[i]->lock.lock();
+                        _locked.push_back(channels[i]);
+                    }
+                }
+            }
+            ~channelLocks() {
+                for (size_t i=0; i<_locked.size(); i++)
+                    _locked[i]->lock.unlock();
+            }
+        private:
+            std::vector<channel_t*> _locked;
+    };
+}
+
+class usrpSimRxStream : public usrpRxStream {
+    public:
+        usrpSimRxStream(const boost::shared_ptr<usrpSimRadio>& radio, const std::vector<size_t>& channels, double full_scale) :
+            _radio(radio),
+            _full_scale(full_scale)
+        {
+            for (size_t i=0; i<channels.size(); i++)
+                _channels.push_back(&_radio->rx(channels[i]));
+        }
+
+        size_t get_num_channels() const {
+            return _channels.size();
+        }
+        size_t get_max_num_samps() const {
+            return usrpSimRadio::PACKET_SAMPS;
+        }
+
+        void issue_stream_cmd(const uhd::stream_cmd_t& stream_cmd) {
+            // one start time for every channel keeps them aligned
+            const uhd::time_spec_t now = _radio->get_time_now();
+            channelLocks<usrpSimRadio::rxChannel> lock(_channels);
+            for (size_t i=0; i<_channels.size(); i++)
+                _radio->streamCommand(*_channels[i], stream_cmd, now);
+        }
+
+        size_t recv(const uhd::rx_streamer::buffs_type& buffs, const size_t nsamps_per_buff,
+                    uhd::rx_metadata_t& metadata, const double timeout, const bool one_packet);
+
+    private:
+        void advance(uint64_t samps);
+
+        boost::shared_ptr<usrpSimRadio> _radio;
+        std::vector<usrpSimRadio::rxChannel*> _channels;
+        const double _full_scale;
+};
+
+/* the channels share the first one's sample clock; their stream commands all
+ * come through issue_stream_cmd()
+ */
+size_t usrpSimRxStream::recv(const uhd::rx_streamer::buffs_type& buffs, const size_t nsamps_per_buff,
+                             uhd::rx_metadata_t& metadata, const double timeout, const bool one_packet)
+{
+    metadata.has_time_spec = false;
+    metadata.more_fragments = false;
+    metadata.fragment_offset = 0;
+    metadata.start_of_burst = false;
+    metadata.end_of_burst = false;
+    metadata.out_of_sequence = false;
+    metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_NONE;
+
+    const uint64_t wanted = one_packet ? std::min(nsamps_per_buff, usrpSimRadio::PACKET_SAMPS) : nsamps_per_buff;
+    const boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds(long(timeout*1e6));
+    usrpSimRadio::rxChannel& first = *_channels[0];
+    while (true) {
+        const boost::shared_ptr<const usrpSimSettings> settings = _radio->settings();
+        const uhd::time_spec_t now = _radio->get_time_now();
+        const bool expired = (boost::get_system_time() >= deadline);
+        double wait = timeout;
+        {
+            channelLocks<usrpSimRadio::rxChannel> lock(_channels);
+            if (first.late) {
+                for (size_t i=0; i<_channels.size(); i++)
+                    _channels[i]->late = false;
+                metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_LATE_COMMAND;
+                return 0;
+            }
+            if (first.streaming) {
+                const double rate = first.rate;
+                uint64_t available = wanted;
+                if (settings->realtime) {
+                    const double produced = std::max(floor((now - first.start).get_real_secs()*rate), 0.0);
+                    available = (produced > first.position) ? uint64_t(produced)-first.position : 0;
+                    const uint64_t capacity = std::max(uint64_t(settings->fifo_time*rate), wanted);
+                    if (available > capacity) {
+                        // the backlog is lost; the next samples carry a later timestamp
+                        metadata.has_time_spec = true;
+                        metadata.time_spec = first.start + uhd::time_spec_t::from_ticks(first.position, rate);
+                        metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_OVERFLOW;
+                        advance(available);
+                        return 0;
+                    }
+                }
+                if (first.next_overflow > 0) {
+                    if (first.position >= first.next_overflow) {
+                        metadata.has_time_spec = true;
+                        metadata.time_spec = first.start + uhd::time_spec_t::from_ticks(first.position, rate);
+                        metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_OVERFLOW;
+                        for (size_t i=0; i<_channels.size(); i++)
+                            _channels[i]->next_overflow += std::max(uint64_t(settings->overflow_interval*rate), uint64_t(1));
+                        advance(usrpSimRadio::PACKET_SAMPS);
+                        return 0;
+                    }
+                    available = std::min(available, first.next_overflow-first.position);
+                }
+                if (not first.continuous)
+                    available = std::min(available, first.remaining);
+
+                const bool done = (not first.continuous) and (available == first.remaining);
+                if ((available >= wanted) or ((available > 0) and (one_packet or expired or done))) {
+                    const size_t num_samps = std::min(available, wanted);
+                    for (size_t i=0; i<_channels.size(); i++)
+                        _radio->synthesize(*_channels[i], static_cast<short*>(buffs[i]), num_samps, _full_scale);
+                    metadata.has_time_spec = true;
+                    metadata.time_spec = first.start + uhd::time_spec_t::from_ticks(first.position, rate);
+                    metadata.start_of_burst = (first.position == 0);
+                    advance(num_samps);
+                    metadata.end_of_burst = not first.streaming;
+                    return num_samps;
+                }
+                if (settings->realtime) {
+                    wait = double(wanted-available)/rate;
+                    if (now < first.start)
+                        wait += (first.start - now).get_real_secs();
+                }
+            }
+        }
+        if (expired) {
+            metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_TIMEOUT;
+            return 0;
+        }
+        sleepFor(std::min(wait, (deadline - boost::get_system_time()).total_microseconds()/1e6));
+    }
+}
+
+/* moves every channel past samps samples, ending a NUM_SAMPS command that
+ * runs out; the channel locks are held
+ */
+void usrpSimRxStream::advance(uint64_t samps)
+{
+    for (size_t i=0; i<_channels.size(); i++) {
+        usrpSimRadio::rxChannel& channel = *_channels[i];
+        channel.position += samps;
+        if (not channel.continuous) {
+            channel.remaining -= std::min(samps, channel.remaining);
+            if (channel.remaining == 0)
+                channel.streaming = false;
+        }
+    }
+}
+
+class usrpSimTxStream : public usrpTxStream {
+    public:
+        usrpSimTxStream(const boost::shared_ptr<usrpSimRadio>& radio, const std::vector<size_t>& channels) :
+            _radio(radio),
+            _numbers(channels)
+        {
+            for (size_t i=0; i<channels.size(); i++)
+                _channels.push_back(&_radio->tx(channels[i]));
+        }
+
+        size_t get_num_channels() const {
+            return _channels.size();
+        }
+        size_t get_max_num_samps() const {
+            return usrpSimRadio::PACKET_SAMPS;
+        }
+
+        size_t send(const uhd::tx_streamer::buffs_type& buffs, const size_t nsamps_per_buff,
+                    const uhd::tx_metadata_t& metadata, const double timeout);
+        bool recv_async_msg(uhd::async_metadata_t& async_metadata, double timeout);
+
+    private:
+        boost::shared_ptr<usrpSimRadio> _radio;
+        std::vector<usrpSimRadio::txChannel*> _channels;
+        std::vector<size_t> _numbers;
+};
+
+/* the samples are discarded once their time comes; the first channel paces the stream */
+size_t usrpSimTxStream::send(const uhd::tx_streamer::buffs_type&, const size_t nsamps_per_buff,
+                             const uhd::tx_metadata_t& metadata, const double timeout)
+{
+    const boost::shared_ptr<const usrpSimSettings> settings = _radio->settings();
+    const boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds(long(timeout*1e6));
+    usrpSimRadio::txChannel& first = *_channels[0];
+    while (true) {
+        const uhd::time_spec_t now = _radio->get_time_now();
+        double ahead = 0;
+        {
+            channelLocks<usrpSimRadio::txChannel> lock(_channels);
+            for (size_t i=0; i<_channels.size(); i++) {
+                usrpSimRadio::txChannel& channel = *_channels[i];
+                if (not channel.in_burst) {
+                    if (metadata.has_time_spec and (metadata.time_spec < now)) {
+                        _radio->pushEvent(channel, _numbers[i], uhd::async_metadata_t::EVENT_CODE_TIME_ERROR, now);
+                        continue;
+                    }
+                    channel.in_burst = true;
+                    channel.underflowed = false;
+                    channel.end = metadata.has_time_spec ? metadata.time_spec : now;
+                } else if (settings->realtime and (channel.end < now)) {
+                    if (not channel.underflowed)
+                        _radio->pushEvent(channel, _numbers[i], uhd::async_metadata_t::EVENT_CODE_UNDERFLOW, channel.end);
+                    channel.end = now;
+                }
+                channel.underflowed = false;
+            }
+            if (not first.in_burst)
+                return nsamps_per_buff; // dropped for being late
+            if (settings->realtime)
+                ahead = (first.end - now).get_real_secs() - settings->fifo_time;
+            if (ahead <= 0) {
+                for (size_t i=0; i<_channels.size(); i++) {
+                    usrpSimRadio::txChannel& channel = *_channels[i];
+                    channel.end += uhd::time_spec_t::from_ticks(nsamps_per_buff, channel.rate);
+                    if (metadata.end_of_burst) {
+                        channel.in_burst = false;
+                        _radio->pushEvent(channel, _numbers[i], uhd::async_metadata_t::EVENT_CODE_BURST_ACK, channel.end);
+                    }
+                }
+                return nsamps_per_buff;
+            }
+        }
+        // the radio's buffer is full
+        const double left = (deadline - boost::get_system_time()).total_microseconds()/1e6;
+        if (left <= 0)
+            return 0;
+        sleepFor(std::min(ahead, left));
+    }
+}
+
+bool usrpSimTxStream::recv_async_msg(uhd::async_metadata_t& async_metadata, double timeout)
+{
+    const boost::shared_ptr<const usrpSimSettings> settings = _radio->settings();
+    const uhd::time_spec_t now = _radio->get_time_now();
+    const boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds(long(timeout*1e6));
+    {
+        channelLocks<usrpSimRadio::txChannel> lock(_channels);
+        for (size_t i=0; i<_channels.size(); i++) {
+            usrpSimRadio::txChannel& channel = *_channels[i];
+            // the host stopped feeding a burst
+            if (settings->realtime and channel.in_burst and (not channel.underflowed) and (channel.end < now)) {
+                _radio->pushEvent(channel, _numbers[i], uhd::async_metadata_t::EVENT_CODE_UNDERFLOW, channel.end);
+                channel.underflowed = true;
+            }
+        }
+    }
+    while (true) {
+        for (size_t i=0; i<_channels.size(); i++) {
+            boost::mutex::scoped_lock lock(_channels[i]->lock);
+            if (not _channels[i]->events.empty()) {
+                async_metadata = _channels[i]->events.front();
+                _channels[i]->events.pop_front();
+                return true;
+            }
+        }
+        boost::mutex::scoped_lock lock(_channels[0]->lock);
+        if (not _channels[0]->events.empty())
+            continue;
+        if (not _channels[0]->event.timed_wait(lock, deadline))
+            return false;
+    }
+}
+
+const size_t usrpSimRadio::PACKET_SAMPS;
+const size_t usrpSimRadio::NOISE_SAMPS;
+
+usrpSimRadio::rxChannel::rxChannel(size_t _index) :
+    index(_index),
+    frequency(1e9),
+    rf_frequency(1e9),
+    applied_frequency(1e9),
+    rate(1e6),
+    bandwidth(1e6),
+    gain(0),
+    applied_gain(0),
+    streaming(false),
+    continuous(false),
+    late(false),
+    remaining(0),
+    position(0),
+    next_overflow(0),
+    noise_state(1)
+{
+}
+
+usrpSimRadio::txChannel::txChannel() :
+    frequency(1e9),
+    rate(1e6),
+    bandwidth(1e6),
+    gain(0),
+    in_burst(false),
+    underflowed(false)
+{
+}
+
+usrpSimRadio::usrpSimRadio(size_t rx_channels, size_t tx_channels, double master_clock_rate, const usrpSimSettings& settings) :
+    _master_clock_rate(master_clock_rate),
+    _pps_pending(false),
+    _command_time_set(false)
+{
+    for (size_t i=0; i<rx_channels; i++)
+        _rx.push_back(boost::shared_ptr<rxChannel>(new rxChannel(i)));
+    for (size_t i=0; i<tx_channels; i++)
+        _tx.push_back(boost::shared_ptr<txChannel>(new txChannel()));
+
+    // a table of gaussian noise to read from at random offsets is far cheaper
+    // than generating it per sample
+    uint32_t state = settings.seed ? settings.seed : 1;
+    _noise.resize(2*NOISE_SAMPS);
+    for (size_t i=0; i<_noise.size(); i+=2) {
+        const double u1 = (xorshift(state) + 1.0)/4294967296.0;
+        const double u2 = xorshift(state)/4294967296.0;
+        const double r = sqrt(-2*log(u1));
+        _noise[i] = r*cos(2*M_PI*u2);
+        _noise[i+1] = r*sin(2*M_PI*u2);
+    }
+    configure(settings);
+}
+
+void usrpSimRadio::configure(const usrpSimSettings& settings)
+{
+    boost::shared_ptr<const usrpSimSettings> next(new usrpSimSettings(settings));
+    boost::mutex::scoped_lock lock(_lock);
+    _settings = next;
+}
+
+boost::shared_ptr<const usrpSimSettings> usrpSimRadio::settings()
+{
+    boost::mutex::scoped_lock lock(_lock);
+    return _settings;
+}
+
+usrpSimRadio::rxChannel& usrpSimRadio::rx(size_t chan)
+{
+    if (chan >= _rx.size())
+        throw uhd::index_error("simulated radio has no RX channel " + boost::lexical_cast<std::string>(chan));
+    return *_rx[chan];
+}
+
+usrpSimRadio::txChannel& usrpSimRadio::tx(size_t chan)
+{
+    if (chan >= _tx.size())
+        throw uhd::index_error("simulated radio has no TX channel " + boost::lexical_cast<std::string>(chan));
+    return *_tx[chan];
+}
+
+usrpRxStream::sptr usrpSimRadio::get_rx_stream(const uhd::stream_args_t& args)
+{
+    if (args.cpu_format != "sc16")
+        throw uhd::value_error("simulated radio only streams sc16, not " + args.cpu_format);
+    std::vector<size_t> channels = args.channels;
+    if (channels.empty())
+        channels.push_back(0);
+    const double full_scale = (args.otw_format == "sc8") ? 127 : 32767;
+    return usrpRxStream::sptr(new usrpSimRxStream(shared_from_this(), channels, full_scale));
+}
+
+usrpTxStream::sptr usrpSimRadio::get_tx_stream(const uhd::stream_args_t& args)
+{
+    if (args.cpu_format != "sc16")
+        throw uhd::value_error("simulated radio only streams sc16, not " + args.cpu_format);
+    std::vector<size_t> channels = args.channels;
+    if (channels.empty())
+        channels.push_back(0);
+    return usrpTxStream::sptr(new usrpSimTxStream(shared_from_this(), channels));
+}
+
+void usrpSimRadio::issue_stream_cmd(const uhd::stream_cmd_t& stream_cmd, size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    const uhd::time_spec_t now = get_time_now();
+    boost::mutex::scoped_lock lock(channel.lock);
+    streamCommand(channel, stream_cmd, now);
+}
+
+/* channel.lock held */
+void usrpSimRadio::streamCommand(rxChannel& channel, const uhd::stream_cmd_t& stream_cmd, const uhd::time_spec_t& now)
+{
+    if (stream_cmd.stream_mode == uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS) {
+        channel.streaming = false;
+        return;
+    }
+    if ((not stream_cmd.stream_now) and (stream_cmd.time_spec < now)) {
+        channel.streaming = false;
+        channel.late = true;
+        return;
+    }
+    channel.continuous = (stream_cmd.stream_mode == uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+    channel.remaining = stream_cmd.num_samps;
+    channel.streaming = channel.continuous or (channel.remaining > 0);
+    channel.late = false;
+    channel.start = stream_cmd.stream_now ? now : stream_cmd.time_spec;
+    channel.position = 0;
+    const double interval = settings()->overflow_interval;
+    channel.next_overflow = (interval > 0) ? std::max(uint64_t(interval*channel.rate), uint64_t(1)) : 0;
+}
+
+/* _lock held */
+uhd::time_spec_t usrpSimRadio::deviceTime()
+{
+    uhd::time_spec_t now = hostTime() + _time_offset;
+    if (_pps_pending and (now >= _pps_edge)) {
+        _time_offset += _pps_time - _pps_edge;
+        _pps_pending = false;
+        now = hostTime() + _time_offset;
+    }
+    return now;
+}
+
+/* when a command issued now takes effect; true if that is the (future) command time */
+bool usrpSimRadio::commandTime(uhd::time_spec_t& when)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    when = deviceTime();
+    if (_command_time_set and (_command_time > when)) {
+        when = _command_time;
+        return true;
+    }
+    return false;
+}
+
+uhd::time_spec_t usrpSimRadio::get_time_now()
+{
+    boost::mutex::scoped_lock lock(_lock);
+    return deviceTime();
+}
+
+uhd::time_spec_t usrpSimRadio::get_time_last_pps()
+{
+    return uhd::time_spec_t(get_time_now().get_full_secs());
+}
+
+void usrpSimRadio::set_time_next_pps(const uhd::time_spec_t& time_spec)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    _pps_edge = uhd::time_spec_t(deviceTime().get_full_secs()+1);
+    _pps_time = time_spec;
+    _pps_pending = true;
+}
+
+void usrpSimRadio::set_command_time(const uhd::time_spec_t& time_spec)
+{
+    boost::mutex::scoped_lock lock(_lock);
+    _command_time = time_spec;
+    _command_time_set = true;
+}
+
+void usrpSimRadio::clear_command_time()
+{
+    boost::mutex::scoped_lock lock(_lock);
+    _command_time_set = false;
+}
+
+// the simulated references are always locked
+void usrpSimRadio::set_clock_source(const std::string&, size_t)
+{
+}
+
+void usrpSimRadio::set_time_source(const std::string&, size_t)
+{
+}
+
+uhd::sensor_value_t usrpSimRadio::get_mboard_sensor(const std::string& name, size_t)
+{
+    if (name == "ref_locked")
+        return uhd::sensor_value_t("Ref", true, "locked", "unlocked");
+    if (name == "gps_locked")
+        return uhd::sensor_value_t("GPS lock status", true, "locked", "unlocked");
+    if (name == "gps_time")
+        return uhd::sensor_value_t("GPS epoch time", int(hostTime().get_full_secs()), "seconds");
+    throw uhd::key_error("simulated radio has no motherboard sensor " + name);
+}
+
+size_t usrpSimRadio::get_rx_num_channels()
+{
+    return _rx.size();
+}
+
+std::string usrpSimRadio::get_rx_subdev_name(size_t chan)
+{
+    rx(chan);
+    return "Simulated RX";
+}
+
+std::string usrpSimRadio::get_rx_antenna(size_t chan)
+{
+    rx(chan);
+    return "RX2";
+}
+
+std::vector<std::string> usrpSimRadio::get_rx_antennas(size_t chan)
+{
+    rx(chan);
+    return std::vector<std::string>(1, "RX2");
+}
+
+/* tunes like UHD: the LO goes to the RF frequency and the DSP shifts by the
+ * difference. A change of RF frequency unlocks the LO for lo_lock_time
+ */
+uhd::tune_result_t usrpSimRadio::set_rx_freq(const uhd::tune_request_t& tune_request, size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    const uhd::freq_range_t range = get_rx_freq_range(chan);
+    const double lo_lock_time = settings()->lo_lock_time;
+    uhd::time_spec_t when;
+    const bool timed = commandTime(when);
+
+    boost::mutex::scoped_lock lock(channel.lock);
+    uhd::tune_result_t result;
+    result.clipped_rf_freq = range.clip(tune_request.target_freq);
+    switch (tune_request.rf_freq_policy) {
+        case uhd::tune_request_t::POLICY_MANUAL:
+            result.target_rf_freq = tune_request.rf_freq;
+            break;
+        case uhd::tune_request_t::POLICY_NONE:
+            result.target_rf_freq = channel.rf_frequency;
+            break;
+        default:
+            result.target_rf_freq = result.clipped_rf_freq;
+    }
+    result.actual_rf_freq = range.clip(result.target_rf_freq);
+    switch (tune_request.dsp_freq_policy) {
+        case uhd::tune_request_t::POLICY_MANUAL:
+            result.target_dsp_freq = tune_request.dsp_freq;
+            break;
+        case uhd::tune_request_t::POLICY_NONE:
+            result.target_dsp_freq = channel.rf_frequency - channel.frequency;
+            break;
+        default:
+            result.target_dsp_freq = result.actual_rf_freq - result.clipped_rf_freq;
+    }
+    result.actual_dsp_freq = uhd::freq_range_t(-_master_clock_rate/2, _master_clock_rate/2).clip(result.target_dsp_freq);
+
+    if (result.actual_rf_freq != channel.rf_frequency)
+        channel.lo_locked_at = when + uhd::time_spec_t(lo_lock_time);
+    channel.rf_frequency = result.actual_rf_freq;
+    channel.frequency = result.actual_rf_freq - result.actual_dsp_freq;
+    if (timed) {
+        timedChange change;
+        change.time = when;
+        change.frequency = true;
+        change.value = channel.frequency;
+        std::vector<timedChange>::iterator it = channel.pending.begin();
+        while ((it != channel.pending.end()) and not (when < it->time))
+            it++;
+        channel.pending.insert(it, change);
+    } else {
+        channel.applied_frequency = channel.frequency;
+    }
+    return result;
+}
+
+double usrpSimRadio::get_rx_freq(size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    return channel.frequency;
+}
+
+uhd::freq_range_t usrpSimRadio::get_rx_freq_range(size_t chan)
+{
+    rx(chan);
+    return uhd::freq_range_t(10e6, 6e9);
+}
+
+/* the DSP decimates the master clock by 2 to 512 */
+double usrpSimRadio::coerceRate(double rate) const
+{
+    if (rate <= 0)
+        return _master_clock_rate/512;
+    const double decimation = std::min(std::max(floor(_master_clock_rate/rate + 0.5), 2.0), 512.0);
+    return _master_clock_rate/decimation;
+}
+
+void usrpSimRadio::set_rx_rate(double rate, size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    const double next = coerceRate(rate);
+    if (channel.streaming) {
+        // the run goes on at the new rate from the next sample
+        channel.start += uhd::time_spec_t::from_ticks(channel.position, channel.rate);
+        if (channel.next_overflow > 0)
+            channel.next_overflow = std::max(uint64_t((channel.next_overflow-std::min(channel.position, channel.next_overflow))*next/channel.rate), uint64_t(1));
+        channel.position = 0;
+    }
+    channel.rate = next;
+}
+
+double usrpSimRadio::get_rx_rate(size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    return channel.rate;
+}
+
+uhd::meta_range_t usrpSimRadio::get_rx_rates(size_t chan)
+{
+    rx(chan);
+    return uhd::meta_range_t(_master_clock_rate/512, _master_clock_rate/2);
+}
+
+void usrpSimRadio::set_rx_bandwidth(double bandwidth, size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    const double clipped = get_rx_bandwidth_range(chan).clip(bandwidth);
+    boost::mutex::scoped_lock lock(channel.lock);
+    channel.bandwidth = clipped;
+}
+
+double usrpSimRadio::get_rx_bandwidth(size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    return channel.bandwidth;
+}
+
+uhd::freq_range_t usrpSimRadio::get_rx_bandwidth_range(size_t chan)
+{
+    rx(chan);
+    return uhd::freq_range_t(_master_clock_rate/512, _master_clock_rate/2);
+}
+
+void usrpSimRadio::set_rx_gain(double gain, size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    const double clipped = get_rx_gain_range(chan).clip(gain, true);
+    uhd::time_spec_t when;
+    const bool timed = commandTime(when);
+
+    boost::mutex::scoped_lock lock(channel.lock);
+    channel.gain = clipped;
+    if (timed) {
+        timedChange change;
+        change.time = when;
+        change.frequency = false;
+        change.value = clipped;
+        std::vector<timedChange>::iterator it = channel.pending.begin();
+        while ((it != channel.pending.end()) and not (when < it->time))
+            it++;
+        channel.pending.insert(it, change);
+    } else {
+        channel.applied_gain = clipped;
+    }
+}
+
+double usrpSimRadio::get_rx_gain(size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    return channel.gain;
+}
+
+uhd::gain_range_t usrpSimRadio::get_rx_gain_range(size_t chan)
+{
+    rx(chan);
+    return uhd::gain_range_t(0, 76, 0.5);
+}
+
+std::vector<double> usrpSimRadio::get_rx_clock_rates(size_t chan)
+{
+    rx(chan);
+    return std::vector<double>(1, _master_clock_rate);
+}
+
+uhd::sensor_value_t usrpSimRadio::get_rx_sensor(const std::string& name, size_t chan)
+{
+    rxChannel& channel = rx(chan);
+    if (name == "lo_locked") {
+        const uhd::time_spec_t now = get_time_now();
+        boost::mutex::scoped_lock lock(channel.lock);
+        return uhd::sensor_value_t("LO", not (now < channel.lo_locked_at), "locked", "unlocked");
+    }
+    throw uhd::key_error("simulated radio has no RX sensor " + name);
+}
+
+size_t usrpSimRadio::get_tx_num_channels()
+{
+    return _tx.size();
+}
+
+std::string usrpSimRadio::get_tx_subdev_name(size_t chan)
+{
+    tx(chan);
+    return "Simulated TX";
+}
+
+std::string usrpSimRadio::get_tx_antenna(size_t chan)
+{
+    tx(chan);
+    return "TX/RX";
+}
+
+std::vector<std::string> usrpSimRadio::get_tx_antennas(size_t chan)
+{
+    tx(chan);
+    return std::vector<std::string>(1, "TX/RX");
+}
+
+uhd::tune_result_t usrpSimRadio::set_tx_freq(const uhd::tune_request_t& tune_request, size_t chan)
+{
+    txChannel& channel = tx(chan);
+    uhd::tune_result_t result;
+    result.clipped_rf_freq = get_tx_freq_range(chan).clip(tune_request.target_freq);
+    result.target_rf_freq = result.actual_rf_freq = result.clipped_rf_freq;
+    result.target_dsp_freq = result.actual_dsp_freq = 0;
+    boost::mutex::scoped_lock lock(channel.lock);
+    channel.frequency = result.actual_rf_freq;
+    return result;
+}
+
+double usrpSimRadio::get_tx_freq(size_t chan)
+{
+    txChannel& channel = tx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    return channel.frequency;
+}
+
+uhd::freq_range_t usrpSimRadio::get_tx_freq_range(size_t chan)
+{
+    tx(chan);
+    return uhd::freq_range_t(10e6, 6e9);
+}
+
+void usrpSimRadio::set_tx_rate(double rate, size_t chan)
+{
+    txChannel& channel = tx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    channel.rate = coerceRate(rate);
+}
+
+double usrpSimRadio::get_tx_rate(size_t chan)
+{
+    txChannel& channel = tx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    return channel.rate;
+}
+
+uhd::meta_range_t usrpSimRadio::get_tx_rates(size_t chan)
+{
+    tx(chan);
+    return uhd::meta_range_t(_master_clock_rate/512, _master_clock_rate/2);
+}
+
+void usrpSimRadio::set_tx_bandwidth(double bandwidth, size_t chan)
+{
+    txChannel& channel = tx(chan);
+    const double clipped = get_tx_bandwidth_range(chan).clip(bandwidth);
+    boost::mutex::scoped_lock lock(channel.lock);
+    channel.bandwidth = clipped;
+}
+
+double usrpSimRadio::get_tx_bandwidth(size_t chan)
+{
+    txChannel& channel = tx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    return channel.bandwidth;
+}
+
+uhd::freq_range_t usrpSimRadio::get_tx_bandwidth_range(size_t chan)
+{
+    tx(chan);
+    return uhd::freq_range_t(_master_clock_rate/512, _master_clock_rate/2);
+}
+
+void usrpSimRadio::set_tx_gain(double gain, size_t chan)
+{
+    txChannel& channel = tx(chan);
+    const double clipped = get_tx_gain_range(chan).clip(gain, true);
+    boost::mutex::scoped_lock lock(channel.lock);
+    channel.gain = clipped;
+}
+
+double usrpSimRadio::get_tx_gain(size_t chan)
+{
+    txChannel& channel = tx(chan);
+    boost::mutex::scoped_lock lock(channel.lock);
+    return channel.gain;
+}
+
+uhd::gain_range_t usrpSimRadio::get_tx_gain_range(size_t chan)
+{
+    tx(chan);
+    return uhd::gain_range_t(0, 31.5, 0.5);
+}
+
+std::vector<double> usrpSimRadio::get_tx_clock_rates(size_t chan)
+{
+    tx(chan);
+    return std::vector<double>(1, _master_clock_rate);
+}
+
+/* txChannel.lock held */
+void usrpSimRadio::pushEvent(txChannel& channel, size_t chan, uhd::async_metadata_t::event_code_t code, const uhd::time_spec_t& time)
+{
+    static const size_t MAX_EVENTS = 1000;
+    uhd::async_metadata_t event;
+    event.channel = chan;
+    event.has_time_spec = true;
+    event.time_spec = time;
+    event.event_code = code;
+    memset(event.user_payload, 0, sizeof(event.user_payload));
+    if (channel.events.size() >= MAX_EVENTS)
+        channel.events.pop_front();
+    channel.events.push_back(event);
+    channel.event.notify_all();
+}
+
+/* applies the timed changes due by time; channel.lock held */
+void usrpSimRadio::applyDue(rxChannel& channel, const uhd::time_spec_t& time)
+{
+    size_t due = 0;
+    while ((due < channel.pending.size()) and not (time < channel.pending[due].time)) {
+        if (channel.pending[due].frequency)
+            channel.applied_frequency = channel.pending[due].value;
+        else
+            channel.applied_gain = channel.pending[due].value;
+        due++;
+    }
+    channel.pending.erase(channel.pending.begin(), channel.pending.begin()+due);
+}
+
+/* fills out with the channel's next num_samps samples, splitting the block
+ * where a timed change lands; channel.lock held
+ */
+void usrpSimRadio::synthesize(rxChannel& channel, short* out, size_t num_samps, double full_scale)
+{
+    const boost::shared_ptr<const usrpSimSettings> current = settings();
+    if (current != channel.settings) {
+        channel.settings = current;
+        channel.phasors.assign(current->tones.size(), std::complex<double>(1, 0));
+        channel.noise_state = (current->seed ? current->seed : 1) + 0x9e3779b9*uint32_t(channel.index);
+        if (channel.noise_state == 0)
+            channel.noise_state = 1;
+    }
+
+    const uhd::time_spec_t first = channel.start + uhd::time_spec_t::from_ticks(channel.position, channel.rate);
+    size_t done = 0;
+    while (done < num_samps) {
+        const uhd::time_spec_t time = first + uhd::time_spec_t::from_ticks(done, channel.rate);
+        applyDue(channel, time);
+        size_t count = num_samps - done;
+        if (not channel.pending.empty()) {
+            // the first sample at or after the change, allowing for rounding in the time
+            const double until = ceil((channel.pending.front().time - time).get_real_secs()*channel.rate - 1e-3);
+            count = std::min(count, size_t(std::max(until, 1.0)));
+        }
+        render(channel, *current, out+2*done, count, full_scale);
+        done += count;
+    }
+}
+
+void usrpSimRadio::render(rxChannel& channel, const usrpSimSettings& settings, short* out, size_t num_samps, double full_scale)
+{
+    const double scale = full_scale*pow(10.0, channel.applied_gain/20.0);
+    const double passband = std::min(channel.rate, channel.bandwidth)/2;
+
+    std::vector<double> amplitude;
+    std::vector<std::complex<double> > step;
+    std::vector<size_t> active;
+    for (size_t t=0; t<settings.tones.size(); t++) {
+        const double offset = settings.tones[t].frequency - channel.applied_frequency;
+        if (fabs(offset) >= passband)
+            continue;
+        active.push_back(t);
+        amplitude.push_back(scale*pow(10.0, settings.tones[t].level/20.0));
+        step.push_back(std::polar(1.0, 2*M_PI*offset/channel.rate));
+    }
+
+    const float sigma = scale*pow(10.0, settings.noise_level/20.0)/sqrt(2.0);
+    size_t noise = xorshift(channel.noise_state) % NOISE_SAMPS;
+    for (size_t n=0; n<num_samps; n++) {
+        std::complex<double> sample(sigma*_noise[2*noise], sigma*_noise[2*noise+1]);
+        if (++noise == NOISE_SAMPS)
+            noise = 0;
+        for (size_t a=0; a<active.size(); a++) {
+            std::complex<double>& phasor = channel.phasors[active[a]];
+            sample += amplitude[a]*phasor;
+            phasor *= step[a];
+        }
+        out[2*n] = clip(sample.real(), full_scale);
+        out[2*n+1] = clip(sample.imag(), full_scale);
+    }
+    // keep the rotators from drifting off the unit circle
+    for (size_t a=0; a<active.size(); a++)
+        channel.phasors[active[a]] /= std::abs(channel.phasors[active[a]]);
+}
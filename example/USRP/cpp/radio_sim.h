@@ -0,0 +1,187 @@
+#ifndef RADIO_SIM_H
+#define RADIO_SIM_H
+
+#include <boost/thread.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <complex>
+#include <deque>
+#include <vector>
+#include <stdint.h>
+#include "radio.h"
+
+struct usrpSimTone {
+    double frequency;       // RF, Hz
+    double level;           // dBFS at 0 dB gain
+};
+
+struct usrpSimSettings {
+    usrpSimSettings() : realtime(true), noise_level(-70), fifo_time(0.1), overflow_interval(0), lo_lock_time(0.0005), seed(1) {}
+    bool realtime;          // streams run off the device clock; otherwise as fast as they are read/written
+    double noise_level;     // dBFS of the complex noise at 0 dB gain
+    std::vector<usrpSimTone> tones;
+    double fifo_time;       // seconds of samples the radio buffers: unread RX past this overflows, TX queued past it blocks
+    double overflow_interval; // an RX overflow is forced every this many seconds of samples; 0 for none
+    double lo_lock_time;    // seconds lo_locked reads false after an RF retune
+    uint32_t seed;
+};
+
+/* usrpRadio with no hardware behind it, for running the device on any host.
+ *  - RX channels synthesize the tones within their passband plus gaussian
+ *    noise, scaled by the channel gain and clipped at full scale
+ *  - the device clock follows the host's UTC clock; set_time_next_pps() moves
+ *    it at the next whole second
+ *  - in realtime mode a stream produces samples at its sample rate from its
+ *    start time. Samples left unread for longer than fifo_time are dropped
+ *    and recv() reports an overflow, and a TX burst the host stops feeding
+ *    reports an underflow. Otherwise streams never wait, and only
+ *    overflow_interval causes overflows
+ *  - gain and frequency set with a command time take effect at the sample
+ *    with that timestamp
+ *  - only the sc16 host format is supported; an sc8 wire format scales full
+ *    scale to 127 like the hardware does
+ * Streams keep the radio alive, so it must be owned by a shared_ptr.
+ */
+class usrpSimRadio : public usrpRadio, public boost::enable_shared_from_this<usrpSimRadio> {
+    public:
+        usrpSimRadio(size_t rx_channels, size_t tx_channels, double master_clock_rate, const usrpSimSettings& settings);
+
+        // tones, noise and timing; takes effect on the next recv()
+        void configure(const usrpSimSettings& settings);
+
+        std::string get_backend() const {
+            return "SIMULATED";
+        }
+
+        usrpRxStream::sptr get_rx_stream(const uhd::stream_args_t& args);
+        usrpTxStream::sptr get_tx_stream(const uhd::stream_args_t& args);
+        void issue_stream_cmd(const uhd::stream_cmd_t& stream_cmd, size_t chan);
+
+        uhd::time_spec_t get_time_now();
+        uhd::time_spec_t get_time_last_pps();
+        void set_time_next_pps(const uhd::time_spec_t& time_spec);
+        void set_command_time(const uhd::time_spec_t& time_spec);
+        void clear_command_time();
+        void set_clock_source(const std::string& source, size_t mboard);
+        void set_time_source(const std::string& source, size_t mboard);
+        uhd::sensor_value_t get_mboard_sensor(const std::string& name, size_t mboard = 0);
+
+        size_t get_rx_num_channels();
+        std::string get_rx_subdev_name(size_t chan);
+        std::string get_rx_antenna(size_t chan);
+        std::vector<std::string> get_rx_antennas(size_t chan);
+        uhd::tune_result_t set_rx_freq(const uhd::tune_request_t& tune_request, size_t chan);
+        double get_rx_freq(size_t chan);
+        uhd::freq_range_t get_rx_freq_range(size_t chan);
+        void set_rx_rate(double rate, size_t chan);
+        double get_rx_rate(size_t chan);
+        uhd::meta_range_t get_rx_rates(size_t chan);
+        void set_rx_bandwidth(double bandwidth, size_t chan);
+        double get_rx_bandwidth(size_t chan);
+        uhd::freq_range_t get_rx_bandwidth_range(size_t chan);
+        void set_rx_gain(double gain, size_t chan);
+        double get_rx_gain(size_t chan);
+        uhd::gain_range_t get_rx_gain_range(size_t chan);
+        std::vector<double> get_rx_clock_rates(size_t chan);
+        uhd::sensor_value_t get_rx_sensor(const std::string& name, size_t chan);
+
+        size_t get_tx_num_channels();
+        std::string get_tx_subdev_name(size_t chan);
+        std::string get_tx_antenna(size_t chan);
+        std::vector<std::string> get_tx_antennas(size_t chan);
+        uhd::tune_result_t set_tx_freq(const uhd::tune_request_t& tune_request, size_t chan);
+        double get_tx_freq(size_t chan);
+        uhd::freq_range_t get_tx_freq_range(size_t chan);
+        void set_tx_rate(double rate, size_t chan);
+        double get_tx_rate(size_t chan);
+        uhd::meta_range_t get_tx_rates(size_t chan);
+        void set_tx_bandwidth(double bandwidth, size_t chan);
+        double get_tx_bandwidth(size_t chan);
+        uhd::freq_range_t get_tx_bandwidth_range(size_t chan);
+        void set_tx_gain(double gain, size_t chan);
+        double get_tx_gain(size_t chan);
+        uhd::gain_range_t get_tx_gain_range(size_t chan);
+        std::vector<double> get_tx_clock_rates(size_t chan);
+
+    private:
+        friend class usrpSimRxStream;
+        friend class usrpSimTxStream;
+
+        static const size_t PACKET_SAMPS = 2000;
+        static const size_t NOISE_SAMPS = 1 << 16;
+
+        // a gain or frequency change waiting for its command time
+        struct timedChange {
+            uhd::time_spec_t time;
+            bool frequency;
+            double value;
+        };
+
+        struct rxChannel {
+            rxChannel(size_t _index);
+            const size_t index;
+            boost::mutex lock;
+            double frequency;           // as reported; the samples follow applied_frequency
+            double rf_frequency;
+            double applied_frequency;
+            double rate;
+            double bandwidth;
+            double gain;
+            double applied_gain;
+            uhd::time_spec_t lo_locked_at;
+            std::vector<timedChange> pending; // by time
+
+            bool streaming;
+            bool continuous;
+            bool late;                  // the last stream command missed its time
+            uint64_t remaining;         // samples left of a NUM_SAMPS command
+            uhd::time_spec_t start;     // time of the first sample of the run
+            uint64_t position;          // samples handed out since start
+            uint64_t next_overflow;     // position of the next forced overflow
+
+            boost::shared_ptr<const usrpSimSettings> settings; // the tones are generated for
+            std::vector<std::complex<double> > phasors;
+            uint32_t noise_state;
+        };
+
+        struct txChannel {
+            txChannel();
+            boost::mutex lock;
+            boost::condition_variable event;
+            double frequency;
+            double rate;
+            double bandwidth;
+            double gain;
+            bool in_burst;
+            bool underflowed;           // reported for the burst in progress
+            uhd::time_spec_t end;       // when the queued samples run out
+            std::deque<uhd::async_metadata_t> events;
+        };
+
+        uhd::time_spec_t deviceTime();          // _lock held
+        bool commandTime(uhd::time_spec_t& when);
+        rxChannel& rx(size_t chan);
+        txChannel& tx(size_t chan);
+        boost::shared_ptr<const usrpSimSettings> settings();
+        double coerceRate(double rate) const;
+        void streamCommand(rxChannel& channel, const uhd::stream_cmd_t& stream_cmd, const uhd::time_spec_t& now);
+        void applyDue(rxChannel& channel, const uhd::time_spec_t& time);
+        void synthesize(rxChannel& channel, short* out, size_t num_samps, double full_scale);
+        void render(rxChannel& channel, const usrpSimSettings& settings, short* out, size_t num_samps, double full_scale);
+        void pushEvent(txChannel& channel, size_t chan, uhd::async_metadata_t::event_code_t code, const uhd::time_spec_t& time);
+
+        const double _master_clock_rate;
+        std::vector<boost::shared_ptr<rxChannel> > _rx;
+        std::vector<boost::shared_ptr<txChannel> > _tx;
+        std::vector<float> _noise;              // unit variance, NOISE_SAMPS complex samples
+
+        boost::mutex _lock;                     // everything below
+        boost::shared_ptr<const usrpSimSettings> _settings;
+        uhd::time_spec_t _time_offset;          // device time - host time
+        bool _pps_pending;
+        uhd::time_spec_t _pps_edge;
+        uhd::time_spec_t _pps_time;
+        bool _command_time_set;
+        uhd::time_spec_t _command_time;
+};
+
+#endif // RADIO_SIM_H
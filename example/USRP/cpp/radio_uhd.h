@@ -0,0 +1,207 @@
+#ifndef RADIO_UHD_H
+#define RADIO_UHD_H
+
+#include <uhd/usrp/multi_usrp.hpp>
+#include "radio.h"
+
+/* usrpRadio on a uhd::usrp::multi_usrp; every call is passed straight through */
+class usrpUHDRxStream : public usrpRxStream {
+    public:
+        usrpUHDRxStream(const uhd::rx_streamer::sptr& streamer) : _streamer(streamer) {}
+
+        size_t get_num_channels() const {
+            return _streamer->get_num_channels();
+        }
+        size_t get_max_num_samps() const {
+            return _streamer->get_max_num_samps();
+        }
+        size_t recv(const uhd::rx_streamer::buffs_type& buffs, const size_t nsamps_per_buff,
+                    uhd::rx_metadata_t& metadata, const double timeout, const bool one_packet) {
+            return _streamer->recv(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+        }
+        void issue_stream_cmd(const uhd::stream_cmd_t& stream_cmd) {
+            _streamer->issue_stream_cmd(stream_cmd);
+        }
+
+    private:
+        uhd::rx_streamer::sptr _streamer;
+};
+
+class usrpUHDTxStream : public usrpTxStream {
+    public:
+        usrpUHDTxStream(const uhd::tx_streamer::sptr& streamer) : _streamer(streamer) {}
+
+        size_t get_num_channels() const {
+            return _streamer->get_num_channels();
+        }
+        size_t get_max_num_samps() const {
+            return _streamer->get_max_num_samps();
+        }
+        size_t send(const uhd::tx_streamer::buffs_type& buffs, const size_t nsamps_per_buff,
+                    const uhd::tx_metadata_t& metadata, const double timeout) {
+            return _streamer->send(buffs, nsamps_per_buff, metadata, timeout);
+        }
+        bool recv_async_msg(uhd::async_metadata_t& async_metadata, double timeout) {
+            return _streamer->recv_async_msg(async_metadata, timeout);
+        }
+
+    private:
+        uhd::tx_streamer::sptr _streamer;
+};
+
+class usrpUHDRadio : public usrpRadio {
+    public:
+        usrpUHDRadio(const uhd::usrp::multi_usrp::sptr& device) : _device(device) {}
+
+        std::string get_backend() const {
+            return "UHD";
+        }
+
+        usrpRxStream::sptr get_rx_stream(const uhd::stream_args_t& args) {
+            return usrpRxStream::sptr(new usrpUHDRxStream(_device->get_rx_stream(args)));
+        }
+        usrpTxStream::sptr get_tx_stream(const uhd::stream_args_t& args) {
+            return usrpTxStream::sptr(new usrpUHDTxStream(_device->get_tx_stream(args)));
+        }
+        void issue_stream_cmd(const uhd::stream_cmd_t& stream_cmd, size_t chan) {
+            _device->issue_stream_cmd(stream_cmd, chan);
+        }
+
+        uhd::time_spec_t get_time_now() {
+            return _device->get_time_now();
+        }
+        uhd::time_spec_t get_time_last_pps() {
+            return _device->get_time_last_pps();
+        }
+        void set_time_next_pps(const uhd::time_spec_t& time_spec) {
+            _device->set_time_next_pps(time_spec);
+        }
+        void set_command_time(const uhd::time_spec_t& time_spec) {
+            _device->set_command_time(time_spec);
+        }
+        void clear_command_time() {
+            _device->clear_command_time();
+        }
+        void set_clock_source(const std::string& source, size_t mboard) {
+            _device->set_clock_source(source, mboard);
+        }
+        void set_time_source(const std::string& source, size_t mboard) {
+            _device->set_time_source(source, mboard);
+        }
+        uhd::sensor_value_t get_mboard_sensor(const std::string& name, size_t mboard) {
+            return _device->get_mboard_sensor(name, mboard);
+        }
+
+        size_t get_rx_num_channels() {
+            return _device->get_rx_num_channels();
+        }
+        std::string get_rx_subdev_name(size_t chan) {
+            return _device->get_rx_subdev_name(chan);
+        }
+        std::string get_rx_antenna(size_t chan) {
+            return _device->get_rx_antenna(chan);
+        }
+        std::vector<std::string> get_rx_antennas(size_t chan) {
+            return _device->get_rx_antennas(chan);
+        }
+        uhd::tune_result_t set_rx_freq(const uhd::tune_request_t& tune_request, size_t chan) {
+            return _device->set_rx_freq(tune_request, chan);
+        }
+        double get_rx_freq(size_t chan) {
+            return _device->get_rx_freq(chan);
+        }
+        uhd::freq_range_t get_rx_freq_range(size_t chan) {
+            return _device->get_rx_freq_range(chan);
+        }
+        void set_rx_rate(double rate, size_t chan) {
+            _device->set_rx_rate(rate, chan);
+        }
+        double get_rx_rate(size_t chan) {
+            return _device->get_rx_rate(chan);
+        }
+        uhd::meta_range_t get_rx_rates(size_t chan) {
+            return _device->get_rx_rates(chan);
+        }
+        void set_rx_bandwidth(double bandwidth, size_t chan) {
+            _device->set_rx_bandwidth(bandwidth, chan);
+        }
+        double get_rx_bandwidth(size_t chan) {
+            return _device->get_rx_bandwidth(chan);
+        }
+        uhd::freq_range_t get_rx_bandwidth_range(size_t chan) {
+            return _device->get_rx_bandwidth_range(chan);
+        }
+        void set_rx_gain(double gain, size_t chan) {
+            _device->set_rx_gain(gain, chan);
+        }
+        double get_rx_gain(size_t chan) {
+            return _device->get_rx_gain(chan);
+        }
+        uhd::gain_range_t get_rx_gain_range(size_t chan) {
+            return _device->get_rx_gain_range(chan);
+        }
+        std::vector<double> get_rx_clock_rates(size_t chan) {
+            return _device->get_rx_dboard_iface(chan)->get_clock_rates(uhd::usrp::dboard_iface::UNIT_RX);
+        }
+        uhd::sensor_value_t get_rx_sensor(const std::string& name, size_t chan) {
+            return _device->get_rx_sensor(name, chan);
+        }
+
+        size_t get_tx_num_channels() {
+            return _device->get_tx_num_channels();
+        }
+        std::string get_tx_subdev_name(size_t chan) {
+            return _device->get_tx_subdev_name(chan);
+        }
+        std::string get_tx_antenna(size_t chan) {
+            return _device->get_tx_antenna(chan);
+        }
+        std::vector<std::string> get_tx_antennas(size_t chan) {
+            return _device->get_tx_antennas(chan);
+        }
+        uhd::tune_result_t set_tx_freq(const uhd::tune_request_t& tune_request, size_t chan) {
+            return _device->set_tx_freq(tune_request, chan);
+        }
+        double get_tx_freq(size_t chan) {
+            return _device->get_tx_freq(chan);
+        }
+        uhd::freq_range_t get_tx_freq_range(size_t chan) {
+            return _device->get_tx_freq_range(chan);
+        }
+        void set_tx_rate(double rate, size_t chan) {
+            _device->set_tx_rate(rate, chan);
+        }
+        double get_tx_rate(size_t chan) {
+            return _device->get_tx_rate(chan);
+        }
+        uhd::meta_range_t get_tx_rates(size_t chan) {
+            return _device->get_tx_rates(chan);
+        }
+        void set_tx_bandwidth(double bandwidth, size_t chan) {
+            _device->set_tx_bandwidth(bandwidth, chan);
+        }
+        double get_tx_bandwidth(size_t chan) {
+            return _device->get_tx_bandwidth(chan);
+        }
+        uhd::freq_range_t get_tx_bandwidth_range(size_t chan) {
+            return _device->get_tx_bandwidth_range(chan);
+        }
+        void set_tx_gain(double gain, size_t chan) {
+            _device->set_tx_gain(gain, chan);
+        }
+        double get_tx_gain(size_t chan) {
+            return _device->get_tx_gain(chan);
+        }
+        uhd::gain_range_t get_tx_gain_range(size_t chan) {
+            return _device->get_tx_gain_range(chan);
+        }
+        // the TX daughterboard reports the clock rates of its RX unit
+        std::vector<double> get_tx_clock_rates(size_t chan) {
+            return _device->get_tx_dboard_iface(chan)->get_clock_rates(uhd::usrp::dboard_iface::UNIT_RX);
+        }
+
+    private:
+        uhd::usrp::multi_usrp::sptr _device;
+};
+
+#endif // RADIO_UHD_H
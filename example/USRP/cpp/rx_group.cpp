@@ -0,0 +1,170 @@
+#include "rx_group.h"
+
+#include <algorithm>
+
+const double usrpRxGroup::START_DELAY = 0.1;
+
+namespace {
+    bool byTunerNumber(const RDC_ns::RDC_i* a, const RDC_ns::RDC_i* b) {
+        return a->tunerNumber() < b->tunerNumber();
+    }
+
+    // holds a set of tuner locks, taken in order and released in reverse
+    class scopedGroupLock {
+        public:
+            scopedGroupLock(const std::vector<ticket_lock_t*>& locks) : _locks(locks) {
+                for (size_t i=0; i<_locks.size(); i++)
+                    lockTuner(*_locks[i]);
+            }
+            ~scopedGroupLock() {
+                for (size_t i=_locks.size(); i>0; i--)
+                    unlockTuner(*_locks[i-1]);
+            }
+        private:
+            const std::vector<ticket_lock_t*>& _locks;
+    };
+}
+
+usrpRxGroup::usrpRxGroup(const usrpRadio::sptr& device, const usrp_command_lock_t& command_lock,
+                         const std::vector<RDC_ns::RDC_i*>& members, const report_function& report) :
+    _device(device),
+    _command_lock(command_lock),
+    _members(members),
+    _report(report),
+    _thread(NULL),
+    _running(false)
+{
+    // channel order (and tuner lock order) follows the tuner numbers
+    std::sort(_members.begin(), _members.end(), byTunerNumber);
+    for (size_t i=0; i<_members.size(); i++) {
+        _locks.push_back(&_members[i]->tunerLock());
+    }
+}
+
+usrpRxGroup::~usrpRxGroup()
+{
+    stop();
+}
+
+bool usrpRxGroup::contains(const RDC_ns::RDC_i* rdc) const
+{
+    return std::find(_members.begin(), _members.end(), rdc) != _members.end();
+}
+
+bool usrpRxGroup::start(std::string& error)
+{
+    if (_members.empty() or (_device.get() == NULL)) {
+        error = "no members";
+        return false;
+    }
+
+    // the members' LOs settle together, so this waits as long as the slowest
+    for (size_t i=0; i<_members.size(); i++) {
+        _members[i]->waitLoLocked();
+    }
+    for (size_t i=0; i<_members.size(); i++) {
+        _members[i]->joinRxGroup();
+    }
+
+    try {
+        uhd::stream_args_t stream_args("sc16", _members[0]->wireFormat());
+        for (size_t i=0; i<_members.size(); i++) {
+            stream_args.channels.push_back(_members[i]->tunerNumber());
+        }
+        stream_args.args["noclear"] = "1";
+        _streamer = _device->get_rx_stream(stream_args);
+
+        uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+        boost::mutex::scoped_lock cmd_lock(*_command_lock);
+        stream_cmd.stream_now = (_members.size() == 1);
+        stream_cmd.time_spec = _device->get_time_now() + uhd::time_spec_t(START_DELAY);
+        _streamer->issue_stream_cmd(stream_cmd);
+    } catch (const std::exception& e) {
+        error = e.what();
+        _streamer.reset();
+        for (size_t i=0; i<_members.size(); i++) {
+            _members[i]->leaveRxGroup();
+        }
+        return false;
+    }
+
+    _running = true;
+    _thread = new boost::thread(&usrpRxGroup::receiveThread, this);
+    return true;
+}
+
+void usrpRxGroup::stop()
+{
+    if (_thread == NULL)
+        return;
+    _running = false;
+    _thread->join(); // bounded by the recv() timeout
+    delete _thread;
+    _thread = NULL;
+    stopStreaming();
+}
+
+/* halts the group's streamer and hands each member back its own */
+void usrpRxGroup::stopStreaming()
+{
+    if (_streamer.get() == NULL)
+        return;
+    try {
+        boost::mutex::scoped_lock cmd_lock(*_command_lock);
+        _streamer->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS);
+    } catch (...) {
+    }
+    _streamer.reset();
+    for (size_t i=0; i<_members.size(); i++) {
+        _members[i]->leaveRxGroup();
+    }
+}
+
+void usrpRxGroup::receiveThread()
+{
+    std::vector<void*> buffs(_members.size());
+    size_t errors = 0;
+    while (_running) {
+        std::string error;
+        {
+            // hold every member for the whole recv() so no channel is retuned or resized mid-buffer
+            scopedGroupLock locks(_locks);
+            size_t samps_to_rx = ~size_t(0);
+            for (size_t i=0; i<_members.size(); i++) {
+                size_t samps = 0;
+                buffs[i] = _members[i]->groupRecvBuffer(samps);
+                samps_to_rx = std::min(samps_to_rx, samps);
+            }
+
+            uhd::rx_metadata_t metadata;
+            size_t num_samps = 0;
+            try {
+                // long enough to ride out the timed start
+                num_samps = _streamer->recv(buffs, samps_to_rx, metadata, START_DELAY+1.0);
+            } catch (const std::exception& e) {
+                error = e.what();
+            } catch (...) {
+                error = "unknown error";
+            }
+            if (error.empty()) {
+                for (size_t i=0; i<_members.size(); i++) {
+                    _members[i]->groupReceived(num_samps, metadata);
+                }
+            }
+        }
+        if (error.empty()) {
+            errors = 0;
+            continue;
+        }
+
+        // back off with the members' locks released, so they can still be controlled
+        if (++errors >= MAX_ERRORS) {
+            _report(error, true);
+            _running = false;
+            stopStreaming();
+            return;
+        }
+        _report(error, false);
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10 << errors));
+    }
+}
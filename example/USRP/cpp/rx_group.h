@@ -0,0 +1,56 @@
+#ifndef RX_GROUP_H
+#define RX_GROUP_H
+
+#include "radio.h"
+#include <vector>
+#include <string>
+#include <atomic>
+#include <boost/function.hpp>
+#include "RDC/RDC.h"
+
+/* A set of RDCs on one motherboard received through a single multi-channel
+ * rx_streamer, so their samples are aligned and carry one set of timestamps.
+ *  - start() waits for the members' LOs to lock, takes reception over from
+ *    the members and starts every channel with one timed stream command
+ *  - the group thread recv()s straight into each member's output buffer (the
+ *    demux is UHD's per-channel buffer list) and lets each member do its usual
+ *    hand-off to its own rx ring, SRI and ports
+ *  - stop() halts the streamer and gives each member its own streamer back
+ *  - recv() errors go to report(); the group backs off after each, and after
+ *    MAX_ERRORS in a row stops and gives the members their streamers back
+ * All members must run at the same sample rate.
+ */
+class usrpRxGroup {
+    public:
+        typedef boost::function<void (const std::string& error, bool stopped)> report_function;
+
+        usrpRxGroup(const usrpRadio::sptr& device, const usrp_command_lock_t& command_lock,
+                    const std::vector<RDC_ns::RDC_i*>& members, const report_function& report);
+        ~usrpRxGroup();
+
+        bool start(std::string& error);
+        void stop();
+
+        const std::vector<RDC_ns::RDC_i*>& members() const {
+            return _members;
+        }
+        bool contains(const RDC_ns::RDC_i* rdc) const;
+
+    private:
+        static const double START_DELAY; // seconds between the stream command and the aligned start
+        static const size_t MAX_ERRORS = 8; // recv() failures in a row before the group stops
+
+        void receiveThread();
+        void stopStreaming();
+
+        usrpRadio::sptr _device;
+        usrp_command_lock_t _command_lock;
+        std::vector<RDC_ns::RDC_i*> _members;
+        std::vector<ticket_lock_t*> _locks; // the members' tuner locks, in tuner number order
+        report_function _report;
+        usrpRxStream::sptr _streamer;
+        boost::thread* _thread;
+        std::atomic<bool> _running;
+};
+
+#endif // RX_GROUP_H
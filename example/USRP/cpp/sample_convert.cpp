@@ -0,0 +1,21 @@
+#include "sample_convert.h"
+
+/* both loops are kept branch-free so gcc can vectorize them; the clamp keeps
+ * full-range data passed with too small a shift from wrapping
+ */
+void sc16_to_sc8(const short* in, size_t len, unsigned shift, int8_t* out)
+{
+    for (size_t i=0; i<len; i++) {
+        int value = in[i] >> shift;
+        value = (value > 127) ? 127 : value;
+        value = (value < -128) ? -128 : value;
+        out[i] = int8_t(value);
+    }
+}
+
+void sc16_to_fc32(const short* in, size_t len, float scale, float* out)
+{
+    for (size_t i=0; i<len; i++) {
+        out[i] = in[i] * scale;
+    }
+}
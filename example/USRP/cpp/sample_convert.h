@@ -0,0 +1,17 @@
+#ifndef SAMPLE_CONVERT_H
+#define SAMPLE_CONVERT_H
+
+#include <cstddef>
+#include <stdint.h>
+
+/* element-wise conversions of interleaved sc16 (I,Q,I,Q,...) data for the
+ * alternate output formats; len counts shorts, not complex samples
+ */
+
+// to 8-bit two's complement, dropping the low shift bits (0 when the values already fit)
+void sc16_to_sc8(const short* in, size_t len, unsigned shift, int8_t* out);
+
+// to fc32, multiplying each value by scale
+void sc16_to_fc32(const short* in, size_t len, float scale, float* out);
+
+#endif // SAMPLE_CONVERT_H
@@ -0,0 +1,167 @@
+#include "sample_stats.h"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#define SAMPLE_STATS_SSE2
+#include <emmintrin.h>
+// target-specific intrinsics outside of -mavx2 need gcc >= 4.9
+#if defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define SAMPLE_STATS_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+double sc16Stats::meanPower() const {
+    if (num_samps == 0)
+        return 0;
+    return double(power_sum) / double(num_samps);
+}
+
+double sc16Stats::powerDbfs(double full_scale) const {
+    const double mean = meanPower();
+    if ((mean <= 0) or (full_scale <= 0))
+        return -200;
+    // a full scale complex sinusoid has I^2+Q^2 == full_scale^2
+    return 10*log10(mean/(full_scale*full_scale));
+}
+
+namespace {
+    typedef void (*sc16_stats_fn)(const short*, size_t, uint16_t, sc16Stats&);
+
+    // handles the whole buffer, or the tail left over by the vector kernels
+    inline void stats_scalar(const short* data, size_t len, uint16_t clip_level, uint16_t& peak, uint64_t& power_sum, size_t& clip_count)
+    {
+        for (size_t i=0; i<len; i++) {
+            const int32_t value = data[i];
+            const uint16_t mag = (value < 0) ? -value : value;
+            if (mag > peak)
+                peak = mag;
+            power_sum += uint32_t(value*value);
+            if (mag >= clip_level)
+                clip_count++;
+        }
+    }
+
+    void sc16_stats_scalar(const short* data, size_t len, uint16_t clip_level, sc16Stats& stats)
+    {
+        stats.reset();
+        stats_scalar(data, len, clip_level, stats.peak, stats.power_sum, stats.clip_count);
+        stats.num_samps = len/2;
+    }
+
+#ifdef SAMPLE_STATS_SSE2
+    /* SSE2 has no unsigned 16-bit max/compare, so magnitudes are biased by 0x8000
+     * and compared as signed values. I^2+Q^2 comes out of madd as a 32-bit value
+     * that only fits unsigned (-32768,-32768 gives 2^31), so it is widened with
+     * zeros before accumulating in 64 bits.
+     */
+    void sc16_stats_sse2(const short* data, size_t len, uint16_t clip_level, sc16Stats& stats)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(short(0x8000));
+        const __m128i clip = _mm_xor_si128(_mm_set1_epi16(short(clip_level)), bias);
+        __m128i peak = _mm_xor_si128(zero, bias); // biased 0
+        __m128i power = zero;
+        size_t under_clip = 0;
+
+        const size_t vec_len = len & ~size_t(7);
+        for (size_t i=0; i<vec_len; i+=8) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data+i));
+            const __m128i sign = _mm_srai_epi16(x, 15);
+            const __m128i mag = _mm_xor_si128(_mm_sub_epi16(_mm_xor_si128(x, sign), sign), bias);
+            peak = _mm_max_epi16(peak, mag);
+            under_clip += __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi16(clip, mag)));
+            const __m128i sq = _mm_madd_epi16(x, x);
+            power = _mm_add_epi64(power, _mm_unpacklo_epi32(sq, zero));
+            power = _mm_add_epi64(power, _mm_unpackhi_epi32(sq, zero));
+        }
+
+        uint16_t lanes[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(peak, bias));
+        uint64_t sums[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), power);
+
+        stats.reset();
+        stats.peak = *std::max_element(lanes, lanes+8);
+        stats.power_sum = sums[0]+sums[1];
+        stats.clip_count = vec_len - under_clip/2; // movemask yields 2 bits per 16-bit lane
+        stats_scalar(data+vec_len, len-vec_len, clip_level, stats.peak, stats.power_sum, stats.clip_count);
+        stats.num_samps = len/2;
+    }
+#endif
+
+#ifdef SAMPLE_STATS_AVX2
+    __attribute__((target("avx2")))
+    void sc16_stats_avx2(const short* data, size_t len, uint16_t clip_level, sc16Stats& stats)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i clip = _mm256_set1_epi16(short(clip_level));
+        __m256i peak = zero;
+        __m256i power = zero;
+        size_t at_clip = 0;
+
+        const size_t vec_len = len & ~size_t(15);
+        for (size_t i=0; i<vec_len; i+=16) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data+i));
+            const __m256i sign = _mm256_srai_epi16(x, 15);
+            const __m256i mag = _mm256_sub_epi16(_mm256_xor_si256(x, sign), sign);
+            peak = _mm256_max_epu16(peak, mag);
+            // mag >= clip  <=>  max(mag, clip) == mag
+            at_clip += __builtin_popcount(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_max_epu16(mag, clip), mag)));
+            const __m256i sq = _mm256_madd_epi16(x, x);
+            power = _mm256_add_epi64(power, _mm256_unpacklo_epi32(sq, zero));
+            power = _mm256_add_epi64(power, _mm256_unpackhi_epi32(sq, zero));
+        }
+
+        uint16_t lanes[16];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), peak);
+        uint64_t sums[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums), power);
+
+        stats.reset();
+        stats.peak = *std::max_element(lanes, lanes+16);
+        stats.power_sum = sums[0]+sums[1]+sums[2]+sums[3];
+        stats.clip_count = at_clip/2; // movemask yields 2 bits per 16-bit lane
+        stats_scalar(data+vec_len, len-vec_len, clip_level, stats.peak, stats.power_sum, stats.clip_count);
+        stats.num_samps = len/2;
+    }
+#endif
+
+    struct sc16_stats_kernel {
+        sc16_stats_kernel() {
+            fn = &sc16_stats_scalar;
+            name = "scalar";
+#ifdef SAMPLE_STATS_SSE2
+            fn = &sc16_stats_sse2;
+            name = "sse2";
+#endif
+#ifdef SAMPLE_STATS_AVX2
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                fn = &sc16_stats_avx2;
+                name = "avx2";
+            }
+#endif
+        }
+        sc16_stats_fn fn;
+        const char* name;
+    };
+
+    const sc16_stats_kernel& kernel()
+    {
+        static sc16_stats_kernel selected;
+        return selected;
+    }
+}
+
+void sc16_stats(const short* data, size_t len, uint16_t clip_level, sc16Stats& stats)
+{
+    kernel().fn(data, len, clip_level, stats);
+}
+
+const char* sc16_stats_impl()
+{
+    return kernel().name;
+}
@@ -0,0 +1,44 @@
+#ifndef SAMPLE_STATS_H
+#define SAMPLE_STATS_H
+
+#include <cstddef>
+#include <stdint.h>
+
+/* single-pass statistics over interleaved sc16 (I,Q,I,Q,...) data
+ *  - peak is the largest |I| or |Q|, so negative excursions count too
+ *  - power_sum is the sum of I^2+Q^2 over all complex samples
+ *  - clip_count is the number of I or Q values whose magnitude is at or beyond the clip level
+ */
+struct sc16Stats {
+    sc16Stats(){
+        reset();
+    }
+
+    size_t num_samps; // complex samples examined
+    uint16_t peak;
+    uint64_t power_sum;
+    size_t clip_count;
+
+    void reset(){
+        num_samps = 0;
+        peak = 0;
+        power_sum = 0;
+        clip_count = 0;
+    }
+
+    // mean of I^2+Q^2 per complex sample
+    double meanPower() const;
+
+    // mean power relative to a full scale sine at full_scale amplitude
+    double powerDbfs(double full_scale) const;
+};
+
+/* computes stats over len shorts (len/2 complex samples) of interleaved sc16 data
+ * the SSE2/AVX2/scalar implementation is picked once at runtime based on the host CPU
+ */
+void sc16_stats(const short* data, size_t len, uint16_t clip_level, sc16Stats& stats);
+
+// name of the implementation sc16_stats() dispatches to ("avx2", "sse2" or "scalar")
+const char* sc16_stats_impl();
+
+#endif // SAMPLE_STATS_H
@@ -0,0 +1,92 @@
+#ifndef SCAN_PLAN_H
+#define SCAN_PLAN_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/* the hops a scan makes, worked out once when its strategy is set
+ *  - a span is expanded to begin, begin+step, ... up to end
+ *  - runs of consecutive hops whose centers all fit within reach of one LO
+ *    share it, so only the DSP moves between them; a hop on its own gets
+ *    lo_frequency 0 and the tuner picks its LO
+ */
+class usrpScanPlan {
+    public:
+        struct hop {
+            double frequency;
+            double lo_frequency; // 0 to let the tuner pick
+        };
+
+        static const size_t MAX_HOPS = 65536;
+
+        // appends the span's frequencies; false if there'd be more than MAX_HOPS
+        static bool expandSpan(double begin, double end, double step, std::vector<double>& frequencies) {
+            if ((step <= 0) or (end <= begin)) {
+                frequencies.push_back(begin);
+                return frequencies.size() <= MAX_HOPS;
+            }
+            const double count = std::floor((end - begin) / step + 1e-9) + 1;
+            if (frequencies.size() + count > MAX_HOPS)
+                return false;
+            for (size_t i=0; i<size_t(count); i++)
+                frequencies.push_back(begin + i*step);
+            return true;
+        }
+
+        // reach: how far from its LO a hop's center may be; <= 0 for no sharing
+        bool build(const std::vector<double>& frequencies, double reach) {
+            _hops.clear();
+            if (frequencies.size() > MAX_HOPS)
+                return false;
+            size_t first = 0;
+            while (first < frequencies.size()) {
+                double low = frequencies[first];
+                double high = frequencies[first];
+                size_t last = first + 1;
+                while ((reach > 0) and (last < frequencies.size())) {
+                    const double next_low = std::min(low, frequencies[last]);
+                    const double next_high = std::max(high, frequencies[last]);
+                    if (next_high - next_low > 2*reach)
+                        break;
+                    low = next_low;
+                    high = next_high;
+                    last++;
+                }
+                const double lo_frequency = (last - first > 1) ? (low + high) / 2 : 0;
+                for (size_t i=first; i<last; i++) {
+                    hop added;
+                    added.frequency = frequencies[i];
+                    added.lo_frequency = lo_frequency;
+                    _hops.push_back(added);
+                }
+                first = last;
+            }
+            return true;
+        }
+
+        void clear() {
+            _hops.clear();
+        }
+        bool empty() const {
+            return _hops.empty();
+        }
+        size_t size() const {
+            return _hops.size();
+        }
+        const hop& operator[](size_t index) const {
+            return _hops[index];
+        }
+        std::vector<double> frequencies() const {
+            std::vector<double> result;
+            for (size_t i=0; i<_hops.size(); i++)
+                result.push_back(_hops[i].frequency);
+            return result;
+        }
+
+    private:
+        std::vector<hop> _hops;
+};
+
+#endif // SCAN_PLAN_H
@@ -0,0 +1,240 @@
+#include "sdds_packetizer.h"
+
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <endian.h>
+
+namespace {
+    const uint8_t SDDS_SF = 0x80;    // standard format
+    const uint8_t SDDS_SOS = 0x40;   // start of sequence
+    const uint8_t SDDS_DM = 0x01;    // data mode
+    const uint8_t SDDS_CX = 0x80;    // complex samples
+    const uint8_t SDDS_BPS = 16;     // bits per sample
+    const uint16_t SDDS_TTV = 0x4000; // time tag valid
+    const uint64_t SDDS_TICKS_PER_SEC = 4000000000ULL;
+    const double SDDS_FREQ_SCALE = 9223372036854775808.0 / 73.728e6; // 2^63 / 73.728 MHz
+
+    // SDDS time tags count from 00:00:00 January 1st of the current (UTC) year
+    time_t startOfYear(time_t secs)
+    {
+        struct tm utc;
+        gmtime_r(&secs, &utc);
+        return secs - (utc.tm_yday*86400 + utc.tm_hour*3600 + utc.tm_min*60 + utc.tm_sec);
+    }
+
+    void advance(time_t& whole_secs, double& frac_secs, double offset)
+    {
+        frac_secs += offset;
+        const double whole = std::floor(frac_secs);
+        whole_secs += time_t(whole);
+        frac_secs -= whole;
+    }
+}
+
+sddsPacketizer::sddsPacketizer() :
+    _fd(-1),
+    _sos(true),
+    _seq(0),
+    _frames_sent(0),
+    _send_errors(0),
+    _carry_secs(0),
+    _carry_frac(0),
+    _carry_rate(0),
+    _headers(BATCH),
+    _iov(3*BATCH),
+    _msgs(BATCH)
+{
+    memset(&_dest, 0, sizeof(_dest));
+    _carry.reserve(2*SAMPLES_PER_FRAME);
+    memset(&_msgs[0], 0, _msgs.size()*sizeof(mmsghdr));
+    for (size_t i=0; i<BATCH; i++) {
+        _iov[3*i].iov_base = &_headers[i];
+        _iov[3*i].iov_len = sizeof(sddsHeader);
+        _msgs[i].msg_hdr.msg_name = &_dest;
+        _msgs[i].msg_hdr.msg_namelen = sizeof(_dest);
+        _msgs[i].msg_hdr.msg_iov = &_iov[3*i];
+    }
+}
+
+sddsPacketizer::~sddsPacketizer()
+{
+    close();
+}
+
+bool sddsPacketizer::open(const std::string& group, unsigned short port, const std::string& iface, unsigned char ttl, std::string& error)
+{
+    close();
+    reset();
+    _frames_sent = 0;
+    _send_errors = 0;
+
+    _dest.sin_family = AF_INET;
+    _dest.sin_port = htons(port);
+    if (inet_aton(group.c_str(), &_dest.sin_addr) == 0) {
+        error = "invalid address " + group;
+        return false;
+    }
+
+    _fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (_fd < 0) {
+        error = std::string("socket: ") + strerror(errno);
+        return false;
+    }
+
+    // best effort; a deeper send queue rides out scheduling hiccups at high rates
+    int sndbuf = 4*1024*1024;
+    setsockopt(_fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+    if (IN_MULTICAST(ntohl(_dest.sin_addr.s_addr))) {
+        int mttl = ttl;
+        if (setsockopt(_fd, IPPROTO_IP, IP_MULTICAST_TTL, &mttl, sizeof(mttl)) < 0) {
+            error = std::string("IP_MULTICAST_TTL: ") + strerror(errno);
+            close();
+            return false;
+        }
+        if (not iface.empty()) {
+            ip_mreqn mreq;
+            memset(&mreq, 0, sizeof(mreq));
+            mreq.imr_ifindex = if_nametoindex(iface.c_str());
+            if ((mreq.imr_ifindex == 0) or (setsockopt(_fd, IPPROTO_IP, IP_MULTICAST_IF, &mreq, sizeof(mreq)) < 0)) {
+                error = "unable to send on interface " + iface + ": " + strerror(errno);
+                close();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void sddsPacketizer::close()
+{
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+void sddsPacketizer::reset()
+{
+    _sos = true;
+    _seq = 0;
+    _carry.clear();
+}
+
+long sddsPacketizer::dataRef()
+{
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+    return 52651; // 0xCDAB
+#else
+    return 43981; // 0xABCD
+#endif
+}
+
+void sddsPacketizer::fillHeader(sddsHeader& header, double sample_rate, time_t whole_secs, double frac_secs)
+{
+    memset(&header, 0, sizeof(header));
+    header.format = SDDS_SF | SDDS_DM | (_sos ? SDDS_SOS : 0);
+    header.bits = SDDS_CX | SDDS_BPS;
+    header.seq = htons(_seq);
+    header.msptr = htons(SDDS_TTV);
+
+    // whole seconds are counted in integer ticks; only the fractional second
+    // goes through a double, which resolves it far below one tick
+    const double frac_ticks = frac_secs*SDDS_TICKS_PER_SEC;
+    const uint64_t whole_frac_ticks = uint64_t(frac_ticks);
+    const uint64_t ticks = uint64_t(whole_secs - startOfYear(whole_secs))*SDDS_TICKS_PER_SEC + whole_frac_ticks;
+    header.ttag = htobe64(ticks);
+    header.ttage = htonl(uint32_t(std::min((frac_ticks-double(whole_frac_ticks))*4294967296.0, 4294967295.0)));
+
+    // the SDDS clock counts I and Q separately
+    const double freq = std::min(2*sample_rate*SDDS_FREQ_SCALE, 18446744073709551615.0);
+    header.freq = htobe64(uint64_t(freq));
+
+    _sos = false;
+    if ((++_seq % 32) == 31)
+        ++_seq; // skip the parity frame slot
+}
+
+size_t sddsPacketizer::send(const short* data, size_t len, double sample_rate, time_t whole_secs, double frac_secs)
+{
+    if ((_fd < 0) or (sample_rate <= 0))
+        return 0;
+
+    const size_t samps = len/2;
+    size_t consumed = 0;
+    size_t count = 0;
+    size_t sent = 0;
+
+    // the carried samples can only lead this buffer if nothing was lost in between
+    if (not _carry.empty()) {
+        time_t carry_end_secs = _carry_secs;
+        double carry_end_frac = _carry_frac;
+        advance(carry_end_secs, carry_end_frac, (_carry.size()/2)/_carry_rate);
+        const double gap = double(whole_secs-carry_end_secs) + (frac_secs-carry_end_frac);
+        if ((_carry_rate != sample_rate) or (std::fabs(gap)*sample_rate > 0.5)) {
+            _carry.clear();
+        }
+    }
+
+    if (not _carry.empty()) {
+        const size_t need = SAMPLES_PER_FRAME - _carry.size()/2;
+        if (samps < need) {
+            _carry.insert(_carry.end(), data, data+len);
+            return 0;
+        }
+        fillHeader(_headers[0], sample_rate, _carry_secs, _carry_frac);
+        _iov[1].iov_base = &_carry[0];
+        _iov[1].iov_len = _carry.size()*sizeof(short);
+        _iov[2].iov_base = const_cast<short*>(data);
+        _iov[2].iov_len = need*2*sizeof(short);
+        _msgs[0].msg_hdr.msg_iovlen = 3;
+        consumed = need;
+        count = 1;
+    }
+
+    while (samps-consumed >= SAMPLES_PER_FRAME) {
+        time_t secs = whole_secs;
+        double frac = frac_secs;
+        advance(secs, frac, consumed/sample_rate);
+        fillHeader(_headers[count], sample_rate, secs, frac);
+        _iov[3*count+1].iov_base = const_cast<short*>(data+2*consumed);
+        _iov[3*count+1].iov_len = PAYLOAD_BYTES;
+        _msgs[count].msg_hdr.msg_iovlen = 2;
+        consumed += SAMPLES_PER_FRAME;
+        if (++count == BATCH) {
+            sent += flush(count);
+            count = 0;
+        }
+    }
+    sent += flush(count);
+
+    // the carry may have been referenced by the first frame, so only replace it now
+    _carry.assign(data+2*consumed, data+2*samps);
+    _carry_secs = whole_secs;
+    _carry_frac = frac_secs;
+    _carry_rate = sample_rate;
+    advance(_carry_secs, _carry_frac, consumed/sample_rate);
+    return sent;
+}
+
+size_t sddsPacketizer::flush(size_t count)
+{
+    size_t done = 0;
+    while (done < count) {
+        const int ret = sendmmsg(_fd, &_msgs[done], count-done, 0);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            // drop the rest of the batch rather than stall the output
+            _send_errors += count-done;
+            break;
+        }
+        done += ret;
+    }
+    _frames_sent += done;
+    return done;
+}
@@ -0,0 +1,92 @@
+#ifndef SDDS_PACKETIZER_H
+#define SDDS_PACKETIZER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+/* SDDS frame header, 56 bytes, all multi-byte fields big-endian on the wire */
+struct sddsHeader {
+    uint8_t format;     // sf | sos | pp | of | ss | dm(3)
+    uint8_t bits;       // cx | snp | vw | bps(5)
+    uint16_t seq;       // frame sequence; multiples of 32 minus one are reserved for parity frames
+    uint16_t msptr;     // msv | ttv | sscv | pi | peo | reserved | msptr(10)
+    uint16_t msdelta;
+    uint64_t ttag;      // 250 ps ticks since the start of the UTC year
+    uint32_t ttage;     // ttag extension, 250 ps / 2^32 ticks
+    uint32_t dfdt;
+    uint64_t freq;      // sample clock, 2^63 / 73.728 MHz units
+    uint8_t ssd[4];
+    uint8_t aad[20];
+} __attribute__((packed));
+
+/* Sends interleaved sc16 buffers as SDDS frames on a UDP (multicast) group.
+ *  - the payload of every frame points straight into the caller's buffer;
+ *    only the headers are built here, and frames go out sendmmsg() batches at a time
+ *  - samples stay in host byte order; consumers are told so through the
+ *    DATA_REF_STR keyword (see dataRef())
+ *  - samples that don't fill a whole frame are carried (copied, < 1 frame) into
+ *    the first frame of the next buffer if it is contiguous, otherwise dropped
+ */
+class sddsPacketizer {
+    public:
+        static const size_t PAYLOAD_BYTES = 1024;
+        static const size_t SAMPLES_PER_FRAME = PAYLOAD_BYTES / (2*sizeof(short));
+        static const size_t BATCH = 64; // frames per sendmmsg()
+
+        sddsPacketizer();
+        ~sddsPacketizer();
+
+        // binds the sending socket; returns false (and leaves the packetizer closed) on failure
+        bool open(const std::string& group, unsigned short port, const std::string& iface, unsigned char ttl, std::string& error);
+        void close();
+        bool isOpen() const {
+            return _fd >= 0;
+        }
+
+        // starts a new sequence (sos set, sequence 0) and drops any carried samples
+        void reset();
+
+        /* packetizes len shorts (len/2 complex samples) taken at sample_rate starting at
+         * whole_secs+frac_secs (UTC); returns the number of frames sent
+         */
+        size_t send(const short* data, size_t len, double sample_rate, time_t whole_secs, double frac_secs);
+
+        size_t framesSent() const {
+            return _frames_sent;
+        }
+        size_t sendErrors() const {
+            return _send_errors;
+        }
+
+        // DATA_REF_STR value describing the byte order the samples are sent in
+        static long dataRef();
+
+    private:
+        void fillHeader(sddsHeader& header, double sample_rate, time_t whole_secs, double frac_secs);
+        size_t flush(size_t count);
+
+        int _fd;
+        sockaddr_in _dest;
+        bool _sos;
+        uint16_t _seq;
+        size_t _frames_sent;
+        size_t _send_errors;
+
+        // partial frame left over from the previous buffer
+        std::vector<short> _carry;
+        time_t _carry_secs;
+        double _carry_frac;
+        double _carry_rate;
+
+        std::vector<sddsHeader> _headers;
+        std::vector<iovec> _iov;
+        std::vector<mmsghdr> _msgs;
+};
+
+#endif // SDDS_PACKETIZER_H
@@ -0,0 +1,228 @@
+#ifndef STATUS_DISPATCHER_H
+#define STATUS_DISPATCHER_H
+
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/* sends status events to a uses port from a thread of its own, so the thread
+ * reporting them never waits on a consumer
+ *  - post() only merges the event into a table under a short lock
+ *  - events with the same traits_t::key() that are waiting together are sent
+ *    once, with traits_t::coalesce() recording how many there were and the
+ *    first and last timestamps
+ *  - each connection gets at most max_rate events a second (bursts of up to
+ *    a second's worth); what it can't take yet keeps coalescing until it can
+ *  - at most MAX_PENDING distinct events wait per connection; more are dropped
+ *
+ * traits_t provides
+ *   typedef ... status_type;  // the event, with a timestamp member
+ *   typedef ... time_type;    // the type of that timestamp
+ *   static uint64_t key(const status_type&);
+ *   static void coalesce(status_type& first, const time_type& last, uint64_t count);
+ */
+template <class traits_t>
+class statusDispatcher {
+    public:
+        typedef typename traits_t::status_type status_type;
+        typedef typename traits_t::time_type time_type;
+        typedef boost::function<void (const status_type&, const std::string&)> send_function;
+        typedef boost::function<std::vector<std::string> ()> connections_function;
+
+        statusDispatcher() : _thread(NULL), _running(false), _max_rate(0), _sequence(0) {
+        }
+        ~statusDispatcher() {
+            stop();
+        }
+
+        // send(status, connection_id) delivers an event; connections() lists the connection ids
+        void start(const send_function& send, const connections_function& connections) {
+            if (_thread != NULL)
+                return;
+            _send = send;
+            _connections = connections;
+            _running = true;
+            _thread = new boost::thread(&statusDispatcher::run, this);
+        }
+
+        // events not yet sent are dropped
+        void stop() {
+            if (_thread == NULL)
+                return;
+            {
+                boost::mutex::scoped_lock lock(_lock);
+                _running = false;
+            }
+            _wake.notify_all();
+            _thread->join();
+            delete _thread;
+            _thread = NULL;
+            _incoming.clear();
+            _consumers.clear();
+        }
+
+        // events a second per connection; 0 for no limit
+        void setMaxRate(double max_rate) {
+            {
+                boost::mutex::scoped_lock lock(_lock);
+                _max_rate = std::max(max_rate, 0.0);
+            }
+            _wake.notify_all();
+        }
+
+        // coalesce=false sends the event on its own even if an identical one is waiting
+        void post(const status_type& status, bool coalesce=true) {
+            boost::mutex::scoped_lock lock(_lock);
+            if (not _running)
+                return;
+            const uint64_t key = coalesce ? (traits_t::key(status) & ~UNIQUE) : (UNIQUE | _sequence);
+            typename table::iterator it = _incoming.find(key);
+            if (it != _incoming.end()) {
+                it->second.last = status.timestamp;
+                it->second.count++;
+                return;
+            }
+            if (_incoming.size() >= MAX_PENDING)
+                return;
+            entry& added = _incoming[key];
+            added.status = status;
+            added.last = status.timestamp;
+            added.count = 1;
+            added.sequence = _sequence++;
+            if (_incoming.size() == 1)
+                _wake.notify_one();
+        }
+
+    private:
+        static const size_t MAX_PENDING = 1024;
+        static const uint64_t UNIQUE = uint64_t(1) << 63; // keys of events posted with coalesce=false
+
+        struct entry {
+            status_type status;     // as first posted
+            time_type last;
+            uint64_t count;
+            uint64_t sequence;      // order of first posting
+        };
+        typedef std::map<uint64_t, entry> table;
+
+        struct consumer {
+            double tokens;
+            boost::system_time refilled;
+            table pending;
+        };
+
+        void run() {
+            boost::system_time next_send; // not_a_date_time while nothing is held back
+            while (true) {
+                table incoming;
+                double max_rate;
+                {
+                    boost::mutex::scoped_lock lock(_lock);
+                    while (_running and _incoming.empty()) {
+                        if (next_send.is_not_a_date_time()) {
+                            _wake.wait(lock);
+                        } else if (not _wake.timed_wait(lock, next_send)) {
+                            break;
+                        }
+                    }
+                    if (not _running)
+                        return;
+                    incoming.swap(_incoming);
+                    max_rate = _max_rate;
+                }
+                next_send = dispatch(incoming, max_rate);
+            }
+        }
+
+        // returns when a held back event may next be sent
+        boost::system_time dispatch(const table& incoming, double max_rate) {
+            const boost::system_time now = boost::get_system_time();
+            const double burst = std::max(max_rate, 1.0);
+
+            // follow the port's connections
+            const std::vector<std::string> ids = _connections();
+            for (typename std::map<std::string, consumer>::iterator it=_consumers.begin(); it!=_consumers.end(); ) {
+                if (std::find(ids.begin(), ids.end(), it->first) == ids.end()) {
+                    _consumers.erase(it++);
+                } else {
+                    it++;
+                }
+            }
+            for (size_t i=0; i<ids.size(); i++) {
+                if (_consumers.find(ids[i]) == _consumers.end()) {
+                    consumer& added = _consumers[ids[i]];
+                    added.tokens = burst;
+                    added.refilled = now;
+                }
+            }
+
+            boost::system_time next_send;
+            for (typename std::map<std::string, consumer>::iterator it=_consumers.begin(); it!=_consumers.end(); it++) {
+                consumer& target = it->second;
+                for (typename table::const_iterator event=incoming.begin(); event!=incoming.end(); event++) {
+                    typename table::iterator waiting = target.pending.find(event->first);
+                    if (waiting != target.pending.end()) {
+                        waiting->second.last = event->second.last;
+                        waiting->second.count += event->second.count;
+                    } else if (target.pending.size() < MAX_PENDING) {
+                        target.pending.insert(*event);
+                    }
+                }
+
+                if (max_rate > 0) {
+                    target.tokens = std::min(burst, target.tokens + (now - target.refilled).total_microseconds()/1e6 * max_rate);
+                }
+                target.refilled = now;
+                while ((not target.pending.empty()) and ((max_rate <= 0) or (target.tokens >= 1))) {
+                    typename table::iterator oldest = target.pending.begin();
+                    for (typename table::iterator waiting=target.pending.begin(); waiting!=target.pending.end(); waiting++) {
+                        if (waiting->second.sequence < oldest->second.sequence)
+                            oldest = waiting;
+                    }
+                    status_type status = oldest->second.status;
+                    if (oldest->second.count > 1)
+                        traits_t::coalesce(status, oldest->second.last, oldest->second.count);
+                    target.pending.erase(oldest);
+                    target.tokens -= 1;
+                    _send(status, it->first);
+                }
+                if (not target.pending.empty()) {
+                    const boost::system_time ready = now + boost::posix_time::microseconds(long(1e6*(1 - target.tokens)/max_rate) + 1);
+                    if (next_send.is_not_a_date_time() or (ready < next_send))
+                        next_send = ready;
+                }
+            }
+            return next_send;
+        }
+
+        send_function _send;
+        connections_function _connections;
+        boost::thread* _thread;
+        std::map<std::string, consumer> _consumers; // dispatcher thread only
+
+        boost::mutex _lock; // everything below
+        boost::condition_variable _wake;
+        bool _running;
+        double _max_rate;
+        uint64_t _sequence;
+        table _incoming;
+};
+
+// FNV-1a, for building traits_t::key()
+inline uint64_t statusHash(const char* text, uint64_t hash = 14695981039346656037ULL)
+{
+    for (; (text != NULL) and (*text != '\0'); text++) {
+        hash ^= uint8_t(*text);
+        hash *= 1099511628211ULL;
+    }
+    // keep fields apart: "ab"+"c" differs from "a"+"bc"
+    hash ^= 0xff;
+    return hash * 1099511628211ULL;
+}
+
+#endif // STATUS_DISPATCHER_H
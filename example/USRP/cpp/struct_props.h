@@ -200,6 +200,373 @@ inline bool operator!= (const device_characteristics_struct& s1, const device_ch
     return !(s1==s2);
 }
 
+struct frontend_snapshot_struct {
+    frontend_snapshot_struct ()
+    {
+    }
+
+    static std::string getId() {
+        return std::string("FRONTEND::snapshot");
+    }
+
+    static const char* getFormat() {
+        return "dddd";
+    }
+
+    double snapshot_start_whole_seconds;
+    double snapshot_start_partial_seconds;
+    double snapshot_stop_whole_seconds;
+    double snapshot_stop_partial_seconds;
+};
+
+inline bool operator>>= (const CORBA::Any& a, frontend_snapshot_struct& s) {
+    CF::Properties* temp;
+    if (!(a >>= temp)) return false;
+    const redhawk::PropertyMap& props = redhawk::PropertyMap::cast(*temp);
+    if (props.contains("FRONTEND::snapshot_start::whole_seconds")) {
+        if (!(props["FRONTEND::snapshot_start::whole_seconds"] >>= s.snapshot_start_whole_seconds)) return false;
+    }
+    if (props.contains("FRONTEND::snapshot_start::partial_seconds")) {
+        if (!(props["FRONTEND::snapshot_start::partial_seconds"] >>= s.snapshot_start_partial_seconds)) return false;
+    }
+    if (props.contains("FRONTEND::snapshot_stop::whole_seconds")) {
+        if (!(props["FRONTEND::snapshot_stop::whole_seconds"] >>= s.snapshot_stop_whole_seconds)) return false;
+    }
+    if (props.contains("FRONTEND::snapshot_stop::partial_seconds")) {
+        if (!(props["FRONTEND::snapshot_stop::partial_seconds"] >>= s.snapshot_stop_partial_seconds)) return false;
+    }
+    return true;
+}
+
+inline void operator<<= (CORBA::Any& a, const frontend_snapshot_struct& s) {
+    redhawk::PropertyMap props;
+ 
+    props["FRONTEND::snapshot_start::whole_seconds"] = s.snapshot_start_whole_seconds;
+ 
+    props["FRONTEND::snapshot_start::partial_seconds"] = s.snapshot_start_partial_seconds;
+ 
+    props["FRONTEND::snapshot_stop::whole_seconds"] = s.snapshot_stop_whole_seconds;
+ 
+    props["FRONTEND::snapshot_stop::partial_seconds"] = s.snapshot_stop_partial_seconds;
+    a <<= props;
+}
+
+inline bool operator== (const frontend_snapshot_struct& s1, const frontend_snapshot_struct& s2) {
+    if (s1.snapshot_start_whole_seconds!=s2.snapshot_start_whole_seconds)
+        return false;
+    if (s1.snapshot_start_partial_seconds!=s2.snapshot_start_partial_seconds)
+        return false;
+    if (s1.snapshot_stop_whole_seconds!=s2.snapshot_stop_whole_seconds)
+        return false;
+    if (s1.snapshot_stop_partial_seconds!=s2.snapshot_stop_partial_seconds)
+        return false;
+    return true;
+}
+
+inline bool operator!= (const frontend_snapshot_struct& s1, const frontend_snapshot_struct& s2) {
+    return !(s1==s2);
+}
+
+struct frontend_delay_struct {
+    frontend_delay_struct ()
+    {
+    }
+
+    static std::string getId() {
+        return std::string("FRONTEND::delay");
+    }
+
+    static const char* getFormat() {
+        return "ddb";
+    }
+
+    double delay_whole_seconds;
+    double delay_partial_seconds;
+    bool delay_relative;
+};
+
+inline bool operator>>= (const CORBA::Any& a, frontend_delay_struct& s) {
+    CF::Properties* temp;
+    if (!(a >>= temp)) return false;
+    const redhawk::PropertyMap& props = redhawk::PropertyMap::cast(*temp);
+    if (props.contains("FRONTEND::delay::whole_seconds")) {
+        if (!(props["FRONTEND::delay::whole_seconds"] >>= s.delay_whole_seconds)) return false;
+    }
+    if (props.contains("FRONTEND::delay::partial_seconds")) {
+        if (!(props["FRONTEND::delay::partial_seconds"] >>= s.delay_partial_seconds)) return false;
+    }
+    if (props.contains("FRONTEND::delay::relative")) {
+        if (!(props["FRONTEND::delay::relative"] >>= s.delay_relative)) return false;
+    }
+    return true;
+}
+
+inline void operator<<= (CORBA::Any& a, const frontend_delay_struct& s) {
+    redhawk::PropertyMap props;
+ 
+    props["FRONTEND::delay::whole_seconds"] = s.delay_whole_seconds;
+ 
+    props["FRONTEND::delay::partial_seconds"] = s.delay_partial_seconds;
+ 
+    props["FRONTEND::delay::relative"] = s.delay_relative;
+    a <<= props;
+}
+
+inline bool operator== (const frontend_delay_struct& s1, const frontend_delay_struct& s2) {
+    if (s1.delay_whole_seconds!=s2.delay_whole_seconds)
+        return false;
+    if (s1.delay_partial_seconds!=s2.delay_partial_seconds)
+        return false;
+    if (s1.delay_relative!=s2.delay_relative)
+        return false;
+    return true;
+}
+
+inline bool operator!= (const frontend_delay_struct& s1, const frontend_delay_struct& s2) {
+    return !(s1==s2);
+}
+
+struct sim_tone_struct {
+    sim_tone_struct ()
+    {
+        frequency = 0.0;
+        level = -40.0;
+    }
+
+    static std::string getId() {
+        return std::string("sim_tone");
+    }
+
+    static const char* getFormat() {
+        return "dd";
+    }
+
+    double frequency;
+    double level;
+};
+
+inline bool operator>>= (const CORBA::Any& a, sim_tone_struct& s) {
+    CF::Properties* temp;
+    if (!(a >>= temp)) return false;
+    const redhawk::PropertyMap& props = redhawk::PropertyMap::cast(*temp);
+    if (props.contains("sim_tones::frequency")) {
+        if (!(props["sim_tones::frequency"] >>= s.frequency)) return false;
+    }
+    if (props.contains("sim_tones::level")) {
+        if (!(props["sim_tones::level"] >>= s.level)) return false;
+    }
+    return true;
+}
+
+inline void operator<<= (CORBA::Any& a, const sim_tone_struct& s) {
+    redhawk::PropertyMap props;
+ 
+    props["sim_tones::frequency"] = s.frequency;
+ 
+    props["sim_tones::level"] = s.level;
+    a <<= props;
+}
+
+inline bool operator== (const sim_tone_struct& s1, const sim_tone_struct& s2) {
+    if (s1.frequency!=s2.frequency)
+        return false;
+    if (s1.level!=s2.level)
+        return false;
+    return true;
+}
+
+inline bool operator!= (const sim_tone_struct& s1, const sim_tone_struct& s2) {
+    return !(s1==s2);
+}
+
+struct timed_command_struct {
+    timed_command_struct ()
+    {
+        twsec = 0.0;
+        tfsec = 0.0;
+        center_frequency = 0.0;
+        sample_rate = 0.0;
+        gain = 0.0;
+        set_gain = false;
+    }
+
+    static std::string getId() {
+        return std::string("timed_command");
+    }
+
+    static const char* getFormat() {
+        return "sdddddb";
+    }
+
+    std::string allocation_id;
+    double twsec;
+    double tfsec;
+    double center_frequency;
+    double sample_rate;
+    double gain;
+    bool set_gain;
+};
+
+inline bool operator>>= (const CORBA::Any& a, timed_command_struct& s) {
+    CF::Properties* temp;
+    if (!(a >>= temp)) return false;
+    const redhawk::PropertyMap& props = redhawk::PropertyMap::cast(*temp);
+    if (props.contains("timed_commands::allocation_id")) {
+        if (!(props["timed_commands::allocation_id"] >>= s.allocation_id)) return false;
+    }
+    if (props.contains("timed_commands::twsec")) {
+        if (!(props["timed_commands::twsec"] >>= s.twsec)) return false;
+    }
+    if (props.contains("timed_commands::tfsec")) {
+        if (!(props["timed_commands::tfsec"] >>= s.tfsec)) return false;
+    }
+    if (props.contains("timed_commands::center_frequency")) {
+        if (!(props["timed_commands::center_frequency"] >>= s.center_frequency)) return false;
+    }
+    if (props.contains("timed_commands::sample_rate")) {
+        if (!(props["timed_commands::sample_rate"] >>= s.sample_rate)) return false;
+    }
+    if (props.contains("timed_commands::gain")) {
+        if (!(props["timed_commands::gain"] >>= s.gain)) return false;
+    }
+    if (props.contains("timed_commands::set_gain")) {
+        if (!(props["timed_commands::set_gain"] >>= s.set_gain)) return false;
+    }
+    return true;
+}
+
+inline void operator<<= (CORBA::Any& a, const timed_command_struct& s) {
+    redhawk::PropertyMap props;
+ 
+    props["timed_commands::allocation_id"] = s.allocation_id;
+ 
+    props["timed_commands::twsec"] = s.twsec;
+ 
+    props["timed_commands::tfsec"] = s.tfsec;
+ 
+    props["timed_commands::center_frequency"] = s.center_frequency;
+ 
+    props["timed_commands::sample_rate"] = s.sample_rate;
+ 
+    props["timed_commands::gain"] = s.gain;
+ 
+    props["timed_commands::set_gain"] = s.set_gain;
+    a <<= props;
+}
+
+inline bool operator== (const timed_command_struct& s1, const timed_command_struct& s2) {
+    if (s1.allocation_id!=s2.allocation_id)
+        return false;
+    if (s1.twsec!=s2.twsec)
+        return false;
+    if (s1.tfsec!=s2.tfsec)
+        return false;
+    if (s1.center_frequency!=s2.center_frequency)
+        return false;
+    if (s1.sample_rate!=s2.sample_rate)
+        return false;
+    if (s1.gain!=s2.gain)
+        return false;
+    if (s1.set_gain!=s2.set_gain)
+        return false;
+    return true;
+}
+
+inline bool operator!= (const timed_command_struct& s1, const timed_command_struct& s2) {
+    return !(s1==s2);
+}
+
+struct timed_command_result_struct {
+    timed_command_result_struct ()
+    {
+    }
+
+    static std::string getId() {
+        return std::string("timed_command_result");
+    }
+
+    static const char* getFormat() {
+        return "Qsddsbq";
+    }
+
+    CORBA::ULongLong id;
+    std::string allocation_id;
+    double twsec;
+    double tfsec;
+    std::string state;
+    bool late;
+    CORBA::LongLong sample_index;
+};
+
+inline bool operator>>= (const CORBA::Any& a, timed_command_result_struct& s) {
+    CF::Properties* temp;
+    if (!(a >>= temp)) return false;
+    const redhawk::PropertyMap& props = redhawk::PropertyMap::cast(*temp);
+    if (props.contains("timed_command_status::id")) {
+        if (!(props["timed_command_status::id"] >>= s.id)) return false;
+    }
+    if (props.contains("timed_command_status::allocation_id")) {
+        if (!(props["timed_command_status::allocation_id"] >>= s.allocation_id)) return false;
+    }
+    if (props.contains("timed_command_status::twsec")) {
+        if (!(props["timed_command_status::twsec"] >>= s.twsec)) return false;
+    }
+    if (props.contains("timed_command_status::tfsec")) {
+        if (!(props["timed_command_status::tfsec"] >>= s.tfsec)) return false;
+    }
+    if (props.contains("timed_command_status::state")) {
+        if (!(props["timed_command_status::state"] >>= s.state)) return false;
+    }
+    if (props.contains("timed_command_status::late")) {
+        if (!(props["timed_command_status::late"] >>= s.late)) return false;
+    }
+    if (props.contains("timed_command_status::sample_index")) {
+        if (!(props["timed_command_status::sample_index"] >>= s.sample_index)) return false;
+    }
+    return true;
+}
+
+inline void operator<<= (CORBA::Any& a, const timed_command_result_struct& s) {
+    redhawk::PropertyMap props;
+ 
+    props["timed_command_status::id"] = s.id;
+ 
+    props["timed_command_status::allocation_id"] = s.allocation_id;
+ 
+    props["timed_command_status::twsec"] = s.twsec;
+ 
+    props["timed_command_status::tfsec"] = s.tfsec;
+ 
+    props["timed_command_status::state"] = s.state;
+ 
+    props["timed_command_status::late"] = s.late;
+ 
+    props["timed_command_status::sample_index"] = s.sample_index;
+    a <<= props;
+}
+
+inline bool operator== (const timed_command_result_struct& s1, const timed_command_result_struct& s2) {
+    if (s1.id!=s2.id)
+        return false;
+    if (s1.allocation_id!=s2.allocation_id)
+        return false;
+    if (s1.twsec!=s2.twsec)
+        return false;
+    if (s1.tfsec!=s2.tfsec)
+        return false;
+    if (s1.state!=s2.state)
+        return false;
+    if (s1.late!=s2.late)
+        return false;
+    if (s1.sample_index!=s2.sample_index)
+        return false;
+    return true;
+}
+
+inline bool operator!= (const timed_command_result_struct& s1, const timed_command_result_struct& s2) {
+    return !(s1==s2);
+}
+
 struct frontend_tuner_status_struct_struct : public frontend::default_frontend_tuner_status_struct_struct {
     frontend_tuner_status_struct_struct () : frontend::default_frontend_tuner_status_struct_struct()
     {
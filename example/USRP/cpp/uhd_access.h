@@ -1,7 +1,25 @@
 #ifndef UHD_ACCESS_H
 #define UHD_ACCESS_H
 
-#include <uhd/usrp/multi_usrp.hpp>
+#include <boost/thread.hpp>
+#include "radio.h"
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cmath>
+#include <boost/shared_ptr.hpp>
+#include "sample_stats.h"
+
+/* serializes use of the shared multi_usrp command time
+ * set_command_time() applies to every channel on the motherboard, so anything
+ * issuing (timed or untimed) commands holds this while it does so
+ */
+typedef boost::shared_ptr<boost::mutex> usrp_command_lock_t;
+
+inline uhd::time_spec_t toTimeSpec(const BULKIO::PrecisionUTCTime& time) {
+    return uhd::time_spec_t(time_t(time.twsec), time.tfsec);
+}
 
 typedef struct ticket_lock {
     ticket_lock(){
@@ -14,31 +32,145 @@ typedef struct ticket_lock {
     size_t queue_head, queue_tail;
 } ticket_lock_t;
 
+// for holding several tuner locks at once; otherwise use scoped_tuner_lock
+inline void lockTuner(ticket_lock_t& ticket){
+    boost::mutex::scoped_lock lock(*ticket.mutex);
+    const size_t queue_me = ticket.queue_tail++;
+    while (queue_me != ticket.queue_head)
+    {
+        ticket.cond->wait(lock);
+    }
+}
+
+inline void unlockTuner(ticket_lock_t& ticket){
+    boost::mutex::scoped_lock lock(*ticket.mutex);
+    ticket.queue_head++;
+    ticket.cond->notify_all();
+}
+
 class scoped_tuner_lock{
     public:
         scoped_tuner_lock(ticket_lock_t& _ticket){
             ticket = &_ticket;
+            lockTuner(*ticket);
+        }
+        ~scoped_tuner_lock(){
+            unlockTuner(*ticket);
+        }
+    private:
+        ticket_lock_t* ticket;
+};
+
+/* pool of fixed-capacity sample buffers
+ *  - get() hands out a redhawk::buffer whose deleter puts the memory back in
+ *    the pool once the last shared_buffer reference (ours or BulkIO's) is gone
+ *  - changing the capacity retires the cached buffers; buffers of the old
+ *    capacity still in flight are freed instead of returned
+ *  - the pool state is reference counted by the outstanding buffers, so they
+ *    may safely outlive the pool itself
+ * usrpBufferPool holds sc16 samples; the other output formats have their own
+ */
+template <typename T>
+class usrpTypedBufferPool {
+    public:
+        usrpTypedBufferPool() : _state(new state()) {
+        }
+
+        void setCapacity(size_t capacity){
+            boost::mutex::scoped_lock lock(_state->mutex);
+            if (capacity == _state->capacity)
+                return;
+            _state->capacity = capacity;
+            _state->purge();
+        }
+
+        size_t capacity() const {
+            return _state->capacity;
+        }
 
-            boost::mutex::scoped_lock lock(*ticket->mutex);
-            queue_me = ticket->queue_tail++;
-            while (queue_me != ticket->queue_head)
+        // number of buffers allocated from the heap over the life of the pool
+        size_t allocated() const {
+            return _state->allocated;
+        }
+
+        redhawk::buffer<T> get(){
+            T* data = NULL;
+            size_t capacity;
             {
-                ticket->cond->wait(lock);
+                boost::mutex::scoped_lock lock(_state->mutex);
+                capacity = _state->capacity;
+                if (not _state->free_list.empty()) {
+                    data = _state->free_list.back();
+                    _state->free_list.pop_back();
+                }
+            }
+            if (data == NULL) {
+                data = new T[capacity];
+                _state->allocated++;
             }
+            return redhawk::buffer<T>(data, capacity, releaser(_state, capacity));
         }
-        ~scoped_tuner_lock(){
-            boost::mutex::scoped_lock lock(*ticket->mutex);
-            ticket->queue_head++;
-            ticket->cond->notify_all();
+
+        // a buffer of at least size elements, for output whose size varies a
+        // little; the capacity only grows, so the pool settles on the largest
+        redhawk::buffer<T> get(size_t size){
+            {
+                boost::mutex::scoped_lock lock(_state->mutex);
+                if (size > _state->capacity) {
+                    _state->capacity = size;
+                    _state->purge();
+                }
+            }
+            return get();
         }
+
     private:
-        ticket_lock_t* ticket;
-        size_t queue_me;
+        static const size_t MAX_CACHED = 64;
+
+        struct state {
+            state() : capacity(0), allocated(0) {
+                free_list.reserve(MAX_CACHED);
+            }
+            ~state() {
+                purge();
+            }
+            void purge() {
+                for (size_t i=0; i<free_list.size(); i++)
+                    delete[] free_list[i];
+                free_list.clear();
+            }
+            boost::mutex mutex;
+            std::vector<T*> free_list;
+            size_t capacity;
+            std::atomic<size_t> allocated;
+        };
+
+        struct releaser {
+            releaser(const boost::shared_ptr<state>& _pool, size_t _capacity) : pool(_pool), capacity(_capacity) {
+            }
+            void operator()(T* data) {
+                {
+                    boost::mutex::scoped_lock lock(pool->mutex);
+                    if ((capacity == pool->capacity) and (pool->free_list.size() < MAX_CACHED)) {
+                        pool->free_list.push_back(data);
+                        return;
+                    }
+                }
+                delete[] data;
+            }
+            boost::shared_ptr<state> pool;
+            size_t capacity;
+        };
+
+        boost::shared_ptr<state> _state;
 };
 
+typedef usrpTypedBufferPool<short> usrpBufferPool;
+
 struct usrpTunerStruct {
     usrpTunerStruct(){
 
+        buffer_size = 0;
         setDefaultBufferSize();
 
         reset();
@@ -56,7 +188,7 @@ struct usrpTunerStruct {
         const size_t max_samples_per_push = (size_t((max_payload_size/sizeof(output_buffer[0]))/1024)*1024);
 
         buffer_capacity = max_samples_per_push;
-        output_buffer.resize( buffer_capacity );
+        resizeOutputBuffer();
     }
 
     bool updateBufferSize(size_t newMaxSamplesPerPush) {
@@ -73,7 +205,7 @@ struct usrpTunerStruct {
             }
             if (newVal <= max_samples_per_push) {
                 buffer_capacity = newVal;
-                output_buffer.resize( buffer_capacity );
+                resizeOutputBuffer();
                 retVal = true;
             } else {
                 std::cerr << "Invalid newMaxSamplesPerPush: " << newMaxSamplesPerPush << " would be too big for transport max sample size of " << max_samples_per_push << std::endl;
@@ -84,13 +216,31 @@ struct usrpTunerStruct {
         return retVal;
     }
 
+    // swap in a pooled buffer of buffer_capacity, keeping any samples already received
+    void resizeOutputBuffer() {
+        pool.setCapacity(buffer_capacity);
+        if (output_buffer.size() == buffer_capacity)
+            return;
+        redhawk::buffer<short> new_buffer = pool.get();
+        buffer_size = std::min(buffer_size, buffer_capacity);
+        std::copy(output_buffer.begin(), output_buffer.begin()+std::min(output_buffer.size(), buffer_size), new_buffer.begin());
+        output_buffer = new_buffer;
+    }
+
+    // hand the current output_buffer off (caller keeps its reference) and start a fresh one
+    void nextOutputBuffer() {
+        output_buffer = pool.get();
+        buffer_size = 0;
+    }
+
+    usrpBufferPool pool;
     redhawk::buffer<short> output_buffer;
     size_t buffer_capacity; // num samps buffer can hold
     size_t buffer_size; // num samps in buffer
     BULKIO::PrecisionUTCTime output_buffer_time;
     BULKIO::PrecisionUTCTime time_up;
     BULKIO::PrecisionUTCTime time_down;
-    bool update_sri;
+    std::atomic<bool> update_sri; // set under lock, consumed by the egress thread
     ticket_lock_t lock;
 
     void reset(){
@@ -102,6 +252,403 @@ struct usrpTunerStruct {
     }
 };
 
+/* one buffer's worth of received samples, as handed from the capture thread
+ * to the egress (service function) thread
+ */
+struct usrpRxBlock {
+    usrpRxBlock(){
+        reset();
+    }
+
+    redhawk::buffer<short> data;
+    size_t size; // num shorts in data that are valid
+    BULKIO::PrecisionUTCTime time; // timestamp of first sample
+    bool overflow; // block was cut short by an overflow
+    sc16Stats stats; // peak/power/clipping over the valid samples
+    bool agc_gain_changed; // a timed gain change (the AGC's or a command's) landed in this block
+    float agc_gain; // gain in effect from agc_gain_offset on
+    size_t agc_gain_offset; // complex sample index the change took effect at
+    uint64_t queued_ns; // latencyHistogram::now() when the block went into the ring
+    bool retuned; // the first sample is the first one at center_frequency and sample_rate (a timed change)
+    double center_frequency;
+    double sample_rate;
+    bool rate_changed;
+
+    void reset(){
+        size = 0;
+        bulkio::sri::zeroTime(time);
+        overflow = false;
+        stats.reset();
+        agc_gain_changed = false;
+        agc_gain = 0;
+        agc_gain_offset = 0;
+        queued_ns = 0;
+        retuned = false;
+        center_frequency = 0;
+        sample_rate = 0;
+        rate_changed = false;
+    }
+};
+
+/* single-producer/single-consumer ring of received blocks
+ *  - the capture thread is the only producer, the egress thread the only consumer
+ *  - blocks are swapped in and out so no sample data is copied
+ *  - resize() and clear() may only be called while neither thread is running
+ */
+class usrpRxRing {
+    public:
+        usrpRxRing(){
+            head = tail = 0;
+            drops = 0;
+            resize(16);
+        }
+
+        void resize(size_t depth){
+            // one slot is always left empty to tell full from empty
+            slots.clear();
+            slots.resize(std::max(depth, size_t(1))+1);
+            head = tail = 0;
+        }
+
+        void clear(){
+            for (size_t i=0; i<slots.size(); i++)
+                slots[i].reset();
+            head = tail = 0;
+        }
+
+        // returns false (and counts a drop) if the ring is full; block is left untouched in that case
+        bool push(usrpRxBlock& block){
+            const size_t t = tail.load(std::memory_order_relaxed);
+            const size_t next = (t+1) % slots.size();
+            if (next == head.load(std::memory_order_acquire)) {
+                drops++;
+                return false;
+            }
+            std::swap(slots[t], block);
+            tail.store(next, std::memory_order_release);
+            return true;
+        }
+
+        // returns false if the ring is empty
+        bool pop(usrpRxBlock& block){
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire))
+                return false;
+            std::swap(slots[h], block);
+            head.store((h+1) % slots.size(), std::memory_order_release);
+            return true;
+        }
+
+        size_t fill() const {
+            const size_t h = head.load(std::memory_order_acquire);
+            const size_t t = tail.load(std::memory_order_acquire);
+            return (t+slots.size()-h) % slots.size();
+        }
+
+        size_t depth() const {
+            return slots.size()-1;
+        }
+
+        size_t dropped() const {
+            return drops.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::vector<usrpRxBlock> slots;
+        std::atomic<size_t> head; // next slot to pop, owned by the consumer
+        std::atomic<size_t> tail; // next slot to push, owned by the producer
+        std::atomic<size_t> drops;
+};
+
+/* what a channel is set to from a given time on, by a UHD timed command */
+struct usrpTimedChange {
+    usrpTimedChange(){
+        id = 0;
+        center_frequency = 0;
+        sample_rate = 0;
+        gain = 0;
+    }
+
+    uint64_t id; // usrpCommandLog entry, 0 for none
+    uhd::time_spec_t when;
+    double center_frequency;
+    double sample_rate;     // 0 for unchanged
+    double gain;
+};
+
+/* where scheduled timed commands took effect, as their channels report it;
+ * keeps the most recent MAX_ENTRIES
+ */
+class usrpCommandLog {
+    public:
+        enum state_t {
+            SCHEDULED,  // issued; the receiver hasn't reached its time yet
+            LANDED,     // sample_index is the first sample at the new settings
+            ISSUED,     // issued to a transmitter, whose samples carry no time to find it by
+            FAILED
+        };
+        struct entry {
+            uint64_t id;
+            std::string allocation_id;
+            uhd::time_spec_t when;
+            state_t state;
+            bool late;              // the radio was already past 'when' once the command was in
+            int64_t sample_index;   // counted from the start of the stream; -1 if not known
+        };
+
+        usrpCommandLog() : _next_id(1) {
+        }
+
+        uint64_t add(const std::string& allocation_id, const uhd::time_spec_t& when, state_t state){
+            boost::mutex::scoped_lock lock(_mutex);
+            entry added;
+            added.id = _next_id++;
+            added.allocation_id = allocation_id;
+            added.when = when;
+            added.state = state;
+            added.late = false;
+            added.sample_index = -1;
+            _entries.push_back(added);
+            if (_entries.size() > MAX_ENTRIES)
+                _entries.pop_front();
+            return added.id;
+        }
+
+        void setLate(uint64_t id){
+            boost::mutex::scoped_lock lock(_mutex);
+            entry* found = find(id);
+            if (found != NULL)
+                found->late = true;
+        }
+
+        void landed(uint64_t id, int64_t sample_index){
+            boost::mutex::scoped_lock lock(_mutex);
+            entry* found = find(id);
+            if (found != NULL) {
+                found->state = LANDED;
+                found->sample_index = sample_index;
+            }
+        }
+
+        std::vector<entry> entries() const {
+            boost::mutex::scoped_lock lock(_mutex);
+            return std::vector<entry>(_entries.begin(), _entries.end());
+        }
+
+    private:
+        static const size_t MAX_ENTRIES = 256;
+
+        entry* find(uint64_t id){
+            for (std::deque<entry>::reverse_iterator it=_entries.rbegin(); it!=_entries.rend(); it++) {
+                if (it->id == id)
+                    return &(*it);
+            }
+            return NULL;
+        }
+
+        mutable boost::mutex _mutex;
+        std::deque<entry> _entries;
+        uint64_t _next_id;
+};
+typedef boost::shared_ptr<usrpCommandLog> usrp_command_log_t;
+
+/* a tuner change asked for by a control call */
+struct usrpTuneCommand {
+    enum kind_t {
+        FREQUENCY,
+        GAIN
+    };
+    kind_t kind;
+    double value;
+};
+
+/* bounded multi-producer/single-consumer queue of tuner commands, after
+ * Vyukov's bounded queue: each slot carries the position it may next be
+ * written (== position) or read (== position+1) at
+ *  - any thread may push() without taking a lock
+ *  - pop() callers must be serialized (RDC_i pops under the tuner lock)
+ */
+class usrpTuneQueue {
+    public:
+        usrpTuneQueue(){
+            for (size_t i=0; i<CAPACITY; i++)
+                slots[i].sequence = i;
+            head = tail = 0;
+        }
+
+        // returns false if the queue is full
+        bool push(const usrpTuneCommand& command){
+            size_t position = tail.load(std::memory_order_relaxed);
+            while (true) {
+                slot& target = slots[position % CAPACITY];
+                const ptrdiff_t lag = ptrdiff_t(target.sequence.load(std::memory_order_acquire)) - ptrdiff_t(position);
+                if (lag == 0) {
+                    if (tail.compare_exchange_weak(position, position+1, std::memory_order_relaxed)) {
+                        target.command = command;
+                        target.sequence.store(position+1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (lag < 0) {
+                    return false;
+                } else {
+                    position = tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // returns false if the queue is empty
+        bool pop(usrpTuneCommand& command){
+            const size_t position = head.load(std::memory_order_relaxed);
+            slot& source = slots[position % CAPACITY];
+            if (source.sequence.load(std::memory_order_acquire) != position+1)
+                return false;
+            command = source.command;
+            source.sequence.store(position+CAPACITY, std::memory_order_release);
+            head.store(position+1, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool empty() const {
+            const size_t position = head.load(std::memory_order_relaxed);
+            return slots[position % CAPACITY].sequence.load(std::memory_order_acquire) != position+1;
+        }
+
+    private:
+        static const size_t CAPACITY = 16;
+        struct slot {
+            std::atomic<size_t> sequence;
+            usrpTuneCommand command;
+        };
+        slot slots[CAPACITY];
+        std::atomic<size_t> head; // next position to pop
+        std::atomic<size_t> tail; // next position to push
+};
+
+/* the LO settings that have served each center frequency, so a retune can go
+ * back to an LO it knows instead of letting UHD pick a new one; keeps the
+ * MAX_ENTRIES most recent. Not thread safe (RDC_i uses it under the tuner lock)
+ */
+class usrpTuneCache {
+    public:
+        struct entry {
+            double frequency;
+            double lo_frequency;
+            double settle_time; // s from the LO move to lock; < 0 if not measured
+        };
+
+        // an LO within reach of frequency: the one that served it last, if that
+        // is, else the most recent one that is
+        bool find(double frequency, double reach, entry& found) const {
+            const entry* nearby = NULL;
+            for (std::deque<entry>::const_reverse_iterator it=_entries.rbegin(); it!=_entries.rend(); it++) {
+                if (std::abs(frequency - it->lo_frequency) > reach + TOLERANCE)
+                    continue;
+                if (std::abs(frequency - it->frequency) <= TOLERANCE) {
+                    found = *it;
+                    return true;
+                }
+                if (nearby == NULL)
+                    nearby = &(*it);
+            }
+            if (nearby == NULL)
+                return false;
+            found = *nearby;
+            return true;
+        }
+
+        void store(double frequency, double lo_frequency){
+            entry added;
+            added.frequency = frequency;
+            added.lo_frequency = lo_frequency;
+            added.settle_time = settleTime(lo_frequency);
+            for (std::deque<entry>::iterator it=_entries.begin(); it!=_entries.end(); it++) {
+                if (std::abs(frequency - it->frequency) <= TOLERANCE) {
+                    _entries.erase(it);
+                    break;
+                }
+            }
+            _entries.push_back(added);
+            if (_entries.size() > MAX_ENTRIES)
+                _entries.pop_front();
+        }
+
+        void settled(double lo_frequency, double settle_time){
+            for (std::deque<entry>::iterator it=_entries.begin(); it!=_entries.end(); it++) {
+                if (std::abs(lo_frequency - it->lo_frequency) <= TOLERANCE)
+                    it->settle_time = settle_time;
+            }
+            _slowest = std::max(_slowest, settle_time);
+        }
+
+        // < 0 if not measured
+        double settleTime(double lo_frequency) const {
+            for (std::deque<entry>::const_reverse_iterator it=_entries.rbegin(); it!=_entries.rend(); it++) {
+                if (std::abs(lo_frequency - it->lo_frequency) <= TOLERANCE)
+                    return it->settle_time;
+            }
+            return -1;
+        }
+
+        // the longest any LO on this frontend has taken to lock; < 0 if none measured
+        double slowestSettleTime() const {
+            return _slowest;
+        }
+
+        void clear(){
+            _entries.clear();
+            _slowest = -1;
+        }
+
+    private:
+        static const size_t MAX_ENTRIES = 64;
+        static constexpr double TOLERANCE = 1.0; // Hz
+        std::deque<entry> _entries;
+        double _slowest = -1;
+};
+
+/* when to poll an LO for lock after it moves: not before it has taken as long
+ * as it took the last time it was at that frequency, then at intervals doubling
+ * from POLL_MIN to POLL_MAX, giving up twice the slowest lock measured on the
+ * frontend after the move (at least MIN_WAIT, and MAX_WAIT before any lock
+ * has been measured)
+ */
+class usrpLockBackoff {
+    public:
+        // expected and slowest as from usrpTuneCache; < 0 if not measured
+        void start(const uhd::time_spec_t& moved_at, double expected, double slowest){
+            _interval = POLL_MIN;
+            _next = moved_at + uhd::time_spec_t(std::max(expected, 0.0));
+            double wait = MAX_WAIT;
+            if (slowest > 0)
+                wait = (2*slowest < MIN_WAIT) ? MIN_WAIT : std::min(2*slowest, wait);
+            _deadline = moved_at + uhd::time_spec_t(std::max(wait, expected));
+        }
+
+        bool due(const uhd::time_spec_t& now) const {
+            return not (now < _next);
+        }
+        bool expired(const uhd::time_spec_t& now) const {
+            return not (now < _deadline);
+        }
+
+        // a poll at now didn't find lock
+        void polled(const uhd::time_spec_t& now){
+            _next = now + uhd::time_spec_t(_interval);
+            if (_deadline < _next)
+                _next = _deadline;
+            _interval = (2*_interval < POLL_MAX) ? 2*_interval : POLL_MAX;
+        }
+
+    private:
+        static constexpr double POLL_MIN = 0.0005; // s
+        static constexpr double POLL_MAX = 0.032;
+        static constexpr double MIN_WAIT = 0.05;
+        static constexpr double MAX_WAIT = 1.0;
+        uhd::time_spec_t _next;
+        uhd::time_spec_t _deadline;
+        double _interval = POLL_MIN;
+};
+
 struct usrpRangesStruct {
     usrpRangesStruct(){
         reset();
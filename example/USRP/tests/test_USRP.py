@@ -1,12 +1,19 @@
 #!/usr/bin/env python
 
+import os
+import json
+import time
+import shutil
+import tempfile
 import ossie.utils.testing
 from ossie.utils import sb
 import frontend
-from ossie.cf import CF
+from ossie.cf import CF, CF__POA
 from omniORB import any
 from redhawk.frontendInterfaces import FRONTEND
 from frontend import tuner_device, fe_types
+from omniORB import CORBA
+from bulkio.bulkioInterfaces import BULKIO, BULKIO__POA
 
 class DeviceTests(ossie.utils.testing.RHTestCase):
     # Path to the SPD file, relative to this file. This must be set in order to
@@ -135,5 +142,700 @@ class DeviceTests(ossie.utils.testing.RHTestCase):
         self._check_fts_member(dev, 'FRONTEND::tuner_status::allocation_id_csv', '')
 
 
+class SlowListener(BULKIO__POA.dataShort):
+    """A dataShort port that takes delay seconds to accept each packet"""
+    def __init__(self, delay):
+        self.delay = delay
+        self.packets = 0
+
+    def _get_state(self):
+        return BULKIO.BUSY
+
+    def _get_activeSRIs(self):
+        return []
+
+    def pushSRI(self, H):
+        pass
+
+    def pushPacket(self, data, T, EOS, streamID):
+        self.packets += 1
+        time.sleep(self.delay)
+
+
+class StatusListener(CF__POA.DeviceStatus):
+    """A DeviceStatus port that keeps the events it is sent"""
+    def __init__(self):
+        self.events = []
+
+    def statusChanged(self, status):
+        self.events.append(status)
+
+
+class SimulatedDeviceTests(ossie.utils.testing.RHTestCase):
+    # Runs the device against its simulated radio (radio_backend=SIMULATED),
+    # so no USRP is needed. The simulated master clock is 100 MHz, and sample
+    # rates are divided down from it by 2 to 512.
+    SPD_FILE = '../USRP.spd.xml'
+
+    def tearDown(self):
+        sb.release()
+
+    def _launch(self, **props):
+        props['radio_backend'] = 'SIMULATED'
+        self.comp = sb.launch(self.spd_file, impl=self.impl, properties=props)
+
+    def _child(self, label):
+        # whole names only, so RDC_1 does not find SRDC_1 or DRDC_1
+        for dev in self.comp.devices:
+            if (dev.label == label) or (dev.label.endswith(label) and not dev.label[-len(label)-1].isalnum()):
+                return dev
+        self.fail('no child device '+label)
+
+    def _configure(self, devptr, name, value):
+        devptr.configure([CF.DataType(id=name, value=value)])
+
+    def _query(self, devptr, name):
+        return devptr.query([CF.DataType(id=name, value=any.to_any(None))])[0].value
+
+    def _query_structs(self, devptr, name):
+        structs = []
+        for struct in self._query(devptr, name)._v:
+            structs.append(dict((prop.id, prop.value._v) for prop in struct._v))
+        return structs
+
+    def _fts_value(self, devptr, name):
+        return self._query_structs(devptr, 'FRONTEND::tuner_status')[0][name]
+
+    def _struct_sequence(self, structs):
+        values = [CORBA.Any(CF._tc_Properties, [CF.DataType(id=k, value=v) for k, v in struct]) for struct in structs]
+        return CORBA.Any(CORBA.TypeCode('IDL:omg.org/CORBA/AnySeq:1.0'), values)
+
+    def _allocate(self, devptr, tuner_type, allocation_id, center_frequency, sample_rate=0.0, sample_rate_tolerance=0.0, bandwidth=0.0):
+        frontend_allocation = tuner_device.createTunerAllocation(tuner_type=tuner_type, allocation_id=allocation_id,
+            center_frequency=center_frequency, bandwidth=bandwidth, sample_rate=sample_rate, sample_rate_tolerance=sample_rate_tolerance, returnDict=False)
+        return devptr.allocate([frontend_allocation])
+
+    def _keyword(self, sri, name):
+        for keyword in sri.keywords:
+            if keyword.id == name:
+                return keyword.value._v
+        return None
+
+    def _samples(self, data):
+        # complex shorts may come back interleaved
+        if data.sri.mode and data.data and not isinstance(data.data[0], complex):
+            return len(data.data)/2
+        return len(data.data)
+
+    def _elapsed(self, start, end):
+        # whole and fractional seconds kept apart, so a sample time stays resolvable
+        return (end.twsec-start.twsec) + (end.tfsec-start.tfsec)
+
+    def _read_until(self, snk, predicate, timeout=5.0):
+        deadline = time.time()+timeout
+        while time.time() < deadline:
+            data = snk.read(timeout=0.5)
+            if data is None:
+                continue
+            self.assertFalse(data.eos)
+            if predicate(data):
+                return data
+        self.fail('timed out reading '+str(snk))
+
+    def _read_for(self, snk, seconds):
+        blocks = []
+        deadline = time.time()+seconds
+        while time.time() < deadline:
+            data = snk.read(timeout=0.5)
+            if data is not None and data.data:
+                blocks.append(data)
+        return blocks
+
+    def _read_stream(self, snk, timeout=5.0):
+        # reads the next stream to its end-of-stream; its last SRI and sample count
+        samples = 0
+        deadline = time.time()+timeout
+        while time.time() < deadline:
+            data = snk.read(timeout=0.5)
+            if data is None:
+                continue
+            samples += self._samples(data)
+            if data.eos:
+                return data.sri, samples
+        self.fail('timed out waiting for the end of a stream on '+str(snk))
+
+    def _power(self, blocks):
+        values = [abs(value)**2 for data in blocks for value in data.data]
+        return sum(values)/len(values)
+
+    def testSimulatedOverflow(self):
+        # the stream is contiguous between the forced overflows, and each one
+        # shows up as a jump in the timestamps
+        rate = 1e6
+        self._launch(sim_overflow_interval=0.5)
+        rdc = self._child('RDC_1')
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'simulated', 100e6, rate, 20)), 1)
+        blocks = self._read_for(snk, 2.0)
+        self.assertTrue(len(blocks) > 1)
+        gaps = 0
+        for previous, data in zip(blocks, blocks[1:]):
+            gap = self._elapsed(previous.timestamps[0][1], data.timestamps[0][1]) - self._samples(previous)/rate
+            self.assertTrue(gap > -0.5/rate)
+            if gap > 0.5/rate:
+                gaps += 1
+        self.assertTrue(1 <= gaps <= 5)
+
+    def testChannelizerPlacement(self):
+        # with 4 channels over 4 Msps, channel k sits k MHz above the RDC,
+        # channels 2 and 3 wrapping to -2 and -1 MHz; a tone at +1 MHz shows
+        # up in channel 1 only
+        self._launch(channelizer_channels=4)
+        self._configure(self.comp, 'sim_tones', self._struct_sequence([[
+            ('sim_tones::frequency', any.to_any(101e6)),
+            ('sim_tones::level', any.to_any(-20.0))]]))
+        rdc = self._child('RDC_1')
+        tone_snk = sb.StreamSink()
+        self._child('DDC_1_2').connect(tone_snk, usesPortName='dataFloat_out')
+        quiet_snk = sb.StreamSink()
+        self._child('DDC_1_4').connect(quiet_snk, usesPortName='dataFloat_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'wideband', 100e6, 4e6, 20)), 1)
+        for channel, offset in enumerate([0, 1, -2, -1]):
+            ddc = self._child('DDC_1_%d' % (channel+1))
+            center_frequency = 100e6+offset*1e6
+            self.assertEquals(len(self._allocate(ddc, 'DDC', 'wrong_%d' % channel, center_frequency+0.6e6)), 0)
+            self.assertEquals(len(self._allocate(ddc, 'DDC', 'channel_%d' % channel, center_frequency)), 1)
+            self.assertEquals(self._fts_value(ddc, 'FRONTEND::tuner_status::center_frequency'), center_frequency)
+            self.assertAlmostEquals(self._fts_value(ddc, 'FRONTEND::tuner_status::sample_rate'), 1e6)
+
+        tone = self._read_for(tone_snk, 1.0)
+        quiet = self._read_for(quiet_snk, 1.0)
+        self.assertTrue(tone and quiet)
+        self.assertTrue(self._power(tone) > 100*self._power(quiet))
+
+    def testResamplerOutputRate(self):
+        # 3 Msps is not a divisor of the 100 MHz clock; the hardware runs at
+        # 100/33 MHz and the output is resampled to exactly 3 Msps
+        rate = 3e6
+        self._launch()
+        rdc = self._child('RDC_1')
+        self._configure(rdc, 'rx_exact_rate', any.to_any(True))
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'resample', 100e6, rate, 5)), 1)
+        self.assertAlmostEquals(self._fts_value(rdc, 'FRONTEND::tuner_status::sample_rate'), rate)
+        self.assertAlmostEquals(self._query(rdc, 'rx_hardware_sample_rate')._v, 100e6/33)
+
+        blocks = self._read_for(snk, 2.0)
+        self.assertTrue(len(blocks) > 1)
+        self.assertAlmostEquals(blocks[-1].sri.xdelta*rate, 1.0)
+        samples = sum(self._samples(data) for data in blocks[:-1])
+        elapsed = self._elapsed(blocks[0].timestamps[0][1], blocks[-1].timestamps[0][1])
+        self.assertTrue(abs(samples/elapsed-rate) < rate*1e-4)
+
+    def testRetuneTagsStream(self):
+        # a retune goes out as new SRI on the same stream, not a new stream
+        self._launch()
+        rdc = self._child('RDC_1')
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'retune', 100e6, 1e6, 20)), 1)
+        first = self._read_until(snk, lambda data: len(data.data) > 0)
+        self.assertEquals(self._keyword(first.sri, 'CHAN_RF'), 100e6)
+
+        tuner = rdc.getPort('DigitalTuner_in')._narrow(FRONTEND.DigitalTuner)
+        tuner.setTunerCenterFrequency('retune', 101e6)
+        retuned = self._read_until(snk, lambda data: self._keyword(data.sri, 'CHAN_RF') == 101e6)
+        self.assertEquals(retuned.streamID, first.streamID)
+        self.assertEquals(self._fts_value(rdc, 'FRONTEND::tuner_status::center_frequency'), 101e6)
+
+    def testTimedCommandTagsSample(self):
+        # a timed retune and gain step land on the sample at the command time,
+        # and the stream's SRI and AGC_GAIN follow from that sample
+        rate = 1e6
+        self._launch()
+        rdc = self._child('RDC_1')
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'timed', 100e6, rate, 20)), 1)
+        first = self._read_until(snk, lambda data: len(data.data) > 0)
+        start = first.timestamps[0][1]
+
+        when = BULKIO.PrecisionUTCTime(start.tcmode, start.tcstatus, start.toff, start.twsec+2, start.tfsec)
+        self._configure(self.comp, 'timed_commands', self._struct_sequence([[
+            ('timed_commands::allocation_id', any.to_any('timed')),
+            ('timed_commands::twsec', any.to_any(float(when.twsec))),
+            ('timed_commands::tfsec', any.to_any(when.tfsec)),
+            ('timed_commands::center_frequency', any.to_any(102e6)),
+            ('timed_commands::sample_rate', any.to_any(0.0)),
+            ('timed_commands::gain', any.to_any(20.0)),
+            ('timed_commands::set_gain', any.to_any(True))]]))
+
+        landed = self._read_until(snk, lambda data: (self._keyword(data.sri, 'CHAN_RF') == 102e6) and
+                                                    (self._keyword(data.sri, 'AGC_GAIN') == 20.0))
+        self.assertEquals(landed.streamID, first.streamID)
+
+        status = [entry for entry in self._query_structs(self.comp, 'timed_command_status')
+                  if entry['timed_command_status::allocation_id'] == 'timed']
+        self.assertEquals(len(status), 1)
+        self.assertEquals(status[0]['timed_command_status::state'], 'LANDED')
+        self.assertFalse(status[0]['timed_command_status::late'])
+        expected = int(round(self._elapsed(start, when)*rate))
+        self.assertTrue(abs(status[0]['timed_command_status::sample_index']-expected) <= 1)
+
+    def _check_listener_policy(self, policy):
+        # a slow listener loses packets under its policy while the fast one,
+        # and the capture behind both, keep up
+        rate = 1e6
+        self._launch()
+        rdc = self._child('RDC_1')
+        self._configure(rdc, 'listener_fanout', any.to_any(True))
+        self._configure(rdc, 'listener_policies', self._struct_sequence([[
+            ('listener_policies::connection_id', any.to_any('slow_listener')),
+            ('listener_policies::policy', any.to_any(policy)),
+            ('listener_policies::queue_depth', CORBA.Any(CORBA.TC_ulong, 4)),
+            ('listener_policies::decimation', CORBA.Any(CORBA.TC_ulong, 4))]]))
+
+        fast = sb.StreamSink()
+        rdc.connect(fast, usesPortName='dataShort_out', connectionId='fast_listener')
+        slow = SlowListener(0.05)
+        orb = CORBA.ORB_init()
+        orb.resolve_initial_references('RootPOA')._get_the_POAManager().activate()
+        rdc.getPort('dataShort_out')._narrow(CF.Port).connectPort(slow._this(), 'slow_listener')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'listeners', 100e6, rate, 20)), 1)
+        blocks = self._read_for(fast, 2.0)
+        self.assertTrue(len(blocks) > 1)
+        for previous, data in zip(blocks, blocks[1:]):
+            gap = self._elapsed(previous.timestamps[0][1], data.timestamps[0][1]) - self._samples(previous)/rate
+            self.assertTrue(abs(gap) < 0.5/rate)
+
+        status = dict((entry['listener_status::connection_id'], entry) for entry in self._query_structs(rdc, 'listener_status'))
+        self.assertEquals(status['slow_listener']['listener_status::policy'], policy)
+        self.assertTrue(status['slow_listener']['listener_status::packets_dropped'] > 0)
+        self.assertTrue(status['slow_listener']['listener_status::queued'] <= 4)
+        self.assertTrue(slow.packets > 0)
+        self.assertEquals(status['fast_listener']['listener_status::policy'], 'block')
+        self.assertEquals(status['fast_listener']['listener_status::packets_dropped'], 0)
+        self.assertEquals(self._query(rdc, 'rx_ring_drops')._v, 0)
+
+    def testListenerDropOldest(self):
+        self._check_listener_policy('drop_oldest')
+
+    def testListenerDecimate(self):
+        self._check_listener_policy('decimate')
+
+    def testListenerEndOfStream(self):
+        # stopping the device ends the stream at each listener
+        self._launch()
+        rdc = self._child('RDC_1')
+        self._configure(rdc, 'listener_fanout', any.to_any(True))
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'listener_eos', 100e6, 1e6, 20)), 1)
+        first = self._read_until(snk, lambda data: len(data.data) > 0)
+        rdc.stop()
+        deadline = time.time()+5.0
+        while time.time() < deadline:
+            data = snk.read(timeout=0.5)
+            if data is not None and data.eos:
+                self.assertEquals(data.streamID, first.streamID)
+                return
+        self.fail('no end-of-stream after stop')
+
+    def testPeakStatsCountNegativeExcursions(self):
+        # a tone a quarter of the rate off center clips one of I and Q in every
+        # sample, half of them at negative full scale, so a clip count that only
+        # looked at positive values would come out at half the samples
+        rate = 1e6
+        self._launch()
+        self._configure(self.comp, 'sim_tones', self._struct_sequence([[
+            ('sim_tones::frequency', any.to_any(100e6+rate/4)),
+            ('sim_tones::level', any.to_any(20.0))]]))
+        rdc = self._child('RDC_1')
+        # only full buffers, so every block pushed is the same size
+        self._configure(rdc, 'max_latency_ms', CORBA.Any(CORBA.TC_ulong, 0))
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'clipping', 100e6, rate, 20)), 1)
+        block = self._read_until(snk, lambda data: len(data.data) > 0)
+        samples = self._samples(block)
+        self.assertEquals(self._query(rdc, 'rx_peak_magnitude')._v, 32768)
+        self.assertTrue(abs(self._query(rdc, 'rx_clip_count')._v - samples) < 0.05*samples)
+
+    def testMaxLatencyFlushesPartialBuffers(self):
+        # at 1 Msps a full buffer takes about half a second to fill; with a
+        # 20 ms deadline the buffers go out partial, holding no more than
+        # about 20 ms of samples, and still back to back
+        rate = 1e6
+        latency = 0.02
+        self._launch()
+        rdc = self._child('RDC_1')
+        self._configure(rdc, 'max_latency_ms', CORBA.Any(CORBA.TC_ulong, int(latency*1000)))
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'low_latency', 100e6, rate, 20)), 1)
+        blocks = self._read_for(snk, 1.0)
+        self.assertTrue(len(blocks) > 10)
+        for data in blocks:
+            self.assertTrue(self._samples(data) <= 2*latency*rate)
+        for previous, data in zip(blocks, blocks[1:]):
+            gap = self._elapsed(previous.timestamps[0][1], data.timestamps[0][1]) - self._samples(previous)/rate
+            self.assertTrue(abs(gap) < 0.5/rate)
+
+    def testSnapshotOnTrigger(self):
+        # an SRDC sharing its RDC reaches back into its history for the
+        # samples ahead of the trigger, then ends the snapshot stream
+        rate = 1e6
+        self._launch(srdc_enable=True)
+        rdc = self._child('RDC_1')
+        srdc = self._child('SRDC_1')
+        self._configure(srdc, 'snapshot_history_seconds', any.to_any(0.5))
+        self._configure(srdc, 'snapshot_pre_trigger_seconds', any.to_any(0.1))
+        self._configure(srdc, 'snapshot_post_trigger_seconds', any.to_any(0.2))
+        snk = sb.StreamSink()
+        srdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'source', 100e6, rate, 20)), 1)
+        self.assertEquals(len(self._allocate(srdc, 'SRDC', 'snapshot', 100e6, rate, 20)), 1)
+        # let the history fill past the pre-trigger time
+        time.sleep(1.0)
+        self._configure(srdc, 'snapshot_trigger', any.to_any(True))
+
+        sri, samples = self._read_stream(snk)
+        self.assertEquals(samples, int(0.3*rate))
+        self.assertEquals(self._keyword(sri, 'SNAPSHOT_TRIGGER_OFFSET'), int(0.1*rate))
+        self.assertEquals(self._query(srdc, 'snapshots_sent')._v, 1)
+        self.assertFalse(self._query(srdc, 'snapshot_trigger')._v)
+
+    def testDelayedStreamOffset(self):
+        # the DRDC replays the RDC's samples under their original timestamps,
+        # delay_seconds after they were taken
+        rate = 1e6
+        delay = 0.5
+        self._launch(drdc_enable=True)
+        rdc = self._child('RDC_1')
+        drdc = self._child('DRDC_1')
+        self._configure(drdc, 'delay_store_seconds', any.to_any(5.0))
+        self._configure(drdc, 'delay_seconds', any.to_any(delay))
+        live = sb.StreamSink()
+        rdc.connect(live, usesPortName='dataShort_out')
+        delayed = sb.StreamSink()
+        drdc.connect(delayed, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'source', 100e6, rate, 20)), 1)
+        self.assertEquals(len(self._allocate(drdc, 'DRDC', 'delayed', 100e6, rate, 20)), 1)
+        live_blocks = self._read_for(live, 2.0)
+        late = self._read_until(delayed, lambda data: len(data.data) > 0)
+        self.assertEquals(self._keyword(late.sri, 'DELAY_SECONDS'), delay)
+        self.assertTrue(abs(self._query(drdc, 'delay_actual_seconds')._v - delay) < 0.1)
+
+        start = late.timestamps[0][1]
+        for data in live_blocks:
+            offset = int(round(self._elapsed(data.timestamps[0][1], start)*rate))
+            count = min(100, self._samples(late), self._samples(data)-offset)
+            if (offset < 0) or (count <= 0):
+                continue
+            # 1 value per sample for complex lists, 2 when interleaved
+            width = len(data.data)/self._samples(data)
+            self.assertEquals(data.data[offset*width:(offset+count)*width], late.data[:count*width])
+            return
+        self.fail('delayed samples were not in the live stream')
+
+    def testSpectrumFrames(self):
+        # a tone a quarter of the rate above center peaks three quarters of the
+        # way along each frame, at about its level, and the frames come no
+        # faster than psd_frame_rate
+        rate = 1e6
+        fft_size = 1024
+        frame_rate = 5.0
+        self._launch()
+        self._configure(self.comp, 'sim_tones', self._struct_sequence([[
+            ('sim_tones::frequency', any.to_any(100e6+rate/4)),
+            ('sim_tones::level', any.to_any(-20.0))]]))
+        rdc = self._child('RDC_1')
+        self._configure(rdc, 'max_latency_ms', CORBA.Any(CORBA.TC_ulong, 20))
+        self._configure(rdc, 'psd_fft_size', CORBA.Any(CORBA.TC_ulong, fft_size))
+        self._configure(rdc, 'psd_averages', CORBA.Any(CORBA.TC_ulong, 4))
+        self._configure(rdc, 'psd_frame_rate', CORBA.Any(CORBA.TC_float, frame_rate))
+        self._configure(rdc, 'psd_enable', any.to_any(True))
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataPSD_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'spectrum', 100e6, rate, 20)), 1)
+        blocks = self._read_for(snk, 2.0)
+        self.assertTrue(blocks)
+        self.assertEquals(blocks[-1].sri.subsize, fft_size)
+        self.assertAlmostEquals(blocks[-1].sri.xstart, -rate/2)
+        frames = []
+        for data in blocks:
+            self.assertEquals(len(data.data) % fft_size, 0)
+            frames += [data.data[i:i+fft_size] for i in range(0, len(data.data), fft_size)]
+        self.assertTrue(3 <= len(frames) <= 2*frame_rate+2)
+        for frame in frames:
+            peak = frame.index(max(frame))
+            self.assertTrue(abs(peak - 3*fft_size/4) <= 1)
+            self.assertTrue(abs(max(frame) + 20.0) < 3.0)
+
+    def testBurstExtraction(self):
+        # a tone switched on for about 0.2 s goes out on dataBurst_out as one
+        # stream of its own, ended with an end-of-stream
+        rate = 1e6
+        self._launch()
+        rdc = self._child('RDC_1')
+        self._configure(rdc, 'max_latency_ms', CORBA.Any(CORBA.TC_ulong, 20))
+        self._configure(rdc, 'burst_detect_enable', any.to_any(True))
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataBurst_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'bursts', 100e6, rate, 20)), 1)
+        time.sleep(0.5)
+        self._configure(self.comp, 'sim_tones', self._struct_sequence([[
+            ('sim_tones::frequency', any.to_any(100.1e6)),
+            ('sim_tones::level', any.to_any(-10.0))]]))
+        time.sleep(0.2)
+        self._configure(self.comp, 'sim_tones', self._struct_sequence([]))
+
+        sri, samples = self._read_stream(snk)
+        self.assertTrue(0.1*rate < samples < 0.4*rate)
+        self.assertEquals(self._query(rdc, 'bursts_detected')._v, 1)
+
+    def testRecordingSigMF(self):
+        # a recording leaves a data file with every byte the recorder reports
+        # and SigMF metadata describing it, once recording is turned off
+        rate = 1e6
+        directory = tempfile.mkdtemp()
+        self.addCleanup(shutil.rmtree, directory, True)
+        self._launch()
+        rdc = self._child('RDC_1')
+        self._configure(rdc, 'record_directory', any.to_any(directory))
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'recording', 100e6, rate, 20)), 1)
+        self._configure(rdc, 'record_enable', any.to_any(True))
+        time.sleep(1.0)
+        data_path = self._query(rdc, 'record_file')._v
+        self.assertEquals(os.path.dirname(data_path), directory)
+        self.assertTrue(data_path.endswith('.sigmf-data'))
+        self._configure(rdc, 'record_enable', any.to_any(False))
+
+        # the recording is closed on a thread of its own
+        deadline = time.time()+5.0
+        while (time.time() < deadline) and (os.path.getsize(data_path) != self._query(rdc, 'record_bytes_written')._v):
+            time.sleep(0.1)
+        written = self._query(rdc, 'record_bytes_written')._v
+        self.assertTrue(written >= 4*0.5*rate)
+        self.assertEquals(os.path.getsize(data_path), written)
+        self.assertEquals(self._query(rdc, 'record_file')._v, '')
+        self.assertEquals(self._query(rdc, 'record_dropped_blocks')._v, 0)
+
+        meta = json.load(open(data_path[:-len('.sigmf-data')]+'.sigmf-meta'))
+        self.assertTrue(meta['global']['core:datatype'].startswith('ci16'))
+        self.assertEquals(meta['global']['core:sample_rate'], rate)
+        self.assertTrue(meta['captures'])
+        self.assertEquals(meta['captures'][0]['core:sample_start'], 0)
+        self.assertEquals(meta['captures'][0]['core:frequency'], 100e6)
+
+    def testStatusCoalescing(self):
+        # a storm of overflows reaches a status listener at no more than
+        # status_max_rate events a second, each counting the ones it stands for
+        max_rate = 2.0
+        self._launch(sim_overflow_interval=0.01)
+        rdc = self._child('RDC_1')
+        self._configure(rdc, 'status_max_rate', CORBA.Any(CORBA.TC_float, max_rate))
+        listener = StatusListener()
+        orb = CORBA.ORB_init()
+        orb.resolve_initial_references('RootPOA')._get_the_POAManager().activate()
+        rdc.getPort('DeviceStatus_out')._narrow(CF.Port).connectPort(listener._this(), 'status_listener')
+        sb.start()
+
+        start = time.time()
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'status_storm', 100e6, 1e6, 20)), 1)
+        time.sleep(2.0)
+        elapsed = time.time()-start
+        overflows = [status for status in listener.events if status.status == CF.DEV_OVERFLOW]
+        self.assertTrue(len(overflows) > 0)
+        # bursts of up to a second's worth are allowed
+        self.assertTrue(len(listener.events) <= max_rate*(elapsed+1)+1)
+        counts = []
+        for status in overflows:
+            self.assertEquals(status.allocation_id, 'status_storm')
+            props = dict((prop.id, prop.value._v) for prop in status.props)
+            counts.append(props.get('COUNT', 1))
+        self.assertTrue(max(counts) > 1)
+        self.assertTrue(sum(counts) > len(overflows))
+
+    def testLatencyReset(self):
+        # the latency histograms fill while streaming, and latency_reset
+        # empties them and reads back false
+        self._launch()
+        rdc = self._child('RDC_1')
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        allocation = self._allocate(rdc, 'RDC', 'latency', 100e6, 1e6, 20)
+        self.assertEquals(len(allocation), 1)
+        self._read_for(snk, 1.0)
+        stats = dict((stat['latency_stats::stage'], stat) for stat in self._query_structs(rdc, 'latency_stats'))
+        self.assertEquals(sorted(stats.keys()), sorted(['recv', 'auto_gain', 'capture', 'ring', 'sri', 'resample', 'write', 'service']))
+        for stage in ('recv', 'write'):
+            self.assertTrue(stats[stage]['latency_stats::count'] > 0)
+            self.assertTrue(stats[stage]['latency_stats::p50_us'] <= stats[stage]['latency_stats::p99_us'])
+
+        # nothing is measured once the allocation is gone
+        rdc.deallocate(allocation[0].alloc_id)
+        time.sleep(0.5)
+        self._configure(rdc, 'latency_reset', any.to_any(True))
+        self.assertEquals(self._query(rdc, 'latency_reset')._v, False)
+        for stat in self._query_structs(rdc, 'latency_stats'):
+            self.assertEquals(stat['latency_stats::count'], 0)
+
+    def _retune_history(self, devptr, length, timeout=5.0):
+        # an LO move is only recorded once it has settled
+        deadline = time.time()+timeout
+        while time.time() < deadline:
+            history = self._query_structs(devptr, 'retune_history')
+            if len(history) >= length:
+                return history
+            time.sleep(0.1)
+        self.fail('retune_history never reached %d records' % length)
+
+    def testRetuneHistory(self):
+        # a hop that stays in the passband only moves the DSP, a return to an
+        # earlier frequency reuses its LO, and each LO move reports its settling.
+        # The 100 kHz bandwidth is below the simulated filter's narrowest, so
+        # the passband has room to spare around it.
+        self._launch()
+        rdc = self._child('RDC_1')
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        self.assertEquals(len(self._allocate(rdc, 'RDC', 'retune_history', 100e6, 1e6, 20, bandwidth=100e3)), 1)
+        self._read_until(snk, lambda data: len(data.data) > 0)
+        tuner = rdc.getPort('DigitalTuner_in')._narrow(FRONTEND.DigitalTuner)
+        for frequency in (100.02e6, 110e6, 100e6):
+            tuner.setTunerCenterFrequency('retune_history', frequency)
+            self._read_until(snk, lambda data: self._keyword(data.sri, 'CHAN_RF') == frequency)
+
+        first, small, hop, back = self._retune_history(rdc, 4)[-4:]
+        self.assertTrue(first['retune_history::lo_moved'])
+        self.assertTrue(first['retune_history::settle_time'] >= 0)
+
+        self.assertEquals(small['retune_history::center_frequency'], 100.02e6)
+        self.assertFalse(small['retune_history::lo_moved'])
+        self.assertEquals(small['retune_history::lo_frequency'], first['retune_history::lo_frequency'])
+        self.assertNotEquals(small['retune_history::dsp_frequency'], 0)
+        self.assertEquals(small['retune_history::settle_time'], 0)
+
+        self.assertTrue(hop['retune_history::lo_moved'])
+        self.assertFalse(hop['retune_history::from_cache'])
+        self.assertTrue(hop['retune_history::settle_time'] >= 0)
+
+        self.assertTrue(back['retune_history::lo_moved'])
+        self.assertTrue(back['retune_history::from_cache'])
+        self.assertEquals(back['retune_history::lo_frequency'], first['retune_history::lo_frequency'])
+        self.assertTrue(back['retune_history::settle_time'] >= 0)
+
+    def testScanSegments(self):
+        # a discrete scan goes out as one stream, each dwell under its own
+        # CHAN_RF and exactly control_value seconds of samples long
+        rate = 1e6
+        dwell = 0.1
+        frequencies = [100e6, 101e6, 102e6]
+        self._launch()
+        rdc = self._child('RDC_1')
+        snk = sb.StreamSink()
+        rdc.connect(snk, usesPortName='dataShort_out')
+        sb.start()
+
+        tuner_allocation = tuner_device.createTunerAllocation(tuner_type='RDC', allocation_id='scan',
+            center_frequency=100e6, sample_rate=rate, sample_rate_tolerance=20, returnDict=False)
+        scanner_allocation = CF.DataType(id='FRONTEND::scanner_allocation', value=CORBA.Any(CF._tc_Properties, [
+            CF.DataType(id='FRONTEND::scanner_allocation::min_freq', value=any.to_any(min(frequencies))),
+            CF.DataType(id='FRONTEND::scanner_allocation::max_freq', value=any.to_any(max(frequencies))),
+            CF.DataType(id='FRONTEND::scanner_allocation::mode', value=any.to_any('DISCRETE_SCAN')),
+            CF.DataType(id='FRONTEND::scanner_allocation::control_mode', value=any.to_any('TIME_BASED')),
+            CF.DataType(id='FRONTEND::scanner_allocation::control_limit', value=any.to_any(dwell))]))
+        self.assertEquals(len(self.comp.allocate([tuner_allocation, scanner_allocation])), 1)
+        first = self._read_until(snk, lambda data: len(data.data) > 0)
+
+        tuner = self.comp.getPort('DigitalTuner_in')._narrow(FRONTEND.DigitalScanningTuner)
+        strategy = FRONTEND.ScanningTuner.ScanStrategy(FRONTEND.ScanningTuner.DISCRETE_SCAN,
+            FRONTEND.ScanningTuner.ScanModeDefinition(discrete_freq_list=frequencies),
+            FRONTEND.ScanningTuner.TIME_BASED, dwell)
+        tuner.setScanStrategy('scan', strategy)
+        blocks = self._read_for(snk, 1.5)
+
+        # runs of samples under one CHAN_RF, in order
+        segments = []
+        for previous, data in zip(blocks, blocks[1:]):
+            self.assertEquals(data.streamID, first.streamID)
+            gap = self._elapsed(previous.timestamps[0][1], data.timestamps[0][1]) - self._samples(previous)/rate
+            self.assertTrue(abs(gap) < 0.5/rate)
+        for data in blocks:
+            frequency = self._keyword(data.sri, 'CHAN_RF')
+            if segments and (segments[-1][0] == frequency):
+                segments[-1][1] += self._samples(data)
+            else:
+                segments.append([frequency, self._samples(data)])
+
+        # the first and last may be cut short by the reads
+        hops = segments[1:-1]
+        self.assertTrue(len(hops) >= 6)
+        for (frequency, _), (following, _) in zip(hops, hops[1:]):
+            self.assertEquals(frequencies[(frequencies.index(frequency)+1) % len(frequencies)], following)
+        for frequency, samples in hops:
+            self.assertTrue(abs(samples - dwell*rate) <= 1)
+        self.assertTrue(tuner.getScanStatus('scan').started)
+
+    def testChannelsLockInParallel(self):
+        # allocating doesn't wait for the LO, so two channels enabled back to
+        # back settle together and each reports its own settling time
+        lock_time = 0.5
+        self._launch(sim_rx_channels=2, sim_lo_lock_time=lock_time)
+        sinks = []
+        for label in ('RDC_1', 'RDC_2'):
+            snk = sb.StreamSink()
+            self._child(label).connect(snk, usesPortName='dataShort_out')
+            sinks.append(snk)
+        sb.start()
+
+        start = time.time()
+        for allocation_id in ('lock_1', 'lock_2'):
+            self.assertEquals(len(self._allocate(self.comp, 'RDC', allocation_id, 100e6, 1e6, 20)), 1)
+        self.assertTrue(time.time()-start < lock_time)
+
+        firsts = [self._read_until(snk, lambda data: len(data.data) > 0) for snk in sinks]
+        self.assertTrue(time.time()-start < 2*lock_time)
+        self.assertTrue(abs(self._elapsed(firsts[0].timestamps[0][1], firsts[1].timestamps[0][1])) < lock_time)
+        for label in ('RDC_1', 'RDC_2'):
+            settle_time = self._retune_history(self._child(label), 1)[-1]['retune_history::settle_time']
+            self.assertTrue(0.9*lock_time <= settle_time < lock_time+0.1)
+
+
 if __name__ == "__main__":
     ossie.utils.testing.main() # By default tests all implementations